@@ -0,0 +1,340 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "balanced_parentheses.h"
+
+#define BLOCK_BITS 512
+#define BLOCK_WORDS (BLOCK_BITS / 64)
+#define SUPERBLOCK_BLOCKS 8
+
+/* The excess of a prefix is the number of its open parentheses minus the number of its closed
+   parentheses; the searches below look for the nearest prefix whose excess differs by a given
+   negative amount from that of a starting prefix, accumulating in r the difference between the
+   excess of the current prefix and that of the starting one. */
+
+/* The minimum excess of the nonempty prefixes of a byte, scanning from its lowest bit. */
+static const int8_t min_forward[256] = {
+	-8, -6, -6, -4, -6, -4, -4, -2, -6, -4, -4, -2, -4, -2, -2, 0,
+	-6, -4, -4, -2, -4, -2, -2, 0, -4, -2, -2, 0, -2, 0, -1, 1,
+	-6, -4, -4, -2, -4, -2, -2, 0, -4, -2, -2, 0, -2, 0, -1, 1,
+	-4, -2, -2, 0, -2, 0, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-6, -4, -4, -2, -4, -2, -2, 0, -4, -2, -2, 0, -2, 0, -1, 1,
+	-4, -2, -2, 0, -2, 0, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-5, -3, -3, -1, -3, -1, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-4, -2, -2, 0, -2, 0, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-7, -5, -5, -3, -5, -3, -3, -1, -5, -3, -3, -1, -3, -1, -1, 1,
+	-5, -3, -3, -1, -3, -1, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-5, -3, -3, -1, -3, -1, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-4, -2, -2, 0, -2, 0, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-6, -4, -4, -2, -4, -2, -2, 0, -4, -2, -2, 0, -2, 0, -1, 1,
+	-4, -2, -2, 0, -2, 0, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-5, -3, -3, -1, -3, -1, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+	-4, -2, -2, 0, -2, 0, -1, 1, -3, -1, -1, 1, -2, 0, -1, 1,
+};
+
+/* The minimum excess of the nonempty suffixes of a byte, negated (i.e., relative to its end), scanning from its highest bit. */
+static const int8_t min_backward[256] = {
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0,
+	1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 0, 0, -1, -2,
+	1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 0, 0, 0, -1, -2,
+	0, 0, 0, 0, 0, 0, -1, -2, -1, -1, -1, -2, -2, -2, -3, -4,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, -2,
+	0, 0, 0, 0, 0, 0, -1, -2, -1, -1, -1, -2, -2, -2, -3, -4,
+	-1, -1, -1, -1, -1, -1, -1, -2, -1, -1, -1, -2, -2, -2, -3, -4,
+	-2, -2, -2, -2, -2, -2, -3, -4, -3, -3, -3, -4, -4, -4, -5, -6,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -2,
+	-1, -1, -1, -1, -1, -1, -1, -2, -1, -1, -1, -2, -2, -2, -3, -4,
+	-1, -1, -1, -1, -1, -1, -1, -2, -1, -1, -1, -2, -2, -2, -3, -4,
+	-2, -2, -2, -2, -2, -2, -3, -4, -3, -3, -3, -4, -4, -4, -5, -6,
+	-2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -3, -4,
+	-2, -2, -2, -2, -2, -2, -3, -4, -3, -3, -3, -4, -4, -4, -5, -6,
+	-3, -3, -3, -3, -3, -3, -3, -4, -3, -3, -3, -4, -4, -4, -5, -6,
+	-4, -4, -4, -4, -4, -4, -5, -6, -5, -5, -5, -6, -6, -6, -7, -8,
+};
+
+static inline int byte_excess(const uint64_t byte) {
+	return 2 * __builtin_popcountll(byte) - 8;
+}
+
+static inline int bit(const uint64_t * const bits, const uint64_t pos) {
+	return bits[pos / 64] >> pos % 64 & 1;
+}
+
+/* Returns the byte starting at position x, which must be a multiple of eight. */
+static inline uint64_t byte_at(const uint64_t * const bits, const uint64_t x) {
+	return bits[x / 64] >> x % 64 & 0xFF;
+}
+
+balanced_parentheses *balanced_parentheses_build(const uint64_t *bits, const uint64_t length) {
+	if (length > UINT64_MAX - 63) return NULL;
+	const uint64_t num_words = (length + 63) / 64;
+	const uint64_t num_blocks = (num_words + BLOCK_WORDS - 1) / BLOCK_WORDS;
+	const uint64_t num_superblocks = (num_blocks + SUPERBLOCK_BLOCKS - 1) / SUPERBLOCK_BLOCKS;
+	uint64_t tree_size = 1;
+	while (tree_size < num_superblocks) tree_size *= 2;
+
+	const uint64_t directory_size = 4 * tree_size * sizeof(int64_t) + 2 * num_superblocks * SUPERBLOCK_BLOCKS * sizeof(int16_t);
+	balanced_parentheses *balanced_parentheses = malloc(sizeof *balanced_parentheses + directory_size);
+	if (balanced_parentheses == NULL) return NULL;
+	memset(balanced_parentheses, 0, sizeof *balanced_parentheses + directory_size);
+	balanced_parentheses->length = length;
+	balanced_parentheses->num_words = num_words;
+	balanced_parentheses->bits = bits;
+	balanced_parentheses->num_superblocks = num_superblocks;
+	balanced_parentheses->tree_size = tree_size;
+	int64_t * const tree_excess = balanced_parentheses->tree_excess = (int64_t *)(balanced_parentheses + 1);
+	int64_t * const tree_min = balanced_parentheses->tree_min = tree_excess + 2 * tree_size;
+	int16_t * const block_excess = balanced_parentheses->block_excess = (int16_t *)(tree_min + 2 * tree_size);
+	int16_t * const block_min = balanced_parentheses->block_min = block_excess + num_superblocks * SUPERBLOCK_BLOCKS;
+
+	// Padding blocks and leaves have zero excess and minimum, so they never contain a match
+	for (uint64_t block = 0; block < num_blocks; block++) {
+		int e = 0, m = 0;
+		for (uint64_t w = block * BLOCK_WORDS; w < (block + 1) * BLOCK_WORDS && w < num_words; w++) {
+			// The bits past the end are not parentheses
+			const int valid = w == num_words - 1 && length % 64 != 0 ? length % 64 : 64;
+			int i = 0;
+			for (; i + 8 <= valid; i += 8) {
+				const uint64_t byte = bits[w] >> i & 0xFF;
+				if (e + min_forward[byte] < m) m = e + min_forward[byte];
+				e += byte_excess(byte);
+			}
+			for (; i < valid; i++)
+				if ((e += 2 * (int)(bits[w] >> i & 1) - 1) < m) m = e;
+		}
+		block_excess[block] = e;
+		block_min[block] = m;
+	}
+
+	for (uint64_t superblock = 0; superblock < num_superblocks; superblock++) {
+		int64_t e = 0, m = 0;
+		for (uint64_t block = superblock * SUPERBLOCK_BLOCKS; block < (superblock + 1) * SUPERBLOCK_BLOCKS; block++) {
+			if (e + block_min[block] < m) m = e + block_min[block];
+			e += block_excess[block];
+		}
+		tree_excess[tree_size + superblock] = e;
+		tree_min[tree_size + superblock] = m;
+	}
+
+	for (uint64_t node = tree_size; node-- > 1;) {
+		tree_excess[node] = tree_excess[2 * node] + tree_excess[2 * node + 1];
+		const int64_t right_min = tree_excess[2 * node] + tree_min[2 * node + 1];
+		tree_min[node] = tree_min[2 * node] < right_min ? tree_min[2 * node] : right_min;
+	}
+
+	// The parentheses are balanced if the excess is zero and no prefix has negative excess
+	if (tree_excess[1] != 0 || tree_min[1] < 0) {
+		free(balanced_parentheses);
+		return NULL;
+	}
+	return balanced_parentheses;
+}
+
+balanced_parentheses *load_balanced_parentheses(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	const dump_header * const header = dump_map_header(map, length);
+	balanced_parentheses *balanced_parentheses = NULL;
+	if (header != NULL && header->kind == DUMP_BALANCED_PARENTHESES && header->num_sections == 1 && header->param[0] <= UINT64_MAX - 63 && header->section[0].length / sizeof(uint64_t) >= (header->param[0] + 63) / 64)
+		balanced_parentheses = balanced_parentheses_build((const uint64_t *)((const char *)map + header->section[0].offset), header->param[0]);
+	if (balanced_parentheses == NULL) {
+		munmap(map, length);
+		return NULL;
+	}
+	balanced_parentheses->map = map;
+	balanced_parentheses->map_length = length;
+	return balanced_parentheses;
+}
+
+/* Returns the end of the first prefix ending in a byte starting at x whose excess, starting from r, reaches d. */
+static inline uint64_t find_forward(const uint64_t byte, const uint64_t x, int64_t r, const int64_t d) {
+	for (int i = 0;; i++)
+		if ((r += 2 * (int)(byte >> i & 1) - 1) == d) return x + i + 1;
+}
+
+/* Returns the start of the last suffix ending in a byte ending at x whose excess, starting from r, reaches d. */
+static inline uint64_t find_backward(const uint64_t byte, const uint64_t x, int64_t r, const int64_t d) {
+	for (int i = 7;; i--)
+		if ((r += 1 - 2 * (int)(byte >> i & 1)) == d) return x - 8 + i;
+}
+
+/* Scans a block known to contain a match from its start. */
+static uint64_t scan_block_forward(const balanced_parentheses * const balanced_parentheses, const uint64_t block, int64_t r, const int64_t d) {
+	const uint64_t * const bits = balanced_parentheses->bits;
+	const uint64_t end = (block + 1) * BLOCK_WORDS < balanced_parentheses->num_words ? (block + 1) * BLOCK_BITS : balanced_parentheses->num_words * 64;
+	for (uint64_t x = block * BLOCK_BITS; x < end; x += 8) {
+		const uint64_t byte = byte_at(bits, x);
+		if (r + min_forward[byte] <= d) return find_forward(byte, x, r, d);
+		r += byte_excess(byte);
+	}
+	return UINT64_MAX;
+}
+
+/* Scans a block known to contain a match from its end. */
+static uint64_t scan_block_backward(const balanced_parentheses * const balanced_parentheses, const uint64_t block, int64_t r, const int64_t d) {
+	const uint64_t * const bits = balanced_parentheses->bits;
+	const uint64_t start = (block + 1) * BLOCK_WORDS < balanced_parentheses->num_words ? (block + 1) * BLOCK_BITS : balanced_parentheses->num_words * 64;
+	for (uint64_t x = start; x > block * BLOCK_BITS; x -= 8) {
+		const uint64_t byte = byte_at(bits, x - 8);
+		if (r + min_backward[byte] <= d) return find_backward(byte, x, r, d);
+		r -= byte_excess(byte);
+	}
+	return UINT64_MAX;
+}
+
+/* Returns the smallest x > from such that the excess of the prefix of length x is that of the
+   prefix of length from plus d < 0. */
+static uint64_t forward_search(const balanced_parentheses * const balanced_parentheses, uint64_t x, const int64_t d) {
+	const uint64_t * const bits = balanced_parentheses->bits;
+	const uint64_t end = balanced_parentheses->num_words * 64;
+	const int64_t * const tree_excess = balanced_parentheses->tree_excess;
+	const int64_t * const tree_min = balanced_parentheses->tree_min;
+	const int16_t * const block_excess = balanced_parentheses->block_excess;
+	const int16_t * const block_min = balanced_parentheses->block_min;
+	int64_t r = 0;
+
+	// Bits up to a byte boundary, and bytes up to a block boundary
+	for (; x % 8 != 0 && x < end; x++)
+		if ((r += 2 * bit(bits, x) - 1) == d) return x + 1;
+	for (; x % BLOCK_BITS != 0 && x < end; x += 8) {
+		const uint64_t byte = byte_at(bits, x);
+		if (r + min_forward[byte] <= d) return find_forward(byte, x, r, d);
+		r += byte_excess(byte);
+	}
+	if (x >= end) return UINT64_MAX;
+
+	// Blocks up to a superblock boundary
+	uint64_t block = x / BLOCK_BITS;
+	for (; block % SUPERBLOCK_BLOCKS != 0; block++) {
+		if (r + block_min[block] <= d) return scan_block_forward(balanced_parentheses, block, r, d);
+		r += block_excess[block];
+	}
+	if (block / SUPERBLOCK_BLOCKS >= balanced_parentheses->num_superblocks) return UINT64_MAX;
+
+	// Superblocks: we climb the tree until a right sibling contains a match, and then descend
+	const uint64_t tree_size = balanced_parentheses->tree_size;
+	uint64_t node = tree_size + block / SUPERBLOCK_BLOCKS;
+	if (r + tree_min[node] > d) {
+		r += tree_excess[node];
+		for (;; node /= 2) {
+			if (node == 1) return UINT64_MAX;
+			if (node % 2 == 0) {
+				if (r + tree_min[node + 1] <= d) {
+					node++;
+					break;
+				}
+				r += tree_excess[node + 1];
+			}
+		}
+	}
+	while (node < tree_size) {
+		node *= 2;
+		if (r + tree_min[node] > d) r += tree_excess[node++];
+	}
+
+	for (block = (node - tree_size) * SUPERBLOCK_BLOCKS; r + block_min[block] > d; block++) r += block_excess[block];
+	return scan_block_forward(balanced_parentheses, block, r, d);
+}
+
+/* Returns the largest x < from such that the excess of the prefix of length x is that of the
+   prefix of length from plus d < 0. */
+static uint64_t backward_search(const balanced_parentheses * const balanced_parentheses, uint64_t x, const int64_t d) {
+	const uint64_t * const bits = balanced_parentheses->bits;
+	const int64_t * const tree_excess = balanced_parentheses->tree_excess;
+	const int64_t * const tree_min = balanced_parentheses->tree_min;
+	const int16_t * const block_excess = balanced_parentheses->block_excess;
+	const int16_t * const block_min = balanced_parentheses->block_min;
+	int64_t r = 0;
+
+	// Bits down to a byte boundary, and bytes down to a block boundary
+	for (; x % 8 != 0; x--)
+		if ((r += 1 - 2 * bit(bits, x - 1)) == d) return x - 1;
+	for (; x % BLOCK_BITS != 0; x -= 8) {
+		const uint64_t byte = byte_at(bits, x - 8);
+		if (r + min_backward[byte] <= d) return find_backward(byte, x, r, d);
+		r -= byte_excess(byte);
+	}
+
+	// Blocks down to a superblock boundary (the minimum relative to the end of a block is its minimum minus its excess)
+	uint64_t block = x / BLOCK_BITS;
+	for (; block % SUPERBLOCK_BLOCKS != 0; block--) {
+		if (r + block_min[block - 1] - block_excess[block - 1] <= d) return scan_block_backward(balanced_parentheses, block - 1, r, d);
+		r -= block_excess[block - 1];
+	}
+	if (block == 0) return UINT64_MAX;
+
+	// Superblocks: we climb the tree until a left sibling contains a match, and then descend
+	const uint64_t tree_size = balanced_parentheses->tree_size;
+	uint64_t node = tree_size + block / SUPERBLOCK_BLOCKS - 1;
+	if (r + tree_min[node] - tree_excess[node] > d) {
+		r -= tree_excess[node];
+		for (;; node /= 2) {
+			if (node == 1) return UINT64_MAX;
+			if (node % 2 == 1) {
+				if (r + tree_min[node - 1] - tree_excess[node - 1] <= d) {
+					node--;
+					break;
+				}
+				r -= tree_excess[node - 1];
+			}
+		}
+	}
+	while (node < tree_size) {
+		node = 2 * node + 1;
+		if (r + tree_min[node] - tree_excess[node] > d) r -= tree_excess[node--];
+	}
+
+	for (block = (node - tree_size + 1) * SUPERBLOCK_BLOCKS; r + block_min[block - 1] - block_excess[block - 1] > d; block--) r -= block_excess[block - 1];
+	return scan_block_backward(balanced_parentheses, block - 1, r, d);
+}
+
+uint64_t balanced_parentheses_find_close(const balanced_parentheses *balanced_parentheses, const uint64_t pos) {
+	// The excess after the closed parenthesis is that before the open one
+	return forward_search(balanced_parentheses, pos + 1, -1) - 1;
+}
+
+uint64_t balanced_parentheses_find_open(const balanced_parentheses *balanced_parentheses, const uint64_t pos) {
+	// The excess before the open parenthesis is that after the closed one
+	return backward_search(balanced_parentheses, pos, -1);
+}
+
+uint64_t balanced_parentheses_enclose(const balanced_parentheses *balanced_parentheses, const uint64_t pos) {
+	return backward_search(balanced_parentheses, pos, -1);
+}
+
+uint64_t balanced_parentheses_parent(const balanced_parentheses *balanced_parentheses, const uint64_t node) {
+	return balanced_parentheses_enclose(balanced_parentheses, node);
+}
+
+uint64_t balanced_parentheses_first_child(const balanced_parentheses *balanced_parentheses, const uint64_t node) {
+	return node + 1 < balanced_parentheses->length && bit(balanced_parentheses->bits, node + 1) ? node + 1 : UINT64_MAX;
+}
+
+uint64_t balanced_parentheses_next_sibling(const balanced_parentheses *balanced_parentheses, const uint64_t node) {
+	const uint64_t next = balanced_parentheses_find_close(balanced_parentheses, node) + 1;
+	return next < balanced_parentheses->length && bit(balanced_parentheses->bits, next) ? next : UINT64_MAX;
+}
+
+uint64_t balanced_parentheses_subtree_size(const balanced_parentheses *balanced_parentheses, const uint64_t node) {
+	return (balanced_parentheses_find_close(balanced_parentheses, node) - node + 1) / 2;
+}
@@ -0,0 +1,73 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef BALANCED_PARENTHESES_H_INCLUDED
+#define BALANCED_PARENTHESES_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+
+/* Balanced parentheses (open = one, closed = zero) with a range min-max directory (see
+   JacobsonBalancedParentheses.dump() in Java). For each block of 512 bits, the directory stores
+   the excess (open minus closed parentheses) of the block and its minimum prefix excess; a
+   complete binary tree stores the same data for superblocks of eight blocks and their unions.
+   Searches scan a block a byte at a time using lookup tables, skip blocks and climb the tree.
+
+   A tree is represented by the open parenthesis of each node followed by the representation of
+   its children and by a closed parenthesis; nodes are identified by the position of their open
+   parenthesis. Functions return UINT64_MAX when there is no such parenthesis or node. */
+typedef struct {
+	uint64_t length;
+	uint64_t num_words;
+	const uint64_t *bits;
+	uint64_t num_superblocks;
+	int16_t *block_excess; // Eight entries per superblock
+	int16_t *block_min; // Minimum excess in each block relative to its start (which is included)
+	uint64_t tree_size; // The number of leaves of the tree, a power of two
+	int64_t *tree_excess; // The tree, in heap order starting from index one
+	int64_t *tree_min;
+	void *map; // The mapping, if loaded by load_balanced_parentheses()
+	uint64_t map_length;
+} balanced_parentheses;
+
+/* Maps a dump in memory (no copy) and builds the directory; returns NULL if the dump is not a valid
+   balanced-parentheses dump or the parentheses are not balanced. The result is a single allocation
+   that can be released with free() after unmapping map. */
+balanced_parentheses *load_balanced_parentheses(int h);
+/* Builds the directory for a bit vector of given length, whose bits past the end must be zero
+   (bits is not copied, and must outlive the result); returns NULL if the parentheses are not
+   balanced. The result is a single allocation that can be released with free(). */
+balanced_parentheses *balanced_parentheses_build(const uint64_t *bits, uint64_t length);
+/* Returns the position of the closed parenthesis matching the open parenthesis in pos. */
+uint64_t balanced_parentheses_find_close(const balanced_parentheses *balanced_parentheses, uint64_t pos);
+/* Returns the position of the open parenthesis matching the closed parenthesis in pos. */
+uint64_t balanced_parentheses_find_open(const balanced_parentheses *balanced_parentheses, uint64_t pos);
+/* Returns the position of the open parenthesis of the pair that most tightly encloses the
+   open parenthesis in pos. */
+uint64_t balanced_parentheses_enclose(const balanced_parentheses *balanced_parentheses, uint64_t pos);
+/* Returns the parent of a node (that is, enclose()). */
+uint64_t balanced_parentheses_parent(const balanced_parentheses *balanced_parentheses, uint64_t node);
+/* Returns the first child of a node. */
+uint64_t balanced_parentheses_first_child(const balanced_parentheses *balanced_parentheses, uint64_t node);
+/* Returns the next sibling of a node. */
+uint64_t balanced_parentheses_next_sibling(const balanced_parentheses *balanced_parentheses, uint64_t node);
+/* Returns the number of nodes of the subtree rooted at a node, including the node itself. */
+uint64_t balanced_parentheses_subtree_size(const balanced_parentheses *balanced_parentheses, uint64_t node);
+
+#endif /* BALANCED_PARENTHESES_H_INCLUDED */
@@ -0,0 +1,506 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * A single benchmark driver for all C-loadable structures.
+ *
+ * bench [-v] [-k KIND] [-m NAME] [-s SOURCE]... [-t THREADS] [-b BATCHES] [-n KEYS] [-r SAMPLES] [-f json|csv] DUMP
+ *
+ * KIND is one of mph, signed_mph, chd, sf3, sf4, sf3_8, sf4_8, two_steps_sf3, csf3, csf4,
+ * filter3, filter4, filter3_8, filter4_8, filter3_16, filter4_16;
+ * it is detected automatically for dumps in the container format. SOURCE is one of
+ * bytes:FILE (newline-separated strings, for RAW_BYTE_ARRAY structures),
+ * uint64:FILE (binary 64-bit integers, for RAW_LONG structures) or signature
+ * (random signatures, to test speed independently of hashing); it can be
+ * repeated. THREADS and BATCHES are comma-separated lists; every combination
+ * of source, thread count and batch size is measured. Each thread performs
+ * lookups on all keys, starting at a different position (at most 64 threads);
+ * times per key are elapsed times divided by the total number of lookups
+ * of all threads.
+ *
+ * A batch size b > 1 computes the signatures of b keys and then passes them
+ * to the batched lookup of the kind (e.g., mph_get_signature_batch()), which
+ * prefetches the memory of different probes so that accesses overlap; kinds
+ * without a batched lookup probe the b signatures one at a time.
+ *
+ * With -v, the structure is verified in the background while the benchmark
+ * runs (see dump.h), and the outcome is reported.
+ *
+ * With -m, DUMP is a catalog (see catalog.h) and the member with the given
+ * name is benchmarked through a view of the mapped catalog.
+ *
+ * Results are printed on standard output, one record per combination.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "mph.h"
+#include "signed_mph.h"
+#include "chd.h"
+#include "sf3.h"
+#include "sf4.h"
+#include "sf3_8.h"
+#include "sf4_8.h"
+#include "two_steps_sf3.h"
+#include "csf3.h"
+#include "csf4.h"
+#include "filter3.h"
+#include "filter4.h"
+#include "spooky.h"
+#include "dump.h"
+#include "catalog.h"
+
+#define MAX_SOURCES 16
+#define MAX_VALUES 64
+#define MAX_BATCH 4096
+
+enum { SOURCE_BYTES, SOURCE_UINT64, SOURCE_SIGNATURE };
+
+static const char * const source_name[] = { "bytes", "uint64", "signature" };
+
+typedef struct {
+	int type;
+	const char *file;
+	uint64_t n;
+	char **buf;
+	int *len;
+	uint64_t *data;
+} source;
+
+typedef uint64_t (*run_fn)(const void *map, const source *source, uint64_t start, uint64_t n, int batch);
+
+typedef struct {
+	const char *name;
+	void *(*load)(int h);
+	void *(*load_verify)(int h, dump_verifier *verifier);
+	void *(*map)(const void *dump, uint64_t length);
+	run_fn run;
+	uint64_t (*size)(const void *map);
+} kind;
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t next(uint64_t * const s) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+/* For kinds without a batched lookup, a batch is hashed first and then probed one key at a time. */
+#define DEFINE_SCALAR_BATCH(NAME, TYPE, RESULT, GET_SIGNATURE) \
+static void NAME##_scalar_batch(const TYPE *t, const uint64_t (*signature)[4], RESULT *result, const uint64_t n) { \
+	for (uint64_t i = 0; i < n; i++) result[i] = GET_SIGNATURE(t, signature[i]); \
+}
+
+/* Generates a run function for a kind. The lookup functions are called
+   directly, so that the driver adds no indirection to the measured loops;
+   batches of signatures are passed to GET_SIGNATURE_BATCH. */
+#define DEFINE_RUN(NAME, TYPE, RESULT, GET_BYTE_ARRAY, GET_UINT64_T, GET_SIGNATURE, GET_SIGNATURE_BATCH) \
+static uint64_t NAME##_run(const void *map, const source *source, uint64_t start, const uint64_t n, const int batch) { \
+	const TYPE * const t = map; \
+	uint64_t u = 0, s[2] = { 0x5603141978c51071 ^ start, 0x3bbddc01ebdf4b72 }; \
+	uint64_t signature[MAX_BATCH][4]; \
+	RESULT result[MAX_BATCH]; \
+	uint64_t i = start; \
+	switch(source->type) { \
+	case SOURCE_BYTES: \
+		if (batch == 1) { \
+			for (uint64_t k = 0; k < n; k++) { \
+				u += GET_BYTE_ARRAY(t, source->buf[i], source->len[i]); \
+				if (++i == n) i = 0; \
+			} \
+			break; \
+		} \
+		for (uint64_t k = 0; k < n; k += batch) { \
+			const int b = n - k < batch ? n - k : batch; \
+			for (int j = 0; j < b; j++) { \
+				spooky_short(source->buf[i], source->len[i], t->global_seed, signature[j]); \
+				if (++i == n) i = 0; \
+			} \
+			GET_SIGNATURE_BATCH(t, (const uint64_t (*)[4])signature, result, b); \
+			for (int j = 0; j < b; j++) u += result[j]; \
+		} \
+		break; \
+	case SOURCE_UINT64: \
+		if (batch == 1) { \
+			for (uint64_t k = 0; k < n; k++) { \
+				u += GET_UINT64_T(t, source->data[i]); \
+				if (++i == n) i = 0; \
+			} \
+			break; \
+		} \
+		for (uint64_t k = 0; k < n; k += batch) { \
+			const int b = n - k < batch ? n - k : batch; \
+			for (int j = 0; j < b; j++) { \
+				spooky_short(&source->data[i], 8, t->global_seed, signature[j]); \
+				if (++i == n) i = 0; \
+			} \
+			GET_SIGNATURE_BATCH(t, (const uint64_t (*)[4])signature, result, b); \
+			for (int j = 0; j < b; j++) u += result[j]; \
+		} \
+		break; \
+	case SOURCE_SIGNATURE: { \
+		uint64_t r[4] = { next(s), next(s), next(s), next(s) }; \
+		for (uint64_t k = 0; k < n; k += batch) { \
+			const int b = n - k < batch ? n - k : batch; \
+			for (int j = 0; j < b; j++) { \
+				const uint64_t x = next(s); \
+				signature[j][0] = r[0] ^= x; \
+				signature[j][1] = r[1] ^= x; \
+				signature[j][2] = r[2] ^= x; \
+				signature[j][3] = r[3] ^= x; \
+			} \
+			if (batch == 1) u += GET_SIGNATURE(t, signature[0]); \
+			else { \
+				GET_SIGNATURE_BATCH(t, (const uint64_t (*)[4])signature, result, b); \
+				for (int j = 0; j < b; j++) u += result[j]; \
+			} \
+		} \
+		break; \
+	} \
+	} \
+	return u; \
+} \
+static void *NAME##_load(int h) { return load_##TYPE##_validated(h); } \
+static void *NAME##_load_verify(int h, dump_verifier *verifier) { return load_##TYPE##_verify(h, verifier); } \
+static void *NAME##_map(const void *dump, uint64_t length) { \
+	TYPE *t = malloc(sizeof *t); \
+	if (t != NULL && map_##TYPE(dump, length, t) == 0 && TYPE##_validate(t) == 0) return t; \
+	free(t); \
+	return NULL; \
+} \
+static uint64_t NAME##_size(const void *map) { return ((const TYPE *)map)->size; }
+
+DEFINE_RUN(mph, mph, int64_t, mph_get_byte_array, mph_get_uint64_t, mph_get_signature, mph_get_signature_batch)
+DEFINE_RUN(signed_mph, signed_mph, int64_t, signed_mph_get_byte_array, signed_mph_get_uint64_t, signed_mph_get_signature, signed_mph_get_signature_batch)
+DEFINE_RUN(chd, chd, int64_t, chd_get_byte_array, chd_get_uint64_t, chd_get_signature, chd_get_signature_batch)
+DEFINE_SCALAR_BATCH(sf3, sf, int64_t, sf3_get_signature)
+DEFINE_RUN(sf3, sf, int64_t, sf3_get_byte_array, sf3_get_uint64_t, sf3_get_signature, sf3_scalar_batch)
+DEFINE_SCALAR_BATCH(sf4, sf, int64_t, sf4_get_signature)
+DEFINE_RUN(sf4, sf, int64_t, sf4_get_byte_array, sf4_get_uint64_t, sf4_get_signature, sf4_scalar_batch)
+DEFINE_SCALAR_BATCH(sf3_8, sf, int64_t, sf3_8_get_signature)
+DEFINE_RUN(sf3_8, sf, int64_t, sf3_8_get_byte_array, sf3_8_get_uint64_t, sf3_8_get_signature, sf3_8_scalar_batch)
+DEFINE_SCALAR_BATCH(sf4_8, sf, int64_t, sf4_8_get_signature)
+DEFINE_RUN(sf4_8, sf, int64_t, sf4_8_get_byte_array, sf4_8_get_uint64_t, sf4_8_get_signature, sf4_8_scalar_batch)
+DEFINE_RUN(two_steps_sf3, two_steps_sf3, int64_t, two_steps_sf3_get_byte_array, two_steps_sf3_get_uint64_t, two_steps_sf3_get_signature, two_steps_sf3_get_signature_batch)
+DEFINE_SCALAR_BATCH(csf3, csf, int64_t, csf3_get_signature)
+DEFINE_RUN(csf3, csf, int64_t, csf3_get_byte_array, csf3_get_uint64_t, csf3_get_signature, csf3_scalar_batch)
+DEFINE_SCALAR_BATCH(csf4, csf, int64_t, csf4_get_signature)
+DEFINE_RUN(csf4, csf, int64_t, csf4_get_byte_array, csf4_get_uint64_t, csf4_get_signature, csf4_scalar_batch)
+DEFINE_RUN(filter3, filter, int, filter3_contains_byte_array, filter3_contains_uint64_t, filter3_contains_signature, filter3_contains_signature_batch)
+DEFINE_RUN(filter3_8, filter, int, filter3_8_contains_byte_array, filter3_8_contains_uint64_t, filter3_8_contains_signature, filter3_8_contains_signature_batch)
+DEFINE_RUN(filter3_16, filter, int, filter3_16_contains_byte_array, filter3_16_contains_uint64_t, filter3_16_contains_signature, filter3_16_contains_signature_batch)
+DEFINE_RUN(filter4, filter, int, filter4_contains_byte_array, filter4_contains_uint64_t, filter4_contains_signature, filter4_contains_signature_batch)
+DEFINE_RUN(filter4_8, filter, int, filter4_8_contains_byte_array, filter4_8_contains_uint64_t, filter4_8_contains_signature, filter4_8_contains_signature_batch)
+DEFINE_RUN(filter4_16, filter, int, filter4_16_contains_byte_array, filter4_16_contains_uint64_t, filter4_16_contains_signature, filter4_16_contains_signature_batch)
+
+#define KIND(NAME) { #NAME, NAME##_load, NAME##_load_verify, NAME##_map, NAME##_run, NAME##_size }
+
+static const kind kinds[] = {
+	KIND(mph), KIND(signed_mph), KIND(chd), KIND(sf3), KIND(sf4), KIND(sf3_8), KIND(sf4_8), KIND(two_steps_sf3), KIND(csf3), KIND(csf4),
+	KIND(filter3), KIND(filter4), KIND(filter3_8), KIND(filter4_8), KIND(filter3_16), KIND(filter4_16)
+};
+
+#define NUM_KINDS (sizeof kinds / sizeof *kinds)
+
+static const kind *get_kind(const char *name) {
+	if (name == NULL) return NULL;
+	for (int i = 0; i < NUM_KINDS; i++) if (strcmp(kinds[i].name, name) == 0) return &kinds[i];
+	return NULL;
+}
+
+static void load_source(source *source, const uint64_t nkeys) {
+	source->n = nkeys;
+	if (source->type == SOURCE_SIGNATURE) return;
+
+	int h = open(source->file, O_RDONLY);
+	if (h < 0) {
+		fprintf(stderr, "Cannot open %s\n", source->file);
+		exit(1);
+	}
+	off_t len = lseek(h, 0, SEEK_END);
+	lseek(h, 0, SEEK_SET);
+
+	if (source->type == SOURCE_UINT64) {
+		if (len / sizeof(uint64_t) < nkeys) source->n = len / sizeof(uint64_t);
+		source->data = calloc(source->n, sizeof *source->data);
+		read(h, source->data, source->n * sizeof *source->data);
+		close(h);
+		return;
+	}
+
+	char *data = malloc(len + 1);
+	read(h, data, len);
+	close(h);
+	data[len] = 0xA;
+
+	source->buf = calloc(nkeys, sizeof *source->buf);
+	source->len = calloc(nkeys, sizeof *source->len);
+	char *p = data, * const end = data + len;
+	uint64_t i;
+	for(i = 0; i < nkeys; i++) {
+		while(p < end && (*p == 0xA || *p == 0xD)) p++;
+		if (p == end) break;
+		source->buf[i] = p;
+		while(*p != 0xA && *p != 0xD) p++;
+		source->len[i] = p - source->buf[i];
+	}
+	source->n = i;
+}
+
+static void check_source(const source *source) {
+	// Per-key times and the wraparound of the key index need at least one key
+	if (source->n != 0) return;
+	fprintf(stderr, "No keys in %s\n", source->file);
+	exit(1);
+}
+
+/* Prints a string as a JSON string literal. */
+static void print_json_string(const char *s) {
+	putchar('"');
+	for (; *s; s++) {
+		if (*s == '"' || *s == '\\') printf("\\%c", *s);
+		else if ((unsigned char)*s < 0x20) printf("\\u%04x", *s);
+		else putchar(*s);
+	}
+	putchar('"');
+}
+
+typedef struct {
+	const kind *kind;
+	const void *map;
+	const source *source;
+	uint64_t start;
+	int batch;
+	uint64_t result;
+} job;
+
+static void *run_job(void *arg) {
+	job * const job = arg;
+	job->result = job->kind->run(job->map, job->source, job->start, job->source->n, job->batch);
+	return NULL;
+}
+
+static int parse_list(const char *s, int *v) {
+	int n = 0;
+	for(char *p = (char *)s; *p && n < MAX_VALUES; ) {
+		v[n++] = strtol(p, &p, 10);
+		if (*p == ',') p++;
+		else if (*p) return -1;
+	}
+	return n;
+}
+
+static void usage(const char *name) {
+	fprintf(stderr, "Usage: %s [-k KIND] [-m NAME] [-s bytes:FILE|uint64:FILE|signature]... [-t THREADS] [-b BATCHES] [-n KEYS] [-r SAMPLES] [-f json|csv] [-v] DUMP\n", name);
+	fprintf(stderr, "Kinds:");
+	for (int i = 0; i < NUM_KINDS; i++) fprintf(stderr, " %s", kinds[i].name);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+int main(int argc, char* argv[]) {
+	const kind *kind = NULL;
+	source sources[MAX_SOURCES];
+	int num_sources = 0, threads[MAX_VALUES] = { 1 }, num_threads = 1, batches[MAX_VALUES] = { 1 }, num_batches = 1, samples = 11, json = 1, verify = 0;
+	uint64_t nkeys = 10000000;
+	const char *member = NULL;
+
+	int c;
+	while((c = getopt(argc, argv, "k:m:s:t:b:n:r:f:v")) != -1) {
+		switch(c) {
+		case 'k':
+			if ((kind = get_kind(optarg)) == NULL) usage(argv[0]);
+			break;
+		case 'm':
+			member = optarg;
+			break;
+		case 's':
+			if (num_sources == MAX_SOURCES) usage(argv[0]);
+			memset(&sources[num_sources], 0, sizeof *sources);
+			if (strcmp(optarg, "signature") == 0) sources[num_sources].type = SOURCE_SIGNATURE;
+			else if (strncmp(optarg, "bytes:", 6) == 0) {
+				sources[num_sources].type = SOURCE_BYTES;
+				sources[num_sources].file = optarg + 6;
+			}
+			else if (strncmp(optarg, "uint64:", 7) == 0) {
+				sources[num_sources].type = SOURCE_UINT64;
+				sources[num_sources].file = optarg + 7;
+			}
+			else usage(argv[0]);
+			num_sources++;
+			break;
+		case 't':
+			if ((num_threads = parse_list(optarg, threads)) <= 0) usage(argv[0]);
+			for (int i = 0; i < num_threads; i++) if (threads[i] < 1 || threads[i] > MAX_VALUES) usage(argv[0]);
+			break;
+		case 'b':
+			if ((num_batches = parse_list(optarg, batches)) <= 0) usage(argv[0]);
+			for (int i = 0; i < num_batches; i++) if (batches[i] < 1 || batches[i] > MAX_BATCH) usage(argv[0]);
+			break;
+		case 'n':
+			nkeys = strtoull(optarg, NULL, 10);
+			break;
+		case 'r':
+			samples = atoi(optarg);
+			break;
+		case 'v':
+			verify = 1;
+			break;
+		case 'f':
+			if (strcmp(optarg, "json") == 0) json = 1;
+			else if (strcmp(optarg, "csv") == 0) json = 0;
+			else usage(argv[0]);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if (optind != argc - 1 || samples < 1 || nkeys == 0 || (member != NULL && verify)) usage(argv[0]);
+	if (num_sources == 0) sources[num_sources++] = (source){ .type = SOURCE_SIGNATURE };
+
+	const char * const dump = argv[optind];
+	int h = open(dump, O_RDONLY);
+	if (h < 0) {
+		fprintf(stderr, "Cannot open %s\n", dump);
+		return 1;
+	}
+
+	dump_verifier verifier;
+	const void *map;
+
+	if (member != NULL) {
+		const catalog * const catalog = load_catalog(h);
+		close(h);
+		const int64_t i = catalog == NULL ? -1 : catalog_find(catalog, member, strlen(member));
+		if (i < 0) {
+			fprintf(stderr, "Cannot find %s in catalog %s\n", member, dump);
+			return 1;
+		}
+		uint64_t length;
+		const void * const container = catalog_member(catalog, i, &length);
+		const dump_header * const header = dump_map_header(container, length);
+		if (kind == NULL && (header == NULL || (kind = get_kind(dump_kind_name(header))) == NULL)) {
+			fprintf(stderr, "Cannot detect the kind of %s: please specify it\n", member);
+			usage(argv[0]);
+		}
+		map = kind->map(container, length);
+	}
+	else {
+		if (kind == NULL) {
+			dump_header header;
+			if (dump_read_header(h, &header) != 1 || (kind = get_kind(dump_kind_name(&header))) == NULL) {
+				fprintf(stderr, "Cannot detect the kind of %s: please specify it\n", dump);
+				usage(argv[0]);
+			}
+			lseek(h, 0, SEEK_SET);
+		}
+		map = verify ? kind->load_verify(h, &verifier) : kind->load(h);
+		close(h);
+	}
+
+	if (map == NULL) {
+		fprintf(stderr, "Cannot load %s as %s\n", member != NULL ? member : dump, kind->name);
+		return 1;
+	}
+
+	for (int i = 0; i < num_sources; i++) {
+		load_source(&sources[i], nkeys);
+		check_source(&sources[i]);
+	}
+
+	if (json) {
+		printf("{\n\"dump\": ");
+		print_json_string(dump);
+		printf(",\n\"kind\": \"%s\",\n\"size\": %" PRIu64 ",\n\"samples\": %d,\n\"results\": [", kind->name, kind->size(map), samples);
+	}
+	else printf("kind,source,threads,batch,keys,median_ns_per_key,min_ns_per_key,mlookups_per_s,checksum\n");
+
+	uint64_t *sample = calloc(samples, sizeof *sample);
+	job jobs[MAX_VALUES];
+	pthread_t thread[MAX_VALUES];
+	int first = 1;
+
+	for (int s = 0; s < num_sources; s++)
+		for (int t = 0; t < num_threads; t++)
+			for (int b = 0; b < num_batches; b++) {
+				const source * const source = &sources[s];
+				const int nt = threads[t];
+				uint64_t u = 0;
+
+				for (int k = 0; k < samples; k++) {
+					for (int j = 0; j < nt; j++) jobs[j] = (job){ kind, map, source, source->n / nt * j, batches[b], 0 };
+					int64_t elapsed = - get_system_time();
+					for (int j = 0; j < nt; j++) pthread_create(&thread[j], NULL, run_job, &jobs[j]);
+					for (int j = 0; j < nt; j++) pthread_join(thread[j], NULL);
+					elapsed += get_system_time();
+					sample[k] = elapsed;
+					for (int j = 0; j < nt; j++) u += jobs[j].result;
+				}
+
+				qsort(sample, samples, sizeof *sample, cmp_uint64_t);
+				// Times are per lookup, on all threads
+				const double median = sample[samples / 2] * 1000. / ((double)nt * source->n);
+				const double min = sample[0] * 1000. / ((double)nt * source->n);
+				const double throughput = (double)nt * source->n / sample[samples / 2];
+
+				if (json) {
+					printf("%s\n{\"source\": \"%s\", \"file\": ", first ? "" : ",", source_name[source->type]);
+					print_json_string(source->file ? source->file : "");
+					printf(", \"threads\": %d, \"batch\": %d, \"keys\": %" PRIu64 ", \"median_ns_per_key\": %.3f, \"min_ns_per_key\": %.3f, \"mlookups_per_s\": %.3f, \"checksum\": %" PRIu64 "}",
+						nt, batches[b], source->n, median, min, throughput, u);
+				}
+				else printf("%s,%s,%d,%d,%" PRIu64 ",%.3f,%.3f,%.3f,%" PRIu64 "\n", kind->name, source_name[source->type], nt, batches[b], source->n, median, min, throughput, u);
+				first = 0;
+				fflush(stdout);
+			}
+
+	const char * const status = verify ? dump_verify_wait(&verifier) == DUMP_VALID ? "valid" : "corrupt" : NULL;
+	if (json) printf("\n]%s%s%s\n}\n", status ? ",\n\"verification\": \"" : "", status ? status : "", status ? "\"" : "");
+	else if (status) fprintf(stderr, "Verification: %s\n", status);
+	return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Broadword primitives shared by the rank/select structures.
+ */
+
+#ifndef BROADWORD_H_INCLUDED
+#define BROADWORD_H_INCLUDED
+
+#include <inttypes.h>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+#define ONES_STEP_9 (UINT64_C(1) << 0 | UINT64_C(1) << 9 | UINT64_C(1) << 18 | UINT64_C(1) << 27 | UINT64_C(1) << 36 | UINT64_C(1) << 45 | UINT64_C(1) << 54)
+#define MSBS_STEP_9 (UINT64_C(0x100) * ONES_STEP_9)
+#define ONES_STEP_16 (UINT64_C(1) << 0 | UINT64_C(1) << 16 | UINT64_C(1) << 32 | UINT64_C(1) << 48)
+#define MSBS_STEP_16 (UINT64_C(0x8000) * ONES_STEP_16)
+
+/* For each 9-bit field, one in its lowest bit if the field of x is smaller than or equal to that of y. */
+static inline uint64_t uleq_step_9(const uint64_t x, const uint64_t y) {
+	return (((((y | MSBS_STEP_9) - (x & ~MSBS_STEP_9)) | (x ^ y)) ^ (x & ~y)) & MSBS_STEP_9) >> 8;
+}
+
+/* For each 16-bit field, one in its lowest bit if the field of x is smaller than or equal to that of y. */
+static inline uint64_t uleq_step_16(const uint64_t x, const uint64_t y) {
+	return (((((y | MSBS_STEP_16) - (x & ~MSBS_STEP_16)) | (x ^ y)) ^ (x & ~y)) & MSBS_STEP_16) >> 15;
+}
+
+/* Returns the position of the one of rank k (starting from zero) in x, which must have more than k ones. */
+static inline int select64(uint64_t x, int k) {
+#ifdef __BMI2__
+	return __builtin_ctzll(_pdep_u64(UINT64_C(1) << k, x));
+#else
+	int b = 0;
+	for (int c; k >= (c = __builtin_popcountll(x >> b & 0xFF)); b += 8) k -= c;
+	x >>= b;
+	while (k-- != 0) x &= x - 1;
+	return b + __builtin_ctzll(x);
+#endif
+}
+
+#endif /* BROADWORD_H_INCLUDED */
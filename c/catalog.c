@@ -0,0 +1,187 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "catalog.h"
+#include "spooky.h"
+
+static uint64_t align(const uint64_t x) {
+	return x + DUMP_ALIGNMENT - 1 & -(uint64_t)DUMP_ALIGNMENT;
+}
+
+static int check(const char *map, const uint64_t length) {
+	const catalog_header * const header = (const catalog_header *)map;
+	if (length < sizeof *header || header->magic != CATALOG_MAGIC || header->version > CATALOG_VERSION) return -1;
+	const uint64_t n = header->num_entries, table_size = header->table_size;
+	if (table_size == 0 || (table_size & table_size - 1) != 0 || table_size <= n) return -1;
+	if (header->entries_offset % sizeof(uint64_t) != 0 || header->entries_offset > length || n > (length - header->entries_offset) / sizeof(catalog_entry)) return -1;
+	if (header->table_offset % sizeof(uint32_t) != 0 || header->table_offset > length || table_size > (length - header->table_offset) / sizeof(uint32_t)) return -1;
+	if (header->names_offset > length || header->names_length > length - header->names_offset) return -1;
+
+	const catalog_entry * const entry = (const catalog_entry *)(map + header->entries_offset);
+	for (uint64_t i = 0; i < n; i++) {
+		if (entry[i].name_offset > header->names_length || entry[i].name_length > header->names_length - entry[i].name_offset) return -1;
+		if (entry[i].offset % DUMP_ALIGNMENT != 0 || entry[i].offset > length || entry[i].length > length - entry[i].offset) return -1;
+	}
+	const uint32_t * const table = (const uint32_t *)(map + header->table_offset);
+	for (uint64_t i = 0; i < table_size; i++) if (table[i] > n) return -1;
+	return 0;
+}
+
+catalog *load_catalog(int h) {
+	uint64_t length;
+	char * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+
+	catalog *catalog;
+	if (check(map, length) != 0 || (catalog = malloc(sizeof *catalog)) == NULL) {
+		munmap(map, length);
+		return NULL;
+	}
+
+	const catalog_header * const header = (const catalog_header *)map;
+	catalog->map = map;
+	catalog->length = length;
+	catalog->num_entries = header->num_entries;
+	catalog->mask = header->table_size - 1;
+	catalog->seed = header->seed;
+	catalog->entry = (const catalog_entry *)(map + header->entries_offset);
+	catalog->table = (const uint32_t *)(map + header->table_offset);
+	catalog->names = map + header->names_offset;
+	return catalog;
+}
+
+void catalog_close(catalog *catalog) {
+	munmap((void *)catalog->map, catalog->length);
+	free(catalog);
+}
+
+int64_t catalog_find(const catalog *catalog, const char *name, const uint64_t len) {
+	uint64_t signature[4];
+	spooky_short(name, len, catalog->seed, signature);
+	// The table might have been built without empty slots
+	for (uint64_t p = signature[0] & catalog->mask, k = 0; k <= catalog->mask; p = p + 1 & catalog->mask, k++) {
+		const uint32_t t = catalog->table[p];
+		if (t == 0) return -1;
+		const catalog_entry * const entry = &catalog->entry[t - 1];
+		if (entry->hash == signature[0] && entry->name_length == len && memcmp(catalog->names + entry->name_offset, name, len) == 0) return t - 1;
+	}
+	return -1;
+}
+
+const char *catalog_name(const catalog *catalog, const uint64_t i, uint64_t *len) {
+	*len = catalog->entry[i].name_length;
+	return catalog->names + catalog->entry[i].name_offset;
+}
+
+const void *catalog_member(const catalog *catalog, const uint64_t i, uint64_t *length) {
+	*length = catalog->entry[i].length;
+	return catalog->map + catalog->entry[i].offset;
+}
+
+static int copy(int out, uint64_t offset, int in, uint64_t length) {
+	char buffer[1 << 16];
+	while (length != 0) {
+		const ssize_t r = read(in, buffer, length < sizeof buffer ? length : sizeof buffer);
+		if (r <= 0) return -1;
+		for (ssize_t w = 0; w < r; ) {
+			const ssize_t t = pwrite(out, buffer + w, r - w, offset + w);
+			if (t <= 0) return -1;
+			w += t;
+		}
+		offset += r;
+		length -= r;
+	}
+	return 0;
+}
+
+static int write_fully(int h, const void *data, uint64_t length, uint64_t offset) {
+	for (const char *p = data; length != 0; ) {
+		const ssize_t w = pwrite(h, p, length, offset);
+		if (w <= 0) return -1;
+		p += w;
+		offset += w;
+		length -= w;
+	}
+	return 0;
+}
+
+int catalog_write(const char *path, const int n, const char * const *name, const char * const *file) {
+	uint64_t table_size = 2;
+	while (table_size < 2 * (uint64_t)n) table_size *= 2;
+	const uint64_t entries_offset = sizeof(catalog_header);
+	const uint64_t table_offset = entries_offset + n * sizeof(catalog_entry);
+	// The length of the names is accumulated below; the seed is zero
+	catalog_header header = { CATALOG_MAGIC, CATALOG_VERSION, n, table_size, 0, entries_offset, table_offset, table_offset + table_size * sizeof(uint32_t), 0 };
+
+	catalog_entry * const entry = calloc(n, sizeof *entry);
+	uint32_t * const table = calloc(header.table_size, sizeof *table);
+	const uint64_t mask = header.table_size - 1;
+	int result = -1, out = -1;
+	if (entry == NULL || table == NULL) goto end;
+
+	for (int i = 0; i < n; i++) {
+		uint64_t signature[4];
+		entry[i].name_length = strlen(name[i]);
+		entry[i].name_offset = header.names_length;
+		header.names_length += entry[i].name_length;
+		spooky_short(name[i], entry[i].name_length, header.seed, signature);
+		entry[i].hash = signature[0];
+		uint64_t p = signature[0] & mask;
+		for (; table[p] != 0; p = p + 1 & mask)
+			if (strcmp(name[table[p] - 1], name[i]) == 0) goto end; // Duplicate name
+		table[p] = i + 1;
+	}
+
+	if ((out = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) goto end;
+
+	uint64_t offset = align(header.names_offset + header.names_length);
+	for (int i = 0; i < n; i++) {
+		const int in = open(file[i], O_RDONLY);
+		if (in < 0) goto end;
+		struct stat st;
+		dump_header dump;
+		// Members must be containers, as they will be mapped directly
+		if (fstat(in, &st) != 0 || dump_read_header(in, &dump) != 1 || lseek(in, 0, SEEK_SET) != 0 || copy(out, offset, in, st.st_size) != 0) {
+			close(in);
+			goto end;
+		}
+		close(in);
+		entry[i].offset = offset;
+		entry[i].length = st.st_size;
+		offset = align(offset + st.st_size);
+	}
+
+	if (write_fully(out, &header, sizeof header, 0) || write_fully(out, entry, n * sizeof *entry, header.entries_offset) || write_fully(out, table, header.table_size * sizeof *table, header.table_offset)) goto end;
+	for (int i = 0; i < n; i++)
+		if (write_fully(out, name[i], entry[i].name_length, header.names_offset + entry[i].name_offset)) goto end;
+	result = 0;
+
+end:
+	if (out >= 0 && close(out) != 0) result = -1;
+	free(entry);
+	free(table);
+	return result;
+}
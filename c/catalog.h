@@ -0,0 +1,91 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * A catalog packs many containers (see dump.h) into a single file, with an
+ * index mapping names to members, so that thousands of structures can be
+ * made available with a single mmap() and no further allocation.
+ *
+ * The file starts with a catalog_header, followed by an array of
+ * catalog_entry (one per member), an open-addressing hash table of
+ * table_size (a power of two) 32-bit slots containing one plus the index of
+ * an entry (zero for empty slots), probed linearly starting at the slot given
+ * by the lowest bits of the SpookyHash of the name with the given seed, and
+ * the concatenation of the names. Members follow at offsets that are
+ * multiples of DUMP_ALIGNMENT; they are complete containers, so views of the
+ * structures they contain can be built in constant time using map_mph(),
+ * map_sf() or map_csf(). Everything is in native byte order.
+ */
+
+#ifndef CATALOG_H_INCLUDED
+#define CATALOG_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+
+#define CATALOG_MAGIC UINT64_C(0x5441434A34585553) // "SUX4JCAT"
+#define CATALOG_VERSION 1
+
+typedef struct {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t num_entries;
+	uint64_t table_size;
+	uint64_t seed;
+	uint64_t entries_offset;
+	uint64_t table_offset;
+	uint64_t names_offset;
+	uint64_t names_length;
+} catalog_header;
+
+typedef struct {
+	uint64_t hash;
+	uint64_t name_offset; // Within the names
+	uint64_t name_length;
+	uint64_t offset; // Within the file
+	uint64_t length;
+} catalog_entry;
+
+typedef struct {
+	const char *map;
+	uint64_t length;
+	uint64_t num_entries;
+	uint64_t mask;
+	uint64_t seed;
+	const catalog_entry *entry;
+	const uint32_t *table;
+	const char *names;
+} catalog;
+
+/* Maps a catalog in memory and checks that its index is consistent; returns NULL on failure. */
+catalog *load_catalog(int h);
+/* Unmaps a catalog: views of its members become invalid. */
+void catalog_close(catalog *catalog);
+/* Returns the index of the member with the given name, or -1. */
+int64_t catalog_find(const catalog *catalog, const char *name, uint64_t len);
+/* Returns the name of a member, storing its length in len. */
+const char *catalog_name(const catalog *catalog, uint64_t i, uint64_t *len);
+/* Returns the address of the container of a member, storing its length in length. */
+const void *catalog_member(const catalog *catalog, uint64_t i, uint64_t *length);
+/* Writes a catalog containing the n given container files with the given names;
+   returns zero on success. */
+int catalog_write(const char *path, int n, const char * const *name, const char * const *file);
+
+#endif /* CATALOG_H_INCLUDED */
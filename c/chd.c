@@ -0,0 +1,226 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "chd.h"
+
+#define BATCH 16
+
+int map_chd(const void *dump, const uint64_t length, chd *chd) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_CHD || header->num_sections != 13) return -1;
+	if (header->param[1] > 64 || header->param[3] > 64) return -1;
+	const char * const base = dump;
+	memset(chd, 0, sizeof *chd);
+	chd->size = header->param[0];
+	chd->chunk_shift = header->param[1];
+	chd->global_seed = header->param[2];
+	chd->signature_width = header->param[3];
+	chd->signature_mask = chd->signature_width == 0 ? 0 : UINT64_MAX >> 64 - chd->signature_width;
+	chd->offset_num_buckets_seed_length = header->section[0].length / sizeof *chd->offset_num_buckets_seed;
+	chd->offset_num_buckets_seed = (const uint64_t *)(base + header->section[0].offset);
+	chd->coefficient_offset = header->param[4];
+	chd->coefficient_bits_length = header->section[1].length / sizeof *chd->coefficient_bits;
+	chd->coefficient_bits = (const uint64_t *)(base + header->section[1].offset);
+	if (map_elias_fano_at(dump, 5, 2, &chd->borders) != 0 || map_sparse_rank_at(dump, 10, 7, &chd->holes) != 0) return -1;
+	chd->signatures_length = header->section[12].length / sizeof *chd->signatures;
+	chd->signatures = (const uint64_t *)(base + header->section[12].offset);
+	return 0;
+}
+
+chd *load_chd(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	chd *chd = malloc(sizeof *chd);
+	if (chd == NULL || map_chd(map, length, chd) != 0) {
+		free(chd);
+		munmap(map, length);
+		return NULL;
+	}
+	chd->map = map;
+	chd->map_length = length;
+	return chd;
+}
+
+/* Returns the width bits starting at position pos. */
+static inline uint64_t get_bits(const uint64_t * const bits, const uint64_t pos, const int width) {
+	if (width == 0) return 0;
+	const uint64_t word = pos / 64;
+	const int bit = pos % 64;
+	uint64_t result = bits[word] >> bit;
+	if (bit + width > 64) result |= bits[word + 1] << 64 - bit;
+	return width == 64 ? result : result & (UINT64_C(1) << width) - 1;
+}
+
+int chd_validate(const chd *chd) {
+	if (chd->size == 0) return 0;
+	if (chd->chunk_shift <= 64 - 31) return -1;
+	const uint64_t num_chunks = chd->chunk_shift == 64 ? 1 : UINT64_C(1) << 64 - chd->chunk_shift;
+	if (chd->offset_num_buckets_seed_length < (num_chunks + 1) * 3 + 2) return -1;
+
+	const elias_fano * const borders = &chd->borders;
+	if (elias_fano_validate(borders) != 0 || borders->length == 0) return -1;
+	const uint64_t num_coefficients = borders->length - 1;
+	const uint64_t * const onbs = chd->offset_num_buckets_seed;
+	for (uint64_t k = 0; k < num_chunks; k++) {
+		// The lookup code divides by the number of bins, and by the same number minus one
+		const uint64_t offset = onbs[k * 3], p = onbs[k * 3 + 3] - offset;
+		if (onbs[k * 3 + 3] < offset || p < 2 || p > INT_MAX) return -1;
+		// A chunk without buckets probes the first bucket of the next one
+		const uint64_t num_buckets = onbs[k * 3 + 1], next = onbs[k * 3 + 4];
+		if (next < num_buckets || num_buckets >= num_coefficients || next > num_coefficients) return -1;
+	}
+	if (sparse_rank_validate(&chd->holes) != 0 || onbs[num_chunks * 3] > chd->holes.n) return -1;
+
+	// Coefficients must be shorter than 64 bits, and lie within the bits
+	elias_fano_iterator iterator;
+	elias_fano_iterator_init(borders, 0, &iterator);
+	uint64_t border[256], prev = 0;
+	for (uint64_t i = 0, r; i <= num_coefficients; i += r) {
+		r = elias_fano_iterator_next(&iterator, border, sizeof border / sizeof *border);
+		for (uint64_t j = 0; j < r; j++) {
+			if (border[j] - prev > 63) return -1;
+			prev = border[j];
+		}
+	}
+	if (prev > chd->coefficient_bits_length * 64) return -1;
+
+	if (chd->signature_width != 0 && (chd->size >= UINT64_MAX / 64 || chd->signatures_length * 64 < chd->size * chd->signature_width)) return -1;
+	return 0;
+}
+
+static int validate(const void *chd) {
+	return chd_validate(chd);
+}
+
+chd *load_chd_validated(int h) {
+	chd *chd = load_chd(h);
+	if (chd == NULL) return NULL;
+	if (chd_validate(chd) == 0) return chd;
+	munmap(chd->map, chd->map_length);
+	free(chd);
+	return NULL;
+}
+
+chd *load_chd_verify(int h, dump_verifier *verifier) {
+	chd *chd = load_chd(h);
+	if (chd == NULL) return NULL;
+	const dump_header * const header = chd->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)chd->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, chd) == 0) return chd;
+	munmap(chd->map, chd->map_length);
+	free(chd);
+	return NULL;
+}
+
+/* As CHDMinimalPerfectHashFunction.spread() in Java: maps a hash into [0, bound). */
+static inline uint64_t spread(const uint64_t hash, const uint64_t bound) {
+	if (bound == 0) return 0;
+	const int shift = __builtin_clzll(bound);
+	return ((hash & (UINT64_C(1) << shift) - 1) * bound) >> shift;
+}
+
+/* Returns the descriptor of the chunk of a signature. */
+static inline const uint64_t *chunk(const chd *chd, const uint64_t *signature) {
+	return chd->offset_num_buckets_seed + (chd->chunk_shift == 64 ? 0 : signature[0] >> chd->chunk_shift) * 3;
+}
+
+/* Returns the coefficient of the bucket of a signature, and stores its hashes in h. */
+static inline uint64_t bucket(const uint64_t *chunk, const uint64_t *signature, uint64_t *h) {
+	spooky_short_rehash_triple(signature, chunk[2], h);
+	return chunk[1] + spread(h[0], chunk[4] - chunk[1]);
+}
+
+/* Returns the value of a signature given the coefficient of its bucket. */
+static inline int64_t value(const chd *chd, const uint64_t *chunk, const uint64_t *signature, const uint64_t *h, const uint64_t from, const uint64_t to) {
+	const int width = to - from;
+	const uint64_t c = (UINT64_C(1) << width | get_bits(chd->coefficient_bits, from, width)) - chd->coefficient_offset;
+	const uint64_t p = chunk[3] - chunk[0];
+	uint64_t result = chunk[0] + (spread(h[1], p) + c % p * (spread(h[2], p - 1) + 1) + c / p) % p;
+	result -= sparse_rank_rank(&chd->holes, result);
+	if (result >= chd->size) return -1;
+	if (chd->signature_mask != 0 && ((get_bits(chd->signatures, result * chd->signature_width, chd->signature_width) ^ signature[0]) & chd->signature_mask) != 0) return -1;
+	return result;
+}
+
+int64_t chd_get_signature(const chd *chd, const uint64_t signature[4]) {
+	if (chd->size == 0) return -1;
+	const uint64_t * const c = chunk(chd, signature);
+	uint64_t h[4], from, to;
+	elias_fano_get_pair(&chd->borders, bucket(c, signature, h), &from, &to);
+	return value(chd, c, signature, h, from, to);
+}
+
+int64_t chd_get_byte_array(const chd *chd, const char *key, const uint64_t len) {
+	uint64_t signature[4];
+	spooky_short(key, len, chd->global_seed, signature);
+	return chd_get_signature(chd, signature);
+}
+
+int64_t chd_get_uint64_t(const chd *chd, const uint64_t key) {
+	uint64_t signature[4];
+	spooky_short(&key, 8, chd->global_seed, signature);
+	return chd_get_signature(chd, signature);
+}
+
+/* Answers a group of at most BATCH signatures: the descriptors of the chunks are prefetched
+   before the buckets are computed, the coefficients are retrieved with a batched access to the
+   borders, and the bits of the coefficients are prefetched before they are extracted. */
+static void get_batch(const chd *chd, const uint64_t (*signature)[4], int64_t *result, const int b) {
+	if (chd->size == 0) {
+		for (int j = 0; j < b; j++) result[j] = -1;
+		return;
+	}
+	const uint64_t *c[BATCH];
+	uint64_t h[BATCH][4], index[BATCH], from[BATCH], to[BATCH];
+	for (int j = 0; j < b; j++) __builtin_prefetch(c[j] = chunk(chd, signature[j]));
+	for (int j = 0; j < b; j++) index[j] = bucket(c[j], signature[j], h[j]);
+	elias_fano_get_pair_batch(&chd->borders, index, from, to, b);
+	for (int j = 0; j < b; j++) __builtin_prefetch(&chd->coefficient_bits[from[j] / 64]);
+	for (int j = 0; j < b; j++) result[j] = value(chd, c[j], signature[j], h[j], from[j], to[j]);
+}
+
+void chd_get_signature_batch(const chd *chd, const uint64_t (*signature)[4], int64_t *result, const uint64_t n) {
+	for (uint64_t i = 0; i < n; i += BATCH) get_batch(chd, signature + i, result + i, n - i < BATCH ? n - i : BATCH);
+}
+
+void chd_get_byte_array_batch(const chd *chd, char * const *key, const int *len, int64_t *result, const uint64_t n) {
+	uint64_t signature[BATCH][4];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) spooky_short(key[i + j], len[i + j], chd->global_seed, signature[j]);
+		get_batch(chd, (const uint64_t (*)[4])signature, result + i, b);
+	}
+}
+
+void chd_get_uint64_t_batch(const chd *chd, const uint64_t *key, int64_t *result, const uint64_t n) {
+	uint64_t signature[BATCH][4];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) spooky_short(&key[i + j], 8, chd->global_seed, signature[j]);
+		get_batch(chd, (const uint64_t (*)[4])signature, result + i, b);
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CHD_H_INCLUDED
+#define CHD_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "elias_fano.h"
+#include "sparse_rank.h"
+
+/* A view of a CHD minimal perfect hash function dump (see
+   CHDMinimalPerfectHashFunction.dump() in Java). Keys are divided in chunks by the first word of
+   their signature; in each chunk, a second hash selects a bucket, whose displacement coefficient
+   yields a position among the bins of the chunk, and the bins left empty (the holes) are
+   removed by ranking them. */
+typedef struct {
+	uint64_t size;
+	int chunk_shift;
+	uint64_t global_seed;
+	int signature_width;
+	uint64_t signature_mask;
+	uint64_t offset_num_buckets_seed_length;
+	/* For each chunk, the offset of its bins, the cumulative number of buckets and the seed,
+	   followed by the offset and the number of buckets of a sentinel chunk. */
+	const uint64_t *offset_num_buckets_seed;
+	uint64_t coefficient_offset; // Subtracted from a coefficient after restoring its most significant bit
+	uint64_t coefficient_bits_length;
+	const uint64_t *coefficient_bits; // The coefficients, without their most significant bit
+	elias_fano borders; // The position of the first bit of each coefficient, and the end of the bits
+	sparse_rank holes;
+	uint64_t signatures_length;
+	const uint64_t *signatures;
+	void *map; // The mapping, if loaded by load_chd()
+	uint64_t map_length;
+} chd;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a CHD dump. */
+chd *load_chd(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_chd(const void *dump, uint64_t length, chd *chd);
+/* Maps a function and validates it (see chd_validate()); returns NULL if the dump is not valid. */
+chd *load_chd_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h). */
+chd *load_chd_verify(int h, dump_verifier *verifier);
+/* Checks that every probe of the lookup code, for any key, falls within the arrays (chunk
+   offsets are increasing, every chunk probes an existing coefficient, coefficients are shorter
+   than 64 bits, the holes cover all bins and the signatures cover all keys); returns zero if valid. */
+int chd_validate(const chd *chd);
+int64_t chd_get_byte_array(const chd *chd, const char *key, uint64_t len);
+int64_t chd_get_uint64_t(const chd *chd, uint64_t key);
+int64_t chd_get_signature(const chd *chd, const uint64_t signature[4]);
+/* Stores in result the values of n keys, hashing groups of keys and then prefetching the memory
+   needed by the probes of each group. */
+void chd_get_byte_array_batch(const chd *chd, char * const *key, const int *len, int64_t *result, uint64_t n);
+void chd_get_uint64_t_batch(const chd *chd, const uint64_t *key, int64_t *result, uint64_t n);
+void chd_get_signature_batch(const chd *chd, const uint64_t (*signature)[4], int64_t *result, uint64_t n);
+
+#endif /* CHD_H_INCLUDED */
@@ -1,20 +1,48 @@
 #!/bin/bash
 
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_mph_byte_array.c mph.c spooky.c -o test_mph_byte_array
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_mph_uint64_t.c mph.c spooky.c -o test_mph_uint64_t
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_mph_uint128_t.c mph.c spooky.c -o test_mph_uint128_t
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_mph_byte_array.c mph.c popcount.c spooky.c dump.c -o test_mph_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_mph_uint64_t.c mph.c popcount.c spooky.c dump.c -o test_mph_uint64_t
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_mph_uint128_t.c mph.c popcount.c spooky.c dump.c -o test_mph_uint128_t
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_signed_mph.c signed_mph.c mph.c popcount.c spooky.c dump.c -o test_signed_mph
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_mph_builder.c mph_builder.c mph.c popcount.c spooky.c dump.c -o test_mph_builder
 
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_sf3_byte_array.c sf.c sf3.c spooky.c -o test_sf3_byte_array
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_sf4_byte_array.c sf.c sf4.c spooky.c -o test_sf4_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_chd_byte_array.c chd.c sparse_rank.c elias_fano.c simple_select.c spooky.c dump.c -o test_chd_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_chd_signature.c chd.c sparse_rank.c elias_fano.c simple_select.c spooky.c dump.c -o test_chd_signature
 
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_sf3_signature.c sf.c sf3.c spooky.c -o test_sf3_signature
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_sf4_signature.c sf.c sf4.c spooky.c -o test_sf4_signature
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_sf3_byte_array.c sf.c sf3.c spooky.c dump.c -o test_sf3_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_sf4_byte_array.c sf.c sf4.c spooky.c dump.c -o test_sf4_byte_array
 
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_csf3_byte_array.c csf.c csf3.c spooky.c -o test_csf3_byte_array
-gcc $@ -O3 -g -march=native -fomit-frame-pointer test_csf4_byte_array.c csf.c csf4.c spooky.c -o test_csf4_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_sf3_signature.c sf.c sf3.c spooky.c dump.c -o test_sf3_signature
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_sf4_signature.c sf.c sf4.c spooky.c dump.c -o test_sf4_signature
 
-gcc $@ -DSF_8 -O3 -g -march=native -fomit-frame-pointer test_sf3_byte_array.c sf.c sf3.c spooky.c -o test_sf3_8_byte_array
-gcc $@ -DSF_8 -O3 -g -march=native -fomit-frame-pointer test_sf4_byte_array.c sf.c sf4.c spooky.c -o test_sf4_8_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_two_steps_sf3_byte_array.c two_steps_sf3.c sf.c sf3.c spooky.c dump.c -o test_two_steps_sf3_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_two_steps_sf3_signature.c two_steps_sf3.c sf.c sf3.c spooky.c dump.c -o test_two_steps_sf3_signature
 
-gcc $@ -DSF_8 -O3 -g -march=native -fomit-frame-pointer test_sf3_signature.c sf.c sf3.c spooky.c -o test_sf3_8_signature
-gcc $@ -DSF_8 -O3 -g -march=native -fomit-frame-pointer test_sf4_signature.c sf.c sf4.c spooky.c -o test_sf4_8_signature
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_csf3_byte_array.c csf.c csf3.c spooky.c dump.c -o test_csf3_byte_array
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_csf4_byte_array.c csf.c csf4.c spooky.c dump.c -o test_csf4_byte_array
+
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_filter.c filter.c filter3.c filter4.c filter3_8.c filter4_8.c filter3_16.c filter4_16.c sf.c spooky.c dump.c -o test_filter
+
+gcc $@ -DSF_8 -pthread -O3 -g -march=native -fomit-frame-pointer test_sf3_byte_array.c sf.c sf3.c spooky.c dump.c -o test_sf3_8_byte_array
+gcc $@ -DSF_8 -pthread -O3 -g -march=native -fomit-frame-pointer test_sf4_byte_array.c sf.c sf4.c spooky.c dump.c -o test_sf4_8_byte_array
+
+gcc $@ -DSF_8 -pthread -O3 -g -march=native -fomit-frame-pointer test_sf3_signature.c sf.c sf3.c spooky.c dump.c -o test_sf3_8_signature
+gcc $@ -DSF_8 -pthread -O3 -g -march=native -fomit-frame-pointer test_sf4_signature.c sf.c sf4.c spooky.c dump.c -o test_sf4_8_signature
+
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer bench.c mph.c signed_mph.c chd.c sparse_rank.c elias_fano.c simple_select.c sf.c sf3.c sf4.c sf3_8.c sf4_8.c two_steps_sf3.c csf.c csf3.c csf4.c filter.c filter3.c filter4.c filter3_8.c filter4_8.c filter3_16.c filter4_16.c popcount.c spooky.c dump.c catalog.c -o bench
+gcc $@ -O3 -g -march=native mkcatalog.c catalog.c spooky.c dump.c -o mkcatalog
+gcc $@ -pthread -O3 -g -march=native mkmph.c mph_builder.c mph.c popcount.c spooky.c dump.c -o mkmph
+
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_rank_select.c rank9.c select9.c popcount.c dump.c -o test_rank_select
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_popcount.c popcount.c -o test_popcount
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_simple_select.c simple_select.c dump.c -o test_simple_select
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_elias_fano.c elias_fano.c simple_select.c dump.c -o test_elias_fano
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_elias_fano_indexed.c elias_fano_indexed.c elias_fano.c simple_select.c dump.c -o test_elias_fano_indexed
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_partitioned_elias_fano.c partitioned_elias_fano.c elias_fano_indexed.c elias_fano.c simple_select.c dump.c -o test_partitioned_elias_fano
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_two_sizes.c two_sizes.c rank9.c popcount.c dump.c -o test_two_sizes
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_sparse.c sparse_rank.c sparse_select.c elias_fano.c simple_select.c dump.c -o test_sparse
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_balanced_parentheses.c balanced_parentheses.c dump.c -o test_balanced_parentheses
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_lcp_mmphf.c lcp_mmphf.c sf.c spooky.c dump.c -o test_lcp_mmphf
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_trie_mmphf.c hollow_trie.c hollow_trie_distributor.c two_steps_lcp_mmphf.c zfast_trie_distributor.c lcp_mmphf.c two_steps_sf3.c sf3.c sf.c rank9.c popcount.c elias_fano.c simple_select.c balanced_parentheses.c spooky.c dump.c -o test_trie_mmphf
+gcc $@ -pthread -O3 -g -march=native -fomit-frame-pointer test_zfast_trie.c zfast_trie.c mph.c lcp_mmphf.c sf.c elias_fano.c simple_select.c popcount.c spooky.c dump.c -o test_zfast_trie
+gcc $@ -O3 -g -march=native -fomit-frame-pointer test_file_lines.c file_lines.c elias_fano.c simple_select.c dump.c -o test_file_lines
@@ -23,11 +23,81 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <stdint.h>
 #include "csf.h"
+#include "dump.h"
+
+#define OFFSET_MASK (UINT64_C(-1) >> 10)
+// One entry per codeword length, plus the escape
+#define MAX_DECODING_TABLE_LENGTH 64
+// Symbol indices are Java integers
+#define MAX_SYMBOLS INT_MAX
+
+static void free_csf(csf *csf) {
+	free(csf->offset_and_seed);
+	free(csf->array);
+	free(csf); // Decoder tables are allocated together with the structure
+}
+
+static csf *load_csf_container(int h, const dump_header *header) {
+	if (header->kind != DUMP_CSF || header->num_sections != 6) return NULL;
+	const uint64_t decoding_table_length = header->section[2].length / sizeof(uint64_t);
+	const uint64_t num_symbols = header->section[5].length / sizeof(uint64_t);
+	if (decoding_table_length > MAX_DECODING_TABLE_LENGTH || num_symbols > MAX_SYMBOLS) return NULL;
+	for (int s = 0; s < 6; s++)
+		if (s != 3 && s != 4 && header->section[s].length % sizeof(uint64_t) != 0) return NULL;
+
+	// Compact
+	char *p = malloc(sizeof(csf) + decoding_table_length * sizeof(uint64_t) + decoding_table_length * sizeof(uint32_t) + (decoding_table_length + 7 & ~7ULL) * sizeof(uint8_t) + num_symbols * sizeof(uint64_t));
+	if (p == NULL) return NULL;
+	csf *csf = (void *)p;
+	memset(csf, 0, sizeof *csf);
+	p += sizeof *csf;
+	csf->decoding_table_length = decoding_table_length;
+	csf->num_symbols = num_symbols;
+
+	csf->size = header->param[0];
+	csf->multiplier = header->param[1];
+	csf->global_seed = header->param[2];
+	csf->global_max_codeword_length = header->param[3];
+	csf->escaped_symbol_length = header->param[4];
+	csf->escape_length = header->param[5];
+
+	csf->offset_and_seed_length = header->section[0].length / sizeof *csf->offset_and_seed;
+	csf->array_length = header->section[1].length / sizeof *csf->array;
+	if (csf->offset_and_seed_length > SIZE_MAX / sizeof *csf->offset_and_seed || csf->array_length > SIZE_MAX / sizeof *csf->array) goto fail;
+	csf->offset_and_seed = malloc(csf->offset_and_seed_length * sizeof *csf->offset_and_seed);
+	csf->array = malloc(csf->array_length * sizeof *csf->array);
+	if (csf->offset_and_seed == NULL || csf->array == NULL) goto fail;
+
+	csf->last_codeword_plus_one = (uint64_t *)p;
+	p += decoding_table_length * sizeof *csf->last_codeword_plus_one;
+	csf->how_many_up_to_block = (uint32_t *)p;
+	p += decoding_table_length * sizeof *csf->how_many_up_to_block;
+	csf->shift = (uint8_t *)p;
+	p += decoding_table_length + 7 & ~7ULL; // Realign
+	csf->symbol = (uint64_t *)p;
+
+	if (header->section[3].length != decoding_table_length * sizeof *csf->how_many_up_to_block || header->section[4].length != decoding_table_length * sizeof *csf->shift) goto fail;
+	if (dump_read_section(h, header, 0, csf->offset_and_seed) || dump_read_section(h, header, 1, csf->array)
+		|| dump_read_section(h, header, 2, csf->last_codeword_plus_one) || dump_read_section(h, header, 3, csf->how_many_up_to_block)
+		|| dump_read_section(h, header, 4, csf->shift) || dump_read_section(h, header, 5, csf->symbol)) goto fail;
+	return csf;
+
+fail:
+	free_csf(csf);
+	return NULL;
+}
+
+static csf *load_csf_header(int h, dump_header *header) {
+	const int container = dump_read_header(h, header);
+	if (container < 0) return NULL;
+	if (container) return load_csf_container(h, header);
 
-csf *load_csf(int h) {
 	csf *csf = calloc(1, sizeof *csf);
-	read(h, &csf->size, sizeof csf->size);
+	if (csf == NULL) return NULL;
+	csf->size = header->magic;
 	uint64_t t;
 
 	read(h, &t, sizeof t);
@@ -38,12 +108,16 @@ csf *load_csf(int h) {
 
 	read(h, &csf->global_seed, sizeof csf->global_seed);
 	read(h, &csf->offset_and_seed_length, sizeof csf->offset_and_seed_length);
+	if (csf->offset_and_seed_length > SIZE_MAX / sizeof *csf->offset_and_seed) goto fail;
 	csf->offset_and_seed = malloc(csf->offset_and_seed_length * sizeof *csf->offset_and_seed);
+	if (csf->offset_and_seed == NULL) goto fail;
 	read(h, csf->offset_and_seed, csf->offset_and_seed_length * sizeof *csf->offset_and_seed);
 
 	read(h, &csf->array_length, sizeof csf->array_length);
+	if (csf->array_length > SIZE_MAX / sizeof *csf->array) goto fail;
 
 	csf->array = malloc(csf->array_length * sizeof *csf->array);
+	if (csf->array == NULL) goto fail;
 	read(h, csf->array, csf->array_length * sizeof *csf->array);
 
 	// Decoder
@@ -55,10 +129,16 @@ csf *load_csf(int h) {
 
 	uint64_t num_symbols;
 	read(h, &num_symbols, sizeof num_symbols);
+	if (decoding_table_length > MAX_DECODING_TABLE_LENGTH || num_symbols > MAX_SYMBOLS) goto fail;
+	csf->decoding_table_length = decoding_table_length;
+	csf->num_symbols = num_symbols;
 
 	// Compact
 	char *p = malloc(sizeof *csf + decoding_table_length * sizeof *csf->last_codeword_plus_one + decoding_table_length * sizeof *csf->how_many_up_to_block + (decoding_table_length + 7 & ~7ULL) * sizeof *csf->shift + num_symbols * sizeof *csf->symbol);
+	if (p == NULL) goto fail;
+	void * const loaded = csf;
 	csf = memcpy(p, csf, sizeof *csf);
+	free(loaded);
 	p += sizeof *csf;
 
 	csf->last_codeword_plus_one = (uint64_t *)p;
@@ -75,4 +155,101 @@ csf *load_csf(int h) {
 	read(h, csf->symbol, num_symbols * sizeof *csf->symbol);
 
 	return csf;
+
+fail:
+	free_csf(csf);
+	return NULL;
+}
+
+csf *load_csf(int h) {
+	dump_header header;
+	return load_csf_header(h, &header);
+}
+
+int map_csf(const void *dump, const uint64_t length, csf *csf) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_CSF || header->num_sections != 6) return -1;
+	if (header->section[3].length != header->section[2].length / sizeof(uint64_t) * sizeof(uint32_t) || header->section[4].length != header->section[2].length / sizeof(uint64_t)) return -1;
+	const char * const base = dump;
+	memset(csf, 0, sizeof *csf);
+	csf->size = header->param[0];
+	csf->multiplier = header->param[1];
+	csf->global_seed = header->param[2];
+	csf->global_max_codeword_length = header->param[3];
+	csf->escaped_symbol_length = header->param[4];
+	csf->escape_length = header->param[5];
+	csf->offset_and_seed_length = header->section[0].length / sizeof *csf->offset_and_seed;
+	csf->offset_and_seed = (uint64_t *)(base + header->section[0].offset);
+	csf->array_length = header->section[1].length / sizeof *csf->array;
+	csf->array = (uint64_t *)(base + header->section[1].offset);
+	csf->decoding_table_length = header->section[2].length / sizeof *csf->last_codeword_plus_one;
+	csf->last_codeword_plus_one = (uint64_t *)(base + header->section[2].offset);
+	csf->how_many_up_to_block = (uint32_t *)(base + header->section[3].offset);
+	csf->shift = (uint8_t *)(base + header->section[4].offset);
+	csf->num_symbols = header->section[5].length / sizeof *csf->symbol;
+	csf->symbol = (uint64_t *)(base + header->section[5].offset);
+	return 0;
+}
+
+int csf_validate(const csf *csf) {
+	if (csf->offset_and_seed == NULL || csf->array == NULL) return -1;
+	const uint64_t w = csf->global_max_codeword_length;
+	// get_value() cannot extract zero bits; the decoder needs the escape above all w-bit values
+	if (w == 0 || w > 62) return -1;
+	if (csf->escape_length + csf->escaped_symbol_length > w) return -1;
+
+	// Every w-bit value must stop within the decoding table, at a valid symbol index
+	if (csf->decoding_table_length == 0 || csf->num_symbols == 0) return -1;
+	const uint64_t max_value = (UINT64_C(1) << w) - 1;
+	uint64_t lo = 0; // The smallest value reaching the current entry
+	for (uint64_t curr = 0; curr < csf->decoding_table_length && lo <= max_value; curr++) {
+		const uint64_t last_codeword_plus_one = csf->last_codeword_plus_one[curr];
+		if (last_codeword_plus_one <= lo) continue; // Unreachable
+		const uint64_t hi = last_codeword_plus_one - 1 < max_value ? last_codeword_plus_one - 1 : max_value;
+		const int s = csf->shift[curr];
+		if (s > 63) return -1;
+		// The index is how_many_up_to_block[curr] minus a distance that decreases with the value
+		const uint64_t how_many_up_to_block = csf->how_many_up_to_block[curr];
+		if ((last_codeword_plus_one >> s) - (lo >> s) > how_many_up_to_block) return -1;
+		if (how_many_up_to_block - ((last_codeword_plus_one >> s) - (hi >> s)) >= csf->num_symbols) return -1;
+		lo = last_codeword_plus_one;
+	}
+	if (lo <= max_value) return -1;
+
+	// The largest bucket computed by the lookup code, which also reads the following offset
+	const uint64_t max_bucket = ((__uint128_t)(UINT64_MAX >> 1) * csf->multiplier) >> 64;
+	if (max_bucket >= INT_MAX || csf->offset_and_seed_length < max_bucket + 2) return -1;
+	if (csf->array_length > UINT64_MAX / 64) return -1;
+	for (uint64_t i = 0; i <= max_bucket; i++) {
+		const uint64_t offset = csf->offset_and_seed[i] & OFFSET_MASK;
+		const uint64_t next = csf->offset_and_seed[i + 1] & OFFSET_MASK;
+		// Offsets are bit positions, and each bucket has w bits of padding
+		if (next < offset + w || next - offset - w > INT_MAX) return -1;
+		const uint64_t num_variables = next - offset - w;
+		// An empty bucket is probed at its offset
+		if (offset + (num_variables != 0 ? num_variables - 1 : 0) + w > csf->array_length * 64) return -1;
+	}
+	return 0;
+}
+
+static int validate(const void *csf) {
+	return csf_validate(csf);
+}
+
+csf *load_csf_validated(int h) {
+	csf *csf = load_csf(h);
+	if (csf == NULL) return NULL;
+	if (csf_validate(csf) == 0) return csf;
+	free_csf(csf);
+	return NULL;
+}
+
+csf *load_csf_verify(int h, dump_verifier *verifier) {
+	dump_header header;
+	csf *csf = load_csf_header(h, &header);
+	if (csf == NULL) return NULL;
+	const void *section[] = { csf->offset_and_seed, csf->array, csf->last_codeword_plus_one, csf->how_many_up_to_block, csf->shift, csf->symbol };
+	if (dump_verify_start(verifier, &header, section, validate, csf) == 0) return csf;
+	free_csf(csf);
+	return NULL;
 }
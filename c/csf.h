@@ -18,7 +18,11 @@
  *
  */
 
+#ifndef CSF_H_INCLUDED
+#define CSF_H_INCLUDED
+
 #include <inttypes.h>
+#include "dump.h"
 
 #ifdef USE_MMAP
 #include <sys/mman.h>
@@ -41,6 +45,21 @@ typedef struct {
 	uint64_t *last_codeword_plus_one;
 	uint32_t *how_many_up_to_block;
 	uint8_t *shift;
+	uint64_t decoding_table_length;
+	uint64_t num_symbols;
 } csf;
 
 csf *load_csf(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h)
+   without copying; the container must stay mapped. Returns zero on success. */
+int map_csf(const void *dump, uint64_t length, csf *csf);
+/* Loads a function and validates it (see csf_validate()); returns NULL if the dump is not valid. */
+csf *load_csf_validated(int h);
+/* Loads a function and starts verifying it in the background (see dump.h). */
+csf *load_csf_verify(int h, dump_verifier *verifier);
+/* Checks that every probe of the lookup code, for any key, falls within the arrays (offsets
+   are monotone, there is a sentinel offset after the last bucket, the last bucket fits the
+   array, and every w-bit value is decoded to a valid symbol index); returns zero if valid. */
+int csf_validate(const csf *csf);
+
+#endif /* CSF_H_INCLUDED */
@@ -36,7 +36,7 @@ static uint64_t inline decode(const csf * const csf, const uint64_t value) {
 static void inline signature_to_equation(const uint64_t *signature, const uint64_t seed, int num_variables, int *e) {
 	uint64_t hash[4];
 	spooky_short_rehash(signature, seed, hash);
-	const int shift = __builtin_clzll(num_variables);
+	const int shift = __builtin_clzll(num_variables | 1); // Empty buckets yield zero
 	const uint64_t mask = (UINT64_C(1) << shift) - 1;
 	e[0] = ((hash[0] & mask) * num_variables) >> shift;
 	e[1] = ((hash[1] & mask) * num_variables) >> shift;
@@ -66,9 +66,10 @@ int64_t csf3_get_byte_array(const csf *csf, char *key, uint64_t len) {
 	signature_to_equation(signature, offset_seed & ~OFFSET_MASK, num_variables, e);
 	const int64_t t = decode(csf, get_value(csf->array, e[0] + bucket_offset, w) ^ get_value(csf->array, e[1] + bucket_offset, w) ^ get_value(csf->array, e[2] + bucket_offset, w));
 	if (t != -1) return t;
+	if (csf->escaped_symbol_length == 0) return 0;
 	const uint64_t end = csf->global_max_codeword_length - csf->escape_length;
 	const uint64_t start = end - csf->escaped_symbol_length;
-	return get_value(csf->array, e[0] + start, e[0] + end) ^ get_value(csf->array, e[1] + start, e[1] + end) ^ get_value(csf->array, e[2] + start, e[2] + end);
+	return get_value(csf->array, e[0] + bucket_offset + start, end - start) ^ get_value(csf->array, e[1] + bucket_offset + start, end - start) ^ get_value(csf->array, e[2] + bucket_offset + start, end - start);
 }
 
 int64_t csf3_get_uint64_t(const csf *csf, const uint64_t key) {
@@ -83,7 +84,24 @@ int64_t csf3_get_uint64_t(const csf *csf, const uint64_t key) {
 	signature_to_equation(signature, offset_seed & ~OFFSET_MASK, num_variables, e);
 	const int64_t t = decode(csf, get_value(csf->array, e[0] + bucket_offset, w) ^ get_value(csf->array, e[1] + bucket_offset, w) ^ get_value(csf->array, e[2] + bucket_offset, w));
 	if (t != -1) return t;
+	if (csf->escaped_symbol_length == 0) return 0;
 	const uint64_t end = csf->global_max_codeword_length - csf->escape_length;
 	const uint64_t start = end - csf->escaped_symbol_length;
-	return get_value(csf->array, e[0] + start, e[0] + end) ^ get_value(csf->array, e[1] + start, e[1] + end) ^ get_value(csf->array, e[2] + start, e[2] + end);
+	return get_value(csf->array, e[0] + bucket_offset + start, end - start) ^ get_value(csf->array, e[1] + bucket_offset + start, end - start) ^ get_value(csf->array, e[2] + bucket_offset + start, end - start);
+}
+
+int64_t csf3_get_signature(const csf *csf, const uint64_t signature[4]) {
+	const int bucket = ((__uint128_t)(signature[0] >> 1) * (__uint128_t)csf->multiplier) >> 64;
+	const uint64_t offset_seed = csf->offset_and_seed[bucket];
+	const uint64_t bucket_offset = offset_seed & OFFSET_MASK;
+	const int w = csf->global_max_codeword_length;
+	const int num_variables = (csf->offset_and_seed[bucket + 1] & OFFSET_MASK) - bucket_offset - w;
+	int e[3];
+	signature_to_equation(signature, offset_seed & ~OFFSET_MASK, num_variables, e);
+	const int64_t t = decode(csf, get_value(csf->array, e[0] + bucket_offset, w) ^ get_value(csf->array, e[1] + bucket_offset, w) ^ get_value(csf->array, e[2] + bucket_offset, w));
+	if (t != -1) return t;
+	if (csf->escaped_symbol_length == 0) return 0;
+	const uint64_t end = csf->global_max_codeword_length - csf->escape_length;
+	const uint64_t start = end - csf->escaped_symbol_length;
+	return get_value(csf->array, e[0] + bucket_offset + start, end - start) ^ get_value(csf->array, e[1] + bucket_offset + start, end - start) ^ get_value(csf->array, e[2] + bucket_offset + start, end - start);
 }
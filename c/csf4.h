@@ -22,3 +22,4 @@
 
 int64_t csf4_get_byte_array(const csf *csf, char *key, uint64_t len);
 int64_t csf4_get_uint64_t(const csf *mph, uint64_t key);
+int64_t csf4_get_signature(const csf *csf, const uint64_t signature[4]);
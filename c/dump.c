@@ -0,0 +1,245 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "dump.h"
+
+int dump_read_header(int h, dump_header *header) {
+	memset(header, 0, sizeof *header);
+	if (read(h, &header->magic, sizeof header->magic) != sizeof header->magic) return -1;
+	if (header->magic != DUMP_MAGIC) return 0;
+	const ssize_t rest = sizeof *header - sizeof header->magic;
+	if (read(h, (char *)header + sizeof header->magic, rest) != rest) return -1;
+	if (header->version > DUMP_VERSION || header->num_sections > DUMP_MAX_SECTIONS) return -1;
+	for (uint32_t i = 0; i < header->num_sections; i++)
+		if (header->section[i].offset % DUMP_ALIGNMENT != 0 || header->section[i].offset + header->section[i].length < header->section[i].offset) return -1;
+	return 1;
+}
+
+int dump_read_section(int h, const dump_header *header, int s, void *buffer) {
+	if (s < 0 || (uint32_t)s >= header->num_sections) return -1;
+	char *p = buffer;
+	uint64_t offset = header->section[s].offset, left = header->section[s].length;
+	while (left != 0) {
+		const ssize_t r = pread(h, p, left, offset);
+		if (r <= 0) return -1;
+		p += r;
+		offset += r;
+		left -= r;
+	}
+	return 0;
+}
+
+const dump_header *dump_map_header(const void *dump, const uint64_t length) {
+	const dump_header * const header = dump;
+	if (length < DUMP_ALIGNMENT || header->magic != DUMP_MAGIC) return NULL;
+	if (header->version > DUMP_VERSION || header->num_sections > DUMP_MAX_SECTIONS) return NULL;
+	for (uint32_t i = 0; i < header->num_sections; i++)
+		if (header->section[i].offset % DUMP_ALIGNMENT != 0 || header->section[i].offset > length || header->section[i].length > length - header->section[i].offset) return NULL;
+	return header;
+}
+
+void *dump_map(int h, uint64_t *length) {
+	struct stat st;
+	if (fstat(h, &st) != 0 || st.st_size == 0) return NULL;
+	void * const map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, h, 0);
+	if (map == MAP_FAILED) return NULL;
+	*length = st.st_size;
+	return map;
+}
+
+#define PRIME64_1 UINT64_C(0x9E3779B185EBCA87)
+#define PRIME64_2 UINT64_C(0xC2B2AE3D27D4EB4F)
+
+#define ROTL64(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+static inline uint64_t round64(const uint64_t acc, const uint64_t word) {
+	return ROTL64(acc + word * PRIME64_2, 31) * PRIME64_1;
+}
+
+uint64_t dump_checksum(const void *data, const uint64_t length) {
+	const uint64_t *p = data;
+	uint64_t v[4] = { PRIME64_1 + PRIME64_2, PRIME64_2, 0, -PRIME64_1 };
+	const uint64_t words = length / 8;
+	uint64_t i;
+	for (i = 0; i + 4 <= words; i += 4) {
+		v[0] = round64(v[0], p[i]);
+		v[1] = round64(v[1], p[i + 1]);
+		v[2] = round64(v[2], p[i + 2]);
+		v[3] = round64(v[3], p[i + 3]);
+	}
+	for (; i < words; i++) v[i & 3] = round64(v[i & 3], p[i]);
+	if (length % 8 != 0) {
+		uint64_t last = 0;
+		memcpy(&last, (const char *)data + words * 8, length % 8);
+		v[i & 3] = round64(v[i & 3], last);
+	}
+
+	uint64_t h = ROTL64(v[0], 1) + ROTL64(v[1], 7) + ROTL64(v[2], 12) + ROTL64(v[3], 18);
+	h ^= length;
+	h ^= h >> 33;
+	h *= UINT64_C(0xFF51AFD7ED558CCD);
+	h ^= h >> 33;
+	h *= UINT64_C(0xC4CEB9FE1A85EC53);
+	h ^= h >> 33;
+	return h;
+}
+
+static int write_fully(const int h, const void *data, uint64_t length, uint64_t offset) {
+	const char *p = data;
+	while (length != 0) {
+		const ssize_t w = pwrite(h, p, length, offset);
+		if (w <= 0) return -1;
+		p += w;
+		offset += w;
+		length -= w;
+	}
+	return 0;
+}
+
+int dump_write(const char *path, dump_header *header, const void * const *section) {
+	if (header->num_sections > DUMP_MAX_SECTIONS) return -1;
+	header->magic = DUMP_MAGIC;
+	header->version = DUMP_VERSION;
+	header->checksum = DUMP_FAST_CHECKSUM;
+	uint64_t offset = DUMP_ALIGNMENT;
+	for (uint32_t i = 0; i < header->num_sections; i++) {
+		header->section[i].offset = offset;
+		header->section[i].checksum = dump_checksum(section[i], header->section[i].length);
+		offset = (offset + header->section[i].length + DUMP_ALIGNMENT - 1) & -(uint64_t)DUMP_ALIGNMENT;
+	}
+	const int h = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (h < 0) return -1;
+	// The header is padded with zeroes to DUMP_ALIGNMENT bytes, as sections are
+	char padded[DUMP_ALIGNMENT] = { 0 };
+	memcpy(padded, header, sizeof *header);
+	int result = write_fully(h, padded, sizeof padded, 0);
+	for (uint32_t i = 0; i < header->num_sections && result == 0; i++) result = write_fully(h, section[i], header->section[i].length, header->section[i].offset);
+	if (close(h) != 0) result = -1;
+	return result;
+}
+
+static void *verify(void *arg) {
+	dump_verifier * const verifier = arg;
+	const dump_header * const header = &verifier->header;
+	if (header->magic == DUMP_MAGIC && header->checksum == DUMP_FAST_CHECKSUM)
+		for (uint32_t i = 0; i < header->num_sections; i++)
+			if (verifier->section[i] != NULL && dump_checksum(verifier->section[i], header->section[i].length) != header->section[i].checksum) {
+				atomic_store(&verifier->status, DUMP_CORRUPT);
+				return NULL;
+			}
+	if (verifier->validate != NULL && verifier->validate(verifier->structure) != 0) {
+		atomic_store(&verifier->status, DUMP_CORRUPT);
+		return NULL;
+	}
+	atomic_store(&verifier->status, DUMP_VALID);
+	return NULL;
+}
+
+int dump_verify_start(dump_verifier *verifier, const dump_header *header, const void * const *section, int (*validate)(const void *structure), const void *structure) {
+	memset(verifier, 0, sizeof *verifier);
+	atomic_init(&verifier->status, DUMP_PENDING);
+	verifier->header = *header;
+	for (uint32_t i = 0; i < header->num_sections && i < DUMP_MAX_SECTIONS; i++) verifier->section[i] = section[i];
+	verifier->validate = validate;
+	verifier->structure = structure;
+	return pthread_create(&verifier->thread, NULL, verify, verifier);
+}
+
+int dump_verify_status(dump_verifier *verifier) {
+	return atomic_load(&verifier->status);
+}
+
+int dump_verify_wait(dump_verifier *verifier) {
+	pthread_join(verifier->thread, NULL);
+	return atomic_load(&verifier->status);
+}
+
+const char *dump_kind_name(const dump_header *header) {
+	switch (header->kind) {
+	case DUMP_MPH:
+		return "mph";
+	case DUMP_SF:
+		if (header->arity == 3) return header->width == 8 ? "sf3_8" : "sf3";
+		if (header->arity == 4) return header->width == 8 ? "sf4_8" : "sf4";
+		return NULL;
+	case DUMP_CSF:
+		if (header->arity == 3) return "csf3";
+		if (header->arity == 4) return "csf4";
+		return NULL;
+	case DUMP_RANK9:
+		return "rank9";
+	case DUMP_SELECT9:
+		return "select9";
+	case DUMP_SIMPLE_SELECT:
+		return "simple_select";
+	case DUMP_SIMPLE_SELECT_ZERO:
+		return "simple_select_zero";
+	case DUMP_ELIAS_FANO:
+		return "elias_fano";
+	case DUMP_ELIAS_FANO_INDEXED:
+		return "elias_fano_indexed";
+	case DUMP_PARTITIONED_ELIAS_FANO:
+		return "partitioned_elias_fano";
+	case DUMP_TWO_SIZES:
+		return "two_sizes";
+	case DUMP_SPARSE_RANK:
+		return "sparse_rank";
+	case DUMP_SPARSE_SELECT:
+		return "sparse_select";
+	case DUMP_BALANCED_PARENTHESES:
+		return "balanced_parentheses";
+	case DUMP_CHD:
+		return "chd";
+	case DUMP_TWO_STEPS_SF:
+		return header->arity == 3 ? "two_steps_sf3" : NULL;
+	case DUMP_LCP_MMPHF:
+		return "lcp_mmphf";
+	case DUMP_HOLLOW_TRIE:
+		return "hollow_trie";
+	case DUMP_HOLLOW_TRIE_DISTRIBUTOR:
+		return "hollow_trie_distributor";
+	case DUMP_HOLLOW_TRIE_DISTRIBUTOR_MMPHF:
+		return "hollow_trie_distributor_mmphf";
+	case DUMP_TWO_STEPS_LCP_MMPHF:
+		return "two_steps_lcp_mmphf";
+	case DUMP_ZFAST_TRIE_DISTRIBUTOR:
+		return "zfast_trie_distributor";
+	case DUMP_ZFAST_TRIE_DISTRIBUTOR_MMPHF:
+		return "zfast_trie_distributor_mmphf";
+	case DUMP_ZFAST_TRIE:
+		return "zfast_trie";
+	case DUMP_SIGNED_MPH:
+		return "signed_mph";
+	case DUMP_FILTER:
+		if (header->arity == 3) return header->width == 8 ? "filter3_8" : header->width == 16 ? "filter3_16" : "filter3";
+		if (header->arity == 4) return header->width == 8 ? "filter4_8" : header->width == 16 ? "filter4_16" : "filter4";
+		return NULL;
+	case DUMP_FILE_LINES:
+		return "file_lines";
+	default:
+		return NULL;
+	}
+}
@@ -0,0 +1,165 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * The self-describing container written by Sux4J's NativeDump.
+ *
+ * A dump starts with a DUMP_ALIGNMENT-byte header containing a magic number,
+ * the format version, the kind of structure, its arity and width, the
+ * transformation strategy and the hash function used for the keys, up to
+ * DUMP_MAX_PARAMS scalar parameters and a table of up to DUMP_MAX_SECTIONS
+ * sections (offset, length in bytes, checksum). Sections start at offsets
+ * that are multiples of DUMP_ALIGNMENT. Everything is in native byte order.
+ *
+ * Checksums (DUMP_FAST_CHECKSUM) process a section as a sequence of 64-bit
+ * words, the last one padded with zeroes, in four independent xxHash64-style
+ * lanes, so they can be verified at memory speed.
+ *
+ * Files without the magic number are legacy dumps, which the loaders still
+ * accept, but without any check on their kind.
+ */
+
+#ifndef DUMP_H_INCLUDED
+#define DUMP_H_INCLUDED
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define DUMP_MAGIC UINT64_C(0x504D444A34585553) // "SUX4JDMP"
+#define DUMP_VERSION 1
+#define DUMP_ALIGNMENT 4096
+#define DUMP_MAX_PARAMS 16
+#define DUMP_MAX_SECTIONS 16
+
+// Kinds of structures
+#define DUMP_MPH 1
+#define DUMP_SF 2
+#define DUMP_CSF 3
+#define DUMP_RANK9 4
+#define DUMP_SELECT9 5
+#define DUMP_SIMPLE_SELECT 6
+#define DUMP_SIMPLE_SELECT_ZERO 7
+#define DUMP_ELIAS_FANO 8
+#define DUMP_ELIAS_FANO_INDEXED 9
+#define DUMP_PARTITIONED_ELIAS_FANO 10
+#define DUMP_TWO_SIZES 11
+#define DUMP_SPARSE_RANK 12
+#define DUMP_SPARSE_SELECT 13
+#define DUMP_BALANCED_PARENTHESES 14
+#define DUMP_CHD 15
+#define DUMP_TWO_STEPS_SF 16
+#define DUMP_LCP_MMPHF 17
+#define DUMP_HOLLOW_TRIE 18
+#define DUMP_HOLLOW_TRIE_DISTRIBUTOR 19
+#define DUMP_HOLLOW_TRIE_DISTRIBUTOR_MMPHF 20
+#define DUMP_TWO_STEPS_LCP_MMPHF 21
+#define DUMP_ZFAST_TRIE_DISTRIBUTOR 22
+#define DUMP_ZFAST_TRIE_DISTRIBUTOR_MMPHF 23
+#define DUMP_ZFAST_TRIE 24
+#define DUMP_SIGNED_MPH 25
+#define DUMP_FILTER 26
+#define DUMP_FILE_LINES 27
+
+// Transformation strategies
+#define DUMP_UNKNOWN_STRATEGY 0
+#define DUMP_RAW_BYTE_ARRAY 1
+#define DUMP_RAW_LONG 2
+#define DUMP_PREFIX_FREE_BYTE_ARRAY 3
+#define DUMP_PREFIX_FREE 4
+
+// Hash functions
+#define DUMP_NO_HASH 0
+#define DUMP_SPOOKY_V2 1
+
+// Checksum algorithms
+#define DUMP_NO_CHECKSUM 0
+#define DUMP_FAST_CHECKSUM 1
+
+// Verification status
+#define DUMP_PENDING 0
+#define DUMP_VALID 1
+#define DUMP_CORRUPT -1
+
+typedef struct {
+	uint64_t offset;
+	uint64_t length;
+	uint64_t checksum;
+} dump_section;
+
+typedef struct {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t kind;
+	uint32_t arity;
+	uint32_t width;
+	uint32_t strategy;
+	uint32_t hash;
+	uint32_t checksum;
+	uint32_t num_sections;
+	uint64_t param[DUMP_MAX_PARAMS];
+	dump_section section[DUMP_MAX_SECTIONS];
+} dump_header;
+
+/* Reads the header of a dump. Returns 1 if the file is a container, -1 if it
+   is a container we cannot read, and 0 if it is a legacy dump; in the last
+   case, header->magic contains the first word of the file, which is the first
+   field of the legacy format. */
+int dump_read_header(int h, dump_header *header);
+/* Reads section s into buffer, which must be large enough. Returns 0 on success. */
+int dump_read_section(int h, const dump_header *header, int s, void *buffer);
+/* Returns the header of a container of length bytes mapped (or loaded) in
+   memory at the given address, or NULL if it is not a container we can read
+   or if some section does not lie within the container. */
+const dump_header *dump_map_header(const void *dump, uint64_t length);
+/* Maps read-only a whole file in memory, storing its length in length; returns NULL on failure. */
+void *dump_map(int h, uint64_t *length);
+/* Computes the fast checksum of length bytes. */
+uint64_t dump_checksum(const void *data, uint64_t length);
+/* Writes a container to a file, as NativeDump does in Java. The kind, arity, width, strategy,
+   hash, parameters, number of sections and lengths of the sections of header must be set; the
+   magic number, the version, the checksum algorithm and the offsets and checksums of the sections
+   are filled in. Returns zero on success. */
+int dump_write(const char *path, dump_header *header, const void * const *section);
+
+/* A background verifier: it checks the checksums of the loaded sections and
+   then calls a structure-specific validation function (returning zero if the
+   structure is valid), while the structure is already being used. */
+typedef struct {
+	atomic_int status;
+	pthread_t thread;
+	dump_header header;
+	const void *section[DUMP_MAX_SECTIONS];
+	int (*validate)(const void *structure);
+	const void *structure;
+} dump_verifier;
+
+/* Starts verifying in the background the given sections (in memory) against
+   the checksums in the header, if any, and then the structure. */
+int dump_verify_start(dump_verifier *verifier, const dump_header *header, const void * const *section, int (*validate)(const void *structure), const void *structure);
+/* Returns DUMP_PENDING, DUMP_VALID or DUMP_CORRUPT without blocking. */
+int dump_verify_status(dump_verifier *verifier);
+/* Waits for the verification to complete and returns DUMP_VALID or DUMP_CORRUPT. */
+int dump_verify_wait(dump_verifier *verifier);
+
+/* Returns a string describing the kind, arity and width of a dump (e.g., "sf3_8"). */
+const char *dump_kind_name(const dump_header *header);
+
+#endif /* DUMP_H_INCLUDED */
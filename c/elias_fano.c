@@ -0,0 +1,329 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "elias_fano.h"
+#include "broadword.h"
+#if defined(__AVX512VBMI2__) && defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Indices whose memory accesses are issued together by the batched method
+#define BATCH 16
+// Zeroes to skip beyond which iterators select instead of counting zeroes word by word
+#define SKIP_THRESHOLD 256
+
+int map_elias_fano(const void *dump, const uint64_t length, elias_fano *elias_fano) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_ELIAS_FANO || header->num_sections != 5) return -1;
+	return map_elias_fano_at(dump, 0, 0, elias_fano);
+}
+
+int map_elias_fano_at(const void *dump, const int param, const int section, elias_fano *elias_fano) {
+	const dump_header * const header = dump;
+	if (param + 5 > DUMP_MAX_PARAMS || section + 5 > (int)header->num_sections || header->param[param + 1] > 63) return -1;
+	const char * const base = dump;
+	memset(elias_fano, 0, sizeof *elias_fano);
+	elias_fano->length = header->param[param];
+	elias_fano->l = header->param[param + 1];
+	elias_fano->lower_bits_length = header->section[section].length / sizeof *elias_fano->lower_bits;
+	elias_fano->lower_bits = (const uint64_t *)(base + header->section[section].offset);
+	return map_simple_select_at(dump, 0, param + 2, section + 1, &elias_fano->upper);
+}
+
+int elias_fano_validate(const elias_fano *elias_fano) {
+	if (elias_fano->length >= UINT64_MAX / 64) return -1;
+	// The sentinel, too, has lower bits (and the lower bits are never empty)
+	const uint64_t lower_bits_length = ((elias_fano->length + 1) * elias_fano->l + 63) / 64;
+	if (elias_fano->lower_bits_length < (lower_bits_length > 0 ? lower_bits_length : 1)) return -1;
+	if (elias_fano->upper.num_ones != elias_fano->length + 1) return -1;
+	return simple_select_validate(&elias_fano->upper);
+}
+
+elias_fano *load_elias_fano(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	elias_fano *elias_fano = malloc(sizeof *elias_fano);
+	if (elias_fano == NULL || map_elias_fano(map, length, elias_fano) != 0) {
+		free(elias_fano);
+		munmap(map, length);
+		return NULL;
+	}
+	elias_fano->map = map;
+	elias_fano->map_length = length;
+	return elias_fano;
+}
+
+static int validate(const void *elias_fano) {
+	return elias_fano_validate(elias_fano);
+}
+
+elias_fano *load_elias_fano_validated(int h) {
+	elias_fano *elias_fano = load_elias_fano(h);
+	if (elias_fano == NULL) return NULL;
+	if (elias_fano_validate(elias_fano) == 0) return elias_fano;
+	munmap(elias_fano->map, elias_fano->map_length);
+	free(elias_fano);
+	return NULL;
+}
+
+elias_fano *load_elias_fano_verify(int h, dump_verifier *verifier) {
+	elias_fano *elias_fano = load_elias_fano(h);
+	if (elias_fano == NULL) return NULL;
+	const dump_header * const header = elias_fano->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)elias_fano->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, elias_fano) == 0) return elias_fano;
+	munmap(elias_fano->map, elias_fano->map_length);
+	free(elias_fano);
+	return NULL;
+}
+
+uint64_t elias_fano_get(const elias_fano *elias_fano, const uint64_t index) {
+	return simple_select_select(&elias_fano->upper, index) - index << elias_fano->l | elias_fano_lower_bits(elias_fano->lower_bits, elias_fano->l, index);
+}
+
+void elias_fano_get_range(const elias_fano *elias_fano, const uint64_t from, const uint64_t to, uint64_t *dest) {
+	if (from >= to) return;
+	simple_select_select_bulk(&elias_fano->upper, from, dest, to - from);
+	// Local copies, as stores to dest might alias the structure
+	const uint64_t * const lower = elias_fano->lower_bits;
+	const int l = elias_fano->l;
+	for (uint64_t i = from; i < to; i++) dest[i - from] = dest[i - from] - i << l | elias_fano_lower_bits(lower, l, i);
+}
+
+void elias_fano_get_batch(const elias_fano *elias_fano, const uint64_t *index, uint64_t *dest, const uint64_t n) {
+	const uint64_t * const lower = elias_fano->lower_bits;
+	const int l = elias_fano->l;
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) __builtin_prefetch(&lower[index[i + j] * l / 64]);
+		simple_select_select_batch(&elias_fano->upper, index + i, dest + i, b);
+		for (int j = 0; j < b; j++) dest[i + j] = dest[i + j] - index[i + j] << l | elias_fano_lower_bits(lower, l, index[i + j]);
+	}
+}
+
+/* Returns the position of the first one following a given position in the upper bits, which must exist. */
+static inline uint64_t next_one(const uint64_t * const upper, const uint64_t position) {
+	uint64_t curr = position / 64;
+	// Two shifts, as position % 64 + 1 might be 64
+	uint64_t window = upper[curr] & UINT64_MAX << position % 64 << 1;
+	while (window == 0) window = upper[++curr];
+	return curr * 64 + __builtin_ctzll(window);
+}
+
+void elias_fano_get_pair(const elias_fano *elias_fano, const uint64_t index, uint64_t *start, uint64_t *end) {
+	const uint64_t * const lower = elias_fano->lower_bits;
+	const int l = elias_fano->l;
+	const uint64_t position = simple_select_select(&elias_fano->upper, index);
+	*start = position - index << l | elias_fano_lower_bits(lower, l, index);
+	*end = next_one(elias_fano->upper.bits, position) - index - 1 << l | elias_fano_lower_bits(lower, l, index + 1);
+}
+
+void elias_fano_get_pair_batch(const elias_fano *elias_fano, const uint64_t *index, uint64_t *start, uint64_t *end, const uint64_t n) {
+	const uint64_t * const lower = elias_fano->lower_bits;
+	const uint64_t * const upper = elias_fano->upper.bits;
+	const int l = elias_fano->l;
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) __builtin_prefetch(&lower[index[i + j] * l / 64]);
+		simple_select_select_batch(&elias_fano->upper, index + i, start + i, b);
+		for (int j = 0; j < b; j++) {
+			const uint64_t k = index[i + j], position = start[i + j];
+			start[i + j] = position - k << l | elias_fano_lower_bits(lower, l, k);
+			end[i + j] = next_one(upper, position) - k - 1 << l | elias_fano_lower_bits(lower, l, k + 1);
+		}
+	}
+}
+
+void elias_fano_iterator_init(const elias_fano *elias_fano, const uint64_t from, elias_fano_iterator *iterator) {
+	const uint64_t position = simple_select_select(&elias_fano->upper, from);
+	iterator->elias_fano = elias_fano;
+	iterator->upper_zero = NULL;
+	iterator->index = from;
+	iterator->curr = position / 64;
+	iterator->window = elias_fano->upper.bits[iterator->curr] & UINT64_MAX << position % 64;
+}
+
+#if defined(__AVX512VBMI2__) && defined(__BMI2__)
+
+/* Stores in dest the positions of the next n ones of the upper bits, minus their rank. A word
+   at a time, the positions of its ones are compressed into bytes, which are widened eight at
+   a time. */
+static void decode_upper(elias_fano_iterator * const iterator, uint64_t * const dest, const uint64_t n) {
+	const uint64_t * const upper = iterator->elias_fano->upper.bits;
+	const __m512i byte_iota = _mm512_set_epi8(63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	const __m512i iota = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+	uint64_t curr = iterator->curr, window = iterator->window;
+	uint8_t position[64];
+
+	for (uint64_t k = 0; k < n;) {
+		while (window == 0) window = upper[++curr];
+		uint64_t ones = window;
+		int c = __builtin_popcountll(window);
+		if (c > n - k) {
+			// We take just the ones we need
+			ones = _pdep_u64((UINT64_C(1) << n - k) - 1, window);
+			c = n - k;
+		}
+		window ^= ones;
+		_mm512_storeu_si512(position, _mm512_maskz_compress_epi8(ones, byte_iota));
+		// The position of the one of rank index + k + j is curr * 64 + position[j]
+		const __m512i base = _mm512_sub_epi64(_mm512_set1_epi64(curr * 64 - (iterator->index + k)), iota);
+		for (int j = 0; j < c; j += 8) {
+			const __m512i p = _mm512_cvtepu8_epi64(_mm_loadl_epi64((const __m128i *)(position + j)));
+			_mm512_mask_storeu_epi64(dest + k + j, c - j >= 8 ? 0xFF : (1 << c - j) - 1, _mm512_sub_epi64(_mm512_add_epi64(base, p), _mm512_set1_epi64(j)));
+		}
+		k += c;
+	}
+
+	iterator->curr = curr;
+	iterator->window = window;
+}
+
+/* Shifts left by l the n values in dest and combines them with the lower bits of the elements
+   starting at index from. Eight lower-bits fields at a time are moved into place by a shuffle
+   of the (at most nine) words containing them and a variable shift. */
+static void decode_lower(const elias_fano * const elias_fano, const uint64_t from, uint64_t * const dest, const uint64_t n) {
+	const int l = elias_fano->l;
+	if (l == 0) return;
+	const uint64_t * const lower = elias_fano->lower_bits;
+	const uint64_t lower_bits_length = elias_fano->lower_bits_length;
+	const __m512i iota_l = _mm512_set_epi64(7 * l, 6 * l, 5 * l, 4 * l, 3 * l, 2 * l, l, 0);
+	const __m512i sixty_four = _mm512_set1_epi64(64), one = _mm512_set1_epi64(1), mask = _mm512_set1_epi64((UINT64_C(1) << l) - 1), shift = _mm512_set1_epi64(l);
+	uint64_t start = from * l;
+
+	for (uint64_t j = 0; j < n; j += 8, start += 8 * l) {
+		const uint64_t w = start / 64;
+		// Loads are masked so as not to read past the end of the lower bits
+		const __mmask8 a_mask = lower_bits_length - w >= 8 ? 0xFF : (1 << lower_bits_length - w) - 1;
+		const __mmask8 b_mask = lower_bits_length - w <= 8 ? 0 : lower_bits_length - w >= 16 ? 0xFF : (1 << lower_bits_length - w - 8) - 1;
+		const __m512i a = _mm512_maskz_loadu_epi64(a_mask, lower + w);
+		const __m512i b = _mm512_maskz_loadu_epi64(b_mask, lower + w + 8);
+		const __m512i offset = _mm512_add_epi64(_mm512_set1_epi64(start % 64), iota_l);
+		const __m512i q = _mm512_srli_epi64(offset, 6), r = _mm512_and_si512(offset, _mm512_set1_epi64(63));
+		const __m512i lo = _mm512_permutex2var_epi64(a, q, b), hi = _mm512_permutex2var_epi64(a, _mm512_add_epi64(q, one), b);
+		// A shift by 64 yields zero, as needed when a field does not cross a word boundary
+		const __m512i bits = _mm512_and_si512(_mm512_or_si512(_mm512_srlv_epi64(lo, r), _mm512_sllv_epi64(hi, _mm512_sub_epi64(sixty_four, r))), mask);
+		const __mmask8 m = n - j >= 8 ? 0xFF : (1 << n - j) - 1;
+		const __m512i upper = _mm512_maskz_loadu_epi64(m, dest + j);
+		_mm512_mask_storeu_epi64(dest + j, m, _mm512_or_si512(_mm512_sllv_epi64(upper, shift), bits));
+	}
+}
+
+#else
+
+static void decode_upper(elias_fano_iterator * const iterator, uint64_t * const dest, const uint64_t n) {
+	const uint64_t * const upper = iterator->elias_fano->upper.bits;
+	uint64_t curr = iterator->curr, window = iterator->window;
+	const uint64_t index = iterator->index;
+
+	for (uint64_t k = 0; k < n; k++) {
+		while (window == 0) window = upper[++curr];
+		dest[k] = curr * 64 + __builtin_ctzll(window) - (index + k);
+		window &= window - 1;
+	}
+
+	iterator->curr = curr;
+	iterator->window = window;
+}
+
+static void decode_lower(const elias_fano * const elias_fano, const uint64_t from, uint64_t * const dest, const uint64_t n) {
+	const int l = elias_fano->l;
+	if (l == 0) return;
+	const uint64_t * const lower = elias_fano->lower_bits;
+	for (uint64_t j = 0; j < n; j++) dest[j] = dest[j] << l | elias_fano_lower_bits(lower, l, from + j);
+}
+
+#endif
+
+uint64_t elias_fano_iterator_next(elias_fano_iterator *iterator, uint64_t *dest, uint64_t n) {
+	const elias_fano * const elias_fano = iterator->elias_fano;
+	if (n > elias_fano->length - iterator->index) n = elias_fano->length - iterator->index;
+	// Two passes keep the loops simple; on blocks of a few hundred elements, dest stays in cache
+	decode_upper(iterator, dest, n);
+	decode_lower(elias_fano, iterator->index, dest, n);
+	iterator->index += n;
+	return n;
+}
+
+/* Returns the position following the zero of rank k among the bits from pos on. */
+static inline uint64_t skip_zeroes(const uint64_t * const bits, const uint64_t pos, uint64_t k) {
+	uint64_t word_index = pos / 64;
+	uint64_t word = ~bits[word_index] & UINT64_MAX << pos % 64;
+
+	for (;;) {
+		const uint64_t bit_count = __builtin_popcountll(word);
+		if (k < bit_count) break;
+		word = ~bits[++word_index];
+		k -= bit_count;
+	}
+
+	return word_index * 64 + select64(word, k) + 1;
+}
+
+uint64_t elias_fano_iterator_skip_to(elias_fano_iterator *iterator, const uint64_t lower_bound) {
+	const elias_fano * const elias_fano = iterator->elias_fano;
+	const uint64_t length = elias_fano->length;
+	if (iterator->index == length) return UINT64_MAX;
+	const uint64_t * const upper = elias_fano->upper.bits;
+	const uint64_t * const lower = elias_fano->lower_bits;
+	const int l = elias_fano->l;
+	uint64_t curr = iterator->curr, window = iterator->window, index = iterator->index, v;
+
+	while (window == 0) window = upper[++curr];
+	const uint64_t zeros = lower_bound >> l, position = curr * 64 + __builtin_ctzll(window);
+
+	if (zeros > position - index) {
+		// The upper bits contain as many zeroes as the buckets of the values up to the sentinel
+		if (zeros >= elias_fano->upper.length - elias_fano->upper.num_ones) {
+			iterator->index = length;
+			return UINT64_MAX;
+		}
+		// We must get past zeros - (position - index) zeroes
+		const uint64_t skip = zeros - (position - index);
+		const uint64_t p = iterator->upper_zero != NULL && skip >= SKIP_THRESHOLD ? simple_select_select(iterator->upper_zero, zeros - 1) + 1 : skip_zeroes(upper, position, skip - 1);
+		curr = p / 64;
+		window = upper[curr] & UINT64_MAX << p % 64;
+		index = p - zeros;
+	}
+
+	for (;;) {
+		while (window == 0) window = upper[++curr];
+		// The sentinel stops the scan
+		if (index == length) {
+			v = UINT64_MAX;
+			break;
+		}
+		v = curr * 64 + __builtin_ctzll(window) - index << l | elias_fano_lower_bits(lower, l, index);
+		if (v >= lower_bound) break;
+		window &= window - 1;
+		index++;
+	}
+
+	iterator->curr = curr;
+	iterator->window = window;
+	iterator->index = index;
+	return v;
+}
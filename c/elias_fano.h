@@ -0,0 +1,94 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ELIAS_FANO_H_INCLUDED
+#define ELIAS_FANO_H_INCLUDED
+
+#include <inttypes.h>
+#include "simple_select.h"
+
+/* A view of an Elias-Fano monotone list dump (see EliasFanoMonotoneLongBigList.dump() in Java). */
+typedef struct {
+	uint64_t length;
+	int l; // The number of lower bits
+	uint64_t lower_bits_length;
+	const uint64_t *lower_bits;
+	simple_select upper; // The upper bits, with a sentinel one after the last element
+	void *map; // The mapping, if loaded by load_elias_fano()
+	uint64_t map_length;
+} elias_fano;
+
+/* An iterator over an Elias-Fano list, decoding elements in blocks. */
+typedef struct {
+	const elias_fano *elias_fano;
+	const simple_select *upper_zero; // Selects the zeroes of the upper bits on long skips, if not NULL
+	uint64_t index; // The index of the next element
+	uint64_t curr; // The index of the current word of the upper bits
+	uint64_t window; // The ones of the current word that have not been returned yet
+} elias_fano_iterator;
+
+/* Maps a dump in memory (no copy), with no validation (see elias_fano_validate());
+   returns NULL if the dump is not an Elias-Fano dump. */
+elias_fano *load_elias_fano(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_elias_fano(const void *dump, uint64_t length, elias_fano *elias_fano);
+/* Fills a view of a list embedded in a dump already checked by dump_map_header(), whose
+   parameters and sections start at the given indices; returns zero on success. */
+int map_elias_fano_at(const void *dump, int param, int section, elias_fano *elias_fano);
+/* Checks the selection structure on the upper bits and the size of the lower bits; returns zero if valid. */
+int elias_fano_validate(const elias_fano *elias_fano);
+/* Maps a dump and validates it (see elias_fano_validate()); returns NULL if the dump is not valid. */
+elias_fano *load_elias_fano_validated(int h);
+/* Maps a dump and starts verifying it in the background (see dump.h). */
+elias_fano *load_elias_fano_verify(int h, dump_verifier *verifier);
+/* Returns the element of given index, which must be smaller than the length. */
+uint64_t elias_fano_get(const elias_fano *elias_fano, uint64_t index);
+/* Stores in dest the elements of index in [from, to), which must be contained in [0, length]. */
+void elias_fano_get_range(const elias_fano *elias_fano, uint64_t from, uint64_t to, uint64_t *dest);
+/* Stores in dest the elements of the n given indices, prefetching groups of indices. */
+void elias_fano_get_batch(const elias_fano *elias_fano, const uint64_t *index, uint64_t *dest, uint64_t n);
+/* Stores in start and end the elements of index index and index + 1, which must not be larger than
+   the length, with a single selection; on the dump of a prefix-sum list (see
+   EliasFanoPrefixSumLongBigList in Java), they delimit the interval [start, end) of element index. */
+void elias_fano_get_pair(const elias_fano *elias_fano, uint64_t index, uint64_t *start, uint64_t *end);
+/* Stores in start and end the pairs of elements of the n given indices, prefetching groups of indices. */
+void elias_fano_get_pair_batch(const elias_fano *elias_fano, const uint64_t *index, uint64_t *start, uint64_t *end, uint64_t n);
+/* Positions an iterator before the element of index from, which must not be larger than the length. */
+void elias_fano_iterator_init(const elias_fano *elias_fano, uint64_t from, elias_fano_iterator *iterator);
+/* Stores in dest the next n elements, or the remaining ones if they are fewer, and returns
+   their number; blocks of a few hundred elements are decoded with vector instructions, if available. */
+uint64_t elias_fano_iterator_next(elias_fano_iterator *iterator, uint64_t *dest, uint64_t n);
+/* Moves the iterator before the first element greater than or equal to lower_bound that is not
+   before the next one, and returns it, or UINT64_MAX if there is no such element (in which case
+   the iterator is exhausted). Zeroes are counted word by word in the upper bits, or selected on
+   long skips if the iterator has a selection structure on zeroes. */
+uint64_t elias_fano_iterator_skip_to(elias_fano_iterator *iterator, uint64_t lower_bound);
+
+/* Returns the lower bits of the element of given index (the sentinel has index length). */
+static inline uint64_t elias_fano_lower_bits(const uint64_t * const lower_bits, const int l, const uint64_t index) {
+	const uint64_t position = index * l;
+	const uint64_t start_word = position / 64;
+	const int start_bit = position % 64;
+	uint64_t result = lower_bits[start_word] >> start_bit;
+	if (start_bit + l > 64) result |= lower_bits[start_word + 1] << 64 - start_bit;
+	return result & (UINT64_C(1) << l) - 1;
+}
+
+#endif /* ELIAS_FANO_H_INCLUDED */
@@ -0,0 +1,219 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "elias_fano_indexed.h"
+
+int map_elias_fano_indexed(const void *dump, const uint64_t length, elias_fano_indexed *elias_fano_indexed) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_ELIAS_FANO_INDEXED || header->num_sections != 8) return -1;
+	return map_elias_fano_indexed_at(dump, 0, 0, elias_fano_indexed);
+}
+
+int map_elias_fano_indexed_at(const void *dump, const int param, const int section, elias_fano_indexed *elias_fano_indexed) {
+	const dump_header * const header = dump;
+	if (param + 10 > DUMP_MAX_PARAMS || section + 8 > (int)header->num_sections) return -1;
+	memset(elias_fano_indexed, 0, sizeof *elias_fano_indexed);
+	if (map_elias_fano_at(dump, param, section, &elias_fano_indexed->elias_fano) != 0) return -1;
+	elias_fano_indexed->first_element = header->param[param + 8];
+	elias_fano_indexed->last_element = header->param[param + 9];
+	// The selection structure on zeroes uses the upper bits of the list
+	return map_simple_select_inventories_at(dump, 1, param + 5, section + 1, section + 5, &elias_fano_indexed->upper_zero);
+}
+
+int elias_fano_indexed_validate(const elias_fano_indexed *elias_fano_indexed) {
+	const elias_fano * const elias_fano = &elias_fano_indexed->elias_fano;
+	if (elias_fano_validate(elias_fano) != 0) return -1;
+	if (elias_fano_indexed->upper_zero.length != elias_fano->upper.length || simple_select_validate(&elias_fano_indexed->upper_zero) != 0) return -1;
+	if (elias_fano->length == 0) return elias_fano_indexed->first_element == INT64_MAX && elias_fano_indexed->last_element == UINT64_MAX ? 0 : -1;
+	if (elias_fano_indexed->first_element != elias_fano_get(elias_fano, 0) || elias_fano_indexed->last_element != elias_fano_get(elias_fano, elias_fano->length - 1)) return -1;
+	// Predecessors select the zero following the upper bits of the last element
+	return elias_fano_indexed->upper_zero.num_ones > elias_fano_indexed->last_element >> elias_fano->l ? 0 : -1;
+}
+
+elias_fano_indexed *load_elias_fano_indexed(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	elias_fano_indexed *elias_fano_indexed = malloc(sizeof *elias_fano_indexed);
+	if (elias_fano_indexed == NULL || map_elias_fano_indexed(map, length, elias_fano_indexed) != 0) {
+		free(elias_fano_indexed);
+		munmap(map, length);
+		return NULL;
+	}
+	elias_fano_indexed->map = map;
+	elias_fano_indexed->map_length = length;
+	return elias_fano_indexed;
+}
+
+static int validate(const void *elias_fano_indexed) {
+	return elias_fano_indexed_validate(elias_fano_indexed);
+}
+
+elias_fano_indexed *load_elias_fano_indexed_validated(int h) {
+	elias_fano_indexed *elias_fano_indexed = load_elias_fano_indexed(h);
+	if (elias_fano_indexed == NULL) return NULL;
+	if (elias_fano_indexed_validate(elias_fano_indexed) == 0) return elias_fano_indexed;
+	munmap(elias_fano_indexed->map, elias_fano_indexed->map_length);
+	free(elias_fano_indexed);
+	return NULL;
+}
+
+elias_fano_indexed *load_elias_fano_indexed_verify(int h, dump_verifier *verifier) {
+	elias_fano_indexed *elias_fano_indexed = load_elias_fano_indexed(h);
+	if (elias_fano_indexed == NULL) return NULL;
+	const dump_header * const header = elias_fano_indexed->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)elias_fano_indexed->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, elias_fano_indexed) == 0) return elias_fano_indexed;
+	munmap(elias_fano_indexed->map, elias_fano_indexed->map_length);
+	free(elias_fano_indexed);
+	return NULL;
+}
+
+/* Returns the first element greater than or equal to lower_bound, which must be in
+   (first_element..last_element]; as in Java, we select the zero preceding the upper bits
+   of lower_bound and scan the ones that follow. */
+static inline uint64_t successor_unsafe(const elias_fano_indexed * const elias_fano_indexed, const uint64_t lower_bound, uint64_t * const index) {
+	const elias_fano * const elias_fano = &elias_fano_indexed->elias_fano;
+	const uint64_t * const upper = elias_fano->upper.bits;
+	const int l = elias_fano->l;
+	const uint64_t zeros = lower_bound >> l;
+	const uint64_t position = zeros == 0 ? 0 : simple_select_select(&elias_fano_indexed->upper_zero, zeros - 1) + 1;
+	uint64_t curr = position / 64;
+	uint64_t window = upper[curr] & UINT64_MAX << position % 64;
+	uint64_t rank = position - zeros;
+
+	for (;;) {
+		while (window == 0) window = upper[++curr];
+		const uint64_t v = curr * 64 + __builtin_ctzll(window) - rank << l | elias_fano_lower_bits(elias_fano->lower_bits, l, rank);
+		if (v >= lower_bound) {
+			*index = rank;
+			return v;
+		}
+		window &= window - 1;
+		rank++;
+	}
+}
+
+/* Returns the last element smaller than upper_bound, which must be in (first_element..last_element];
+   as in Java, we select the zero following the upper bits of upper_bound and scan backwards. */
+static inline uint64_t predecessor_unsafe(const elias_fano_indexed * const elias_fano_indexed, const uint64_t upper_bound, uint64_t * const index) {
+	const elias_fano * const elias_fano = &elias_fano_indexed->elias_fano;
+	const uint64_t * const upper = elias_fano->upper.bits;
+	const int l = elias_fano->l;
+	const uint64_t zeros = upper_bound >> l;
+	const uint64_t upper_bound_lower_bits = upper_bound & (UINT64_C(1) << l) - 1;
+	uint64_t position = simple_select_select(&elias_fano_indexed->upper_zero, zeros) - 1;
+	uint64_t rank = position - zeros;
+
+	for (;;) {
+		const uint64_t lower = elias_fano_lower_bits(elias_fano->lower_bits, l, rank);
+		if ((upper[position / 64] & UINT64_C(1) << position % 64) == 0) {
+			// No smaller element has the upper bits of upper_bound: we look for the previous one
+			uint64_t curr = position / 64;
+			uint64_t window = upper[curr] & (UINT64_C(1) << position % 64) - 1;
+			while (window == 0) window = upper[--curr];
+			*index = rank;
+			return curr * 64 + 63 - __builtin_clzll(window) - rank << l | lower;
+		}
+		if (lower < upper_bound_lower_bits) {
+			*index = rank;
+			return zeros << l | lower;
+		}
+		position--;
+		rank--;
+	}
+}
+
+uint64_t elias_fano_indexed_successor(const elias_fano_indexed *elias_fano_indexed, const uint64_t lower_bound, uint64_t *index) {
+	if (elias_fano_indexed->elias_fano.length == 0 || lower_bound > elias_fano_indexed->last_element) {
+		*index = elias_fano_indexed->elias_fano.length;
+		return UINT64_MAX;
+	}
+	if (lower_bound <= elias_fano_indexed->first_element) {
+		*index = 0;
+		return elias_fano_indexed->first_element;
+	}
+	return successor_unsafe(elias_fano_indexed, lower_bound, index);
+}
+
+uint64_t elias_fano_indexed_strict_successor(const elias_fano_indexed *elias_fano_indexed, const uint64_t lower_bound, uint64_t *index) {
+	if (elias_fano_indexed->elias_fano.length == 0 || lower_bound >= elias_fano_indexed->last_element) {
+		*index = elias_fano_indexed->elias_fano.length;
+		return UINT64_MAX;
+	}
+	if (lower_bound < elias_fano_indexed->first_element) {
+		*index = 0;
+		return elias_fano_indexed->first_element;
+	}
+	return successor_unsafe(elias_fano_indexed, lower_bound + 1, index);
+}
+
+uint64_t elias_fano_indexed_predecessor(const elias_fano_indexed *elias_fano_indexed, const uint64_t upper_bound, uint64_t *index) {
+	if (elias_fano_indexed->elias_fano.length == 0 || upper_bound <= elias_fano_indexed->first_element) return *index = UINT64_MAX;
+	if (upper_bound > elias_fano_indexed->last_element) {
+		*index = elias_fano_indexed->elias_fano.length - 1;
+		return elias_fano_indexed->last_element;
+	}
+	return predecessor_unsafe(elias_fano_indexed, upper_bound, index);
+}
+
+uint64_t elias_fano_indexed_weak_predecessor(const elias_fano_indexed *elias_fano_indexed, const uint64_t upper_bound, uint64_t *index) {
+	if (elias_fano_indexed->elias_fano.length == 0 || upper_bound < elias_fano_indexed->first_element) return *index = UINT64_MAX;
+	if (upper_bound >= elias_fano_indexed->last_element) {
+		*index = elias_fano_indexed->elias_fano.length - 1;
+		return elias_fano_indexed->last_element;
+	}
+	return predecessor_unsafe(elias_fano_indexed, upper_bound + 1, index);
+}
+
+uint64_t elias_fano_indexed_index_of(const elias_fano_indexed *elias_fano_indexed, const uint64_t x) {
+	if (elias_fano_indexed->elias_fano.length == 0 || x < elias_fano_indexed->first_element || x > elias_fano_indexed->last_element) return UINT64_MAX;
+	if (x == elias_fano_indexed->first_element) return 0;
+	uint64_t index;
+	return successor_unsafe(elias_fano_indexed, x, &index) == x ? index : UINT64_MAX;
+}
+
+int elias_fano_indexed_contains(const elias_fano_indexed *elias_fano_indexed, const uint64_t x) {
+	return elias_fano_indexed_index_of(elias_fano_indexed, x) != UINT64_MAX;
+}
+
+void elias_fano_indexed_iterator_init(const elias_fano_indexed *elias_fano_indexed, const uint64_t from, elias_fano_iterator *iterator) {
+	elias_fano_iterator_init(&elias_fano_indexed->elias_fano, from, iterator);
+	iterator->upper_zero = &elias_fano_indexed->upper_zero;
+}
+
+void elias_fano_indexed_successor_sorted(const elias_fano_indexed *elias_fano_indexed, const uint64_t *lower_bound, uint64_t *index, uint64_t *dest, const uint64_t n) {
+	elias_fano_iterator iterator;
+	elias_fano_indexed_iterator_init(elias_fano_indexed, 0, &iterator);
+	for (uint64_t i = 0; i < n; i++) {
+		// The iterator does not move past a successor, so we can skip only if it is too small
+		if (i != 0 && lower_bound[i] <= dest[i - 1]) {
+			dest[i] = dest[i - 1];
+			index[i] = index[i - 1];
+			continue;
+		}
+		dest[i] = elias_fano_iterator_skip_to(&iterator, lower_bound[i]);
+		index[i] = iterator.index;
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef ELIAS_FANO_INDEXED_H_INCLUDED
+#define ELIAS_FANO_INDEXED_H_INCLUDED
+
+#include <inttypes.h>
+#include "elias_fano.h"
+
+/* A view of an indexed Elias-Fano monotone list dump (see EliasFanoIndexedMonotoneLongBigList.dump()
+   in Java). Successors return UINT64_MAX and set the index to the length of the list if there is
+   no such element; predecessors return UINT64_MAX and set the index to UINT64_MAX. */
+typedef struct {
+	elias_fano elias_fano;
+	simple_select upper_zero; // Selects the zeroes of the upper bits, which are shared with elias_fano.upper
+	uint64_t first_element; // INT64_MAX if the list is empty, as in Java
+	uint64_t last_element; // UINT64_MAX if the list is empty, as in Java
+	void *map; // The mapping, if loaded by load_elias_fano_indexed()
+	uint64_t map_length;
+} elias_fano_indexed;
+
+/* Maps a dump in memory (no copy), with no validation (see elias_fano_indexed_validate());
+   returns NULL if the dump is not an indexed Elias-Fano dump. */
+elias_fano_indexed *load_elias_fano_indexed(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_elias_fano_indexed(const void *dump, uint64_t length, elias_fano_indexed *elias_fano_indexed);
+/* Fills a view of a list embedded in a dump already checked by dump_map_header(), whose
+   parameters and sections start at the given indices; returns zero on success. */
+int map_elias_fano_indexed_at(const void *dump, int param, int section, elias_fano_indexed *elias_fano_indexed);
+/* Checks the list, the selection structure on zeroes and the first and last element; returns zero if valid. */
+int elias_fano_indexed_validate(const elias_fano_indexed *elias_fano_indexed);
+/* Maps a dump and validates it (see elias_fano_indexed_validate()); returns NULL if the dump is not valid. */
+elias_fano_indexed *load_elias_fano_indexed_validated(int h);
+/* Maps a dump and starts verifying it in the background (see dump.h). */
+elias_fano_indexed *load_elias_fano_indexed_verify(int h, dump_verifier *verifier);
+/* Returns the first element greater than or equal to lower_bound, storing its index in index. */
+uint64_t elias_fano_indexed_successor(const elias_fano_indexed *elias_fano_indexed, uint64_t lower_bound, uint64_t *index);
+/* Returns the first element greater than lower_bound, storing its index in index. */
+uint64_t elias_fano_indexed_strict_successor(const elias_fano_indexed *elias_fano_indexed, uint64_t lower_bound, uint64_t *index);
+/* Returns the last element smaller than upper_bound, storing its index in index. */
+uint64_t elias_fano_indexed_predecessor(const elias_fano_indexed *elias_fano_indexed, uint64_t upper_bound, uint64_t *index);
+/* Returns the last element smaller than or equal to upper_bound, storing its index in index. */
+uint64_t elias_fano_indexed_weak_predecessor(const elias_fano_indexed *elias_fano_indexed, uint64_t upper_bound, uint64_t *index);
+/* Returns the index of the first occurrence of x, or UINT64_MAX if x does not occur in the list. */
+uint64_t elias_fano_indexed_index_of(const elias_fano_indexed *elias_fano_indexed, uint64_t x);
+/* Returns whether x occurs in the list. */
+int elias_fano_indexed_contains(const elias_fano_indexed *elias_fano_indexed, uint64_t x);
+/* Positions an iterator before the element of index from, which must not be larger than the
+   length; elias_fano_iterator_skip_to() will select zeroes on long skips. */
+void elias_fano_indexed_iterator_init(const elias_fano_indexed *elias_fano_indexed, uint64_t from, elias_fano_iterator *iterator);
+/* Stores in dest and index the successors of the n given nondecreasing lower bounds, and their
+   indices, skipping forward with an iterator from the previous successor. */
+void elias_fano_indexed_successor_sorted(const elias_fano_indexed *elias_fano_indexed, const uint64_t *lower_bound, uint64_t *index, uint64_t *dest, uint64_t n);
+
+#endif /* ELIAS_FANO_INDEXED_H_INCLUDED */
@@ -0,0 +1,133 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "file_lines.h"
+#include "dump.h"
+
+#define BATCH 64
+
+int map_file_lines(const void *dump, const uint64_t length, const char *text, const uint64_t text_length, file_lines *file_lines) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_FILE_LINES || header->num_sections != 5) return -1;
+	// The file must be the one the dump was built on
+	if (header->param[5] != text_length) return -1;
+	memset(file_lines, 0, sizeof *file_lines);
+	file_lines->text_length = text_length;
+	file_lines->terminators = header->param[6];
+	file_lines->text = text;
+	if (map_elias_fano_at(dump, 0, 0, &file_lines->borders) != 0) return -1;
+	file_lines->size = file_lines->borders.length;
+	return 0;
+}
+
+int file_lines_validate(const file_lines *file_lines) {
+	if (elias_fano_validate(&file_lines->borders) != 0) return -1;
+	if (file_lines->size == 0) return 0;
+	// Offsets are nondecreasing, so a sentinel equal to the length bounds all lines
+	uint64_t start, end;
+	elias_fano_get_pair(&file_lines->borders, file_lines->size - 1, &start, &end);
+	return end == file_lines->text_length ? 0 : -1;
+}
+
+file_lines *load_file_lines(int h, int text) {
+	uint64_t length, text_length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	// An empty text cannot be mapped; other failures are caught by the length check
+	void * const text_map = dump_map(text, &text_length);
+	if (text_map == NULL) text_length = 0;
+	file_lines *file_lines = malloc(sizeof *file_lines);
+	if (file_lines == NULL || map_file_lines(map, length, text_map, text_length, file_lines) != 0) {
+		free(file_lines);
+		if (text_map != NULL) munmap(text_map, text_length);
+		munmap(map, length);
+		return NULL;
+	}
+	file_lines->map = map;
+	file_lines->map_length = length;
+	file_lines->text_map = text_map;
+	return file_lines;
+}
+
+static void release(file_lines *file_lines) {
+	if (file_lines->text_map != NULL) munmap(file_lines->text_map, file_lines->text_length);
+	munmap(file_lines->map, file_lines->map_length);
+	free(file_lines);
+}
+
+static int validate(const void *file_lines) {
+	return file_lines_validate(file_lines);
+}
+
+file_lines *load_file_lines_validated(int h, int text) {
+	file_lines *file_lines = load_file_lines(h, text);
+	if (file_lines == NULL) return NULL;
+	if (file_lines_validate(file_lines) == 0) return file_lines;
+	release(file_lines);
+	return NULL;
+}
+
+file_lines *load_file_lines_verify(int h, int text, dump_verifier *verifier) {
+	file_lines *file_lines = load_file_lines(h, text);
+	if (file_lines == NULL) return NULL;
+	const dump_header * const header = file_lines->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)file_lines->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, file_lines) == 0) return file_lines;
+	release(file_lines);
+	return NULL;
+}
+
+/* Returns the length of the line in [start, end) without its terminator. */
+static inline uint64_t strip(const file_lines *file_lines, const uint64_t start, uint64_t end) {
+	const char * const text = file_lines->text;
+	if (end == start) return 0;
+	if (text[end - 1] == '\n') {
+		if ((file_lines->terminators & FILE_LINES_CR_LF) && end - start >= 2 && text[end - 2] == '\r') return end - start - 2;
+		if (file_lines->terminators & FILE_LINES_LF) return end - start - 1;
+	}
+	else if (text[end - 1] == '\r' && (file_lines->terminators & FILE_LINES_CR)) return end - start - 1;
+	return end - start;
+}
+
+const char *file_lines_get(const file_lines *file_lines, const uint64_t index, uint64_t *len) {
+	uint64_t start, end;
+	elias_fano_get_pair(&file_lines->borders, index, &start, &end);
+	*len = strip(file_lines, start, end);
+	return file_lines->text + start;
+}
+
+void file_lines_get_batch(const file_lines *file_lines, const uint64_t *index, const char **line, uint64_t *len, const uint64_t n) {
+	uint64_t start[BATCH], end[BATCH];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		elias_fano_get_pair_batch(&file_lines->borders, index + i, start, end, b);
+		// The terminator is read at the end of the line, which is usually in the same cache line
+		for (int j = 0; j < b; j++) __builtin_prefetch(file_lines->text + end[j] - (end[j] != start[j]));
+		for (int j = 0; j < b; j++) {
+			len[i + j] = strip(file_lines, start[j], end[j]);
+			line[i + j] = file_lines->text + start[j];
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FILE_LINES_H_INCLUDED
+#define FILE_LINES_H_INCLUDED
+
+#include <inttypes.h>
+#include "elias_fano.h"
+
+// Line terminators, as recorded by FileLinesBigList.dump() in Java
+#define FILE_LINES_CR 1
+#define FILE_LINES_LF 2
+#define FILE_LINES_CR_LF 4
+
+/* A view of the lines of a text file, given a dump of the offsets of their starts (see
+   FileLinesBigList.dump() in Java) and the file itself. Lines are returned as pointers into the
+   text, with no copy and no terminator; once the view is validated, the offsets of all lines
+   are known to lie within the text, so lookups need no bound checks. */
+typedef struct {
+	uint64_t size; // The number of lines
+	uint64_t text_length; // The length of the text file
+	int terminators; // A mask of FILE_LINES_CR, FILE_LINES_LF and FILE_LINES_CR_LF
+	elias_fano borders; // The starts of the lines, with the length of the text as sentinel
+	const char *text;
+	void *map; // The mapping of the dump, if loaded by load_file_lines()
+	uint64_t map_length;
+	void *text_map; // The mapping of the text, if loaded by load_file_lines()
+} file_lines;
+
+/* Maps a dump and the text file it describes in memory (no copy), with no validation (see
+   file_lines_validate()); returns NULL if the dump is not a file-lines dump for the text. */
+file_lines *load_file_lines(int h, int text);
+/* Fills a view of a dump and of a text mapped in memory; returns zero on success. */
+int map_file_lines(const void *dump, uint64_t length, const char *text, uint64_t text_length, file_lines *file_lines);
+/* Checks the list of offsets, and that its sentinel is the length of the text; returns zero if valid. */
+int file_lines_validate(const file_lines *file_lines);
+/* Maps a dump and its text file and validates them (see file_lines_validate()); returns NULL if
+   the dump is not valid. */
+file_lines *load_file_lines_validated(int h, int text);
+/* Maps a dump and its text file and starts verifying them in the background (see dump.h). */
+file_lines *load_file_lines_verify(int h, int text, dump_verifier *verifier);
+/* Returns a pointer to the line of given index, which must be smaller than the number of lines,
+   and stores its length, terminator excluded, in len. */
+const char *file_lines_get(const file_lines *file_lines, uint64_t index, uint64_t *len);
+/* Stores in line and len the lines of the n given indices, prefetching groups of offsets and
+   then the starts of the lines. */
+void file_lines_get_batch(const file_lines *file_lines, const uint64_t *index, const char **line, uint64_t *len, uint64_t n);
+
+#endif /* FILE_LINES_H_INCLUDED */
@@ -0,0 +1,85 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "filter.h"
+
+int map_filter(const void *dump, const uint64_t length, filter *filter) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_FILTER || header->num_sections != 2) return -1;
+	if (header->arity != 3 && header->arity != 4) return -1;
+	if (header->width == 0 || header->width > 64) return -1;
+	memset(filter, 0, sizeof *filter);
+	if (map_sf_at(dump, header->width, 0, 0, &filter->sf) != 0) return -1;
+	filter->size = filter->sf.size;
+	filter->global_seed = filter->sf.global_seed;
+	filter->arity = header->arity;
+	filter->fingerprint_width = header->width;
+	filter->fingerprint_mask = UINT64_MAX >> 64 - filter->fingerprint_width;
+	return 0;
+}
+
+filter *load_filter(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	filter *filter = malloc(sizeof *filter);
+	if (filter == NULL || map_filter(map, length, filter) != 0) {
+		free(filter);
+		munmap(map, length);
+		return NULL;
+	}
+	filter->map = map;
+	filter->map_length = length;
+	return filter;
+}
+
+int filter_validate(const filter *filter) {
+	// An empty filter is never probed
+	if (filter->size == 0) return 0;
+	return sf_validate(&filter->sf);
+}
+
+static int validate(const void *filter) {
+	return filter_validate(filter);
+}
+
+filter *load_filter_validated(int h) {
+	filter *filter = load_filter(h);
+	if (filter == NULL) return NULL;
+	if (filter_validate(filter) == 0) return filter;
+	munmap(filter->map, filter->map_length);
+	free(filter);
+	return NULL;
+}
+
+filter *load_filter_verify(int h, dump_verifier *verifier) {
+	filter *filter = load_filter(h);
+	if (filter == NULL) return NULL;
+	const dump_header * const header = filter->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)filter->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, filter) == 0) return filter;
+	munmap(filter->map, filter->map_length);
+	free(filter);
+	return NULL;
+}
@@ -0,0 +1,59 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FILTER_H_INCLUDED
+#define FILTER_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "sf.h"
+
+/* A view of an approximate dictionary dump, that is, a GOV3Function or GOV4Function built using
+   Builder.dictionary(fingerprint_width) in Java: the function maps each key to its fingerprint,
+   the lower fingerprint_width bits of the first word of the signature of the key, so it is an
+   XOR filter. A key is in the set if the XOR of the values at the arity probed positions is
+   equal to its fingerprint; keys not in the set are found to be in the set with probability
+   2^-fingerprint_width. The function is evaluated by the filter3_*() functions (see filter3.h)
+   if arity is 3 and by the filter4_*() functions (see filter4.h) if arity is 4; the variants
+   with a fixed width (e.g., filter3_8_*()) can be used only if fingerprint_width is that width. */
+typedef struct {
+	uint64_t size;
+	uint64_t global_seed;
+	int arity;
+	int fingerprint_width;
+	uint64_t fingerprint_mask;
+	sf sf;
+	void *map; // The mapping, if loaded by load_filter()
+	uint64_t map_length;
+} filter;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a filter dump. */
+filter *load_filter(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_filter(const void *dump, uint64_t length, filter *filter);
+/* Maps a filter and validates it (see filter_validate()); returns NULL if the dump is not valid. */
+filter *load_filter_validated(int h);
+/* Maps a filter and starts verifying it in the background (see dump.h). */
+filter *load_filter_verify(int h, dump_verifier *verifier);
+/* Checks the underlying function (see sf_validate()); returns zero if valid. */
+int filter_validate(const filter *filter);
+
+#endif /* FILTER_H_INCLUDED */
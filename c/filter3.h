@@ -0,0 +1,52 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FILTER3_H_INCLUDED
+#define FILTER3_H_INCLUDED
+
+#include "filter.h"
+
+/* Return 1 if a key is in the set, and 0 otherwise (see filter.h); the batched versions store the
+   answers for n keys in result, probing groups of keys as sf3_get_signature() does, but
+   prefetching first the buckets and then the values of the whole group. The _8 and _16
+   versions read the values with byte and short accesses, and require a fingerprint of that
+   width. */
+int filter3_contains_byte_array(const filter *filter, const char *key, uint64_t len);
+int filter3_contains_uint64_t(const filter *filter, uint64_t key);
+int filter3_contains_signature(const filter *filter, const uint64_t signature[4]);
+void filter3_contains_byte_array_batch(const filter *filter, char * const *key, const int *len, int *result, uint64_t n);
+void filter3_contains_uint64_t_batch(const filter *filter, const uint64_t *key, int *result, uint64_t n);
+void filter3_contains_signature_batch(const filter *filter, const uint64_t (*signature)[4], int *result, uint64_t n);
+
+int filter3_8_contains_byte_array(const filter *filter, const char *key, uint64_t len);
+int filter3_8_contains_uint64_t(const filter *filter, uint64_t key);
+int filter3_8_contains_signature(const filter *filter, const uint64_t signature[4]);
+void filter3_8_contains_byte_array_batch(const filter *filter, char * const *key, const int *len, int *result, uint64_t n);
+void filter3_8_contains_uint64_t_batch(const filter *filter, const uint64_t *key, int *result, uint64_t n);
+void filter3_8_contains_signature_batch(const filter *filter, const uint64_t (*signature)[4], int *result, uint64_t n);
+
+int filter3_16_contains_byte_array(const filter *filter, const char *key, uint64_t len);
+int filter3_16_contains_uint64_t(const filter *filter, uint64_t key);
+int filter3_16_contains_signature(const filter *filter, const uint64_t signature[4]);
+void filter3_16_contains_byte_array_batch(const filter *filter, char * const *key, const int *len, int *result, uint64_t n);
+void filter3_16_contains_uint64_t_batch(const filter *filter, const uint64_t *key, int *result, uint64_t n);
+void filter3_16_contains_signature_batch(const filter *filter, const uint64_t (*signature)[4], int *result, uint64_t n);
+
+#endif /* FILTER3_H_INCLUDED */
@@ -0,0 +1,32 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Direct byte access version of filter3.c for filters with 8-bit fingerprints,
+   usable side by side with the generic version. */
+
+#define FILTER_8
+#define filter3_contains_byte_array filter3_8_contains_byte_array
+#define filter3_contains_uint64_t filter3_8_contains_uint64_t
+#define filter3_contains_signature filter3_8_contains_signature
+#define filter3_contains_byte_array_batch filter3_8_contains_byte_array_batch
+#define filter3_contains_uint64_t_batch filter3_8_contains_uint64_t_batch
+#define filter3_contains_signature_batch filter3_8_contains_signature_batch
+
+#include "filter3.c"
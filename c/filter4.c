@@ -0,0 +1,149 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Membership tests for filters of arity 4 (see filter.h). Defining FILTER_8 or FILTER_16 (see
+   filter4_8.c and filter4_16.c) replaces the extraction of bit blocks with direct byte or short
+   access. */
+
+#include <stdlib.h>
+#include "filter4.h"
+#include "spooky.h"
+
+#define BATCH 16
+#define OFFSET_MASK (UINT64_C(-1) >> 8)
+
+static void inline signature_to_equation(const uint64_t *signature, const uint64_t seed, int num_variables, unsigned int *e) {
+	uint64_t hash[4];
+	spooky_short_rehash(signature, seed, hash);
+	const int shift = __builtin_clzll(num_variables | 1); // Empty buckets yield zero
+	const uint64_t mask = (UINT64_C(1) << shift) - 1;
+	e[0] = ((hash[0] & mask) * num_variables) >> shift;
+	e[1] = ((hash[1] & mask) * num_variables) >> shift;
+	e[2] = ((hash[2] & mask) * num_variables) >> shift;
+	e[3] = ((hash[3] & mask) * num_variables) >> shift;
+}
+
+static inline uint64_t get(const filter *filter, uint64_t pos) {
+#if defined(FILTER_8)
+	return ((const uint8_t *)filter->sf.array)[pos];
+#elif defined(FILTER_16)
+	return ((const uint16_t *)filter->sf.array)[pos];
+#else
+	const int width = filter->fingerprint_width;
+	pos *= width;
+	const int l = 64 - width;
+	const uint64_t start_word = pos / 64;
+	const int start_bit = pos % 64;
+	if (start_bit <= l) return filter->sf.array[start_word] << l - start_bit >> l;
+	return filter->sf.array[start_word] >> start_bit | filter->sf.array[start_word + 1] << 64 + l - start_bit >> l;
+#endif
+}
+
+/* The address of the word containing (the start of) a value, for prefetching. */
+static inline const void *address(const filter *filter, const uint64_t pos) {
+#if defined(FILTER_8)
+	return (const uint8_t *)filter->sf.array + pos;
+#elif defined(FILTER_16)
+	return (const uint16_t *)filter->sf.array + pos;
+#else
+	return filter->sf.array + pos * filter->fingerprint_width / 64;
+#endif
+}
+
+static inline uint64_t fingerprint_mask(const filter *filter) {
+#if defined(FILTER_8)
+	(void)filter;
+	return UINT8_MAX;
+#elif defined(FILTER_16)
+	(void)filter;
+	return UINT16_MAX;
+#else
+	return filter->fingerprint_mask;
+#endif
+}
+
+int filter4_contains_signature(const filter *filter, const uint64_t signature[4]) {
+	if (filter->size == 0) return 0;
+	const int bucket = ((__uint128_t)(signature[0] >> 1) * (__uint128_t)filter->sf.multiplier) >> 64;
+	const uint64_t offset_seed = filter->sf.offset_and_seed[bucket];
+	const uint64_t bucket_offset = offset_seed & OFFSET_MASK;
+	const int num_variables = (filter->sf.offset_and_seed[bucket + 1] & OFFSET_MASK) - bucket_offset;
+	unsigned int e[4];
+	signature_to_equation(signature, offset_seed & ~OFFSET_MASK, num_variables, e);
+	return ((get(filter, e[0] + bucket_offset) ^ get(filter, e[1] + bucket_offset) ^ get(filter, e[2] + bucket_offset) ^ get(filter, e[3] + bucket_offset) ^ signature[0]) & fingerprint_mask(filter)) == 0;
+}
+
+int filter4_contains_byte_array(const filter *filter, const char *key, const uint64_t len) {
+	uint64_t signature[4];
+	spooky_short(key, len, filter->global_seed, signature);
+	return filter4_contains_signature(filter, signature);
+}
+
+int filter4_contains_uint64_t(const filter *filter, const uint64_t key) {
+	uint64_t signature[4];
+	spooky_short(&key, 8, filter->global_seed, signature);
+	return filter4_contains_signature(filter, signature);
+}
+
+/* Answers a group of at most BATCH signatures: the buckets of the whole group are prefetched, then
+   the values at the positions of the equations, and only then the values are combined. */
+static void contains_batch(const filter *filter, const uint64_t (*signature)[4], int *result, const int b) {
+	if (filter->size == 0) {
+		for (int j = 0; j < b; j++) result[j] = 0;
+		return;
+	}
+	uint64_t bucket_offset[BATCH];
+	int bucket[BATCH];
+	unsigned int e[BATCH][4];
+	for (int j = 0; j < b; j++) {
+		bucket[j] = ((__uint128_t)(signature[j][0] >> 1) * (__uint128_t)filter->sf.multiplier) >> 64;
+		__builtin_prefetch(&filter->sf.offset_and_seed[bucket[j]]);
+	}
+	for (int j = 0; j < b; j++) {
+		const uint64_t offset_seed = filter->sf.offset_and_seed[bucket[j]];
+		bucket_offset[j] = offset_seed & OFFSET_MASK;
+		const int num_variables = (filter->sf.offset_and_seed[bucket[j] + 1] & OFFSET_MASK) - bucket_offset[j];
+		signature_to_equation(signature[j], offset_seed & ~OFFSET_MASK, num_variables, e[j]);
+		for (int k = 0; k < 4; k++) __builtin_prefetch(address(filter, e[j][k] + bucket_offset[j]));
+	}
+	for (int j = 0; j < b; j++) result[j] = ((get(filter, e[j][0] + bucket_offset[j]) ^ get(filter, e[j][1] + bucket_offset[j]) ^ get(filter, e[j][2] + bucket_offset[j]) ^ get(filter, e[j][3] + bucket_offset[j]) ^ signature[j][0]) & fingerprint_mask(filter)) == 0;
+}
+
+void filter4_contains_signature_batch(const filter *filter, const uint64_t (*signature)[4], int *result, const uint64_t n) {
+	for (uint64_t i = 0; i < n; i += BATCH) contains_batch(filter, signature + i, result + i, n - i < BATCH ? n - i : BATCH);
+}
+
+void filter4_contains_byte_array_batch(const filter *filter, char * const *key, const int *len, int *result, const uint64_t n) {
+	uint64_t signature[BATCH][4];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) spooky_short(key[i + j], len[i + j], filter->global_seed, signature[j]);
+		contains_batch(filter, (const uint64_t (*)[4])signature, result + i, b);
+	}
+}
+
+void filter4_contains_uint64_t_batch(const filter *filter, const uint64_t *key, int *result, const uint64_t n) {
+	uint64_t signature[BATCH][4];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) spooky_short(&key[i + j], 8, filter->global_seed, signature[j]);
+		contains_batch(filter, (const uint64_t (*)[4])signature, result + i, b);
+	}
+}
@@ -0,0 +1,153 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "lcp_mmphf.h"
+#include "hollow_trie.h"
+
+#define BUFFER_WORDS 32 // Byte arrays shorter than this many words are converted on the stack
+
+static inline int get_bit(const uint64_t * const bits, const uint64_t pos) {
+	return bits[pos / 64] >> pos % 64 & 1;
+}
+
+int map_hollow_trie_at(const void *dump, const int param, const int section, hollow_trie *hollow_trie) {
+	const dump_header * const header = dump;
+	if (param + 6 > DUMP_MAX_PARAMS || section + 7 > (int)header->num_sections) return -1;
+	const char * const base = dump;
+	memset(hollow_trie, 0, sizeof *hollow_trie);
+	hollow_trie->skip_offset = header->param[param];
+	hollow_trie->skip_bits_length = header->section[section].length / sizeof *hollow_trie->skip_bits;
+	hollow_trie->skip_bits = (const uint64_t *)(base + header->section[section].offset);
+	if (map_elias_fano_at(dump, param + 1, section + 1, &hollow_trie->skip_borders) != 0) return -1;
+	// A pair of parentheses for each skip, and the fake pair
+	const uint64_t length = hollow_trie->skip_borders.length;
+	if (length >= UINT64_MAX / 128 || header->section[section + 6].length / sizeof(uint64_t) < (2 * length + 63) / 64) return -1;
+	hollow_trie->trie = balanced_parentheses_build((const uint64_t *)(base + header->section[section + 6].offset), 2 * length);
+	return hollow_trie->trie == NULL ? -1 : 0;
+}
+
+int map_hollow_trie(const void *dump, const uint64_t length, hollow_trie *hollow_trie) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_HOLLOW_TRIE) return -1;
+	if (header->param[0] <= 1) {
+		memset(hollow_trie, 0, sizeof *hollow_trie);
+		hollow_trie->size = header->param[0];
+		return header->num_sections == 0 ? 0 : -1;
+	}
+	if (header->num_sections != 7 || map_hollow_trie_at(dump, 1, 0, hollow_trie) != 0) return -1;
+	hollow_trie->size = header->param[0];
+	return 0;
+}
+
+hollow_trie *load_hollow_trie(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	hollow_trie *hollow_trie = malloc(sizeof *hollow_trie);
+	if (hollow_trie == NULL || map_hollow_trie(map, length, hollow_trie) != 0) {
+		free(hollow_trie);
+		munmap(map, length);
+		return NULL;
+	}
+	hollow_trie->map = map;
+	hollow_trie->map_length = length;
+	return hollow_trie;
+}
+
+int hollow_trie_validate(const hollow_trie *hollow_trie) {
+	const balanced_parentheses * const trie = hollow_trie->trie;
+	if (trie == NULL) return 0;
+	const elias_fano * const borders = &hollow_trie->skip_borders;
+	if (elias_fano_validate(borders) != 0 || borders->length < 2) return -1;
+	// Then the root is internal, and every internal node reached by a lookup has a skip
+	if (balanced_parentheses_find_close(trie, 0) != trie->length - 1) return -1;
+
+	// Skips must be shorter than 64 bits, and lie within the bits
+	elias_fano_iterator iterator;
+	elias_fano_iterator_init(borders, 0, &iterator);
+	uint64_t border[256], prev = 0;
+	for (uint64_t i = 0, r; i < borders->length; i += r) {
+		r = elias_fano_iterator_next(&iterator, border, sizeof border / sizeof *border);
+		for (uint64_t j = 0; j < r; j++) {
+			if (border[j] - prev > 63) return -1;
+			prev = border[j];
+		}
+	}
+	return prev > hollow_trie->skip_bits_length * 64 ? -1 : 0;
+}
+
+static int validate(const void *hollow_trie) {
+	return hollow_trie_validate(hollow_trie);
+}
+
+hollow_trie *load_hollow_trie_validated(int h) {
+	hollow_trie *hollow_trie = load_hollow_trie(h);
+	if (hollow_trie == NULL) return NULL;
+	if (hollow_trie_validate(hollow_trie) == 0) return hollow_trie;
+	munmap(hollow_trie->map, hollow_trie->map_length);
+	free(hollow_trie->trie);
+	free(hollow_trie);
+	return NULL;
+}
+
+hollow_trie *load_hollow_trie_verify(int h, dump_verifier *verifier) {
+	hollow_trie *hollow_trie = load_hollow_trie(h);
+	if (hollow_trie == NULL) return NULL;
+	const dump_header * const header = hollow_trie->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)hollow_trie->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, hollow_trie) == 0) return hollow_trie;
+	munmap(hollow_trie->map, hollow_trie->map_length);
+	free(hollow_trie->trie);
+	free(hollow_trie);
+	return NULL;
+}
+
+int64_t hollow_trie_get_bits(const hollow_trie *hollow_trie, const uint64_t *bits, const uint64_t length) {
+	if (hollow_trie->size <= 1) return (int64_t)hollow_trie->size - 1;
+	const uint64_t * const trie = hollow_trie->trie->bits;
+	uint64_t p = 1, index = 0, s = 0, r = 0;
+
+	for (;;) {
+		if ((s += hollow_trie_skip(hollow_trie, r)) >= length) return -1;
+		if (get_bit(bits, s)) {
+			const uint64_t q = balanced_parentheses_find_close(hollow_trie->trie, p) + 1;
+			r += q - p >> 1;
+			index += q - p >> 1;
+			if (!get_bit(trie, q)) return index;
+			p = q;
+		} else {
+			if (!get_bit(trie, ++p)) return index;
+			r++;
+		}
+		s++;
+	}
+}
+
+int64_t hollow_trie_get_byte_array(const hollow_trie *hollow_trie, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = hollow_trie_get_bits(hollow_trie, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
@@ -0,0 +1,87 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HOLLOW_TRIE_H_INCLUDED
+#define HOLLOW_TRIE_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "elias_fano.h"
+#include "balanced_parentheses.h"
+
+/* A view of a hollow-trie monotone minimal perfect hash function dump (see
+   HollowTrieMonotoneMinimalPerfectHashFunction.dump() in Java). Keys are bit vectors stored as in
+   a LongArrayBitVector. The trie is represented by balanced parentheses following a fake open
+   parenthesis, where internal nodes are open parentheses; the skips of the internal nodes, in
+   preorder, are stored as in an EliasFanoLongBigList, that is, the skips plus an offset are
+   concatenated without their most significant bit, and an Elias-Fano list records the borders.
+   A lookup skips bits of the key and turns left or right at each internal node. */
+typedef struct {
+	uint64_t size;
+	uint64_t skip_offset; // Subtracted from a skip after restoring its most significant bit
+	uint64_t skip_bits_length;
+	const uint64_t *skip_bits; // The skips, without their most significant bit
+	elias_fano skip_borders; // The position of the first bit of each skip, and the end of the bits
+	balanced_parentheses *trie; // Built when mapping; NULL if there are less than two keys
+	void *map; // The mapping, if loaded by load_hollow_trie()
+	uint64_t map_length;
+} hollow_trie;
+
+/* Maps a dump in memory (no copy) and builds the balanced-parentheses directory of the trie;
+   returns NULL if the dump is not a hollow-trie dump. The directory (the trie field) is a single
+   allocation that can be released with free(). */
+hollow_trie *load_hollow_trie(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h), building
+   the directory of the trie; returns zero on success. */
+int map_hollow_trie(const void *dump, uint64_t length, hollow_trie *hollow_trie);
+/* Fills a view of the skips and of the trie embedded in a dump already checked by dump_map_header(),
+   whose parameters and sections start at the given indices (see
+   HollowTrieMonotoneMinimalPerfectHashFunction.dump() in Java), building the directory of the
+   trie; the size is left to the caller. Returns zero on success. */
+int map_hollow_trie_at(const void *dump, int param, int section, hollow_trie *hollow_trie);
+/* Maps a function and validates it (see hollow_trie_validate()); returns NULL if the dump is not valid. */
+hollow_trie *load_hollow_trie_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h). */
+hollow_trie *load_hollow_trie_verify(int h, dump_verifier *verifier);
+/* Checks that there is a skip for each internal node, that skips are shorter than 64 bits and lie
+   within the bits, and that the fake parenthesis encloses the trie; returns zero if valid. */
+int hollow_trie_validate(const hollow_trie *hollow_trie);
+/* Returns the rank of a key of given length in bits, or -1 if the key can be recognized as not
+   belonging to the key set. */
+int64_t hollow_trie_get_bits(const hollow_trie *hollow_trie, const uint64_t *bits, uint64_t length);
+/* As hollow_trie_get_bits(), for a function built using TransformationStrategies.prefixFreeByteArray()
+   (see lcp_mmphf_byte_array_to_bits()). */
+int64_t hollow_trie_get_byte_array(const hollow_trie *hollow_trie, const char *key, uint64_t len);
+
+/* Returns the skip of the internal node of given index in preorder. */
+static inline uint64_t hollow_trie_skip(const hollow_trie * const hollow_trie, const uint64_t index) {
+	uint64_t from, to;
+	elias_fano_get_pair(&hollow_trie->skip_borders, index, &from, &to);
+	const int width = to - from;
+	// The bits might end exactly at from
+	if (width == 0) return 1 - hollow_trie->skip_offset;
+	const uint64_t word = from / 64;
+	const int bit = from % 64;
+	uint64_t skip = hollow_trie->skip_bits[word] >> bit;
+	if (bit + width > 64) skip |= hollow_trie->skip_bits[word + 1] << 64 - bit;
+	return (UINT64_C(1) << width | skip & (UINT64_C(1) << width) - 1) - hollow_trie->skip_offset;
+}
+
+#endif /* HOLLOW_TRIE_H_INCLUDED */
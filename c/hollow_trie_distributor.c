@@ -0,0 +1,236 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "lcp_mmphf.h"
+#include "hollow_trie_distributor.h"
+
+#define LEFT 0
+#define FOLLOW 2
+#define BUFFER_WORDS 32 // Keys shorter than this many words are hashed using a buffer on the stack
+
+static inline int get_bit(const uint64_t * const bits, const uint64_t pos) {
+	return bits[pos / 64] >> pos % 64 & 1;
+}
+
+static inline int64_t get_signature(const sf *sf, const uint64_t signature[4]) {
+	return sf->width == 0 ? 0 : sf3_get_signature(sf, signature);
+}
+
+int map_hollow_trie_distributor(const void *dump, const uint64_t length, hollow_trie_distributor *hollow_trie_distributor) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_HOLLOW_TRIE_DISTRIBUTOR) return -1;
+	memset(hollow_trie_distributor, 0, sizeof *hollow_trie_distributor);
+	hollow_trie_distributor->size = header->param[0];
+	if (header->num_sections == 0) return 0;
+	if (header->num_sections != 11 || map_sf_at(dump, 1, 7, 7, &hollow_trie_distributor->external_behaviour) != 0 || map_sf_at(dump, 1, 10, 9, &hollow_trie_distributor->false_follows_detector) != 0) return -1;
+	return map_hollow_trie_at(dump, 1, 0, &hollow_trie_distributor->trie);
+}
+
+hollow_trie_distributor *load_hollow_trie_distributor(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	hollow_trie_distributor *hollow_trie_distributor = malloc(sizeof *hollow_trie_distributor);
+	if (hollow_trie_distributor == NULL || map_hollow_trie_distributor(map, length, hollow_trie_distributor) != 0) {
+		free(hollow_trie_distributor);
+		munmap(map, length);
+		return NULL;
+	}
+	hollow_trie_distributor->map = map;
+	hollow_trie_distributor->map_length = length;
+	return hollow_trie_distributor;
+}
+
+int hollow_trie_distributor_validate(const hollow_trie_distributor *hollow_trie_distributor) {
+	if (hollow_trie_distributor->trie.trie == NULL) return 0;
+	if (hollow_trie_validate(&hollow_trie_distributor->trie) != 0) return -1;
+	return sf_validate(&hollow_trie_distributor->external_behaviour) != 0 || sf_validate(&hollow_trie_distributor->false_follows_detector) != 0 ? -1 : 0;
+}
+
+static int validate_distributor(const void *hollow_trie_distributor) {
+	return hollow_trie_distributor_validate(hollow_trie_distributor);
+}
+
+hollow_trie_distributor *load_hollow_trie_distributor_validated(int h) {
+	hollow_trie_distributor *hollow_trie_distributor = load_hollow_trie_distributor(h);
+	if (hollow_trie_distributor == NULL) return NULL;
+	if (hollow_trie_distributor_validate(hollow_trie_distributor) == 0) return hollow_trie_distributor;
+	munmap(hollow_trie_distributor->map, hollow_trie_distributor->map_length);
+	free(hollow_trie_distributor->trie.trie);
+	free(hollow_trie_distributor);
+	return NULL;
+}
+
+hollow_trie_distributor *load_hollow_trie_distributor_verify(int h, dump_verifier *verifier) {
+	hollow_trie_distributor *hollow_trie_distributor = load_hollow_trie_distributor(h);
+	if (hollow_trie_distributor == NULL) return NULL;
+	const dump_header * const header = hollow_trie_distributor->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)hollow_trie_distributor->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate_distributor, hollow_trie_distributor) == 0) return hollow_trie_distributor;
+	munmap(hollow_trie_distributor->map, hollow_trie_distributor->map_length);
+	free(hollow_trie_distributor->trie.trie);
+	free(hollow_trie_distributor);
+	return NULL;
+}
+
+/* Stores in key the preorder position of a node, as 64 bits, followed by the bits of a key in
+   [from, to), and hashes it. */
+static inline void hash_node(uint64_t *key, const uint64_t node, const uint64_t *bits, const uint64_t from, const uint64_t to, const uint64_t seed, uint64_t *signature) {
+	key[0] = node;
+	for (uint64_t i = from; i < to; i += 64) {
+		const uint64_t word = i / 64;
+		const int bit = i % 64;
+		// Bits after to are not hashed
+		key[1 + (i - from) / 64] = bit == 0 ? bits[word] : bits[word] >> bit | (i + 64 - bit < to ? bits[word + 1] << 64 - bit : 0);
+	}
+	spooky_short_bits(key, 64 + to - from, seed, signature);
+}
+
+uint64_t hollow_trie_distributor_get_bits(const hollow_trie_distributor *hollow_trie_distributor, const uint64_t *bits, const uint64_t length) {
+	const hollow_trie * const hollow_trie = &hollow_trie_distributor->trie;
+	if (hollow_trie_distributor->size == 0 || hollow_trie->trie == NULL) return 0;
+	const sf * const external_behaviour = &hollow_trie_distributor->external_behaviour, * const false_follows_detector = &hollow_trie_distributor->false_follows_detector;
+	const uint64_t * const trie = hollow_trie->trie->bits;
+	uint64_t buffer[BUFFER_WORDS], signature[4];
+	uint64_t * const key = length / 64 + 2 <= BUFFER_WORDS ? buffer : malloc((length / 64 + 2) * sizeof *key);
+	uint64_t p = 1, index = 0, r = 0, s = 0, skip = 0, last_left_turn = 0, last_left_turn_index = 0;
+	int is_internal, behaviour;
+
+	for (;;) {
+		is_internal = get_bit(trie, p);
+		if (is_internal) skip = hollow_trie_skip(hollow_trie, r);
+		// Internal nodes examine the skipped bits, leaves the rest of the key
+		const uint64_t end = is_internal && s + skip < length ? s + skip : length;
+		if (is_internal) {
+			hash_node(key, p - 1, bits, s, end, false_follows_detector->global_seed, signature);
+			behaviour = get_signature(false_follows_detector, signature) == 0 ? FOLLOW : -1;
+		}
+		if (!is_internal || behaviour != FOLLOW) {
+			hash_node(key, p - 1, bits, s, end, external_behaviour->global_seed, signature);
+			behaviour = get_signature(external_behaviour, signature);
+		}
+
+		if (behaviour != FOLLOW || !is_internal || (s += skip) >= length) break;
+
+		if (get_bit(bits, s)) {
+			const uint64_t q = balanced_parentheses_find_close(hollow_trie->trie, p) + 1;
+			index += q - p >> 1;
+			r += q - p >> 1;
+			p = q;
+		} else {
+			last_left_turn = p;
+			last_left_turn_index = index;
+			p++;
+			r++;
+		}
+		s++;
+	}
+
+	if (key != buffer) free(key);
+	if (behaviour == LEFT) return index;
+	if (is_internal) return (balanced_parentheses_find_close(hollow_trie->trie, last_left_turn) - last_left_turn + 1 >> 1) + last_left_turn_index;
+	return index + 1;
+}
+
+int map_hollow_trie_distributor_mmphf(const void *dump, const uint64_t length, hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_HOLLOW_TRIE_DISTRIBUTOR_MMPHF) return -1;
+	memset(hollow_trie_distributor_mmphf, 0, sizeof *hollow_trie_distributor_mmphf);
+	hollow_trie_distributor_mmphf->size = header->param[0];
+	if (hollow_trie_distributor_mmphf->size <= 1) return header->num_sections == 0 ? 0 : -1;
+	if (header->num_sections != 3 || header->param[1] > 63) return -1;
+	hollow_trie_distributor_mmphf->log2_bucket_size = header->param[1];
+	if (map_sf_at(dump, hollow_trie_distributor_mmphf->log2_bucket_size, 2, 0, &hollow_trie_distributor_mmphf->offset) != 0) return -1;
+	// The distributor is a complete container, aligned as any section
+	return map_hollow_trie_distributor((const char *)dump + header->section[2].offset, header->section[2].length, &hollow_trie_distributor_mmphf->distributor);
+}
+
+hollow_trie_distributor_mmphf *load_hollow_trie_distributor_mmphf(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf = malloc(sizeof *hollow_trie_distributor_mmphf);
+	if (hollow_trie_distributor_mmphf == NULL || map_hollow_trie_distributor_mmphf(map, length, hollow_trie_distributor_mmphf) != 0) {
+		free(hollow_trie_distributor_mmphf);
+		munmap(map, length);
+		return NULL;
+	}
+	hollow_trie_distributor_mmphf->map = map;
+	hollow_trie_distributor_mmphf->map_length = length;
+	return hollow_trie_distributor_mmphf;
+}
+
+int hollow_trie_distributor_mmphf_validate(const hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf) {
+	if (hollow_trie_distributor_mmphf->size <= 1) return 0;
+	// Functions of width zero are never probed
+	const sf * const offset = &hollow_trie_distributor_mmphf->offset;
+	if (offset->width != 0 && sf_validate(offset) != 0) return -1;
+	return hollow_trie_distributor_validate(&hollow_trie_distributor_mmphf->distributor);
+}
+
+static int validate(const void *hollow_trie_distributor_mmphf) {
+	return hollow_trie_distributor_mmphf_validate(hollow_trie_distributor_mmphf);
+}
+
+hollow_trie_distributor_mmphf *load_hollow_trie_distributor_mmphf_validated(int h) {
+	hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf = load_hollow_trie_distributor_mmphf(h);
+	if (hollow_trie_distributor_mmphf == NULL) return NULL;
+	if (hollow_trie_distributor_mmphf_validate(hollow_trie_distributor_mmphf) == 0) return hollow_trie_distributor_mmphf;
+	munmap(hollow_trie_distributor_mmphf->map, hollow_trie_distributor_mmphf->map_length);
+	free(hollow_trie_distributor_mmphf->distributor.trie.trie);
+	free(hollow_trie_distributor_mmphf);
+	return NULL;
+}
+
+hollow_trie_distributor_mmphf *load_hollow_trie_distributor_mmphf_verify(int h, dump_verifier *verifier) {
+	hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf = load_hollow_trie_distributor_mmphf(h);
+	if (hollow_trie_distributor_mmphf == NULL) return NULL;
+	const dump_header * const header = hollow_trie_distributor_mmphf->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)hollow_trie_distributor_mmphf->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, hollow_trie_distributor_mmphf) == 0) return hollow_trie_distributor_mmphf;
+	munmap(hollow_trie_distributor_mmphf->map, hollow_trie_distributor_mmphf->map_length);
+	free(hollow_trie_distributor_mmphf->distributor.trie.trie);
+	free(hollow_trie_distributor_mmphf);
+	return NULL;
+}
+
+int64_t hollow_trie_distributor_mmphf_get_bits(const hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf, const uint64_t *bits, const uint64_t length) {
+	if (hollow_trie_distributor_mmphf->size <= 1) return -1;
+	uint64_t signature[4];
+	const uint64_t bucket = hollow_trie_distributor_get_bits(&hollow_trie_distributor_mmphf->distributor, bits, length);
+	spooky_short_bits(bits, length, hollow_trie_distributor_mmphf->offset.global_seed, signature);
+	const uint64_t result = (bucket << hollow_trie_distributor_mmphf->log2_bucket_size) + get_signature(&hollow_trie_distributor_mmphf->offset, signature);
+	// Out-of-set keys can generate bizarre 3-hyperedges
+	return result >= hollow_trie_distributor_mmphf->size ? -1 : result;
+}
+
+int64_t hollow_trie_distributor_mmphf_get_byte_array(const hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = hollow_trie_distributor_mmphf_get_bits(hollow_trie_distributor_mmphf, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
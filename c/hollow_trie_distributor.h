@@ -0,0 +1,96 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HOLLOW_TRIE_DISTRIBUTOR_H_INCLUDED
+#define HOLLOW_TRIE_DISTRIBUTOR_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "sf3.h"
+#include "hollow_trie.h"
+
+/* A view of a hollow-trie distributor dump (see HollowTrieDistributor.dump() in Java), which maps
+   a key to its bucket. The trie on the bucket delimiters is represented as in a hollow_trie;
+   at each node, the pair formed by the preorder position of the node (as 64 bits) and the part of
+   the key examined by the node is hashed, and the false-follow detector tells whether the key
+   follows the path of the node, whereas the external-behaviour function tells whether it exits
+   the trie to the left or to the right. The lookup code uses the generic code of sf3.c, so it must
+   not be compiled with SF_8. */
+typedef struct {
+	uint64_t size;
+	hollow_trie trie; // The size is unused; the trie is NULL if there are less than two delimiters
+	sf external_behaviour;
+	sf false_follows_detector;
+	void *map; // The mapping, if loaded by load_hollow_trie_distributor()
+	uint64_t map_length;
+} hollow_trie_distributor;
+
+/* A view of a hollow-trie distributor-based monotone minimal perfect hash function dump (see
+   HollowTrieDistributorMonotoneMinimalPerfectHashFunction.dump() in Java): the distributor,
+   embedded in the last section, maps a key to its bucket, and a function maps the key to its
+   offset in the bucket (the lower log2_bucket_size bits of the rank). */
+typedef struct {
+	uint64_t size;
+	int log2_bucket_size;
+	sf offset; // A function of width zero always returns zero
+	hollow_trie_distributor distributor;
+	void *map; // The mapping, if loaded by load_hollow_trie_distributor_mmphf()
+	uint64_t map_length;
+} hollow_trie_distributor_mmphf;
+
+/* Maps a dump in memory (no copy) and builds the directory of the trie (see load_hollow_trie());
+   returns NULL if the dump is not a hollow-trie distributor dump. */
+hollow_trie_distributor *load_hollow_trie_distributor(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h), building
+   the directory of the trie; returns zero on success. */
+int map_hollow_trie_distributor(const void *dump, uint64_t length, hollow_trie_distributor *hollow_trie_distributor);
+/* Maps a distributor and validates it (see hollow_trie_distributor_validate()); returns NULL if the dump is not valid. */
+hollow_trie_distributor *load_hollow_trie_distributor_validated(int h);
+/* Maps a distributor and starts verifying it in the background (see dump.h). */
+hollow_trie_distributor *load_hollow_trie_distributor_verify(int h, dump_verifier *verifier);
+/* Checks the trie (see hollow_trie_validate()) and both functions (see sf_validate()); returns zero if valid. */
+int hollow_trie_distributor_validate(const hollow_trie_distributor *hollow_trie_distributor);
+/* Returns the bucket of a key of given length in bits (an arbitrary bucket if the key does not
+   belong to the key set). */
+uint64_t hollow_trie_distributor_get_bits(const hollow_trie_distributor *hollow_trie_distributor, const uint64_t *bits, uint64_t length);
+
+/* Maps a dump in memory (no copy) and builds the directory of the trie of the distributor (see
+   load_hollow_trie()); returns NULL if the dump is not a hollow-trie distributor-based monotone
+   minimal perfect hash function dump. */
+hollow_trie_distributor_mmphf *load_hollow_trie_distributor_mmphf(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h), building
+   the directory of the trie of the distributor; returns zero on success. */
+int map_hollow_trie_distributor_mmphf(const void *dump, uint64_t length, hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf);
+/* Maps a function and validates it (see hollow_trie_distributor_mmphf_validate()); returns NULL if the dump is not valid. */
+hollow_trie_distributor_mmphf *load_hollow_trie_distributor_mmphf_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h); the embedded
+   distributor is verified as a whole section. */
+hollow_trie_distributor_mmphf *load_hollow_trie_distributor_mmphf_verify(int h, dump_verifier *verifier);
+/* Checks the offset function (see sf_validate()) and the distributor (see
+   hollow_trie_distributor_validate()); returns zero if valid. */
+int hollow_trie_distributor_mmphf_validate(const hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf);
+/* Returns the rank of a key of given length in bits, or -1 if the key can be recognized as not
+   belonging to the key set. */
+int64_t hollow_trie_distributor_mmphf_get_bits(const hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf, const uint64_t *bits, uint64_t length);
+/* As hollow_trie_distributor_mmphf_get_bits(), for a function built using
+   TransformationStrategies.prefixFreeByteArray() (see lcp_mmphf_byte_array_to_bits()). */
+int64_t hollow_trie_distributor_mmphf_get_byte_array(const hollow_trie_distributor_mmphf *hollow_trie_distributor_mmphf, const char *key, uint64_t len);
+
+#endif /* HOLLOW_TRIE_DISTRIBUTOR_H_INCLUDED */
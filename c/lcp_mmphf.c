@@ -0,0 +1,257 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "lcp_mmphf.h"
+
+#define OFFSET_MASK (UINT64_C(-1) >> 8)
+#define BATCH 16
+#define BUFFER_WORDS 32 // Byte arrays shorter than this many words are converted on the stack
+
+int map_lcp_mmphf(const void *dump, const uint64_t length, lcp_mmphf *lcp_mmphf) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_LCP_MMPHF) return -1;
+	memset(lcp_mmphf, 0, sizeof *lcp_mmphf);
+	lcp_mmphf->size = header->param[0];
+	if (lcp_mmphf->size == 0) return header->num_sections == 0 ? 0 : -1;
+	if (header->num_sections != 5 || header->param[1] > 32 || header->param[3] > 64 || header->param[4] > 64 || header->param[5] > 64) return -1;
+	lcp_mmphf->log2_bucket_size = header->param[1];
+	lcp_mmphf->global_seed = header->param[2];
+	lcp_mmphf->signature_width = header->param[3];
+	lcp_mmphf->signature_mask = lcp_mmphf->signature_width == 0 ? 0 : UINT64_MAX >> 64 - lcp_mmphf->signature_width;
+	if (map_sf_at(dump, header->param[4], 6, 0, &lcp_mmphf->offset_lcp_length) != 0 || map_sf_at(dump, header->param[5], 9, 2, &lcp_mmphf->lcp_to_bucket) != 0) return -1;
+	lcp_mmphf->signatures_length = header->section[4].length / sizeof *lcp_mmphf->signatures;
+	lcp_mmphf->signatures = (const uint64_t *)((const char *)dump + header->section[4].offset);
+	return 0;
+}
+
+lcp_mmphf *load_lcp_mmphf(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	lcp_mmphf *lcp_mmphf = malloc(sizeof *lcp_mmphf);
+	if (lcp_mmphf == NULL || map_lcp_mmphf(map, length, lcp_mmphf) != 0) {
+		free(lcp_mmphf);
+		munmap(map, length);
+		return NULL;
+	}
+	lcp_mmphf->map = map;
+	lcp_mmphf->map_length = length;
+	return lcp_mmphf;
+}
+
+int lcp_mmphf_validate(const lcp_mmphf *lcp_mmphf) {
+	if (lcp_mmphf->size == 0) return 0;
+	// Functions of width zero are never probed
+	const sf * const offset_lcp_length = &lcp_mmphf->offset_lcp_length, * const lcp_to_bucket = &lcp_mmphf->lcp_to_bucket;
+	if (offset_lcp_length->width != 0 && (sf_validate(offset_lcp_length) != 0 || offset_lcp_length->global_seed != lcp_mmphf->global_seed)) return -1;
+	if (lcp_to_bucket->width != 0 && sf_validate(lcp_to_bucket) != 0) return -1;
+	if (lcp_mmphf->signature_width != 0 && (lcp_mmphf->size >= UINT64_MAX / 64 || lcp_mmphf->signatures_length * 64 < lcp_mmphf->size * lcp_mmphf->signature_width)) return -1;
+	return 0;
+}
+
+static int validate(const void *lcp_mmphf) {
+	return lcp_mmphf_validate(lcp_mmphf);
+}
+
+lcp_mmphf *load_lcp_mmphf_validated(int h) {
+	lcp_mmphf *lcp_mmphf = load_lcp_mmphf(h);
+	if (lcp_mmphf == NULL) return NULL;
+	if (lcp_mmphf_validate(lcp_mmphf) == 0) return lcp_mmphf;
+	munmap(lcp_mmphf->map, lcp_mmphf->map_length);
+	free(lcp_mmphf);
+	return NULL;
+}
+
+lcp_mmphf *load_lcp_mmphf_verify(int h, dump_verifier *verifier) {
+	lcp_mmphf *lcp_mmphf = load_lcp_mmphf(h);
+	if (lcp_mmphf == NULL) return NULL;
+	const dump_header * const header = lcp_mmphf->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)lcp_mmphf->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, lcp_mmphf) == 0) return lcp_mmphf;
+	munmap(lcp_mmphf->map, lcp_mmphf->map_length);
+	free(lcp_mmphf);
+	return NULL;
+}
+
+static void inline signature_to_equation(const uint64_t *signature, const uint64_t seed, int num_variables, unsigned int *e) {
+	uint64_t hash[4];
+	spooky_short_rehash(signature, seed, hash);
+	const int shift = __builtin_clzll(num_variables | 1); // Empty buckets yield zero
+	const uint64_t mask = (UINT64_C(1) << shift) - 1;
+	e[0] = ((hash[0] & mask) * num_variables) >> shift;
+	e[1] = ((hash[1] & mask) * num_variables) >> shift;
+	e[2] = ((hash[2] & mask) * num_variables) >> shift;
+}
+
+static uint64_t inline get_value(const uint64_t * const array, uint64_t pos, const int width) {
+	pos *= width;
+	const int l = 64 - width;
+	const uint64_t start_word = pos / 64;
+	const int start_bit = pos % 64;
+	if (start_bit <= l) return array[start_word] << l - start_bit >> l;
+	return array[start_word] >> start_bit | array[start_word + 1] << 64 + l - start_bit >> l;
+}
+
+static inline uint64_t get_bits(const uint64_t * const bits, const uint64_t pos, const int width) {
+	const uint64_t word = pos / 64;
+	const int bit = pos % 64;
+	uint64_t result = bits[word] >> bit;
+	if (bit + width > 64) result |= bits[word + 1] << 64 - bit;
+	return width == 64 ? result : result & (UINT64_C(1) << width) - 1;
+}
+
+static inline int64_t get_signature(const sf *sf, const uint64_t signature[4]) {
+	if (sf->width == 0) return 0;
+	const int bucket = ((__uint128_t)(signature[0] >> 1) * (__uint128_t)sf->multiplier) >> 64;
+	const uint64_t offset_seed = sf->offset_and_seed[bucket];
+	const uint64_t bucket_offset = offset_seed & OFFSET_MASK;
+	const int num_variables = (sf->offset_and_seed[bucket + 1] & OFFSET_MASK) - bucket_offset;
+	unsigned int e[3];
+	signature_to_equation(signature, offset_seed & ~OFFSET_MASK, num_variables, e);
+	return get_value(sf->array, e[0] + bucket_offset, sf->width) ^ get_value(sf->array, e[1] + bucket_offset, sf->width) ^ get_value(sf->array, e[2] + bucket_offset, sf->width);
+}
+
+/* Evaluates a function on b signatures, prefetching the offsets and seeds of their buckets
+   before computing the equations, and their data before extracting it. */
+static void get_signature_batch(const sf *sf, const uint64_t (*signature)[4], const int b, uint64_t *value) {
+	uint64_t bucket[BATCH], pos[BATCH][3];
+	if (sf->width == 0) {
+		memset(value, 0, b * sizeof *value);
+		return;
+	}
+	for (int j = 0; j < b; j++) {
+		bucket[j] = ((__uint128_t)(signature[j][0] >> 1) * (__uint128_t)sf->multiplier) >> 64;
+		__builtin_prefetch(&sf->offset_and_seed[bucket[j]]);
+	}
+	for (int j = 0; j < b; j++) {
+		const uint64_t offset_seed = sf->offset_and_seed[bucket[j]];
+		const uint64_t bucket_offset = offset_seed & OFFSET_MASK;
+		const int num_variables = (sf->offset_and_seed[bucket[j] + 1] & OFFSET_MASK) - bucket_offset;
+		unsigned int e[3];
+		signature_to_equation(signature[j], offset_seed & ~OFFSET_MASK, num_variables, e);
+		for (int k = 0; k < 3; k++) {
+			pos[j][k] = e[k] + bucket_offset;
+			__builtin_prefetch(&sf->array[pos[j][k] * sf->width / 64]);
+		}
+	}
+	for (int j = 0; j < b; j++) value[j] = get_value(sf->array, pos[j][0], sf->width) ^ get_value(sf->array, pos[j][1], sf->width) ^ get_value(sf->array, pos[j][2], sf->width);
+}
+
+/* Returns the rank given the value of the first function and the bucket, or -1. */
+static inline int64_t rank(const lcp_mmphf *lcp_mmphf, const uint64_t *signature, const uint64_t value, const uint64_t bucket) {
+	const uint64_t result = (bucket << lcp_mmphf->log2_bucket_size) + (value & (UINT64_C(1) << lcp_mmphf->log2_bucket_size) - 1);
+	// Out-of-set keys can generate bizarre 3-hyperedges
+	if (result >= lcp_mmphf->size) return -1;
+	if (lcp_mmphf->signature_mask != 0 && ((get_bits(lcp_mmphf->signatures, result * lcp_mmphf->signature_width, lcp_mmphf->signature_width) ^ signature[0]) & lcp_mmphf->signature_mask) != 0) return -1;
+	return result;
+}
+
+int64_t lcp_mmphf_get_bits(const lcp_mmphf *lcp_mmphf, const uint64_t *bits, const uint64_t length) {
+	if (lcp_mmphf->size == 0) return -1;
+	uint64_t signature[4], prefix_signature[4];
+	spooky_short_bits(bits, length, lcp_mmphf->global_seed, signature);
+	const uint64_t value = get_signature(&lcp_mmphf->offset_lcp_length, signature);
+	const uint64_t prefix = value >> lcp_mmphf->log2_bucket_size;
+	if (prefix > length) return -1;
+	spooky_short_bits(bits, prefix, lcp_mmphf->lcp_to_bucket.global_seed, prefix_signature);
+	return rank(lcp_mmphf, signature, value, get_signature(&lcp_mmphf->lcp_to_bucket, prefix_signature));
+}
+
+uint64_t lcp_mmphf_byte_array_to_bits(const char *key, const uint64_t len, uint64_t *bits) {
+	const uint8_t * const p = (const uint8_t *)key;
+	for (uint64_t i = 0; i <= len / 8; i++) {
+		uint64_t word = 0;
+		if (i < len / 8) memcpy(&word, p + i * 8, 8); // Little endian
+		else for (int k = 0; k < len % 8; k++) word |= (uint64_t)p[i * 8 + k] << k * 8;
+		// Most significant bits first in each byte
+		word = (word >> 1 & UINT64_C(0x5555555555555555)) | (word & UINT64_C(0x5555555555555555)) << 1;
+		word = (word >> 2 & UINT64_C(0x3333333333333333)) | (word & UINT64_C(0x3333333333333333)) << 2;
+		bits[i] = (word >> 4 & UINT64_C(0x0F0F0F0F0F0F0F0F)) | (word & UINT64_C(0x0F0F0F0F0F0F0F0F)) << 4;
+	}
+	return (len + 1) * 8;
+}
+
+int64_t lcp_mmphf_get_byte_array(const lcp_mmphf *lcp_mmphf, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = lcp_mmphf_get_bits(lcp_mmphf, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
+
+/* Returns whether two bit vectors have the same prefix of given length. */
+static inline int same_prefix(const uint64_t *a, const uint64_t *b, const uint64_t length) {
+	const uint64_t words = length / 64;
+	if (memcmp(a, b, words * sizeof *a) != 0) return 0;
+	return length % 64 == 0 || ((a[words] ^ b[words]) << 64 - length % 64) == 0;
+}
+
+/* Answers a group of at most BATCH keys: the first function is evaluated on the whole group,
+   and the second one on the distinct prefixes of consecutive keys. */
+static void get_batch(const lcp_mmphf *lcp_mmphf, const uint64_t * const *bits, const uint64_t *length, int64_t *result, const int b) {
+	uint64_t signature[BATCH][4], prefix_signature[BATCH][4], value[BATCH], bucket[BATCH], prefix[BATCH];
+	int owner[BATCH], m = 0, last = -1;
+	for (int j = 0; j < b; j++) spooky_short_bits(bits[j], length[j], lcp_mmphf->global_seed, signature[j]);
+	get_signature_batch(&lcp_mmphf->offset_lcp_length, signature, b, value);
+	for (int j = 0; j < b; j++) {
+		prefix[j] = value[j] >> lcp_mmphf->log2_bucket_size;
+		if (prefix[j] > length[j]) {
+			owner[j] = -1;
+			continue;
+		}
+		if (last >= 0 && prefix[last] == prefix[j] && same_prefix(bits[last], bits[j], prefix[j])) owner[j] = owner[last];
+		else spooky_short_bits(bits[j], prefix[j], lcp_mmphf->lcp_to_bucket.global_seed, prefix_signature[owner[j] = m++]);
+		last = j;
+	}
+	get_signature_batch(&lcp_mmphf->lcp_to_bucket, prefix_signature, m, bucket);
+	for (int j = 0; j < b; j++) result[j] = owner[j] < 0 ? -1 : rank(lcp_mmphf, signature[j], value[j], bucket[owner[j]]);
+}
+
+void lcp_mmphf_get_bits_batch(const lcp_mmphf *lcp_mmphf, const uint64_t * const *bits, const uint64_t *length, int64_t *result, const uint64_t n) {
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		if (lcp_mmphf->size == 0) for (int j = 0; j < b; j++) result[i + j] = -1;
+		else get_batch(lcp_mmphf, bits + i, length + i, result + i, b);
+	}
+}
+
+void lcp_mmphf_get_byte_array_batch(const lcp_mmphf *lcp_mmphf, char * const *key, const int *len, int64_t *result, const uint64_t n) {
+	uint64_t buffer[BATCH][BUFFER_WORDS], length[BATCH];
+	const uint64_t *bits[BATCH];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		if (lcp_mmphf->size == 0) {
+			for (int j = 0; j < b; j++) result[i + j] = -1;
+			continue;
+		}
+		for (int j = 0; j < b; j++) {
+			uint64_t * const p = len[i + j] / 8 < BUFFER_WORDS ? buffer[j] : malloc((len[i + j] / 8 + 1) * sizeof *p);
+			length[j] = lcp_mmphf_byte_array_to_bits(key[i + j], len[i + j], p);
+			bits[j] = p;
+		}
+		get_batch(lcp_mmphf, bits, length, result + i, b);
+		for (int j = 0; j < b; j++) if (bits[j] != buffer[j]) free((void *)bits[j]);
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LCP_MMPHF_H_INCLUDED
+#define LCP_MMPHF_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "sf.h"
+
+/* A view of an LCP-based monotone minimal perfect hash function dump (see
+   LcpMonotoneMinimalPerfectHashFunction.dump() in Java). Keys are bit vectors stored as in a
+   LongArrayBitVector; the first function maps a key to the length of the longest common prefix
+   of its bucket (upper bits) and to its offset in the bucket (lower log2_bucket_size bits), and
+   the second function maps the prefix of the key of that length to the bucket. The lookup code
+   uses the generic code of sf3.c, so it must not be compiled with SF_8. */
+typedef struct {
+	uint64_t size;
+	int log2_bucket_size;
+	uint64_t global_seed;
+	int signature_width;
+	uint64_t signature_mask;
+	sf offset_lcp_length; // A function of width zero always returns zero
+	sf lcp_to_bucket;
+	uint64_t signatures_length;
+	const uint64_t *signatures;
+	void *map; // The mapping, if loaded by load_lcp_mmphf()
+	uint64_t map_length;
+} lcp_mmphf;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not an LCP monotone minimal
+   perfect hash function dump. */
+lcp_mmphf *load_lcp_mmphf(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_lcp_mmphf(const void *dump, uint64_t length, lcp_mmphf *lcp_mmphf);
+/* Maps a function and validates it (see lcp_mmphf_validate()); returns NULL if the dump is not valid. */
+lcp_mmphf *load_lcp_mmphf_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h). */
+lcp_mmphf *load_lcp_mmphf_verify(int h, dump_verifier *verifier);
+/* Checks both functions (see sf_validate()), that the seeds agree and that the signatures cover
+   all keys; returns zero if valid. */
+int lcp_mmphf_validate(const lcp_mmphf *lcp_mmphf);
+/* Returns the rank of a key of given length in bits, or -1 if the key can be recognized as not
+   belonging to the key set. */
+int64_t lcp_mmphf_get_bits(const lcp_mmphf *lcp_mmphf, const uint64_t *bits, uint64_t length);
+/* As lcp_mmphf_get_bits(), for a function built using TransformationStrategies.prefixFreeByteArray():
+   the bits of each byte are taken starting from the most significant one, and a zero byte
+   is appended, so key must not contain zero bytes. */
+int64_t lcp_mmphf_get_byte_array(const lcp_mmphf *lcp_mmphf, const char *key, uint64_t len);
+/* Stores in result the ranks of n keys: the keys of a group are hashed and probed in the first
+   function, and then their prefixes are hashed and probed in the second function, prefetching
+   the memory needed by each stage. Consecutive keys with the same prefix (e.g., sorted keys in
+   the same bucket) share the hash and the probe of the prefix. */
+void lcp_mmphf_get_bits_batch(const lcp_mmphf *lcp_mmphf, const uint64_t * const *bits, const uint64_t *length, int64_t *result, uint64_t n);
+void lcp_mmphf_get_byte_array_batch(const lcp_mmphf *lcp_mmphf, char * const *key, const int *len, int64_t *result, uint64_t n);
+/* Stores in bits the bit vector of length 8 * (len + 1) representing key under
+   TransformationStrategies.prefixFreeByteArray(); bits must contain len / 8 + 1 words. */
+uint64_t lcp_mmphf_byte_array_to_bits(const char *key, uint64_t len, uint64_t *bits);
+
+#endif /* LCP_MMPHF_H_INCLUDED */
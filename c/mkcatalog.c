@@ -0,0 +1,56 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Packs containers into a catalog (see catalog.h).
+ *
+ * mkcatalog CATALOG NAME=DUMP...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "catalog.h"
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s CATALOG NAME=DUMP...\n", argv[0]);
+		return 1;
+	}
+
+	const int n = argc - 2;
+	const char **name = calloc(n, sizeof *name), **file = calloc(n, sizeof *file);
+	for (int i = 0; i < n; i++) {
+		char * const eq = strchr(argv[i + 2], '=');
+		if (eq == NULL) {
+			fprintf(stderr, "Missing name in %s\n", argv[i + 2]);
+			return 1;
+		}
+		*eq = 0;
+		name[i] = argv[i + 2];
+		file[i] = eq + 1;
+	}
+
+	if (catalog_write(argv[1], n, name, file) != 0) {
+		fprintf(stderr, "Cannot write %s (are all dumps containers, with distinct names?)\n", argv[1]);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Builds a GOVMinimalPerfectHashFunction on the lines of a file (without terminators) and
+ * writes it as a container (see mph_builder.h), as GOVMinimalPerfectHashFunction with
+ * TransformationStrategies.rawByteArray() would.
+ *
+ * mkmph [-t THREADS] [-T TEMPDIR] KEYS DUMP
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "mph_builder.h"
+
+#define BATCH (1 << 20)
+
+/* Reads the keys by batches, which are hashed in parallel; the keys of a batch are concatenated in pool. */
+static int add_keys(mph_builder *builder, const char *path, const int threads) {
+	FILE * const f = fopen(path, "r");
+	if (f == NULL) return -1;
+	char ** const key = malloc(BATCH * sizeof *key), *pool = NULL, *line = NULL;
+	int * const len = malloc(BATCH * sizeof *len);
+	size_t size = 0, pool_size = 0, pool_capacity = 0;
+	ssize_t l = 0;
+	int result = key == NULL || len == NULL ? -1 : 0;
+	uint64_t n = 0;
+	while (result == 0 && l != -1) {
+		if ((l = getline(&line, &size, f)) != -1) {
+			if (l > 0 && line[l - 1] == '\n') l--;
+			if (pool_size + l > pool_capacity) {
+				pool_capacity = (pool_size + l) * 2;
+				char * const p = realloc(pool, pool_capacity);
+				if (p == NULL) {
+					result = -1;
+					break;
+				}
+				pool = p;
+			}
+			memcpy(pool + pool_size, line, l);
+			pool_size += l;
+			len[n++] = l;
+		}
+		if (n == BATCH || (l == -1 && n != 0)) {
+			key[0] = pool;
+			for (uint64_t i = 1; i < n; i++) key[i] = key[i - 1] + len[i - 1];
+			result = mph_builder_add_byte_array_batch(builder, key, len, n, threads);
+			n = pool_size = 0;
+		}
+	}
+	free(key);
+	free(len);
+	free(pool);
+	free(line);
+	fclose(f);
+	return result;
+}
+
+int main(int argc, char* argv[]) {
+	int threads = 0, opt;
+	const char *temp_dir = NULL;
+	while ((opt = getopt(argc, argv, "t:T:")) != -1) {
+		if (opt == 't') threads = atoi(optarg);
+		else if (opt == 'T') temp_dir = optarg;
+		else break;
+	}
+	if (argc - optind != 2) {
+		fprintf(stderr, "Usage: %s [-t THREADS] [-T TEMPDIR] KEYS DUMP\n", argv[0]);
+		return 1;
+	}
+
+	// As in Java, a duplicate signature is retried a few times with a different seed
+	uint64_t seed = 0;
+	mph_builder * const builder = mph_builder_new(temp_dir, seed);
+	if (builder == NULL) {
+		fprintf(stderr, "Cannot create temporary files\n");
+		return 1;
+	}
+	mph mph;
+	for (int attempt = 0;; attempt++) {
+		if (add_keys(builder, argv[optind], threads) != 0) {
+			fprintf(stderr, "Cannot read %s\n", argv[optind]);
+			return 1;
+		}
+		const int result = mph_builder_build(builder, threads, &mph);
+		if (result == 0) break;
+		if (result != MPH_BUILDER_DUPLICATE || attempt == 3) {
+			fprintf(stderr, result == MPH_BUILDER_DUPLICATE ? "Duplicate keys in %s\n" : "Cannot build a function on %s\n", argv[optind]);
+			return 1;
+		}
+		seed = seed * 0x9E3779B97F4A7C15 + 0x9E3779B97F4A7C15;
+		if (mph_builder_reset(builder, seed) != 0) return 1;
+	}
+	fprintf(stderr, "%" PRIu64 " keys, %" PRIu64 " unsolvable, %" PRIu64 " unorientable\n", mph.size, builder->unsolvable, builder->unorientable);
+	mph_builder_free(builder);
+
+	if (mph_dump(&mph, DUMP_RAW_BYTE_ARRAY, argv[optind + 1]) != 0) {
+		fprintf(stderr, "Cannot write %s\n", argv[optind + 1]);
+		return 1;
+	}
+	return 0;
+}
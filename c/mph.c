@@ -19,15 +19,58 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <math.h>
+#include <limits.h>
 #include "spooky.h"
 #include "mph.h"
+#include "dump.h"
+#include "popcount.h"
 
-mph *load_mph(int h) {
+#define OFFSET_MASK (UINT64_C(-1) >> 8)
+#define C_TIMES_256 (int)(floor((1.09 + 0.01) * 256))
+#define BATCH 16
+
+static uint64_t inline vertex_offset(const uint64_t edge_offset_seed) {
+	return ((edge_offset_seed & OFFSET_MASK) * C_TIMES_256 >> 8);
+}
+
+static void free_mph(mph *mph) {
+#ifndef USE_MMAP // Anonymous mappings are not reclaimed
+	free(mph->edge_offset_and_seed);
+	free(mph->array);
+	free(mph);
+#endif
+}
+
+static mph *load_mph_header(int h, dump_header *header) {
+	const int container = dump_read_header(h, header);
+	if (container < 0) return NULL;
+
+	if (container && (header->kind != DUMP_MPH || header->num_sections != 2)) return NULL;
+	// Sections are arrays of longs
+	if (container && (header->section[0].length % sizeof(uint64_t) != 0 || header->section[1].length % sizeof(uint64_t) != 0)) return NULL;
 	mph *mph = calloc(1, sizeof *mph);
-	read(h, &mph->size, sizeof mph->size);
+	if (mph == NULL) return NULL;
+
+	if (container) {
+		mph->size = header->param[0];
+		mph->multiplier = header->param[1];
+		mph->global_seed = header->param[2];
+		mph->edge_offset_and_seed_length = header->section[0].length / sizeof *mph->edge_offset_and_seed;
+		mph->edge_offset_and_seed = calloc(mph->edge_offset_and_seed_length, sizeof *mph->edge_offset_and_seed);
+		mph->array_length = header->section[1].length / sizeof *mph->array;
+		mph->array = calloc(mph->array_length, sizeof *mph->array);
+		if (mph->edge_offset_and_seed == NULL || mph->array == NULL || dump_read_section(h, header, 0, mph->edge_offset_and_seed) || dump_read_section(h, header, 1, mph->array)) {
+			free_mph(mph);
+			return NULL;
+		}
+		return mph;
+	}
+
+	mph->size = header->magic;
 	uint64_t t;
 	read(h, &t, sizeof t);
 	mph->multiplier = t;
@@ -42,20 +85,101 @@ mph *load_mph(int h) {
 	return mph;
 }
 
+mph *load_mph(int h) {
+	dump_header header;
+	return load_mph_header(h, &header);
+}
+
+int map_mph_at(const void *dump, const int param, const int section, mph *mph) {
+	const dump_header * const header = dump;
+	if (param + 3 > DUMP_MAX_PARAMS || section + 2 > (int)header->num_sections) return -1;
+	const char * const base = dump;
+	memset(mph, 0, sizeof *mph);
+	mph->size = header->param[param];
+	mph->multiplier = header->param[param + 1];
+	mph->global_seed = header->param[param + 2];
+	mph->edge_offset_and_seed_length = header->section[section].length / sizeof *mph->edge_offset_and_seed;
+	mph->edge_offset_and_seed = (uint64_t *)(base + header->section[section].offset);
+	mph->array_length = header->section[section + 1].length / sizeof *mph->array;
+	mph->array = (uint64_t *)(base + header->section[section + 1].offset);
+	return 0;
+}
+
+int map_mph(const void *dump, const uint64_t length, mph *mph) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_MPH || header->num_sections != 2) return -1;
+	return map_mph_at(dump, 0, 0, mph);
+}
+
+int mph_validate(const mph *mph) {
+	if (mph->edge_offset_and_seed == NULL || mph->array == NULL) return -1;
+	// The largest bucket computed by the lookup code, which also reads the following offset
+	const uint64_t max_bucket = ((__uint128_t)(UINT64_MAX >> 1) * mph->multiplier) >> 64;
+	if (max_bucket >= INT_MAX || mph->edge_offset_and_seed_length < max_bucket + 2) return -1;
+	if (mph->array_length > UINT64_MAX / 32) return -1;
+	for (uint64_t i = 0; i <= max_bucket; i++) {
+		const uint64_t offset = mph->edge_offset_and_seed[i] & OFFSET_MASK;
+		const uint64_t next = mph->edge_offset_and_seed[i + 1] & OFFSET_MASK;
+		// Offsets must be monotone, and vertex_offset() must not overflow
+		if (next < offset || next > UINT64_MAX / C_TIMES_256) return -1;
+		const uint64_t bucket_offset = vertex_offset(offset);
+		const uint64_t num_variables = vertex_offset(next) - bucket_offset;
+		if (num_variables > INT_MAX) return -1;
+		// Two bits per vertex; an empty bucket is probed at its offset
+		if (bucket_offset + (num_variables != 0 ? num_variables : 1) > mph->array_length * 32) return -1;
+	}
+	return 0;
+}
+
+int mph_dump(const mph *mph, const int strategy, const char *path) {
+	dump_header header = { .kind = DUMP_MPH, .arity = 3, .width = 2, .strategy = strategy, .hash = DUMP_SPOOKY_V2, .num_sections = 2 };
+	header.param[0] = mph->size;
+	header.param[1] = mph->multiplier;
+	header.param[2] = mph->global_seed;
+	header.section[0].length = mph->edge_offset_and_seed_length * sizeof *mph->edge_offset_and_seed;
+	header.section[1].length = mph->array_length * sizeof *mph->array;
+	const void *section[] = { mph->edge_offset_and_seed, mph->array };
+	return dump_write(path, &header, section);
+}
+
+static int validate(const void *mph) {
+	return mph_validate(mph);
+}
+
+mph *load_mph_validated(int h) {
+	mph *mph = load_mph(h);
+	if (mph == NULL) return NULL;
+	if (mph_validate(mph) == 0) return mph;
+	free_mph(mph);
+	return NULL;
+}
+
+mph *load_mph_verify(int h, dump_verifier *verifier) {
+	dump_header header;
+	mph *mph = load_mph_header(h, &header);
+	if (mph == NULL) return NULL;
+	const void *section[] = { mph->edge_offset_and_seed, mph->array };
+	if (dump_verify_start(verifier, &header, section, validate, mph) == 0) return mph;
+	free_mph(mph);
+	return NULL;
+}
+
 static int inline _count_nonzero_pairs(const uint64_t x) {
 	return __builtin_popcountll((x | x >> 1) & 0x5555555555555555);
 }
 
 static uint64_t inline count_nonzero_pairs(const uint64_t start, const uint64_t end, const uint64_t * const array) {
-	int block = start / 32;
-	const int end_block = end / 32;
+	uint64_t block = start / 32;
+	const uint64_t end_block = end / 32;
 	const int start_offset = start % 32;
 	const int end_offset = end % 32;
 
 	if (block == end_block) return _count_nonzero_pairs((array[block] & (UINT64_C(1) << end_offset * 2) - 1) >> start_offset * 2);
 	uint64_t pairs = 0;
 	if (start_offset != 0) pairs += _count_nonzero_pairs(array[block++] >> start_offset * 2);
-	while(block < end_block) pairs += _count_nonzero_pairs(array[block++]);
+	// Whole words go to the vectorized kernel, if any (see popcount.h)
+	pairs += popcount_nonzero_pairs(array + block, end_block - block);
+	block = end_block;
 	if (end_offset != 0) pairs += _count_nonzero_pairs(array[block] & (UINT64_C(1) << end_offset * 2) - 1);
 	return pairs;
 }						 	 	 	 	 	 	 																						
@@ -63,7 +187,7 @@ static uint64_t inline count_nonzero_pairs(const uint64_t start, const uint64_t
 static void inline signature_to_equation(const uint64_t *signature, const uint64_t seed, int num_variables, int *e) {
 	uint64_t hash[4];
 	spooky_short_rehash(signature, seed, hash);
-	const int shift = __builtin_clzll(num_variables);
+	const int shift = __builtin_clzll(num_variables | 1); // Empty buckets yield zero
 	const uint64_t mask = (UINT64_C(1) << shift) - 1;
 	e[0] = ((hash[0] & mask) * num_variables) >> shift;
 	e[1] = ((hash[1] & mask) * num_variables) >> shift;
@@ -71,13 +195,6 @@ static void inline signature_to_equation(const uint64_t *signature, const uint64
 }
 																										
 
-#define OFFSET_MASK (UINT64_C(-1) >> 8)
-#define C_TIMES_256 (int)(floor((1.09 + 0.01) * 256))
-
-static uint64_t inline vertex_offset(const uint64_t edge_offset_seed) {
-	return ((edge_offset_seed & OFFSET_MASK) * C_TIMES_256 >> 8);
-}
-
 static int inline get_2bit_value(uint64_t *array, uint64_t pos) {
 	pos *= 2;
 	return array[pos / 64] >> pos % 64 & 3;
@@ -118,3 +235,33 @@ int64_t mph_get_uint128_t(const mph *mph, const __uint128_t key) {
 	signature_to_equation(signature, edge_offset_seed & ~OFFSET_MASK, num_variables, e);
 	return (edge_offset_seed & OFFSET_MASK) + count_nonzero_pairs(bucket_offset, bucket_offset + e[(get_2bit_value(mph->array, e[0] + bucket_offset) + get_2bit_value(mph->array, e[1] + bucket_offset) + get_2bit_value(mph->array, e[2] + bucket_offset)) % 3], mph->array);
 }
+
+int64_t mph_get_signature(const mph *mph, const uint64_t signature[4]) {
+	const int bucket = ((__uint128_t)(signature[0] >> 1) * (__uint128_t)mph->multiplier) >> 64;
+	const uint64_t edge_offset_seed = mph->edge_offset_and_seed[bucket];
+	const uint64_t bucket_offset = vertex_offset(edge_offset_seed);
+	const int num_variables = vertex_offset(mph->edge_offset_and_seed[bucket + 1]) - bucket_offset;
+	int e[3];
+	signature_to_equation(signature, edge_offset_seed & ~OFFSET_MASK, num_variables, e);
+	return (edge_offset_seed & OFFSET_MASK) + count_nonzero_pairs(bucket_offset, bucket_offset + e[(get_2bit_value(mph->array, e[0] + bucket_offset) + get_2bit_value(mph->array, e[1] + bucket_offset) + get_2bit_value(mph->array, e[2] + bucket_offset)) % 3], mph->array);
+}
+
+void mph_get_signature_batch(const mph *mph, const uint64_t (*signature)[4], int64_t *result, const uint64_t n) {
+	uint64_t edge_offset_seed[BATCH], bucket_offset[BATCH];
+	int bucket[BATCH], e[BATCH][3];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) {
+			bucket[j] = ((__uint128_t)(signature[i + j][0] >> 1) * (__uint128_t)mph->multiplier) >> 64;
+			__builtin_prefetch(&mph->edge_offset_and_seed[bucket[j]]);
+		}
+		for (int j = 0; j < b; j++) {
+			edge_offset_seed[j] = mph->edge_offset_and_seed[bucket[j]];
+			bucket_offset[j] = vertex_offset(edge_offset_seed[j]);
+			const int num_variables = vertex_offset(mph->edge_offset_and_seed[bucket[j] + 1]) - bucket_offset[j];
+			signature_to_equation(signature[i + j], edge_offset_seed[j] & ~OFFSET_MASK, num_variables, e[j]);
+			for (int k = 0; k < 3; k++) __builtin_prefetch(&mph->array[(e[j][k] + bucket_offset[j]) / 32]);
+		}
+		for (int j = 0; j < b; j++) result[i + j] = (edge_offset_seed[j] & OFFSET_MASK) + count_nonzero_pairs(bucket_offset[j], bucket_offset[j] + e[j][(get_2bit_value(mph->array, e[j][0] + bucket_offset[j]) + get_2bit_value(mph->array, e[j][1] + bucket_offset[j]) + get_2bit_value(mph->array, e[j][2] + bucket_offset[j])) % 3], mph->array);
+	}
+}
@@ -18,7 +18,11 @@
  *
  */
 
+#ifndef MPH_H_INCLUDED
+#define MPH_H_INCLUDED
+
 #include <inttypes.h>
+#include "dump.h"
 
 #ifdef USE_MMAP
 #include <sys/mman.h>
@@ -37,6 +41,30 @@ typedef struct {
 } mph;
 
 mph *load_mph(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h)
+   without copying; the container must stay mapped. Returns zero on success. */
+int map_mph(const void *dump, uint64_t length, mph *mph);
+/* Fills a view of a function embedded in a container already checked by dump_map_header(),
+   whose parameters and sections start at the given indices; returns zero on success. */
+int map_mph_at(const void *dump, int param, int section, mph *mph);
+/* Loads a function and validates it (see mph_validate()); returns NULL if the dump is not valid. */
+mph *load_mph_validated(int h);
+/* Loads a function and starts verifying it in the background (see dump.h). */
+mph *load_mph_verify(int h, dump_verifier *verifier);
+/* Checks that every probe of the lookup code, for any key, falls within the arrays (offsets
+   are monotone, there is a sentinel offset after the last bucket, and the last bucket fits
+   the array); returns zero if valid. */
+int mph_validate(const mph *mph);
+/* Writes a function in the container format (see dump.h), as GOVMinimalPerfectHashFunction.dump()
+   in Java, recording the given transformation strategy (e.g., DUMP_RAW_BYTE_ARRAY); returns zero
+   on success. */
+int mph_dump(const mph *mph, int strategy, const char *path);
 int64_t mph_get_byte_array(const mph *mph, char *key, uint64_t len);
 int64_t mph_get_uint64_t(const mph *mph, uint64_t key);
 int64_t mph_get_uint128_t(const mph *mph, __uint128_t key);
+int64_t mph_get_signature(const mph *mph, const uint64_t signature[4]);
+/* Stores in result the values of n signatures, prefetching for groups of signatures first the
+   offsets and seeds of their buckets, and then the values of the vertices of their equations. */
+void mph_get_signature_batch(const mph *mph, const uint64_t (*signature)[4], int64_t *result, uint64_t n);
+
+#endif /* MPH_H_INCLUDED */
@@ -0,0 +1,799 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* The construction of GOVMinimalPerfectHashFunction, as in Java: in each bucket, the hypergraph
+   is peeled; the remaining edges are oriented using the selfless algorithm (see
+   Orient3Hypergraph), and the resulting system on F_3, whose variables are the hinges, is solved by
+   lazy Gaussian elimination (see Modulo3System). Hinges get a nonzero value, so the value of a key
+   is the number of nonzero values preceding its hinge. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "spooky.h"
+#include "mph_builder.h"
+
+#define SEED_STEP (UINT64_C(1) << 56)
+#define C_TIMES_256 (int)(floor((1.09 + 0.01) * 256))
+#define SEGMENT_SHIFT (64 - MPH_BUILDER_LOG2_SEGMENTS)
+#define BUFFER_SIZE (1 << 16)
+
+static inline uint64_t vertex_offset(const uint64_t edge_offset) {
+	return edge_offset * C_TIMES_256 >> 8;
+}
+
+static inline uint64_t bucket(const uint64_t signature0, const uint64_t multiplier) {
+	return ((__uint128_t)(signature0 >> 1) * multiplier) >> 64;
+}
+
+static FILE *open_segment(const char *temp_dir) {
+	if (temp_dir == NULL) return tmpfile();
+	char * const path = malloc(strlen(temp_dir) + sizeof "/mph_builderXXXXXX");
+	if (path == NULL) return NULL;
+	strcpy(path, temp_dir);
+	strcat(path, "/mph_builderXXXXXX");
+	const int h = mkstemp(path);
+	if (h >= 0) unlink(path);
+	free(path);
+	return h < 0 ? NULL : fdopen(h, "w+");
+}
+
+mph_builder *mph_builder_new(const char *temp_dir, const uint64_t global_seed) {
+	mph_builder *builder = calloc(1, sizeof *builder);
+	if (builder == NULL) return NULL;
+	builder->global_seed = global_seed;
+	for (int i = 0; i < MPH_BUILDER_SEGMENTS; i++)
+		if ((builder->segment[i] = open_segment(temp_dir)) == NULL || setvbuf(builder->segment[i], NULL, _IOFBF, BUFFER_SIZE) != 0) {
+			mph_builder_free(builder);
+			return NULL;
+		}
+	return builder;
+}
+
+int mph_builder_reset(mph_builder *builder, const uint64_t global_seed) {
+	for (int i = 0; i < MPH_BUILDER_SEGMENTS; i++) {
+		if (fflush(builder->segment[i]) != 0 || ftruncate(fileno(builder->segment[i]), 0) != 0 || fseeko(builder->segment[i], 0, SEEK_SET) != 0) return -1;
+		builder->count[i] = 0;
+	}
+	builder->size = 0;
+	builder->global_seed = global_seed;
+	return 0;
+}
+
+int mph_builder_add_signature(mph_builder *builder, const uint64_t signature[4]) {
+	const int s = signature[0] >> SEGMENT_SHIFT;
+	if (fwrite(signature, sizeof *signature, 2, builder->segment[s]) != 2) return -1;
+	builder->count[s]++;
+	builder->size++;
+	return 0;
+}
+
+int mph_builder_add_byte_array(mph_builder *builder, const char *key, const uint64_t len) {
+	uint64_t signature[4];
+	spooky_short(key, len, builder->global_seed, signature);
+	return mph_builder_add_signature(builder, signature);
+}
+
+int mph_builder_add_uint64_t(mph_builder *builder, const uint64_t key) {
+	uint64_t signature[4];
+	spooky_short(&key, 8, builder->global_seed, signature);
+	return mph_builder_add_signature(builder, signature);
+}
+
+/* The keys of a batch hashed by a thread, which then writes the signatures of each segment at once. */
+typedef struct {
+	mph_builder *builder;
+	char * const *key; // Byte arrays, or NULL if the keys are in data
+	const int *len;
+	const uint64_t *data;
+	uint64_t start, end;
+	uint64_t count[MPH_BUILDER_SEGMENTS];
+	int status;
+} add_job;
+
+static void *add_worker(void *arg) {
+	add_job * const job = arg;
+	const uint64_t n = job->end - job->start;
+	uint64_t (* const signature)[2] = malloc(n * sizeof *signature), (* const sorted)[2] = malloc(n * sizeof *sorted);
+	if (signature == NULL || sorted == NULL) {
+		free(signature);
+		free(sorted);
+		job->status = -1;
+		return NULL;
+	}
+
+	for (uint64_t i = 0; i < n; i++) {
+		uint64_t h[4];
+		if (job->key != NULL) spooky_short(job->key[job->start + i], job->len[job->start + i], job->builder->global_seed, h);
+		else spooky_short(&job->data[job->start + i], 8, job->builder->global_seed, h);
+		signature[i][0] = h[0];
+		signature[i][1] = h[1];
+		job->count[h[0] >> SEGMENT_SHIFT]++;
+	}
+
+	// Counting sort by segment
+	uint64_t start[MPH_BUILDER_SEGMENTS];
+	start[0] = 0;
+	for (int s = 1; s < MPH_BUILDER_SEGMENTS; s++) start[s] = start[s - 1] + job->count[s - 1];
+	for (uint64_t i = 0; i < n; i++) memcpy(sorted[start[signature[i][0] >> SEGMENT_SHIFT]++], signature[i], sizeof *sorted);
+
+	// fwrite() locks the stream, so the runs of different threads do not interleave
+	for (int s = 0; s < MPH_BUILDER_SEGMENTS; s++) {
+		const uint64_t count = job->count[s];
+		if (count != 0 && fwrite(sorted[start[s] - count], sizeof *sorted, count, job->builder->segment[s]) != count) job->status = -1;
+	}
+	free(signature);
+	free(sorted);
+	return NULL;
+}
+
+static int add_batch(mph_builder *builder, char * const *key, const int *len, const uint64_t *data, const uint64_t n, int threads) {
+	if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads <= 0) threads = 1;
+	if ((uint64_t)threads > n) threads = n;
+	if (threads == 0) return 0;
+
+	add_job * const job = calloc(threads, sizeof *job);
+	pthread_t * const thread = calloc(threads, sizeof *thread);
+	int status = job == NULL || thread == NULL ? -1 : 0;
+	int started = 0;
+	const uint64_t chunk = n / threads, extra = n % threads;
+	for (; status == 0 && started < threads; started++) {
+		// The first n % threads chunks have one more key
+		const uint64_t t = started, start = t * chunk + (t < extra ? t : extra);
+		job[started] = (add_job){ .builder = builder, .key = key, .len = len, .data = data, .start = start, .end = start + chunk + (t < extra) };
+		if (pthread_create(thread + started, NULL, add_worker, job + started) != 0) {
+			status = -1;
+			break;
+		}
+	}
+	for (int t = 0; t < started; t++) {
+		pthread_join(thread[t], NULL);
+		if (job[t].status != 0) status = -1;
+		for (int s = 0; s < MPH_BUILDER_SEGMENTS; s++) builder->count[s] += job[t].count[s];
+		builder->size += job[t].end - job[t].start;
+	}
+	free(job);
+	free(thread);
+	return status;
+}
+
+int mph_builder_add_byte_array_batch(mph_builder *builder, char * const *key, const int *len, const uint64_t n, const int threads) {
+	return add_batch(builder, key, len, NULL, n, threads);
+}
+
+int mph_builder_add_uint64_t_batch(mph_builder *builder, const uint64_t *key, const uint64_t n, const int threads) {
+	return add_batch(builder, NULL, NULL, key, n, threads);
+}
+
+void mph_builder_free(mph_builder *builder) {
+	for (int i = 0; i < MPH_BUILDER_SEGMENTS; i++)
+		if (builder->segment[i] != NULL) fclose(builder->segment[i]);
+	free(builder);
+}
+
+/* The memory used by a thread to solve buckets, reallocated when a larger bucket shows up. */
+typedef struct {
+	int max_edges, max_vertices, max_words;
+	uint64_t (*signature)[2]; // The signatures of the bucket, sorted to find duplicates
+	int (*edge)[3];
+	int *d, *xor_edge, *stack, *peeled;
+	// Orientation
+	int *core, *vertex_start, *vertex_edge, *weight, *done, *is_hinge, *priority, *position, *queue[8], queue_size[8], *hinge;
+	// Lazy Gaussian elimination: rows are two bit planes (coefficient 1 and 2) over the hinges
+	uint64_t *plus, *minus, *idle, *solution_plus, *solution_minus;
+	int *c, *row_priority, *var_weight, *var_start, *var_row, *variables, *count, *rows, *solved, *pivot, *dense, *dense_pivot;
+	uint8_t *solution;
+} workspace;
+
+static void *grow(void *p, const size_t size) {
+	void * const q = realloc(p, size != 0 ? size : 1);
+	if (q == NULL) free(p);
+	return q;
+}
+
+static int ensure(workspace *w, const int m, const int nv) {
+	const int words = (m + 63) / 64;
+	if (m > w->max_edges) {
+		w->max_edges = m;
+		int ok = (w->signature = grow(w->signature, m * sizeof *w->signature)) && (w->edge = grow(w->edge, m * sizeof *w->edge));
+		ok = ok && (w->peeled = grow(w->peeled, m * sizeof(int))) && (w->core = grow(w->core, m * sizeof(int)));
+		ok = ok && (w->vertex_edge = grow(w->vertex_edge, 3 * m * sizeof(int))) && (w->weight = grow(w->weight, m * sizeof(int)));
+		ok = ok && (w->done = grow(w->done, m * sizeof(int))) && (w->hinge = grow(w->hinge, m * sizeof(int)));
+		ok = ok && (w->c = grow(w->c, m * sizeof(int))) && (w->row_priority = grow(w->row_priority, m * sizeof(int)));
+		ok = ok && (w->var_weight = grow(w->var_weight, m * sizeof(int))) && (w->var_start = grow(w->var_start, (m + 1) * sizeof(int)));
+		ok = ok && (w->var_row = grow(w->var_row, 3 * m * sizeof(int))) && (w->variables = grow(w->variables, m * sizeof(int)));
+		ok = ok && (w->rows = grow(w->rows, m * sizeof(int))) && (w->solved = grow(w->solved, m * sizeof(int)));
+		ok = ok && (w->pivot = grow(w->pivot, m * sizeof(int))) && (w->dense = grow(w->dense, m * sizeof(int)));
+		ok = ok && (w->dense_pivot = grow(w->dense_pivot, m * sizeof(int))) && (w->count = grow(w->count, (m + 1) * sizeof(int)));
+		if (!ok) return -1;
+	}
+	if (nv > w->max_vertices) {
+		w->max_vertices = nv;
+		int ok = (w->d = grow(w->d, nv * sizeof(int))) && (w->xor_edge = grow(w->xor_edge, nv * sizeof(int)));
+		ok = ok && (w->stack = grow(w->stack, nv * sizeof(int))) && (w->vertex_start = grow(w->vertex_start, (nv + 1) * sizeof(int)));
+		ok = ok && (w->is_hinge = grow(w->is_hinge, nv * sizeof(int))) && (w->priority = grow(w->priority, nv * sizeof(int)));
+		ok = ok && (w->position = grow(w->position, nv * sizeof(int))) && (w->solution = grow(w->solution, nv));
+		for (int i = 0; i < 8; i++) ok = ok && (w->queue[i] = grow(w->queue[i], nv * sizeof(int)));
+		if (!ok) return -1;
+	}
+	if ((uint64_t)words * m > (uint64_t)w->max_words) {
+		w->max_words = words * m;
+		int ok = (w->plus = grow(w->plus, (size_t)words * m * sizeof(uint64_t))) && (w->minus = grow(w->minus, (size_t)words * m * sizeof(uint64_t)));
+		ok = ok && (w->idle = grow(w->idle, words * sizeof(uint64_t))) && (w->solution_plus = grow(w->solution_plus, words * sizeof(uint64_t)));
+		ok = ok && (w->solution_minus = grow(w->solution_minus, words * sizeof(uint64_t)));
+		if (!ok) return -1;
+	}
+	return 0;
+}
+
+static void free_workspace(workspace *w) {
+	free(w->signature); free(w->edge); free(w->d); free(w->xor_edge); free(w->stack); free(w->peeled);
+	free(w->core); free(w->vertex_start); free(w->vertex_edge); free(w->weight); free(w->done); free(w->is_hinge);
+	free(w->priority); free(w->position); free(w->hinge);
+	for (int i = 0; i < 8; i++) free(w->queue[i]);
+	free(w->plus); free(w->minus); free(w->idle); free(w->solution_plus); free(w->solution_minus);
+	free(w->c); free(w->row_priority); free(w->var_weight); free(w->var_start); free(w->var_row); free(w->variables); free(w->count);
+	free(w->rows); free(w->solved); free(w->pivot); free(w->dense); free(w->dense_pivot); free(w->solution);
+}
+
+static inline void signature_to_equation(const uint64_t *signature, const uint64_t seed, const int num_variables, int *e) {
+	uint64_t hash[4];
+	spooky_short_rehash(signature, seed, hash);
+	const int shift = __builtin_clzll(num_variables | 1);
+	const uint64_t mask = (UINT64_C(1) << shift) - 1;
+	e[0] = ((hash[0] & mask) * num_variables) >> shift;
+	e[1] = ((hash[1] & mask) * num_variables) >> shift;
+	e[2] = ((hash[2] & mask) * num_variables) >> shift;
+}
+
+/* Peels the hypergraph, storing the hinges in peeling order; returns the number of peeled edges. */
+static int peel(workspace *w, const int nv) {
+	int (* const edge)[3] = w->edge;
+	int * const d = w->d, * const xor_edge = w->xor_edge, * const stack = w->stack;
+	int top = 0;
+	for (int x = 0; x < nv; x++) {
+		if (d[x] != 1) continue;
+		int pos = top, curr = top;
+		stack[top++] = x;
+		while (pos < top) {
+			const int v = stack[pos++];
+			if (d[v] != 1) continue; // Skip no longer useful entries
+			stack[curr++] = v;
+			const int e = xor_edge[v];
+			w->peeled[e] = 1;
+			const int a = edge[e][0], b = edge[e][1], c = edge[e][2];
+			if (a != v) xor_edge[a] ^= e;
+			if (b != v) xor_edge[b] ^= e;
+			if (c != v) xor_edge[c] ^= e;
+			d[a]--;
+			d[b]--;
+			d[c]--;
+			if (d[a] == 1) stack[top++] = a;
+			if (d[b] == 1 && b != a) stack[top++] = b;
+			if (d[c] == 1 && c != a && c != b) stack[top++] = c;
+		}
+		top = curr;
+	}
+	return top;
+}
+
+static void queue_remove(workspace *w, const int q, const int v) {
+	const int position = w->position[v];
+	const int last = w->queue[q][--w->queue_size[q]];
+	if (position == w->queue_size[q]) return;
+	w->queue[q][w->position[last] = position] = last;
+}
+
+static void queue_move(workspace *w, const int v, const int before, const int after) {
+	if (before == after) return;
+	queue_remove(w, before, v);
+	w->position[v] = w->queue_size[after];
+	w->queue[after][w->queue_size[after]++] = v;
+}
+
+static inline int min7(const int x) {
+	return x < 7 ? x : 7;
+}
+
+/* Orients the core edges, whose vertices have the given core degrees, with the selfless algorithm
+   (see Orient3Hypergraph in Java): priorities are multiplied by 6, queues 0-6 contain vertices
+   of that priority and queue 7 vertices of larger priority. Returns zero on success. */
+static int orient(workspace *w, const int core_m, const int nv) {
+	int (* const edge)[3] = w->edge;
+	int * const core = w->core, * const d = w->d, * const priority = w->priority, * const weight = w->weight;
+	int * const is_hinge = w->is_hinge, * const done = w->done;
+
+	// Incidence lists of the core, with repetitions for repeated vertices
+	w->vertex_start[0] = 0;
+	for (int v = 0; v < nv; v++) w->vertex_start[v + 1] = w->vertex_start[v] + d[v];
+	for (int v = 0; v < nv; v++) w->position[v] = w->vertex_start[v];
+	for (int j = 0; j < core_m; j++)
+		for (int k = 0; k < 3; k++) w->vertex_edge[w->position[edge[core[j]][k]]++] = j;
+
+	memset(w->queue_size, 0, sizeof w->queue_size);
+	for (int v = 0; v < nv; v++) {
+		is_hinge[v] = 0;
+		priority[v] = 2 * d[v];
+		if (d[v] > 0) {
+			const int q = min7(priority[v]);
+			w->position[v] = w->queue_size[q];
+			w->queue[q][w->queue_size[q]++] = v;
+		}
+	}
+	for (int j = 0; j < core_m; j++) {
+		weight[j] = 3;
+		done[j] = 0;
+	}
+
+	for (int t = 0; t < core_m; t++) {
+		int min_priority = 0;
+		while (min_priority < 8 && w->queue_size[min_priority] == 0) min_priority++;
+		if (min_priority == 8) return -1;
+		const int hinge = w->queue[min_priority][--w->queue_size[min_priority]];
+		int chosen = -1, min_weight = 4;
+		for (int i = w->vertex_start[hinge + 1]; i-- != w->vertex_start[hinge];) {
+			const int e = w->vertex_edge[i];
+			if (!done[e] && weight[e] < min_weight) {
+				chosen = e;
+				min_weight = weight[e];
+			}
+		}
+		if (chosen == -1 || priority[hinge] > 6) return -1;
+		w->hinge[chosen] = hinge;
+		is_hinge[hinge] = 1;
+		done[chosen] = 1;
+
+		for (int i = w->vertex_start[hinge + 1]; i-- != w->vertex_start[hinge];) {
+			const int e = w->vertex_edge[i];
+			if (done[e]) continue;
+			// An edge whose vertices are all hinges cannot be oriented
+			if (weight[e] == 1) return -1;
+			const int update = -6 / weight[e] + 6 / (weight[e] - 1);
+			weight[e]--;
+			for (int k = 0; k < 3; k++) {
+				const int v = edge[core[e]][k];
+				if (is_hinge[v]) continue;
+				const int before = min7(priority[v]);
+				priority[v] += update;
+				queue_move(w, v, before, min7(priority[v]));
+			}
+		}
+
+		for (int k = 0; k < 3; k++) {
+			const int v = edge[core[chosen]][k];
+			d[v]--;
+			if (is_hinge[v]) continue;
+			const int before = min7(priority[v]);
+			if (d[v] == 0) queue_remove(w, before, v);
+			else {
+				if (d[v] == 1) priority[v] = 0;
+				else priority[v] -= 6 / weight[chosen];
+				queue_move(w, v, before, min7(priority[v]));
+			}
+		}
+	}
+	return 0;
+}
+
+/* Arithmetic on F_3 vectors represented by two bit planes (the positions of the ones and of the twos). */
+
+static inline int get3(const uint64_t *plus, const uint64_t *minus, const int i) {
+	return (plus[i / 64] >> i % 64 & 1) | (minus[i / 64] >> i % 64 & 1) << 1;
+}
+
+static inline void set3(uint64_t *plus, uint64_t *minus, const int i, const int value) {
+	const uint64_t bit = UINT64_C(1) << i % 64;
+	plus[i / 64] = (plus[i / 64] & ~bit) | (value == 1 ? bit : 0);
+	minus[i / 64] = (minus[i / 64] & ~bit) | (value == 2 ? bit : 0);
+}
+
+/* Adds to (p, n) the vector (q, o) (pass (o, q) to subtract it). */
+static inline void add3(uint64_t *p, uint64_t *n, const uint64_t *q, const uint64_t *o, const int words) {
+	for (int i = 0; i < words; i++) {
+		const uint64_t a1 = p[i], a2 = n[i], b1 = q[i], b2 = o[i];
+		p[i] = (a1 & ~(b1 | b2)) | (b1 & ~(a1 | a2)) | (a2 & b2);
+		n[i] = (a2 & ~(b1 | b2)) | (b2 & ~(a1 | a2)) | (a1 & b1);
+	}
+}
+
+static inline int dot3(const uint64_t *p, const uint64_t *n, const uint64_t *sp, const uint64_t *sn, const int words) {
+	int64_t s = 0;
+	for (int i = 0; i < words; i++) s += __builtin_popcountll(p[i] & sp[i]) + __builtin_popcountll(n[i] & sn[i]) - __builtin_popcountll(p[i] & sn[i]) - __builtin_popcountll(n[i] & sp[i]);
+	return (s % 3 + 3) % 3;
+}
+
+/* Subtracts from row i the multiple of row j cancelling variable v. */
+static inline void eliminate(workspace *w, const int words, const int i, const int j, const int v) {
+	uint64_t * const pi = w->plus + (size_t)i * words, * const ni = w->minus + (size_t)i * words;
+	const uint64_t * const pj = w->plus + (size_t)j * words, * const nj = w->minus + (size_t)j * words;
+	// The inverse of a nonzero element of F_3 is the element itself
+	const int f = get3(pi, ni, v) * get3(pj, nj, v) % 3;
+	if (f == 0) return;
+	if (f == 1) add3(pi, ni, nj, pj, words);
+	else add3(pi, ni, pj, nj, words);
+	w->c[i] = ((w->c[i] - f * w->c[j]) % 3 + 3) % 3;
+}
+
+/* Solves by lazy Gaussian elimination (see Modulo3System in Java) the system whose equations are the
+   core edges, whose variables are their hinges (variable j is the hinge of core edge j) and whose
+   known terms are the positions of the hinges in the edges, storing the solution in the planes of
+   the solution. Returns zero on success. */
+static int solve_core(workspace *w, const int core_m) {
+	int (* const edge)[3] = w->edge;
+	int * const c = w->c, * const row_priority = w->row_priority, * const var_weight = w->var_weight;
+	const int words = (core_m + 63) / 64;
+	// The variable of each core vertex (-1 if it is not a hinge); queue positions are no longer needed
+	int * const variable = w->position;
+	for (int j = 0; j < core_m; j++) for (int k = 0; k < 3; k++) variable[edge[w->core[j]][k]] = -1;
+	for (int j = 0; j < core_m; j++) variable[w->hinge[j]] = j;
+
+	memset(w->plus, 0, (size_t)words * core_m * sizeof *w->plus);
+	memset(w->minus, 0, (size_t)words * core_m * sizeof *w->minus);
+	memset(var_weight, 0, core_m * sizeof *var_weight);
+	for (int j = 0; j < core_m; j++) {
+		const int * const e = edge[w->core[j]];
+		uint64_t * const p = w->plus + (size_t)j * words, * const n = w->minus + (size_t)j * words;
+		for (int k = 0; k < 3; k++) if (variable[e[k]] >= 0) set3(p, n, variable[e[k]], (get3(p, n, variable[e[k]]) + 1) % 3);
+		c[j] = w->hinge[j] == e[0] ? 0 : w->hinge[j] == e[1] ? 1 : 2;
+		row_priority[j] = 0;
+		for (int k = 0; k < 3; k++) {
+			const int v = variable[e[k]];
+			// Count each variable with nonzero coefficient once
+			if (v < 0 || get3(p, n, v) == 0 || (k > 0 && variable[e[0]] == v) || (k > 1 && variable[e[1]] == v)) continue;
+			row_priority[j]++;
+			var_weight[v]++;
+		}
+	}
+
+	// The rows in which each variable appears
+	w->var_start[0] = 0;
+	for (int v = 0; v < core_m; v++) w->var_start[v + 1] = w->var_start[v] + var_weight[v];
+	int * const fill = w->pivot;
+	memcpy(fill, w->var_start, core_m * sizeof *fill);
+	for (int j = 0; j < core_m; j++) {
+		const int * const e = edge[w->core[j]];
+		const uint64_t * const p = w->plus + (size_t)j * words, * const n = w->minus + (size_t)j * words;
+		for (int k = 0; k < 3; k++) {
+			const int v = variable[e[k]];
+			if (v < 0 || get3(p, n, v) == 0 || (k > 0 && variable[e[0]] == v) || (k > 1 && variable[e[1]] == v)) continue;
+			w->var_row[fill[v]++] = j;
+		}
+	}
+
+	// Variables by increasing weight (heavier variables are made active first)
+	int * const count = w->count, * const variables = w->variables;
+	memset(count, 0, (core_m + 1) * sizeof *count);
+	for (int v = 0; v < core_m; v++) count[var_weight[v]]++;
+	for (int i = 1; i <= core_m; i++) count[i] += count[i - 1];
+	for (int v = core_m; v-- != 0;) variables[--count[var_weight[v]]] = v;
+	int num_variables = core_m;
+
+	int * const list = w->rows;
+	int list_size = 0;
+	for (int j = core_m; j-- != 0;) if (row_priority[j] <= 1) list[list_size++] = j;
+
+	uint64_t * const idle = w->idle;
+	memset(idle, 0xFF, words * sizeof *idle);
+	int num_solved = 0, num_dense = 0;
+
+	for (int remaining = core_m; remaining != 0;) {
+		if (list_size == 0) {
+			// Make another variable active
+			int v;
+			do v = variables[--num_variables]; while (var_weight[v] == 0);
+			idle[v / 64] &= ~(UINT64_C(1) << v % 64);
+			for (int i = w->var_start[v]; i < w->var_start[v + 1]; i++)
+				if (--row_priority[w->var_row[i]] == 1) list[list_size++] = w->var_row[i];
+			continue;
+		}
+
+		remaining--;
+		const int j = list[--list_size];
+		const uint64_t * const p = w->plus + (size_t)j * words, * const n = w->minus + (size_t)j * words;
+		if (row_priority[j] == 0) {
+			int zero = 1;
+			for (int i = 0; i < words && zero; i++) zero = (p[i] | n[i]) == 0;
+			if (zero) {
+				if (c[j] != 0) return -1;
+				continue;
+			}
+			// All variables are active: this equation is solved by standard Gaussian elimination
+			w->dense[num_dense++] = j;
+		}
+		else {
+			// The only idle variable is the pivot
+			int i = 0;
+			while (((p[i] | n[i]) & idle[i]) == 0) i++;
+			const int v = i * 64 + __builtin_ctzll((p[i] | n[i]) & idle[i]);
+			w->solved[num_solved] = j;
+			w->pivot[num_solved++] = v;
+			var_weight[v] = 0;
+			for (int k = w->var_start[v]; k < w->var_start[v + 1]; k++) {
+				const int r = w->var_row[k];
+				if (r == j) continue;
+				if (--row_priority[r] == 1) list[list_size++] = r;
+				eliminate(w, words, r, j, v);
+			}
+		}
+	}
+
+	// Gaussian elimination on the dense equations
+	uint64_t * const sp = w->solution_plus, * const sn = w->solution_minus;
+	memset(sp, 0, words * sizeof *sp);
+	memset(sn, 0, words * sizeof *sn);
+	int num_pivots = 0;
+	int * const dense_pivot = w->dense_pivot;
+	for (int d = 0; d < num_dense; d++) {
+		const int j = w->dense[d];
+		for (int k = 0; k < num_pivots; k++) eliminate(w, words, j, w->dense[k], dense_pivot[k]);
+		const uint64_t * const p = w->plus + (size_t)j * words, * const n = w->minus + (size_t)j * words;
+		int i = 0;
+		while (i < words && (p[i] | n[i]) == 0) i++;
+		if (i == words) {
+			if (c[j] != 0) return -1;
+			continue;
+		}
+		w->dense[num_pivots] = j;
+		dense_pivot[num_pivots++] = i * 64 + __builtin_ctzll(p[i] | n[i]);
+	}
+	// Later rows do not contain earlier pivots; free variables are zero
+	for (int k = num_pivots; k-- != 0;) {
+		const int j = w->dense[k], v = dense_pivot[k];
+		const uint64_t * const p = w->plus + (size_t)j * words, * const n = w->minus + (size_t)j * words;
+		const int sum = (c[j] - dot3(p, n, sp, sn, words) + 3) % 3;
+		set3(sp, sn, v, sum * get3(p, n, v) % 3);
+	}
+
+	for (int k = num_solved; k-- != 0;) {
+		const int j = w->solved[k], v = w->pivot[k];
+		const uint64_t * const p = w->plus + (size_t)j * words, * const n = w->minus + (size_t)j * words;
+		const int sum = (c[j] - dot3(p, n, sp, sn, words) + 3) % 3;
+		set3(sp, sn, v, sum * get3(p, n, v) % 3);
+	}
+	return 0;
+}
+
+/* Generates the hypergraph of a bucket with a given seed and tries to compute the values of its
+   vertices; returns zero on success, 1 if the core is not orientable and 2 if the system is not
+   solvable. */
+static int solve_bucket(workspace *w, const int m, const int nv, const uint64_t seed) {
+	int (* const edge)[3] = w->edge;
+	int * const d = w->d, * const xor_edge = w->xor_edge;
+	uint8_t * const solution = w->solution;
+	memset(d, 0, nv * sizeof *d);
+	memset(xor_edge, 0, nv * sizeof *xor_edge);
+	memset(solution, 0, nv);
+	for (int i = 0; i < m; i++) {
+		signature_to_equation(w->signature[i], seed, nv, edge[i]);
+		w->peeled[i] = 0;
+		for (int k = 0; k < 3; k++) {
+			d[edge[i][k]]++;
+			xor_edge[edge[i][k]] ^= i;
+		}
+	}
+
+	int top = peel(w, nv);
+
+	if (top != m) {
+		// The remaining edges and their degrees
+		int core_m = 0;
+		memset(d, 0, nv * sizeof *d);
+		for (int i = 0; i < m; i++) {
+			if (w->peeled[i]) continue;
+			w->core[core_m++] = i;
+			for (int k = 0; k < 3; k++) d[edge[i][k]]++;
+		}
+		if (orient(w, core_m, nv) != 0) return 1;
+		if (solve_core(w, core_m) != 0) return 2;
+		for (int j = 0; j < core_m; j++) {
+			const int value = get3(w->solution_plus, w->solution_minus, j);
+			solution[w->hinge[j]] = value == 0 ? 3 : value;
+		}
+	}
+
+	// Complete with peeled edges, in reverse peeling order
+	while (top > 0) {
+		const int v = w->stack[--top];
+		const int e = xor_edge[v];
+		const int k = v == edge[e][0] ? 0 : v == edge[e][1] ? 1 : 2;
+		int s = 0;
+		for (int i = 0; i < 3; i++) if (edge[e][i] != v) s += solution[edge[e][i]];
+		s = (k - s % 3 + 3) % 3;
+		solution[v] = s == 0 ? 3 : s;
+	}
+	return 0;
+}
+
+/* The complete buckets of a segment, solved in parallel. */
+typedef struct {
+	const uint64_t (*signature)[2]; // The signatures of the segment, grouped by bucket
+	const uint64_t *start; // The start of each bucket in signature
+	const uint64_t *edge_offset; // The edge offset of each bucket (one more than the buckets)
+	uint64_t first_bucket, num_buckets;
+	atomic_uint_fast64_t next;
+	atomic_int status;
+	atomic_uint_fast64_t unsolvable, unorientable;
+	mph *mph;
+} segment_job;
+
+typedef struct {
+	segment_job *job;
+	workspace *workspace;
+} worker_arg;
+
+static int compare_signatures(const void *a, const void *b) {
+	const uint64_t *x = a, *y = b;
+	if (x[0] != y[0]) return x[0] < y[0] ? -1 : 1;
+	return x[1] < y[1] ? -1 : x[1] > y[1];
+}
+
+static int build_bucket(segment_job *job, workspace *w, const uint64_t i) {
+	const int m = job->start[i + 1] - job->start[i];
+	const uint64_t base = vertex_offset(job->edge_offset[i]);
+	const int nv = vertex_offset(job->edge_offset[i + 1]) - base;
+	if (ensure(w, m, nv) != 0) return -1;
+
+	memcpy(w->signature, job->signature + job->start[i], m * sizeof *w->signature);
+	qsort(w->signature, m, sizeof *w->signature, compare_signatures);
+	for (int k = 1; k < m; k++)
+		if (w->signature[k][0] == w->signature[k - 1][0] && w->signature[k][1] == w->signature[k - 1][1]) return MPH_BUILDER_DUPLICATE;
+
+	uint64_t seed = 0;
+	for (int result; (result = solve_bucket(w, m, nv, seed)) != 0;) {
+		if (result == 1) atomic_fetch_add_explicit(&job->unorientable, 1, memory_order_relaxed);
+		else atomic_fetch_add_explicit(&job->unsolvable, 1, memory_order_relaxed);
+		if ((seed += SEED_STEP) == 0) return -1; // All seeds have failed
+	}
+	job->mph->edge_offset_and_seed[job->first_bucket + i] |= seed;
+
+	// Words at the boundary of the bucket might be shared with other threads
+	uint64_t * const array = job->mph->array;
+	uint64_t word = 0, index = base * 2 / 64;
+	for (int k = 0; k < nv; k++) {
+		const uint64_t pos = (base + k) * 2;
+		if (pos / 64 != index) {
+			if (word != 0) __atomic_fetch_or(array + index, word, __ATOMIC_RELAXED);
+			index = pos / 64;
+			word = 0;
+		}
+		word |= (uint64_t)w->solution[k] << pos % 64;
+	}
+	if (word != 0) __atomic_fetch_or(array + index, word, __ATOMIC_RELAXED);
+	return 0;
+}
+
+static void *worker(void *arg) {
+	segment_job * const job = ((worker_arg *)arg)->job;
+	workspace * const w = ((worker_arg *)arg)->workspace;
+	for (;;) {
+		const uint64_t i = atomic_fetch_add(&job->next, 1);
+		if (i >= job->num_buckets || atomic_load_explicit(&job->status, memory_order_relaxed) != 0) return NULL;
+		const int result = build_bucket(job, w, i);
+		if (result != 0) atomic_store(&job->status, result);
+	}
+}
+
+static int read_segment(FILE *segment, uint64_t (*signature)[2], const uint64_t count) {
+	if (fflush(segment) != 0 || fseeko(segment, 0, SEEK_SET) != 0) return -1;
+	if (fread(signature, sizeof *signature, count, segment) != count) return -1;
+	// We might add more keys later
+	return fseeko(segment, 0, SEEK_END);
+}
+
+int mph_builder_build(mph_builder *builder, int threads, mph *mph) {
+	if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads <= 0) threads = 1;
+	const uint64_t n = builder->size;
+	const uint64_t num_buckets = n / MPH_BUILDER_BUCKET_SIZE + 1;
+
+	memset(mph, 0, sizeof *mph);
+	mph->size = n;
+	mph->multiplier = num_buckets * 2;
+	mph->global_seed = builder->global_seed;
+	mph->edge_offset_and_seed_length = num_buckets + 1;
+	mph->edge_offset_and_seed = calloc(mph->edge_offset_and_seed_length, sizeof *mph->edge_offset_and_seed);
+	// One more value, so that an empty last bucket fits the array
+	mph->array_length = ((vertex_offset(n) + 1) * 2 + 63) / 64;
+	mph->array = calloc(mph->array_length, sizeof *mph->array);
+
+	workspace * const w = calloc(threads, sizeof *w);
+	worker_arg * const arg = calloc(threads, sizeof *arg);
+	pthread_t * const thread = calloc(threads, sizeof *thread);
+	uint64_t (*signature)[2] = NULL, (*sorted)[2] = NULL, *start = NULL, *edge_offset = NULL;
+	uint64_t capacity = 0, start_capacity = 0;
+	int status = mph->edge_offset_and_seed == NULL || mph->array == NULL || w == NULL || arg == NULL || thread == NULL ? -1 : 0;
+	builder->unsolvable = builder->unorientable = 0;
+
+	// Signatures of the last (incomplete) bucket of a segment are carried to the next one
+	uint64_t first_bucket = 0, residual = 0, offset = 0;
+	for (int s = 0; s < MPH_BUILDER_SEGMENTS && status == 0; s++) {
+		const uint64_t last_bucket = s == MPH_BUILDER_SEGMENTS - 1 ? num_buckets - 1 : bucket(((uint64_t)(s + 1) << SEGMENT_SHIFT) - 1, mph->multiplier);
+		const uint64_t count = residual + builder->count[s];
+		if (count > capacity) {
+			capacity = count + count / 2;
+			if ((signature = grow(signature, capacity * sizeof *signature)) == NULL || (sorted = grow(sorted, capacity * sizeof *sorted)) == NULL) {
+				status = -1;
+				break;
+			}
+		}
+		if (read_segment(builder->segment[s], signature + residual, builder->count[s]) != 0) {
+			status = -1;
+			break;
+		}
+
+		// Counting sort by bucket
+		const uint64_t nb = last_bucket - first_bucket + 1;
+		if (nb + 1 > start_capacity) {
+			start_capacity = nb + 1;
+			if ((start = grow(start, start_capacity * sizeof *start)) == NULL || (edge_offset = grow(edge_offset, start_capacity * sizeof *edge_offset)) == NULL) {
+				status = -1;
+				break;
+			}
+		}
+		memset(start, 0, (nb + 1) * sizeof *start);
+		for (uint64_t i = 0; i < residual; i++) start[1]++;
+		for (uint64_t i = residual; i < count; i++) start[bucket(signature[i][0], mph->multiplier) - first_bucket + 1]++;
+		for (uint64_t b = 1; b <= nb; b++) start[b] += start[b - 1];
+		memcpy(edge_offset, start, (nb + 1) * sizeof *start);
+		for (uint64_t i = 0; i < residual; i++) memcpy(sorted[edge_offset[0]++], signature[i], sizeof *sorted);
+		for (uint64_t i = residual; i < count; i++) memcpy(sorted[edge_offset[bucket(signature[i][0], mph->multiplier) - first_bucket]++], signature[i], sizeof *sorted);
+
+		const uint64_t complete = s == MPH_BUILDER_SEGMENTS - 1 ? nb : nb - 1;
+		for (uint64_t b = 0; b <= complete; b++) mph->edge_offset_and_seed[first_bucket + b] = edge_offset[b] = offset + start[b];
+
+		segment_job job = { .signature = (const uint64_t (*)[2])sorted, .start = start, .edge_offset = edge_offset, .first_bucket = first_bucket, .num_buckets = complete, .mph = mph };
+		int started = 0;
+		for (; started < threads && (uint64_t)started < complete; started++) {
+			arg[started] = (worker_arg){ &job, w + started };
+			if (pthread_create(thread + started, NULL, worker, arg + started) != 0) {
+				atomic_store(&job.status, -1);
+				break;
+			}
+		}
+		for (int t = 0; t < started; t++) pthread_join(thread[t], NULL);
+		status = atomic_load(&job.status);
+		builder->unsolvable += atomic_load(&job.unsolvable);
+		builder->unorientable += atomic_load(&job.unorientable);
+
+		residual = start[nb] - start[complete];
+		memcpy(signature, sorted + start[complete], residual * sizeof *signature);
+		offset += start[complete];
+		first_bucket += complete;
+	}
+
+	free(signature);
+	free(sorted);
+	free(start);
+	free(edge_offset);
+	if (w != NULL) for (int t = 0; t < threads; t++) free_workspace(w + t);
+	free(w);
+	free(arg);
+	free(thread);
+	if (status != 0) {
+		free(mph->edge_offset_and_seed);
+		free(mph->array);
+		memset(mph, 0, sizeof *mph);
+	}
+	return status;
+}
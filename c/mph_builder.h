@@ -0,0 +1,76 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MPH_BUILDER_H_INCLUDED
+#define MPH_BUILDER_H_INCLUDED
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "mph.h"
+
+/* The number of disk segments, selected by the highest bits of the signatures (as in
+   BucketedHashStore in Java). */
+#define MPH_BUILDER_LOG2_SEGMENTS 8
+#define MPH_BUILDER_SEGMENTS (1 << MPH_BUILDER_LOG2_SEGMENTS)
+/* The expected bucket size (GOVMinimalPerfectHashFunction.BUCKET_SIZE in Java). */
+#define MPH_BUILDER_BUCKET_SIZE 1500
+
+/* Returned by mph_builder_build() if two keys have the same signature. */
+#define MPH_BUILDER_DUPLICATE -2
+
+/* A builder for GOVMinimalPerfectHashFunction. Keys are hashed with the global seed as in Java
+   (in parallel, if added by batches) and their 128-bit signatures are appended to disk segments,
+   so that only a segment at a time needs to be in memory; mph_builder_build() then sorts each
+   segment into buckets by counting and solves buckets in parallel, writing directly the arrays of
+   an mph, which can be used as is or written with mph_dump(). */
+typedef struct {
+	uint64_t size;
+	uint64_t global_seed;
+	FILE *segment[MPH_BUILDER_SEGMENTS];
+	uint64_t count[MPH_BUILDER_SEGMENTS];
+	uint64_t unsolvable; // Statistics of the last call to mph_builder_build()
+	uint64_t unorientable;
+} mph_builder;
+
+/* Creates a builder whose segments are unlinked temporary files in temp_dir (or in the standard
+   temporary directory, if NULL); returns NULL on failure. */
+mph_builder *mph_builder_new(const char *temp_dir, uint64_t global_seed);
+/* Discards all keys and sets a new global seed (e.g., after a duplicate signature). */
+int mph_builder_reset(mph_builder *builder, uint64_t global_seed);
+/* Add a key; return zero on success. */
+int mph_builder_add_byte_array(mph_builder *builder, const char *key, uint64_t len);
+int mph_builder_add_uint64_t(mph_builder *builder, uint64_t key);
+/* Adds a signature computed with the global seed (only the first two words are used). */
+int mph_builder_add_signature(mph_builder *builder, const uint64_t signature[4]);
+/* Add n keys, hashing them and distributing their signatures to the segments on the given number
+   of threads (all processors if nonpositive), each handling a contiguous chunk of the keys with a
+   temporary buffer of 32 bytes per key; return zero on success. On failure, the builder must be
+   reset. */
+int mph_builder_add_byte_array_batch(mph_builder *builder, char * const *key, const int *len, uint64_t n, int threads);
+int mph_builder_add_uint64_t_batch(mph_builder *builder, const uint64_t *key, uint64_t n, int threads);
+/* Builds a function on the keys added so far using the given number of threads, filling mph with
+   arrays allocated by malloc(); returns zero on success, MPH_BUILDER_DUPLICATE if two keys have the
+   same signature (reset the builder with a different seed and add the keys again) and -1 on other
+   failures. */
+int mph_builder_build(mph_builder *builder, int threads, mph *mph);
+/* Closes the segments and frees the builder. */
+void mph_builder_free(mph_builder *builder);
+
+#endif /* MPH_BUILDER_H_INCLUDED */
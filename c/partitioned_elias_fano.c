@@ -0,0 +1,323 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "partitioned_elias_fano.h"
+#include "broadword.h"
+
+// The types of chunks, as in Java
+#define IMPLICIT 0
+#define BITMAP 1
+#define ELIAS_FANO 2
+
+/* The decoding parameters of a chunk. */
+typedef struct {
+	uint64_t first; // The first element
+	uint64_t last; // The last element (not set for implicit chunks)
+	uint64_t m; // The number of elements
+	uint64_t offset; // The position of the encoding in the bits
+	uint64_t upper; // The position of the upper bits, for Elias-Fano chunks
+	int type;
+	int l; // The number of lower bits, for Elias-Fano chunks
+} chunk;
+
+/* Returns width > 0 bits starting at the given position; the next word is read only if the field crosses its end. */
+static inline uint64_t read_bits(const uint64_t * const bits, const uint64_t position, const int width) {
+	const uint64_t start_word = position / 64;
+	const int start_bit = position % 64;
+	uint64_t result = bits[start_word] >> start_bit;
+	if (start_bit + width > 64) result |= bits[start_word + 1] << 64 - start_bit;
+	return result & UINT64_MAX >> 64 - width;
+}
+
+/* Returns the number of lower bits of an Elias-Fano chunk with m elements and universe u, as in Java. */
+static inline int lower_bits(const uint64_t m, const uint64_t u) {
+	const uint64_t q = u / m;
+	return q == 0 ? 0 : 63 - __builtin_clzll(q);
+}
+
+/* Returns the lower bits of the element of given rank of an Elias-Fano chunk. */
+static inline uint64_t chunk_lower_bits(const uint64_t * const bits, const chunk * const chunk, const uint64_t rank) {
+	return chunk->l == 0 ? 0 : read_bits(bits, chunk->offset + rank * chunk->l, chunk->l);
+}
+
+/* Returns the position, relative to from, of the one (or zero, if flip is UINT64_MAX) of given
+   rank among the bits following from, which must exist. */
+static inline uint64_t select_from(const uint64_t * const bits, const uint64_t flip, const uint64_t from, uint64_t rank) {
+	uint64_t curr = from / 64;
+	uint64_t window = (bits[curr] ^ flip) & UINT64_MAX << from % 64;
+	for (int bit_count; rank >= (bit_count = __builtin_popcountll(window)); rank -= bit_count) window = bits[++curr] ^ flip;
+	return curr * 64 + select64(window, rank) - from;
+}
+
+/* Returns the number of ones in [from, to). */
+static inline uint64_t count_ones(const uint64_t * const bits, const uint64_t from, const uint64_t to) {
+	if (from == to) return 0;
+	uint64_t curr = from / 64, count = 0;
+	const uint64_t last = (to - 1) / 64;
+	uint64_t window = bits[curr] & UINT64_MAX << from % 64;
+	for (; curr < last; window = bits[++curr]) count += __builtin_popcountll(window);
+	return count + __builtin_popcountll(window & UINT64_MAX >> 63 - (to - 1) % 64);
+}
+
+/* Fills the decoding parameters of chunk c. */
+static inline void get_chunk(const partitioned_elias_fano * const partitioned_elias_fano, const uint64_t c, chunk * const chunk) {
+	const elias_fano * const endpoints = &partitioned_elias_fano->endpoints.elias_fano;
+	const int log2_partition_size = partitioned_elias_fano->log2_partition_size;
+	const int descriptor_width = partitioned_elias_fano->descriptor_width;
+	const uint64_t descriptor = read_bits(partitioned_elias_fano->descriptors, c * descriptor_width, descriptor_width);
+	chunk->type = descriptor & 3;
+	chunk->offset = descriptor >> 2;
+	chunk->m = partitioned_elias_fano->length - (c << log2_partition_size);
+	if (chunk->m > UINT64_C(1) << log2_partition_size) chunk->m = UINT64_C(1) << log2_partition_size;
+	if (chunk->type == IMPLICIT) {
+		chunk->first = elias_fano_get(endpoints, 2 * c);
+		return;
+	}
+	// A single selection for both endpoints
+	uint64_t endpoint[2];
+	elias_fano_get_range(endpoints, 2 * c, 2 * c + 2, endpoint);
+	chunk->first = endpoint[0];
+	chunk->last = endpoint[1];
+	chunk->l = chunk->type == ELIAS_FANO ? lower_bits(chunk->m, chunk->last - chunk->first + 1) : 0;
+	chunk->upper = chunk->offset + chunk->m * chunk->l;
+}
+
+int map_partitioned_elias_fano(const void *dump, const uint64_t length, partitioned_elias_fano *partitioned_elias_fano) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_PARTITIONED_ELIAS_FANO || header->num_sections != 10) return -1;
+	// The same bounds as in Java; descriptors contain at least the type
+	if (header->param[1] > 16 || header->param[2] < 2 || header->param[2] > 63) return -1;
+	const char * const base = dump;
+	memset(partitioned_elias_fano, 0, sizeof *partitioned_elias_fano);
+	partitioned_elias_fano->length = header->param[0];
+	partitioned_elias_fano->log2_partition_size = header->param[1];
+	partitioned_elias_fano->descriptor_width = header->param[2];
+	partitioned_elias_fano->descriptors_length = header->section[8].length / sizeof *partitioned_elias_fano->descriptors;
+	partitioned_elias_fano->descriptors = (const uint64_t *)(base + header->section[8].offset);
+	partitioned_elias_fano->bits_length = header->section[9].length / sizeof *partitioned_elias_fano->bits;
+	partitioned_elias_fano->bits = (const uint64_t *)(base + header->section[9].offset);
+	return map_elias_fano_indexed_at(dump, 3, 0, &partitioned_elias_fano->endpoints);
+}
+
+int partitioned_elias_fano_validate(const partitioned_elias_fano *partitioned_elias_fano) {
+	const elias_fano * const endpoints = &partitioned_elias_fano->endpoints.elias_fano;
+	if (elias_fano_indexed_validate(&partitioned_elias_fano->endpoints) != 0) return -1;
+	const uint64_t length = partitioned_elias_fano->length;
+	const int log2_partition_size = partitioned_elias_fano->log2_partition_size;
+	const uint64_t num_chunks = (length >> log2_partition_size) + ((length & (UINT64_C(1) << log2_partition_size) - 1) != 0);
+	if (endpoints->length % 2 != 0 || endpoints->length / 2 != num_chunks) return -1;
+	if (partitioned_elias_fano->descriptors_length < (num_chunks * partitioned_elias_fano->descriptor_width + 63) / 64) return -1;
+
+	const uint64_t * const bits = partitioned_elias_fano->bits;
+	const uint64_t bits_length = partitioned_elias_fano->bits_length * 64;
+	for (uint64_t c = 0; c < num_chunks; c++) {
+		chunk chunk;
+		get_chunk(partitioned_elias_fano, c, &chunk);
+		const uint64_t last = elias_fano_get(endpoints, 2 * c + 1);
+		const uint64_t u = last - chunk.first + 1;
+		if (u == 0) return -1;
+		switch (chunk.type) {
+		case IMPLICIT:
+			if (u != chunk.m) return -1;
+			break;
+		case BITMAP:
+			if (chunk.offset > bits_length || u > bits_length - chunk.offset) return -1;
+			// The endpoints are set, and so are exactly m bits
+			if ((bits[chunk.offset / 64] & UINT64_C(1) << chunk.offset % 64) == 0) return -1;
+			if ((bits[(chunk.offset + u - 1) / 64] & UINT64_C(1) << (chunk.offset + u - 1) % 64) == 0) return -1;
+			if (count_ones(bits, chunk.offset, chunk.offset + u) != chunk.m) return -1;
+			break;
+		case ELIAS_FANO: {
+			const uint64_t upper_length = chunk.m + (u - 1 >> chunk.l);
+			if (chunk.offset > bits_length || chunk.m * chunk.l + upper_length > bits_length - chunk.offset) return -1;
+			// Exactly m ones, so that selection never leaves the chunk, and the endpoints are decoded correctly
+			if (count_ones(bits, chunk.upper, chunk.upper + upper_length) != chunk.m) return -1;
+			if ((select_from(bits, 0, chunk.upper, 0) << chunk.l | chunk_lower_bits(bits, &chunk, 0)) != 0) return -1;
+			const uint64_t r = chunk.m - 1;
+			if ((select_from(bits, 0, chunk.upper, r) - r << chunk.l | chunk_lower_bits(bits, &chunk, r)) != u - 1) return -1;
+			break;
+		}
+		default:
+			return -1;
+		}
+	}
+	return 0;
+}
+
+partitioned_elias_fano *load_partitioned_elias_fano(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	partitioned_elias_fano *partitioned_elias_fano = malloc(sizeof *partitioned_elias_fano);
+	if (partitioned_elias_fano == NULL || map_partitioned_elias_fano(map, length, partitioned_elias_fano) != 0) {
+		free(partitioned_elias_fano);
+		munmap(map, length);
+		return NULL;
+	}
+	partitioned_elias_fano->map = map;
+	partitioned_elias_fano->map_length = length;
+	return partitioned_elias_fano;
+}
+
+static int validate(const void *partitioned_elias_fano) {
+	return partitioned_elias_fano_validate(partitioned_elias_fano);
+}
+
+partitioned_elias_fano *load_partitioned_elias_fano_validated(int h) {
+	partitioned_elias_fano *partitioned_elias_fano = load_partitioned_elias_fano(h);
+	if (partitioned_elias_fano == NULL) return NULL;
+	if (partitioned_elias_fano_validate(partitioned_elias_fano) == 0) return partitioned_elias_fano;
+	munmap(partitioned_elias_fano->map, partitioned_elias_fano->map_length);
+	free(partitioned_elias_fano);
+	return NULL;
+}
+
+partitioned_elias_fano *load_partitioned_elias_fano_verify(int h, dump_verifier *verifier) {
+	partitioned_elias_fano *partitioned_elias_fano = load_partitioned_elias_fano(h);
+	if (partitioned_elias_fano == NULL) return NULL;
+	const dump_header * const header = partitioned_elias_fano->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)partitioned_elias_fano->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, partitioned_elias_fano) == 0) return partitioned_elias_fano;
+	munmap(partitioned_elias_fano->map, partitioned_elias_fano->map_length);
+	free(partitioned_elias_fano);
+	return NULL;
+}
+
+uint64_t partitioned_elias_fano_get(const partitioned_elias_fano *partitioned_elias_fano, const uint64_t index) {
+	const int log2_partition_size = partitioned_elias_fano->log2_partition_size;
+	const uint64_t rank = index & (UINT64_C(1) << log2_partition_size) - 1;
+	chunk chunk;
+	get_chunk(partitioned_elias_fano, index >> log2_partition_size, &chunk);
+
+	switch (chunk.type) {
+	case IMPLICIT:
+		return chunk.first + rank;
+	case BITMAP:
+		return chunk.first + select_from(partitioned_elias_fano->bits, 0, chunk.offset, rank);
+	default:
+		return chunk.first + (select_from(partitioned_elias_fano->bits, 0, chunk.upper, rank) - rank << chunk.l | chunk_lower_bits(partitioned_elias_fano->bits, &chunk, rank));
+	}
+}
+
+uint64_t partitioned_elias_fano_successor(const partitioned_elias_fano *partitioned_elias_fano, const uint64_t lower_bound, uint64_t *index) {
+	uint64_t i;
+	const uint64_t endpoint = elias_fano_indexed_successor(&partitioned_elias_fano->endpoints, lower_bound, &i);
+	if (i == partitioned_elias_fano->endpoints.elias_fano.length) {
+		*index = partitioned_elias_fano->length;
+		return UINT64_MAX;
+	}
+
+	const int log2_partition_size = partitioned_elias_fano->log2_partition_size;
+	const uint64_t c = i / 2, base = c << log2_partition_size;
+	// The successor is the first element of a chunk
+	if (i % 2 == 0) {
+		*index = base;
+		return endpoint;
+	}
+
+	// Otherwise, it is in chunk c, whose first element is smaller than lower_bound
+	const uint64_t * const bits = partitioned_elias_fano->bits;
+	chunk chunk;
+	get_chunk(partitioned_elias_fano, c, &chunk);
+	const uint64_t x = lower_bound - chunk.first;
+
+	switch (chunk.type) {
+	case IMPLICIT:
+		*index = base + x;
+		return lower_bound;
+	case BITMAP: {
+		const uint64_t position = chunk.offset + x;
+		uint64_t curr = position / 64;
+		uint64_t window = bits[curr] & UINT64_MAX << position % 64;
+		while (window == 0) window = bits[++curr];
+		*index = base + count_ones(bits, chunk.offset, position);
+		return chunk.first + curr * 64 + __builtin_ctzll(window) - chunk.offset;
+	}
+	default: {
+		// We skip the zeroes preceding the upper bits of x and scan the ones that follow
+		const int l = chunk.l;
+		const uint64_t zeros = x >> l;
+		const uint64_t position = zeros == 0 ? chunk.upper : chunk.upper + select_from(bits, UINT64_MAX, chunk.upper, zeros - 1) + 1;
+		uint64_t curr = position / 64;
+		uint64_t window = bits[curr] & UINT64_MAX << position % 64;
+		uint64_t rank = position - chunk.upper - zeros;
+
+		for (;;) {
+			while (window == 0) window = bits[++curr];
+			const uint64_t v = curr * 64 + __builtin_ctzll(window) - chunk.upper - rank << l | chunk_lower_bits(bits, &chunk, rank);
+			if (v >= x) {
+				*index = base + rank;
+				return chunk.first + v;
+			}
+			window &= window - 1;
+			rank++;
+		}
+	}
+	}
+}
+
+void partitioned_elias_fano_get_range(const partitioned_elias_fano *partitioned_elias_fano, uint64_t from, const uint64_t to, uint64_t *dest) {
+	// Local copies, as stores to dest might alias the structure
+	const uint64_t * const bits = partitioned_elias_fano->bits;
+	const int log2_partition_size = partitioned_elias_fano->log2_partition_size;
+	const uint64_t mask = (UINT64_C(1) << log2_partition_size) - 1;
+
+	while (from < to) {
+		chunk chunk;
+		get_chunk(partitioned_elias_fano, from >> log2_partition_size, &chunk);
+		const uint64_t start = from & mask;
+		const uint64_t end = to - from < chunk.m - start ? start + (to - from) : chunk.m;
+		const uint64_t first = chunk.first;
+
+		switch (chunk.type) {
+		case IMPLICIT:
+			for (uint64_t r = start; r < end; r++) *dest++ = first + r;
+			break;
+		case BITMAP: {
+			const uint64_t position = chunk.offset + select_from(bits, 0, chunk.offset, start);
+			uint64_t curr = position / 64;
+			uint64_t window = bits[curr] & UINT64_MAX << position % 64;
+			for (uint64_t r = start; r < end; r++) {
+				while (window == 0) window = bits[++curr];
+				*dest++ = first + curr * 64 + __builtin_ctzll(window) - chunk.offset;
+				window &= window - 1;
+			}
+			break;
+		}
+		default: {
+			const int l = chunk.l;
+			const uint64_t position = chunk.upper + select_from(bits, 0, chunk.upper, start);
+			uint64_t curr = position / 64;
+			uint64_t window = bits[curr] & UINT64_MAX << position % 64;
+			for (uint64_t r = start; r < end; r++) {
+				while (window == 0) window = bits[++curr];
+				*dest++ = first + (curr * 64 + __builtin_ctzll(window) - chunk.upper - r << l | chunk_lower_bits(bits, &chunk, r));
+				window &= window - 1;
+			}
+		}
+		}
+		from += end - start;
+	}
+}
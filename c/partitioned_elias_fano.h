@@ -0,0 +1,66 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PARTITIONED_ELIAS_FANO_H_INCLUDED
+#define PARTITIONED_ELIAS_FANO_H_INCLUDED
+
+#include <inttypes.h>
+#include "elias_fano_indexed.h"
+
+/* A view of a partitioned Elias-Fano monotone list dump (see
+   PartitionedEliasFanoMonotoneLongBigList.dump() in Java). The list is divided in chunks of
+   2^log2_partition_size elements, each encoded relative to its first element implicitly, as a
+   bitmap or as an Elias-Fano list; the first and last element of each chunk are stored in an
+   indexed Elias-Fano list. Successors return UINT64_MAX and set the index to the length of the
+   list if there is no such element. */
+typedef struct {
+	uint64_t length;
+	int log2_partition_size;
+	int descriptor_width;
+	elias_fano_indexed endpoints; // The first and last element of each chunk, interleaved
+	uint64_t descriptors_length;
+	const uint64_t *descriptors; // The position of the encoding of each chunk, shifted left by two, plus its type
+	uint64_t bits_length;
+	const uint64_t *bits; // The encodings of the chunks
+	void *map; // The mapping, if loaded by load_partitioned_elias_fano()
+	uint64_t map_length;
+} partitioned_elias_fano;
+
+/* Maps a dump in memory (no copy), with no validation (see partitioned_elias_fano_validate());
+   returns NULL if the dump is not a partitioned Elias-Fano dump. */
+partitioned_elias_fano *load_partitioned_elias_fano(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_partitioned_elias_fano(const void *dump, uint64_t length, partitioned_elias_fano *partitioned_elias_fano);
+/* Checks the endpoints, the descriptors and the encoding of every chunk; returns zero if valid. */
+int partitioned_elias_fano_validate(const partitioned_elias_fano *partitioned_elias_fano);
+/* Maps a dump and validates it (see partitioned_elias_fano_validate()); returns NULL if the dump is not valid. */
+partitioned_elias_fano *load_partitioned_elias_fano_validated(int h);
+/* Maps a dump and starts verifying it in the background (see dump.h). */
+partitioned_elias_fano *load_partitioned_elias_fano_verify(int h, dump_verifier *verifier);
+/* Returns the element of given index, which must be smaller than the length. */
+uint64_t partitioned_elias_fano_get(const partitioned_elias_fano *partitioned_elias_fano, uint64_t index);
+/* Returns the first element greater than or equal to lower_bound, storing its index in index;
+   the chunk is located by a successor query on the endpoints. */
+uint64_t partitioned_elias_fano_successor(const partitioned_elias_fano *partitioned_elias_fano, uint64_t lower_bound, uint64_t *index);
+/* Stores in dest the elements of index in [from, to), which must be contained in [0, length],
+   decoding each chunk sequentially. */
+void partitioned_elias_fano_get_range(const partitioned_elias_fano *partitioned_elias_fano, uint64_t from, uint64_t to, uint64_t *dest);
+
+#endif /* PARTITIONED_ELIAS_FANO_H_INCLUDED */
@@ -0,0 +1,286 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include "popcount.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#define PAIRS_MASK UINT64_C(0x5555555555555555)
+
+typedef struct {
+	uint64_t (*words)(const uint64_t *words, uint64_t n);
+	uint64_t (*nonzero_pairs)(const uint64_t *words, uint64_t n);
+	uint64_t (*rank9_counts)(const uint64_t *bits, uint64_t num_words, uint64_t *count);
+} kernels;
+
+// The scalar kernels are the portable baseline, so we keep the compiler from vectorizing them
+#define SCALAR __attribute__((optimize("no-tree-vectorize")))
+
+SCALAR static uint64_t words_scalar(const uint64_t *words, const uint64_t n) {
+	uint64_t c = 0;
+	for (uint64_t i = 0; i < n; i++) c += __builtin_popcountll(words[i]);
+	return c;
+}
+
+SCALAR static uint64_t nonzero_pairs_scalar(const uint64_t *words, const uint64_t n) {
+	uint64_t c = 0;
+	for (uint64_t i = 0; i < n; i++) c += __builtin_popcountll((words[i] | words[i] >> 1) & PAIRS_MASK);
+	return c;
+}
+
+/* Fills the counts of the block of eight words starting at i, which might be incomplete. */
+static uint64_t rank9_block_scalar(const uint64_t *bits, const uint64_t num_words, const uint64_t i, uint64_t c, uint64_t *count) {
+	const uint64_t start = c;
+	uint64_t subcounts = 0;
+	c += __builtin_popcountll(bits[i]);
+	for (int j = 1; j < 8; j++) {
+		// Subcounts after the end are all ones, so that select9 never stops there
+		subcounts |= (i + j <= num_words ? c - start : 0x1FF) << 9 * (j - 1);
+		if (i + j < num_words) c += __builtin_popcountll(bits[i + j]);
+	}
+	count[0] = start;
+	count[1] = subcounts;
+	return c;
+}
+
+static uint64_t rank9_counts_scalar(const uint64_t *bits, const uint64_t num_words, uint64_t *count) {
+	uint64_t c = 0, pos = 0;
+	for (uint64_t i = 0; i < num_words; i += 8, pos += 2) c = rank9_block_scalar(bits, num_words, i, c, count + pos);
+	count[pos] = c;
+	return c;
+}
+
+#if defined(__x86_64__)
+
+#define AVX2 __attribute__((target("avx2")))
+
+/* Muła's nibble-lookup population count, returning the count of each 64-bit lane. */
+AVX2 static inline __m256i popcount256(const __m256i v) {
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low_mask = _mm256_set1_epi8(0x0F);
+	const __m256i lo = _mm256_and_si256(v, low_mask);
+	const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+	const __m256i c = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+	return _mm256_sad_epu8(c, _mm256_setzero_si256());
+}
+
+AVX2 static inline uint64_t sum256(const __m256i v) {
+	return _mm256_extract_epi64(v, 0) + _mm256_extract_epi64(v, 1) + _mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3);
+}
+
+/* A carry-save adder: h and l are the high and low bits of a + b + c. */
+#define CSA(h, l, a, b, c) do { \
+	const __m256i u = _mm256_xor_si256(a, b); \
+	h = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c)); \
+	l = _mm256_xor_si256(u, c); \
+} while (0)
+
+/* Loads four words, replacing each bit pair with its nonzeroness if pairs is true. */
+AVX2 static inline __m256i load256(const uint64_t *p, const int pairs) {
+	const __m256i v = _mm256_loadu_si256((const __m256i *)p);
+	return pairs ? _mm256_and_si256(_mm256_or_si256(v, _mm256_srli_epi64(v, 1)), _mm256_set1_epi64x(PAIRS_MASK)) : v;
+}
+
+#define LOAD(i) load256(words + 4 * (i), pairs)
+
+/* Harley-Seal population count (Muła, Kurz and Lemire), sixteen vectors at a time. */
+AVX2 static inline __attribute__((always_inline)) uint64_t harley_seal(const uint64_t *words, const uint64_t n, const int pairs) {
+	const uint64_t size = n / 4;
+	__m256i total = _mm256_setzero_si256(), ones = total, twos = total, fours = total, eights = total, sixteens, twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+	uint64_t i;
+	for (i = 0; i + 16 <= size; i += 16) {
+		CSA(twos_a, ones, ones, LOAD(i), LOAD(i + 1));
+		CSA(twos_b, ones, ones, LOAD(i + 2), LOAD(i + 3));
+		CSA(fours_a, twos, twos, twos_a, twos_b);
+		CSA(twos_a, ones, ones, LOAD(i + 4), LOAD(i + 5));
+		CSA(twos_b, ones, ones, LOAD(i + 6), LOAD(i + 7));
+		CSA(fours_b, twos, twos, twos_a, twos_b);
+		CSA(eights_a, fours, fours, fours_a, fours_b);
+		CSA(twos_a, ones, ones, LOAD(i + 8), LOAD(i + 9));
+		CSA(twos_b, ones, ones, LOAD(i + 10), LOAD(i + 11));
+		CSA(fours_a, twos, twos, twos_a, twos_b);
+		CSA(twos_a, ones, ones, LOAD(i + 12), LOAD(i + 13));
+		CSA(twos_b, ones, ones, LOAD(i + 14), LOAD(i + 15));
+		CSA(fours_b, twos, twos, twos_a, twos_b);
+		CSA(eights_b, fours, fours, fours_a, fours_b);
+		CSA(sixteens, eights, eights, eights_a, eights_b);
+		total = _mm256_add_epi64(total, popcount256(sixteens));
+	}
+
+	total = _mm256_slli_epi64(total, 4);
+	total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(eights), 3));
+	total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(fours), 2));
+	total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(twos), 1));
+	total = _mm256_add_epi64(total, popcount256(ones));
+	for (; i < size; i++) total = _mm256_add_epi64(total, popcount256(LOAD(i)));
+
+	return sum256(total) + (pairs ? nonzero_pairs_scalar : words_scalar)(words + 4 * size, n % 4);
+}
+
+AVX2 static uint64_t words_avx2(const uint64_t *words, const uint64_t n) {
+	return harley_seal(words, n, 0);
+}
+
+AVX2 static uint64_t nonzero_pairs_avx2(const uint64_t *words, const uint64_t n) {
+	return harley_seal(words, n, 1);
+}
+
+AVX2 static uint64_t rank9_counts_avx2(const uint64_t *bits, const uint64_t num_words, uint64_t *count) {
+	uint64_t c = 0, pos = 0, i;
+	for (i = 0; i + 8 <= num_words; i += 8, pos += 2) {
+		uint64_t p[8];
+		_mm256_storeu_si256((__m256i *)p, popcount256(_mm256_loadu_si256((const __m256i *)(bits + i))));
+		_mm256_storeu_si256((__m256i *)(p + 4), popcount256(_mm256_loadu_si256((const __m256i *)(bits + i + 4))));
+		uint64_t s = 0, subcounts = 0;
+		for (int j = 0; j < 7; j++) subcounts |= (s += p[j]) << 9 * j;
+		count[pos] = c;
+		count[pos + 1] = subcounts;
+		c += s + p[7];
+	}
+	if (i < num_words) c = rank9_block_scalar(bits, num_words, i, c, count + pos), pos += 2;
+	count[pos] = c;
+	return c;
+}
+
+#define AVX512 __attribute__((target("avx512f,avx512vpopcntdq")))
+
+AVX512 static uint64_t words_avx512(const uint64_t *words, const uint64_t n) {
+	__m512i t0 = _mm512_setzero_si512(), t1 = t0, t2 = t0, t3 = t0;
+	uint64_t i;
+	for (i = 0; i + 32 <= n; i += 32) {
+		t0 = _mm512_add_epi64(t0, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+		t1 = _mm512_add_epi64(t1, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i + 8)));
+		t2 = _mm512_add_epi64(t2, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i + 16)));
+		t3 = _mm512_add_epi64(t3, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i + 24)));
+	}
+	for (; i + 8 <= n; i += 8) t0 = _mm512_add_epi64(t0, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+	if (i < n) t0 = _mm512_add_epi64(t0, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64((1 << (n - i)) - 1, words + i)));
+	return _mm512_reduce_add_epi64(_mm512_add_epi64(_mm512_add_epi64(t0, t1), _mm512_add_epi64(t2, t3)));
+}
+
+AVX512 static uint64_t nonzero_pairs_avx512(const uint64_t *words, const uint64_t n) {
+	const __m512i mask = _mm512_set1_epi64(PAIRS_MASK);
+	__m512i total = _mm512_setzero_si512();
+	uint64_t i;
+	for (i = 0; i + 8 <= n; i += 8) {
+		const __m512i v = _mm512_loadu_si512(words + i);
+		total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_and_si512(_mm512_or_si512(v, _mm512_srli_epi64(v, 1)), mask)));
+	}
+	if (i < n) {
+		const __m512i v = _mm512_maskz_loadu_epi64((1 << (n - i)) - 1, words + i);
+		total = _mm512_add_epi64(total, _mm512_popcnt_epi64(_mm512_and_si512(_mm512_or_si512(v, _mm512_srli_epi64(v, 1)), mask)));
+	}
+	return _mm512_reduce_add_epi64(total);
+}
+
+AVX512 static uint64_t rank9_counts_avx512(const uint64_t *bits, const uint64_t num_words, uint64_t *count) {
+	const __m512i zero = _mm512_setzero_si512();
+	// Lane j of the inclusive prefix sums is the subcount of word j + 1 (lane 7 is the block total)
+	const __m512i shift = _mm512_setr_epi64(0, 9, 18, 27, 36, 45, 54, 0);
+	uint64_t c = 0, pos = 0, i;
+	for (i = 0; i + 8 <= num_words; i += 8, pos += 2) {
+		__m512i p = _mm512_popcnt_epi64(_mm512_loadu_si512(bits + i));
+		p = _mm512_add_epi64(p, _mm512_alignr_epi64(p, zero, 7));
+		p = _mm512_add_epi64(p, _mm512_alignr_epi64(p, zero, 6));
+		p = _mm512_add_epi64(p, _mm512_alignr_epi64(p, zero, 4));
+		count[pos] = c;
+		count[pos + 1] = _mm512_mask_reduce_or_epi64(0x7F, _mm512_sllv_epi64(p, shift));
+		c += _mm_extract_epi64(_mm512_extracti32x4_epi32(p, 3), 1);
+	}
+	if (i < num_words) c = rank9_block_scalar(bits, num_words, i, c, count + pos), pos += 2;
+	count[pos] = c;
+	return c;
+}
+
+#endif
+
+static const kernels table[] = {
+	{ words_scalar, nonzero_pairs_scalar, rank9_counts_scalar },
+#if defined(__x86_64__)
+	{ words_avx2, nonzero_pairs_avx2, rank9_counts_avx2 },
+	{ words_avx512, nonzero_pairs_avx512, rank9_counts_avx512 },
+#endif
+};
+
+static int supported(const int kernel) {
+#if defined(__x86_64__)
+	__builtin_cpu_init();
+	switch (kernel) {
+	case POPCOUNT_SCALAR:
+		return 1;
+	case POPCOUNT_AVX2:
+		return __builtin_cpu_supports("avx2");
+	case POPCOUNT_AVX512:
+		return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+	}
+	return 0;
+#else
+	return kernel == POPCOUNT_SCALAR;
+#endif
+}
+
+static int current = POPCOUNT_SCALAR;
+
+__attribute__((constructor)) static void init(void) {
+	for (int k = POPCOUNT_AVX512; k > POPCOUNT_SCALAR; k--)
+		if (supported(k)) {
+			current = k;
+			return;
+		}
+}
+
+int popcount_kernel(void) {
+	return current;
+}
+
+int popcount_use(const int kernel) {
+	if (kernel < POPCOUNT_SCALAR || kernel > POPCOUNT_AVX512 || !supported(kernel)) return -1;
+	current = kernel;
+	return 0;
+}
+
+const char *popcount_kernel_name(const int kernel) {
+	static const char * const name[] = { "scalar", "avx2", "avx512" };
+	return kernel >= POPCOUNT_SCALAR && kernel <= POPCOUNT_AVX512 ? name[kernel] : NULL;
+}
+
+uint64_t popcount_words(const uint64_t *words, const uint64_t n) {
+	return table[current].words(words, n);
+}
+
+uint64_t popcount_range(const uint64_t *bits, const uint64_t from, const uint64_t to) {
+	if (from >= to) return 0;
+	const uint64_t from_word = from / 64, to_word = to / 64;
+	const uint64_t first = bits[from_word] & -(UINT64_C(1) << from % 64);
+	if (from_word == to_word) return __builtin_popcountll(first & (UINT64_C(1) << to % 64) - 1);
+	uint64_t c = __builtin_popcountll(first) + popcount_words(bits + from_word + 1, to_word - from_word - 1);
+	if (to % 64 != 0) c += __builtin_popcountll(bits[to_word] & (UINT64_C(1) << to % 64) - 1);
+	return c;
+}
+
+uint64_t popcount_nonzero_pairs(const uint64_t *words, const uint64_t n) {
+	return table[current].nonzero_pairs(words, n);
+}
+
+uint64_t popcount_rank9_counts(const uint64_t *bits, const uint64_t num_words, uint64_t *count) {
+	return table[current].rank9_counts(bits, num_words, count);
+}
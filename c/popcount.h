@@ -0,0 +1,53 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Bulk population counts, dispatched at runtime to AVX-512 VPOPCNTDQ,
+ * AVX2 (Harley-Seal) or scalar kernels depending on the processor.
+ */
+
+#ifndef POPCOUNT_H_INCLUDED
+#define POPCOUNT_H_INCLUDED
+
+#include <inttypes.h>
+
+// Kernels
+#define POPCOUNT_SCALAR 0
+#define POPCOUNT_AVX2 1
+#define POPCOUNT_AVX512 2
+
+/* Returns the kernel in use (the best supported one, unless forced by popcount_use()). */
+int popcount_kernel(void);
+/* Forces the use of a kernel (e.g., for benchmarking); returns -1 if it is not supported. */
+int popcount_use(int kernel);
+/* Returns the name of a kernel. */
+const char *popcount_kernel_name(int kernel);
+
+/* Returns the number of ones in n words. */
+uint64_t popcount_words(const uint64_t *words, uint64_t n);
+/* Returns the number of ones in the bit range [from, to) of a bit vector. */
+uint64_t popcount_range(const uint64_t *bits, uint64_t from, uint64_t to);
+/* Returns the number of nonzero bit pairs (i.e., nonzero 2-bit values) in n words. */
+uint64_t popcount_nonzero_pairs(const uint64_t *words, uint64_t n);
+/* Fills count (of size (num_words + 7) / 8 * 2 + 1) with the counts of Rank9 for a bit
+   vector of num_words words, exactly as the Java constructor; returns the number of ones. */
+uint64_t popcount_rank9_counts(const uint64_t *bits, uint64_t num_words, uint64_t *count);
+
+#endif /* POPCOUNT_H_INCLUDED */
@@ -0,0 +1,125 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "rank9.h"
+#include "popcount.h"
+
+// Positions whose memory accesses are issued together by the batched methods
+#define BATCH 16
+
+int map_rank9(const void *dump, const uint64_t length, rank9 *rank9) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	// A Select9 dump starts with the sections of the underlying Rank9
+	if (!(header->kind == DUMP_RANK9 && header->num_sections == 2) && !(header->kind == DUMP_SELECT9 && header->num_sections == 4)) return -1;
+	return map_rank9_at(dump, 0, 0, rank9);
+}
+
+int map_rank9_at(const void *dump, const int param, const int section, rank9 *rank9) {
+	const dump_header * const header = dump;
+	if (param + 3 > DUMP_MAX_PARAMS || section + 2 > (int)header->num_sections) return -1;
+	const char * const base = dump;
+	memset(rank9, 0, sizeof *rank9);
+	rank9->length = header->param[param];
+	rank9->num_ones = header->param[param + 1];
+	rank9->last_one = header->param[param + 2];
+	rank9->num_words = header->section[section].length / sizeof *rank9->bits;
+	rank9->bits = (const uint64_t *)(base + header->section[section].offset);
+	rank9->count_length = header->section[section + 1].length / sizeof *rank9->count;
+	rank9->count = (const uint64_t *)(base + header->section[section + 1].offset);
+	return 0;
+}
+
+int rank9_validate(const rank9 *rank9) {
+	if (rank9->num_words != (rank9->length + 63) / 64) return -1;
+	// Two counts for each block of eight words, plus the number of ones
+	if (rank9->count_length != (rank9->length + 511) / 512 * 2 + 1) return -1;
+	if (rank9->count[rank9->count_length - 1] != rank9->num_ones) return -1;
+	if (rank9->last_one < -1 || (rank9->last_one >= 0 && (uint64_t)rank9->last_one >= rank9->length)) return -1;
+	return 0;
+}
+
+rank9 *load_rank9(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	rank9 *rank9 = malloc(sizeof *rank9);
+	if (rank9 == NULL || map_rank9(map, length, rank9) != 0 || rank9_validate(rank9) != 0) {
+		free(rank9);
+		munmap(map, length);
+		return NULL;
+	}
+	rank9->map = map;
+	rank9->map_length = length;
+	return rank9;
+}
+
+rank9 *rank9_build(const uint64_t *bits, const uint64_t length) {
+	const uint64_t num_words = (length + 63) / 64;
+	const uint64_t count_length = (num_words + 7) / 8 * 2 + 1;
+	rank9 *rank9 = malloc(sizeof *rank9 + count_length * sizeof *rank9->count);
+	if (rank9 == NULL) return NULL;
+	memset(rank9, 0, sizeof *rank9);
+	uint64_t * const count = (uint64_t *)(rank9 + 1);
+	rank9->length = length;
+	rank9->num_words = num_words;
+	rank9->bits = bits;
+	rank9->count_length = count_length;
+	rank9->count = count;
+	rank9->num_ones = popcount_rank9_counts(bits, num_words, count);
+	rank9->last_one = -1;
+	for (uint64_t i = num_words; i-- != 0;)
+		if (bits[i] != 0) {
+			rank9->last_one = i * 64 + 63 - __builtin_clzll(bits[i]);
+			break;
+		}
+	return rank9;
+}
+
+static inline uint64_t rank_one(const rank9 * const rank9, const uint64_t pos) {
+	// Positions after the last one might be beyond the last word
+	if (rank9->last_one < 0 || pos > (uint64_t)rank9->last_one) return rank9->num_ones;
+	const uint64_t word = pos / 64;
+	const uint64_t block = (word >> 2) & ~UINT64_C(1);
+	const int offset = (word & 7) - 1;
+	// For the first word of a block, offset & 7 is 7, and the topmost bit of the subcounts is zero
+	return rank9->count[block] + (rank9->count[block + 1] >> (offset & 7) * 9 & 0x1FF) + __builtin_popcountll(rank9->bits[word] & (UINT64_C(1) << pos % 64) - 1);
+}
+
+uint64_t rank9_rank(const rank9 *rank9, const uint64_t pos) {
+	return rank_one(rank9, pos);
+}
+
+void rank9_rank_batch(const rank9 *rank9, const uint64_t *pos, uint64_t *rank, const uint64_t n) {
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) {
+			const uint64_t word = pos[i + j] / 64;
+			if (word < rank9->num_words) {
+				__builtin_prefetch(&rank9->count[(word >> 2) & ~UINT64_C(1)]);
+				__builtin_prefetch(&rank9->bits[word]);
+			}
+		}
+		for (int j = 0; j < b; j++) rank[i + j] = rank_one(rank9, pos[i + j]);
+	}
+}
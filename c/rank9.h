@@ -0,0 +1,57 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RANK9_H_INCLUDED
+#define RANK9_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+
+/* A view of a Rank9 dump (see Rank9.dump() in Java). */
+typedef struct {
+	uint64_t length;
+	uint64_t num_ones;
+	int64_t last_one;
+	uint64_t num_words;
+	const uint64_t *bits;
+	uint64_t count_length;
+	const uint64_t *count;
+	void *map; // The mapping, if loaded by load_rank9()
+	uint64_t map_length;
+} rank9;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a valid Rank9 dump. */
+rank9 *load_rank9(int h);
+/* Builds the counts for a bit vector of given length, whose bits past the end must be zero (bits is not copied, and must outlive the
+   result); the result is a single allocation that can be released with free(). */
+rank9 *rank9_build(const uint64_t *bits, uint64_t length);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_rank9(const void *dump, uint64_t length, rank9 *rank9);
+/* Fills a view of a Rank9 embedded in a dump already checked by dump_map_header(), whose parameters
+   and sections start at the given indices (see Rank9.dump(NativeDump) in Java); returns zero on success. */
+int map_rank9_at(const void *dump, int param, int section, rank9 *rank9);
+/* Checks that the arrays have the size implied by the length of the bit vector; returns zero if valid. */
+int rank9_validate(const rank9 *rank9);
+/* Returns the number of ones before pos (num_ones if pos is beyond the last one). */
+uint64_t rank9_rank(const rank9 *rank9, uint64_t pos);
+/* Stores in rank the ranks of the n positions in pos, prefetching groups of positions. */
+void rank9_rank_batch(const rank9 *rank9, const uint64_t *pos, uint64_t *rank, uint64_t n);
+
+#endif /* RANK9_H_INCLUDED */
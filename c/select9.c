@@ -0,0 +1,213 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "select9.h"
+#include "broadword.h"
+
+#define LOG2_ONES_PER_INVENTORY 9
+#define ONES_PER_INVENTORY (1 << LOG2_ONES_PER_INVENTORY)
+#define INVENTORY_MASK (ONES_PER_INVENTORY - 1)
+
+// Ranks whose memory accesses are issued together by the batched methods
+#define BATCH 16
+
+int map_select9(const void *dump, const uint64_t length, select9 *select9) {
+	memset(select9, 0, sizeof *select9);
+	if (map_rank9(dump, length, &select9->rank9) != 0) return -1;
+	const dump_header * const header = dump;
+	if (header->kind != DUMP_SELECT9) return -1;
+	const char * const base = dump;
+	select9->inventory_length = header->section[2].length / sizeof *select9->inventory;
+	select9->inventory = (const uint64_t *)(base + header->section[2].offset);
+	select9->subinventory_length = header->section[3].length / sizeof *select9->subinventory;
+	select9->subinventory = (const uint64_t *)(base + header->section[3].offset);
+	return 0;
+}
+
+/* Returns the 16-bit field of given index of the subinventory, as written by Java. */
+static inline uint64_t field16(const uint64_t *subinventory, const uint64_t index) {
+	return subinventory[index >> 2] >> ((index & 3) << 4) & 0xFFFF;
+}
+
+/* Checks the 16-bit fields used by spans smaller than 128 against the counts, as the Java
+   constructor writes them; unused fields must be 0xFFFF, so that no search goes past the span. */
+static int validate_fields(const select9 *select9, const uint64_t word_left, const uint64_t word_right, const uint64_t span) {
+	const uint64_t * const subinventory = select9->subinventory;
+	const uint64_t * const count = select9->rank9.count;
+	const uint64_t base = (word_left >> 2) << 2;
+	const uint64_t block_left = word_left >> 3, block_span = (word_right >> 3) - block_left;
+	const uint64_t counts_at_start = count[block_left * 2];
+	const uint64_t padded = (block_span + 8) & ~UINT64_C(7);
+	// Spans of 16 groups or more start with a first level of one field every eight blocks
+	const uint64_t second = span >= 16 ? 8 : 0;
+	for (uint64_t k = 0; k < padded; k++)
+		if (field16(subinventory, base + second + k) != (k < block_span ? count[(block_left + k + 1) * 2] - counts_at_start : 0xFFFF)) return -1;
+	if (span >= 16)
+		for (uint64_t k = 0; k < 8; k++)
+			if (field16(subinventory, base + k) != (k < block_span >> 3 ? count[(block_left + (k + 1) * 8) * 2] - counts_at_start : 0xFFFF)) return -1;
+	return 0;
+}
+
+int select9_validate(const select9 *select9) {
+	const rank9 * const rank9 = &select9->rank9;
+	if (rank9_validate(rank9) != 0) return -1;
+	if (select9->inventory_length != (rank9->num_ones + ONES_PER_INVENTORY - 1) / ONES_PER_INVENTORY + 1) return -1;
+	if (select9->subinventory_length != (rank9->num_words + 3) >> 2) return -1;
+	// The last entry of the inventory is a sentinel at the end of the last group of four words
+	if (select9->inventory[select9->inventory_length - 1] != (rank9->num_words + 3 & ~UINT64_C(3)) * 64) return -1;
+
+	/* Selection trusts the counts to locate blocks and words, so, without reading the bit vector,
+	   we check that each block contains at most the ones that fit in it, and that no rank in the
+	   last block can stop at a subcount past the end. */
+	const uint64_t * const count = rank9->count;
+	if (count[0] != 0) return -1;
+	for (uint64_t b = 0; b < rank9->count_length / 2; b++) {
+		const uint64_t words = rank9->num_words - b * 8 < 8 ? rank9->num_words - b * 8 : 8;
+		if (count[b * 2 + 2] < count[b * 2] || count[b * 2 + 2] - count[b * 2] > words * 64) return -1;
+		for (uint64_t j = words; j < 8; j++)
+			if ((count[b * 2 + 1] >> 9 * (j - 1) & 0x1FF) < count[b * 2 + 2] - count[b * 2]) return -1;
+	}
+
+	for (uint64_t i = 0; i + 1 < select9->inventory_length; i++) {
+		const uint64_t left = select9->inventory[i], right = select9->inventory[i + 1];
+		if (left >= rank9->length || left > right) return -1;
+		// The first one of the inventory must lie in the block of its position
+		const uint64_t block = left / 512;
+		if (count[block * 2] > i * ONES_PER_INVENTORY || count[block * 2 + 2] <= i * ONES_PER_INVENTORY) return -1;
+
+		const uint64_t word_left = left / 64, word_right = right / 64;
+		const uint64_t span = (word_right >> 2) - (word_left >> 2);
+		const uint64_t subinventory_index = word_left >> 2;
+		const uint64_t ones = rank9->num_ones - i * ONES_PER_INVENTORY < ONES_PER_INVENTORY ? rank9->num_ones - i * ONES_PER_INVENTORY : ONES_PER_INVENTORY;
+		const uint64_t * const subinventory = select9->subinventory;
+		if (span >= 512) {
+			for (uint64_t k = 0; k < ones; k++)
+				if (subinventory[subinventory_index + k] < left || subinventory[subinventory_index + k] >= rank9->length) return -1;
+		}
+		else if (span >= 256) {
+			for (uint64_t k = 0; k < ones; k++) {
+				const uint64_t index32 = (subinventory_index << 1) + k;
+				if ((subinventory[index32 >> 1] >> ((index32 & 1) << 5) & 0xFFFFFFFF) >= rank9->length - left) return -1;
+			}
+		}
+		else if (span >= 128) {
+			for (uint64_t k = 0; k < ones; k++)
+				if (field16(subinventory, (subinventory_index << 2) + k) >= rank9->length - left) return -1;
+		}
+		else if (span >= 2 && validate_fields(select9, word_left, word_right, span) != 0) return -1;
+	}
+	return 0;
+}
+
+select9 *load_select9(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	select9 *select9 = malloc(sizeof *select9);
+	if (select9 == NULL || map_select9(map, length, select9) != 0 || select9_validate(select9) != 0) {
+		free(select9);
+		munmap(map, length);
+		return NULL;
+	}
+	select9->map = map;
+	select9->map_length = length;
+	return select9;
+}
+
+static inline uint64_t select_one(const select9 * const select9, const uint64_t rank) {
+	const uint64_t * const inventory = select9->inventory;
+	const uint64_t * const subinventory = select9->subinventory;
+	const uint64_t * const count = select9->rank9.count;
+	const uint64_t inventory_index_left = rank >> LOG2_ONES_PER_INVENTORY;
+
+	const uint64_t inventory_left = inventory[inventory_index_left];
+	const uint64_t block_right = inventory[inventory_index_left + 1] / 64;
+	uint64_t block_left = inventory_left / 64;
+	const uint64_t subinventory_index = block_left >> 2;
+	const uint64_t span = (block_right >> 2) - (block_left >> 2);
+	uint64_t count_left, rank_in_block;
+
+	if (span < 2) {
+		block_left &= ~UINT64_C(7);
+		count_left = (block_left >> 2) & ~UINT64_C(1);
+		rank_in_block = rank - count[count_left];
+	}
+	else if (span < 16) {
+		block_left &= ~UINT64_C(7);
+		count_left = (block_left >> 2) & ~UINT64_C(1);
+		const uint64_t rank_in_superblock_step_16 = (rank - count[count_left]) * ONES_STEP_16;
+		const uint64_t first = subinventory[subinventory_index], second = subinventory[subinventory_index + 1];
+		// Twice the number of blocks starting with a smaller rank
+		const int where = (uleq_step_16(first, rank_in_superblock_step_16) + uleq_step_16(second, rank_in_superblock_step_16)) * ONES_STEP_16 >> 47;
+		block_left += where * 4;
+		count_left += where;
+		rank_in_block = rank - count[count_left];
+	}
+	else if (span < 128) {
+		block_left &= ~UINT64_C(7);
+		count_left = (block_left >> 2) & ~UINT64_C(1);
+		const uint64_t rank_in_superblock_step_16 = (rank - count[count_left]) * ONES_STEP_16;
+		const uint64_t first = subinventory[subinventory_index], second = subinventory[subinventory_index + 1];
+		const int where0 = (uleq_step_16(first, rank_in_superblock_step_16) + uleq_step_16(second, rank_in_superblock_step_16)) * ONES_STEP_16 >> 47;
+		const uint64_t first_bis = subinventory[subinventory_index + where0 + 2], second_bis = subinventory[subinventory_index + where0 + 2 + 1];
+		const int where1 = (where0 << 3) + ((uleq_step_16(first_bis, rank_in_superblock_step_16) + uleq_step_16(second_bis, rank_in_superblock_step_16)) * ONES_STEP_16 >> 47);
+		block_left += where1 << 2;
+		count_left += where1;
+		rank_in_block = rank - count[count_left];
+	}
+	else if (span < 256) {
+		const uint64_t index16 = (subinventory_index << 2) + (rank & INVENTORY_MASK);
+		return (subinventory[index16 >> 2] >> ((index16 & 3) << 4) & 0xFFFF) + inventory_left;
+	}
+	else if (span < 512) {
+		const uint64_t index32 = (subinventory_index << 1) + (rank & INVENTORY_MASK);
+		return (subinventory[index32 >> 1] >> ((index32 & 1) << 5) & 0xFFFFFFFF) + inventory_left;
+	}
+	else return subinventory[subinventory_index + (rank & INVENTORY_MASK)];
+
+	const uint64_t rank_in_block_step_9 = rank_in_block * ONES_STEP_9;
+	const uint64_t subcounts = count[count_left + 1];
+	const int offset_in_block = (uleq_step_9(subcounts, rank_in_block_step_9) * ONES_STEP_9 >> 54 & 0x7);
+
+	const uint64_t word = block_left + offset_in_block;
+	const int rank_in_word = rank_in_block - (subcounts >> (offset_in_block - 1 & 7) * 9 & 0x1FF);
+	return word * 64 + select64(select9->rank9.bits[word], rank_in_word);
+}
+
+uint64_t select9_select(const select9 *select9, const uint64_t rank) {
+	return select_one(select9, rank);
+}
+
+void select9_select_batch(const select9 *select9, const uint64_t *rank, uint64_t *pos, const uint64_t n) {
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) __builtin_prefetch(&select9->inventory[rank[i + j] >> LOG2_ONES_PER_INVENTORY]);
+		// Once the inventory is in cache, the subinventory and the counts can be fetched
+		for (int j = 0; j < b; j++) {
+			const uint64_t block_left = select9->inventory[rank[i + j] >> LOG2_ONES_PER_INVENTORY] / 64;
+			__builtin_prefetch(&select9->subinventory[block_left >> 2]);
+			__builtin_prefetch(&select9->rank9.count[block_left >> 3 << 1]);
+		}
+		for (int j = 0; j < b; j++) pos[i + j] = select_one(select9, rank[i + j]);
+	}
+}
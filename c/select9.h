@@ -0,0 +1,53 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SELECT9_H_INCLUDED
+#define SELECT9_H_INCLUDED
+
+#include <inttypes.h>
+#include "rank9.h"
+
+/* A view of a Select9 dump (see Select9.dump() in Java), which contains
+   the underlying Rank9 (so it can also be loaded by load_rank9()). */
+typedef struct {
+	rank9 rank9;
+	uint64_t inventory_length;
+	const uint64_t *inventory;
+	uint64_t subinventory_length;
+	const uint64_t *subinventory;
+	void *map; // The mapping, if loaded by load_select9()
+	uint64_t map_length;
+} select9;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a valid Select9 dump. */
+select9 *load_select9(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_select9(const void *dump, uint64_t length, select9 *select9);
+/* Checks that the arrays have the size implied by the bit vector, that the inventory is monotone and
+   consistent with the counts, and that the subinventory contains what the Java constructor would
+   store given the counts (or positions within the bit vector), so that no selection reads out of
+   bounds; the bit vector is not read, so a corrupt one yields wrong positions. Returns zero if valid. */
+int select9_validate(const select9 *select9);
+/* Returns the position of the one of given rank, which must be smaller than the number of ones. */
+uint64_t select9_select(const select9 *select9, uint64_t rank);
+/* Stores in pos the positions of the ones of the n given ranks, prefetching groups of ranks. */
+void select9_select_batch(const select9 *select9, const uint64_t *rank, uint64_t *pos, uint64_t n);
+
+#endif /* SELECT9_H_INCLUDED */
@@ -19,14 +19,51 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <limits.h>
 #include "sf.h"
+#include "dump.h"
 
-sf *load_sf(int h) {
+#define OFFSET_MASK (UINT64_C(-1) >> 8)
+
+static void free_sf(sf *sf) {
+#ifndef USE_MMAP // Anonymous mappings are not reclaimed
+	free(sf->offset_and_seed);
+	free(sf->array);
+	free(sf);
+#endif
+}
+
+static sf *load_sf_header(int h, dump_header *header) {
+	const int container = dump_read_header(h, header);
+	if (container < 0) return NULL;
+
+	if (container && (header->kind != DUMP_SF || header->num_sections != 2)) return NULL;
+	// Sections are arrays of longs
+	if (container && (header->section[0].length % sizeof(uint64_t) != 0 || header->section[1].length % sizeof(uint64_t) != 0)) return NULL;
 	sf *sf = calloc(1, sizeof *sf);
-	read(h, &sf->size, sizeof sf->size);
+	if (sf == NULL) return NULL;
+
+	if (container) {
+		sf->size = header->param[0];
+		sf->width = header->width;
+		sf->multiplier = header->param[1];
+		sf->global_seed = header->param[2];
+		sf->offset_and_seed_length = header->section[0].length / sizeof *sf->offset_and_seed;
+		sf->offset_and_seed = calloc(sf->offset_and_seed_length, sizeof *sf->offset_and_seed);
+		sf->array_length = header->section[1].length / sizeof *sf->array;
+		sf->array = calloc(sf->array_length, sizeof *sf->array);
+		if (sf->offset_and_seed == NULL || sf->array == NULL || dump_read_section(h, header, 0, sf->offset_and_seed) || dump_read_section(h, header, 1, sf->array)) {
+			free_sf(sf);
+			return NULL;
+		}
+		return sf;
+	}
+
+	sf->size = header->magic;
 	uint64_t t;
 	read(h, &t, sizeof t);
 	sf->width = t;
@@ -42,3 +79,71 @@ sf *load_sf(int h) {
 	read(h, sf->array, sf->array_length * sizeof *sf->array);
 	return sf;
 }
+
+sf *load_sf(int h) {
+	dump_header header;
+	return load_sf_header(h, &header);
+}
+
+int map_sf(const void *dump, const uint64_t length, sf *sf) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_SF || header->num_sections != 2) return -1;
+	return map_sf_at(dump, header->width, 0, 0, sf);
+}
+
+int map_sf_at(const void *dump, const int width, const int param, const int section, sf *sf) {
+	const dump_header * const header = dump;
+	if (param + 3 > DUMP_MAX_PARAMS || section + 2 > (int)header->num_sections) return -1;
+	const char * const base = dump;
+	memset(sf, 0, sizeof *sf);
+	sf->size = header->param[param];
+	sf->width = width;
+	sf->multiplier = header->param[param + 1];
+	sf->global_seed = header->param[param + 2];
+	sf->offset_and_seed_length = header->section[section].length / sizeof *sf->offset_and_seed;
+	sf->offset_and_seed = (uint64_t *)(base + header->section[section].offset);
+	sf->array_length = header->section[section + 1].length / sizeof *sf->array;
+	sf->array = (uint64_t *)(base + header->section[section + 1].offset);
+	return 0;
+}
+
+int sf_validate(const sf *sf) {
+	if (sf->offset_and_seed == NULL || sf->array == NULL) return -1;
+	// get_value() cannot extract zero bits
+	if (sf->width == 0 || sf->width > 64) return -1;
+	// The largest bucket computed by the lookup code, which also reads the following offset
+	const uint64_t max_bucket = ((__uint128_t)(UINT64_MAX >> 1) * sf->multiplier) >> 64;
+	if (max_bucket >= INT_MAX || sf->offset_and_seed_length < max_bucket + 2) return -1;
+	if (sf->array_length > UINT64_MAX / 64) return -1;
+	for (uint64_t i = 0; i <= max_bucket; i++) {
+		const uint64_t offset = sf->offset_and_seed[i] & OFFSET_MASK;
+		const uint64_t next = sf->offset_and_seed[i + 1] & OFFSET_MASK;
+		if (next < offset || next - offset > INT_MAX) return -1;
+		const uint64_t num_variables = next - offset;
+		// width bits per variable; an empty bucket is probed at its offset
+		if ((offset + (num_variables != 0 ? num_variables : 1)) * sf->width > sf->array_length * 64) return -1;
+	}
+	return 0;
+}
+
+static int validate(const void *sf) {
+	return sf_validate(sf);
+}
+
+sf *load_sf_validated(int h) {
+	sf *sf = load_sf(h);
+	if (sf == NULL) return NULL;
+	if (sf_validate(sf) == 0) return sf;
+	free_sf(sf);
+	return NULL;
+}
+
+sf *load_sf_verify(int h, dump_verifier *verifier) {
+	dump_header header;
+	sf *sf = load_sf_header(h, &header);
+	if (sf == NULL) return NULL;
+	const void *section[] = { sf->offset_and_seed, sf->array };
+	if (dump_verify_start(verifier, &header, section, validate, sf) == 0) return sf;
+	free_sf(sf);
+	return NULL;
+}
@@ -18,7 +18,11 @@
  *
  */
 
+#ifndef SF_H_INCLUDED
+#define SF_H_INCLUDED
+
 #include <inttypes.h>
+#include "dump.h"
 
 #ifdef USE_MMAP
 #include <sys/mman.h>
@@ -38,4 +42,20 @@ typedef struct {
 } sf;
 
 sf *load_sf(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h)
+   without copying; the container must stay mapped. Returns zero on success. */
+int map_sf(const void *dump, uint64_t length, sf *sf);
+/* Fills a view of a function of given width embedded in a container already checked by
+   dump_map_header(), whose parameters and sections start at the given indices (see
+   GOV3Function.dump(NativeDump) in Java); returns zero on success. */
+int map_sf_at(const void *dump, int width, int param, int section, sf *sf);
+/* Loads a function and validates it (see sf_validate()); returns NULL if the dump is not valid. */
+sf *load_sf_validated(int h);
+/* Loads a function and starts verifying it in the background (see dump.h). */
+sf *load_sf_verify(int h, dump_verifier *verifier);
+/* Checks that every probe of the lookup code, for any key, falls within the arrays (the width
+   is between 1 and 64, offsets are monotone, there is a sentinel offset after the last bucket,
+   and the last bucket fits the array); returns zero if valid. */
+int sf_validate(const sf *sf);
 
+#endif /* SF_H_INCLUDED */
@@ -28,7 +28,7 @@
 static void inline signature_to_equation(const uint64_t *signature, const uint64_t seed, int num_variables, unsigned int *e) {
 	uint64_t hash[4];
 	spooky_short_rehash(signature, seed, hash);
-	const int shift = __builtin_clzll(num_variables);
+	const int shift = __builtin_clzll(num_variables | 1); // Empty buckets yield zero
 	const uint64_t mask = (UINT64_C(1) << shift) - 1;
 	e[0] = ((hash[0] & mask) * num_variables) >> shift;
 	e[1] = ((hash[1] & mask) * num_variables) >> shift;
@@ -41,7 +41,7 @@ static void inline signature_to_equation(const uint64_t *signature, const uint64
 static uint64_t inline get_value(const uint64_t * const array, uint64_t pos, const int width) {
 	pos *= width;
 	const int l = 64 - width;
-	const int start_word = pos / 64;
+	const uint64_t start_word = pos / 64;
 	const int start_bit = pos % 64;
 	if (start_bit <= l) return array[start_word] << l - start_bit >> l;
 	return array[start_word] >> start_bit | array[start_word + 1] << 64 + l - start_bit >> l;
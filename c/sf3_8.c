@@ -0,0 +1,30 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2018-2020 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* Direct byte access version of sf3.c for functions with an 8-bit output,
+   usable side by side with the generic version. */
+
+#define SF_8
+#define sf3_get_byte_array sf3_8_get_byte_array
+#define sf3_get_uint64_t sf3_8_get_uint64_t
+#define sf3_get_signature sf3_8_get_signature
+
+#include "sf3_8.h"
+#include "sf3.c"
@@ -0,0 +1,25 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2018-2020 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sf.h"
+
+int64_t sf4_8_get_byte_array(const sf *sf, char *key, uint64_t len);
+int64_t sf4_8_get_uint64_t(const sf *sf, uint64_t key);
+int64_t sf4_8_get_signature(const sf *sf, const uint64_t signature[4]);
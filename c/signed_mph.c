@@ -0,0 +1,155 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "signed_mph.h"
+
+#define BATCH 16
+
+static inline uint64_t get_bits(const uint64_t * const bits, const uint64_t pos, const int width) {
+	const uint64_t word = pos / 64;
+	const int bit = pos % 64;
+	uint64_t result = bits[word] >> bit;
+	if (bit + width > 64) result |= bits[word + 1] << 64 - bit;
+	return width == 64 ? result : result & (UINT64_C(1) << width) - 1;
+}
+
+int map_signed_mph(const void *dump, const uint64_t length, signed_mph *signed_mph) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_SIGNED_MPH || header->num_sections != 3) return -1;
+	if (header->param[3] == 0 || header->param[3] > 64) return -1;
+	memset(signed_mph, 0, sizeof *signed_mph);
+	if (map_mph_at(dump, 0, 0, &signed_mph->mph) != 0) return -1;
+	signed_mph->size = signed_mph->mph.size;
+	signed_mph->global_seed = signed_mph->mph.global_seed;
+	signed_mph->signature_width = header->param[3];
+	signed_mph->signature_mask = UINT64_MAX >> 64 - signed_mph->signature_width;
+	signed_mph->signatures_length = header->section[2].length / sizeof *signed_mph->signatures;
+	signed_mph->signatures = (const uint64_t *)((const char *)dump + header->section[2].offset);
+	return 0;
+}
+
+signed_mph *load_signed_mph(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	signed_mph *signed_mph = malloc(sizeof *signed_mph);
+	if (signed_mph == NULL || map_signed_mph(map, length, signed_mph) != 0) {
+		free(signed_mph);
+		munmap(map, length);
+		return NULL;
+	}
+	signed_mph->map = map;
+	signed_mph->map_length = length;
+	return signed_mph;
+}
+
+int signed_mph_validate(const signed_mph *signed_mph) {
+	// An empty function is never probed
+	if (signed_mph->size == 0) return 0;
+	if (mph_validate(&signed_mph->mph) != 0) return -1;
+	if (signed_mph->size >= UINT64_MAX / 64 || signed_mph->signatures_length * 64 < signed_mph->size * signed_mph->signature_width) return -1;
+	return 0;
+}
+
+static int validate(const void *signed_mph) {
+	return signed_mph_validate(signed_mph);
+}
+
+signed_mph *load_signed_mph_validated(int h) {
+	signed_mph *signed_mph = load_signed_mph(h);
+	if (signed_mph == NULL) return NULL;
+	if (signed_mph_validate(signed_mph) == 0) return signed_mph;
+	munmap(signed_mph->map, signed_mph->map_length);
+	free(signed_mph);
+	return NULL;
+}
+
+signed_mph *load_signed_mph_verify(int h, dump_verifier *verifier) {
+	signed_mph *signed_mph = load_signed_mph(h);
+	if (signed_mph == NULL) return NULL;
+	const dump_header * const header = signed_mph->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)signed_mph->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, signed_mph) == 0) return signed_mph;
+	munmap(signed_mph->map, signed_mph->map_length);
+	free(signed_mph);
+	return NULL;
+}
+
+/* Checks the fingerprint of a signature against the one stored at the value of the function. */
+static inline int64_t check(const signed_mph *signed_mph, const uint64_t signature[4], const uint64_t result) {
+	// Out-of-set keys can generate bizarre 3-hyperedges
+	if (result >= signed_mph->size) return -1;
+	return ((get_bits(signed_mph->signatures, result * signed_mph->signature_width, signed_mph->signature_width) ^ signature[0]) & signed_mph->signature_mask) != 0 ? -1 : (int64_t)result;
+}
+
+int64_t signed_mph_get_signature(const signed_mph *signed_mph, const uint64_t signature[4]) {
+	if (signed_mph->size == 0) return -1;
+	return check(signed_mph, signature, mph_get_signature(&signed_mph->mph, signature));
+}
+
+int64_t signed_mph_get_byte_array(const signed_mph *signed_mph, const char *key, const uint64_t len) {
+	uint64_t signature[4];
+	spooky_short(key, len, signed_mph->global_seed, signature);
+	return signed_mph_get_signature(signed_mph, signature);
+}
+
+int64_t signed_mph_get_uint64_t(const signed_mph *signed_mph, const uint64_t key) {
+	uint64_t signature[4];
+	spooky_short(&key, 8, signed_mph->global_seed, signature);
+	return signed_mph_get_signature(signed_mph, signature);
+}
+
+/* Answers a group of at most BATCH signatures: once the function has been evaluated on the whole
+   group, the fingerprints are prefetched before being checked. */
+static void get_batch(const signed_mph *signed_mph, const uint64_t (*signature)[4], int64_t *result, const int b) {
+	if (signed_mph->size == 0) {
+		for (int j = 0; j < b; j++) result[j] = -1;
+		return;
+	}
+	mph_get_signature_batch(&signed_mph->mph, signature, result, b);
+	for (int j = 0; j < b; j++) if ((uint64_t)result[j] < signed_mph->size) __builtin_prefetch(&signed_mph->signatures[result[j] * signed_mph->signature_width / 64]);
+	for (int j = 0; j < b; j++) result[j] = check(signed_mph, signature[j], result[j]);
+}
+
+void signed_mph_get_signature_batch(const signed_mph *signed_mph, const uint64_t (*signature)[4], int64_t *result, const uint64_t n) {
+	for (uint64_t i = 0; i < n; i += BATCH) get_batch(signed_mph, signature + i, result + i, n - i < BATCH ? n - i : BATCH);
+}
+
+void signed_mph_get_byte_array_batch(const signed_mph *signed_mph, char * const *key, const int *len, int64_t *result, const uint64_t n) {
+	uint64_t signature[BATCH][4];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) spooky_short(key[i + j], len[i + j], signed_mph->global_seed, signature[j]);
+		get_batch(signed_mph, (const uint64_t (*)[4])signature, result + i, b);
+	}
+}
+
+void signed_mph_get_uint64_t_batch(const signed_mph *signed_mph, const uint64_t *key, int64_t *result, const uint64_t n) {
+	uint64_t signature[BATCH][4];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) spooky_short(&key[i + j], 8, signed_mph->global_seed, signature[j]);
+		get_batch(signed_mph, (const uint64_t (*)[4])signature, result + i, b);
+	}
+}
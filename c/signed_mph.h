@@ -0,0 +1,66 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIGNED_MPH_H_INCLUDED
+#define SIGNED_MPH_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "mph.h"
+
+/* A view of a signed minimal perfect hash function dump (see
+   GOVMinimalPerfectHashFunction.dump() in Java). The value of a key indexes an array of
+   signature_width-bit fingerprints, the lower bits of the first word of the signature of the
+   key: the fingerprint is checked in the same lookup, so keys not in the set are rejected
+   (returning -1) with probability 1 - 2^-signature_width, as in SignedFunctionStringMap. */
+typedef struct {
+	uint64_t size;
+	uint64_t global_seed;
+	mph mph;
+	int signature_width;
+	uint64_t signature_mask;
+	uint64_t signatures_length;
+	const uint64_t *signatures;
+	void *map; // The mapping, if loaded by load_signed_mph()
+	uint64_t map_length;
+} signed_mph;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a signed function dump. */
+signed_mph *load_signed_mph(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_signed_mph(const void *dump, uint64_t length, signed_mph *signed_mph);
+/* Maps a function and validates it (see signed_mph_validate()); returns NULL if the dump is not valid. */
+signed_mph *load_signed_mph_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h). */
+signed_mph *load_signed_mph_verify(int h, dump_verifier *verifier);
+/* Checks the function (see mph_validate()) and that the signatures cover all keys; returns
+   zero if valid. */
+int signed_mph_validate(const signed_mph *signed_mph);
+int64_t signed_mph_get_byte_array(const signed_mph *signed_mph, const char *key, uint64_t len);
+int64_t signed_mph_get_uint64_t(const signed_mph *signed_mph, uint64_t key);
+int64_t signed_mph_get_signature(const signed_mph *signed_mph, const uint64_t signature[4]);
+/* Stores in result the values of n keys, or -1 for keys not in the set, evaluating the function
+   on groups of keys as mph_get_signature_batch() does and then prefetching their fingerprints. */
+void signed_mph_get_byte_array_batch(const signed_mph *signed_mph, char * const *key, const int *len, int64_t *result, uint64_t n);
+void signed_mph_get_uint64_t_batch(const signed_mph *signed_mph, const uint64_t *key, int64_t *result, uint64_t n);
+void signed_mph_get_signature_batch(const signed_mph *signed_mph, const uint64_t (*signature)[4], int64_t *result, uint64_t n);
+
+#endif /* SIGNED_MPH_H_INCLUDED */
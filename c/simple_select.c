@@ -0,0 +1,271 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "simple_select.h"
+#include "broadword.h"
+
+#define MAX_LOG2_LONGWORDS_PER_SUBINVENTORY 3
+// Inventories are built by Java with at most 2^13 ones per entry, but padding
+// zeroes can make SimpleSelectZero choose a larger value for short vectors
+#define MAX_LOG2_ONES_PER_INVENTORY 30
+#define SPILLED (UINT64_C(1) << 63)
+
+// Ranks whose memory accesses are issued together by the batched method
+#define BATCH 16
+
+static inline int max(const int a, const int b) {
+	return a > b ? a : b;
+}
+
+static inline int min(const int a, const int b) {
+	return a < b ? a : b;
+}
+
+int map_simple_select_at(const void *dump, const int zero, const int param, const int section, simple_select *simple_select) {
+	const dump_header * const header = dump;
+	if (section + 4 > (int)header->num_sections) return -1;
+	return map_simple_select_inventories_at(dump, zero, param, section, section + 1, simple_select);
+}
+
+int map_simple_select_inventories_at(const void *dump, const int zero, const int param, const int bits_section, const int section, simple_select *simple_select) {
+	const dump_header * const header = dump;
+	if (param + 3 > DUMP_MAX_PARAMS || bits_section >= (int)header->num_sections || section + 3 > (int)header->num_sections) return -1;
+	if (header->param[param + 2] > MAX_LOG2_ONES_PER_INVENTORY) return -1;
+	const char * const base = dump;
+	memset(simple_select, 0, sizeof *simple_select);
+	simple_select->length = header->param[param];
+	simple_select->num_ones = header->param[param + 1];
+	simple_select->flip = zero ? UINT64_MAX : 0;
+	// The same derivation as in the Java constructor
+	const int log2_ones_per_inventory = header->param[param + 2];
+	simple_select->log2_ones_per_inventory = log2_ones_per_inventory;
+	simple_select->log2_longwords_per_subinventory = min(MAX_LOG2_LONGWORDS_PER_SUBINVENTORY, max(0, log2_ones_per_inventory - 2));
+	simple_select->log2_ones_per_sub16 = max(0, max(0, log2_ones_per_inventory - simple_select->log2_longwords_per_subinventory) - 2);
+	simple_select->num_words = header->section[bits_section].length / sizeof *simple_select->bits;
+	simple_select->bits = (const uint64_t *)(base + header->section[bits_section].offset);
+	simple_select->inventory_length = header->section[section].length / sizeof *simple_select->inventory;
+	simple_select->inventory = (const int64_t *)(base + header->section[section].offset);
+	simple_select->subinventory_length = header->section[section + 1].length / sizeof *simple_select->subinventory;
+	simple_select->subinventory = (const uint64_t *)(base + header->section[section + 1].offset);
+	simple_select->exact_spill_length = header->section[section + 2].length / sizeof *simple_select->exact_spill;
+	simple_select->exact_spill = (const uint64_t *)(base + header->section[section + 2].offset);
+	return 0;
+}
+
+int map_simple_select(const void *dump, const uint64_t length, simple_select *simple_select) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if ((header->kind != DUMP_SIMPLE_SELECT && header->kind != DUMP_SIMPLE_SELECT_ZERO) || header->num_sections != 4) return -1;
+	return map_simple_select_at(dump, header->kind == DUMP_SIMPLE_SELECT_ZERO, 0, 0, simple_select);
+}
+
+int simple_select_validate(const simple_select *simple_select) {
+	const uint64_t length = simple_select->length, num_words = simple_select->num_words;
+	if (num_words != (length + 63) / 64) return -1;
+	const int log2_ones_per_inventory = simple_select->log2_ones_per_inventory;
+	const int log2_longwords_per_subinventory = simple_select->log2_longwords_per_subinventory;
+	const int log2_ones_per_sub16 = simple_select->log2_ones_per_sub16;
+	const uint64_t ones_per_inventory_mask = (UINT64_C(1) << log2_ones_per_inventory) - 1;
+	const uint64_t ones_per_sub16_mask = (UINT64_C(1) << log2_ones_per_sub16) - 1;
+	const uint64_t num_ones = simple_select->num_ones;
+	uint64_t d = 0, inventory_index = 0, start = 0, spill = 0;
+	int spilled = 0;
+
+	// We enumerate the ones and check that each piece of information the lookup will use is exact
+	for (uint64_t i = 0; i < num_words; i++) {
+		uint64_t word = simple_select->bits[i] ^ simple_select->flip;
+		if (i == num_words - 1 && length % 64 != 0) word &= (UINT64_C(1) << length % 64) - 1;
+		for (; word != 0; word &= word - 1, d++) {
+			const uint64_t p = i * 64 + __builtin_ctzll(word);
+			if (d >= num_ones) return -1;
+			const uint64_t subrank = d & ones_per_inventory_mask;
+			if (subrank == 0) {
+				inventory_index = d >> log2_ones_per_inventory;
+				if (inventory_index >= simple_select->inventory_length) return -1;
+				const uint64_t entry = simple_select->inventory[inventory_index];
+				if ((entry & ~SPILLED) != p) return -1;
+				start = p;
+				spilled = (entry & SPILLED) != 0;
+				if (spilled) {
+					// Java spills only if there is more than one one per subinventory longword
+					if (log2_ones_per_inventory - log2_longwords_per_subinventory <= 0) return -1;
+					const uint64_t index = inventory_index << log2_longwords_per_subinventory;
+					if (index >= simple_select->subinventory_length) return -1;
+					spill = simple_select->subinventory[index];
+					const uint64_t ones = num_ones - d < ones_per_inventory_mask + 1 ? num_ones - d : ones_per_inventory_mask + 1;
+					if (spill > simple_select->exact_spill_length || ones > simple_select->exact_spill_length - spill) return -1;
+				}
+			}
+
+			if (spilled) {
+				if (simple_select->exact_spill[spill + subrank] != p) return -1;
+			}
+			else if ((subrank & ones_per_sub16_mask) == 0) {
+				const uint64_t index16 = (inventory_index << log2_longwords_per_subinventory + 2) + (subrank >> log2_ones_per_sub16);
+				if (index16 >= simple_select->subinventory_length * 4) return -1;
+				if ((simple_select->subinventory[index16 >> 2] >> ((index16 & 3) << 4) & 0xFFFF) != p - start) return -1;
+			}
+		}
+	}
+
+	return d == num_ones ? 0 : -1;
+}
+
+simple_select *load_simple_select(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	simple_select *simple_select = malloc(sizeof *simple_select);
+	if (simple_select == NULL || map_simple_select(map, length, simple_select) != 0) {
+		free(simple_select);
+		munmap(map, length);
+		return NULL;
+	}
+	simple_select->map = map;
+	simple_select->map_length = length;
+	return simple_select;
+}
+
+static int validate(const void *simple_select) {
+	return simple_select_validate(simple_select);
+}
+
+simple_select *load_simple_select_validated(int h) {
+	simple_select *simple_select = load_simple_select(h);
+	if (simple_select == NULL) return NULL;
+	if (simple_select_validate(simple_select) == 0) return simple_select;
+	munmap(simple_select->map, simple_select->map_length);
+	free(simple_select);
+	return NULL;
+}
+
+simple_select *load_simple_select_verify(int h, dump_verifier *verifier) {
+	simple_select *simple_select = load_simple_select(h);
+	if (simple_select == NULL) return NULL;
+	const dump_header * const header = simple_select->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)simple_select->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, simple_select) == 0) return simple_select;
+	munmap(simple_select->map, simple_select->map_length);
+	free(simple_select);
+	return NULL;
+}
+
+/* Returns the position of the one of rank residual among the bits from pos on. */
+static inline uint64_t scan(const simple_select * const simple_select, const uint64_t pos, uint64_t residual) {
+	const uint64_t * const bits = simple_select->bits;
+	const uint64_t flip = simple_select->flip;
+	uint64_t word_index = pos / 64;
+	uint64_t word = (bits[word_index] ^ flip) & UINT64_MAX << pos % 64;
+
+	for (;;) {
+		const uint64_t bit_count = __builtin_popcountll(word);
+		if (residual < bit_count) break;
+		word = bits[++word_index] ^ flip;
+		residual -= bit_count;
+	}
+
+	return word_index * 64 + select64(word, residual);
+}
+
+static inline uint64_t select_one(const simple_select * const simple_select, const uint64_t rank) {
+	const uint64_t inventory_index = rank >> simple_select->log2_ones_per_inventory;
+	const int64_t inventory_rank = simple_select->inventory[inventory_index];
+	const uint64_t subrank = rank & (UINT64_C(1) << simple_select->log2_ones_per_inventory) - 1;
+
+	if (subrank == 0) return inventory_rank & ~SPILLED;
+
+	if (inventory_rank < 0) return simple_select->exact_spill[simple_select->subinventory[inventory_index << simple_select->log2_longwords_per_subinventory] + subrank];
+
+	const uint64_t index16 = (inventory_index << simple_select->log2_longwords_per_subinventory + 2) + (subrank >> simple_select->log2_ones_per_sub16);
+	const uint64_t start = inventory_rank + (simple_select->subinventory[index16 >> 2] >> ((index16 & 3) << 4) & 0xFFFF);
+	const uint64_t residual = subrank & (UINT64_C(1) << simple_select->log2_ones_per_sub16) - 1;
+
+	if (residual == 0) return start;
+	return scan(simple_select, start, residual);
+}
+
+uint64_t simple_select_select(const simple_select *simple_select, const uint64_t rank) {
+	return select_one(simple_select, rank);
+}
+
+void simple_select_select_bulk(const simple_select *simple_select, const uint64_t rank, uint64_t *pos, const uint64_t n) {
+	if (n == 0) return;
+	const uint64_t * const bits = simple_select->bits;
+	const uint64_t flip = simple_select->flip;
+	const uint64_t s = select_one(simple_select, rank);
+	pos[0] = s;
+	uint64_t curr = s / 64;
+
+	uint64_t window = (bits[curr] ^ flip) & UINT64_MAX << s % 64;
+	window &= window - 1;
+
+	for (uint64_t i = 1; i < n; i++) {
+		while (window == 0) window = bits[++curr] ^ flip;
+		pos[i] = curr * 64 + __builtin_ctzll(window);
+		window &= window - 1;
+	}
+}
+
+void simple_select_select_batch(const simple_select *simple_select, const uint64_t *rank, uint64_t *pos, const uint64_t n) {
+	const int log2_ones_per_inventory = simple_select->log2_ones_per_inventory;
+	const int log2_longwords_per_subinventory = simple_select->log2_longwords_per_subinventory;
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		for (int j = 0; j < b; j++) {
+			const uint64_t inventory_index = rank[i + j] >> log2_ones_per_inventory;
+			__builtin_prefetch(&simple_select->inventory[inventory_index]);
+			__builtin_prefetch(&simple_select->subinventory[inventory_index << log2_longwords_per_subinventory]);
+		}
+		// Once the inventories are in cache, the first word to scan (or the spill) can be fetched
+		for (int j = 0; j < b; j++) {
+			const uint64_t inventory_index = rank[i + j] >> log2_ones_per_inventory;
+			const int64_t inventory_rank = simple_select->inventory[inventory_index];
+			const uint64_t subrank = rank[i + j] & (UINT64_C(1) << log2_ones_per_inventory) - 1;
+			if (inventory_rank < 0) __builtin_prefetch(&simple_select->exact_spill[simple_select->subinventory[inventory_index << log2_longwords_per_subinventory] + subrank]);
+			else {
+				const uint64_t index16 = (inventory_index << log2_longwords_per_subinventory + 2) + (subrank >> simple_select->log2_ones_per_sub16);
+				__builtin_prefetch(&simple_select->bits[(inventory_rank + (simple_select->subinventory[index16 >> 2] >> ((index16 & 3) << 4) & 0xFFFF)) / 64]);
+			}
+		}
+		for (int j = 0; j < b; j++) pos[i + j] = select_one(simple_select, rank[i + j]);
+	}
+}
+
+void simple_select_select_sorted(const simple_select *simple_select, const uint64_t *rank, uint64_t *pos, const uint64_t n) {
+	const int log2_ones_per_inventory = simple_select->log2_ones_per_inventory;
+	const int log2_ones_per_sub16 = simple_select->log2_ones_per_sub16;
+	uint64_t last_rank = UINT64_MAX, last_pos = 0;
+	for (uint64_t i = 0; i < n; i++) {
+		const uint64_t r = rank[i];
+		if (r != last_rank) {
+			// Within the span of a 16-bit subinventory entry select_one() would scan from the start of
+			// the span, so we scan instead from the previous position (spilled inventories need no scan)
+			if (last_rank != UINT64_MAX && r >> log2_ones_per_sub16 == last_rank >> log2_ones_per_sub16 && simple_select->inventory[r >> log2_ones_per_inventory] >= 0)
+				last_pos = scan(simple_select, last_pos + 1, r - last_rank - 1);
+			else last_pos = select_one(simple_select, r);
+			last_rank = r;
+		}
+		pos[i] = last_pos;
+	}
+}
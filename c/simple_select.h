@@ -0,0 +1,80 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SIMPLE_SELECT_H_INCLUDED
+#define SIMPLE_SELECT_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+
+/* A view of a SimpleSelect or SimpleSelectZero dump (see SimpleSelect.dump() in Java).
+   For SimpleSelectZero dumps, the bits are complemented on the fly, so "ones" must be
+   read as "zeroes" throughout. */
+typedef struct {
+	uint64_t length;
+	uint64_t num_ones;
+	uint64_t flip; // All ones for SimpleSelectZero dumps, zero otherwise
+	int log2_ones_per_inventory;
+	int log2_longwords_per_subinventory;
+	int log2_ones_per_sub16;
+	uint64_t num_words;
+	const uint64_t *bits;
+	uint64_t inventory_length;
+	const int64_t *inventory; // Negative entries have spilled
+	uint64_t subinventory_length;
+	const uint64_t *subinventory;
+	uint64_t exact_spill_length;
+	const uint64_t *exact_spill;
+	void *map; // The mapping, if loaded by load_simple_select()
+	uint64_t map_length;
+} simple_select;
+
+/* Maps a dump in memory (no copy), with no validation (see simple_select_validate());
+   returns NULL if the dump is not a SimpleSelect or SimpleSelectZero dump. */
+simple_select *load_simple_select(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_simple_select(const void *dump, uint64_t length, simple_select *simple_select);
+/* Fills a view of a SimpleSelect (or SimpleSelectZero, if zero is true) embedded in a dump
+   already checked by dump_map_header(), whose parameters and sections start at the given
+   indices (see SimpleSelect.dump(NativeDump) in Java); returns zero on success. */
+int map_simple_select_at(const void *dump, int zero, int param, int section, simple_select *simple_select);
+/* As map_simple_select_at(), but the bit vector, shared with another structure, is in section
+   bits_section, and section is the index of the inventory (see SimpleSelectZero.dump(NativeDump, boolean) in Java). */
+int map_simple_select_inventories_at(const void *dump, int zero, int param, int bits_section, int section, simple_select *simple_select);
+/* Checks, with a scan of the bit vector, that the inventories contain the positions they
+   should, so that selections need no bound check; returns zero if valid. */
+int simple_select_validate(const simple_select *simple_select);
+/* Maps a dump and validates it (see simple_select_validate()); returns NULL if the dump is not valid. */
+simple_select *load_simple_select_validated(int h);
+/* Maps a dump and starts verifying it in the background (see dump.h). */
+simple_select *load_simple_select_verify(int h, dump_verifier *verifier);
+/* Returns the position of the one of given rank, which must be smaller than the number of ones. */
+uint64_t simple_select_select(const simple_select *simple_select, uint64_t rank);
+/* Stores in pos the positions of the ones of the n consecutive ranks starting at rank
+   (rank + n must not be larger than the number of ones), as the bulk select() in Java. */
+void simple_select_select_bulk(const simple_select *simple_select, uint64_t rank, uint64_t *pos, uint64_t n);
+/* Stores in pos the positions of the ones of the n given ranks, prefetching groups of ranks. */
+void simple_select_select_batch(const simple_select *simple_select, const uint64_t *rank, uint64_t *pos, uint64_t n);
+/* Stores in pos the positions of the ones of the n given nondecreasing ranks: repeated ranks
+   are selected once, and a rank in the same subinventory span as the previous one is found
+   by scanning forward from the position of the previous one. */
+void simple_select_select_sorted(const simple_select *simple_select, const uint64_t *rank, uint64_t *pos, uint64_t n);
+
+#endif /* SIMPLE_SELECT_H_INCLUDED */
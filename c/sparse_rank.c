@@ -0,0 +1,128 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "sparse_rank.h"
+
+int map_sparse_rank(const void *dump, const uint64_t length, sparse_rank *sparse_rank) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_SPARSE_RANK || header->num_sections != 5) return -1;
+	return map_sparse_rank_at(dump, 0, 0, sparse_rank);
+}
+
+int map_sparse_rank_at(const void *dump, const int param, const int section, sparse_rank *sparse_rank) {
+	const dump_header * const header = dump;
+	if (param + 6 > DUMP_MAX_PARAMS || section + 5 > (int)header->num_sections || header->param[param + 1] > 63) return -1;
+	const char * const base = dump;
+	memset(sparse_rank, 0, sizeof *sparse_rank);
+	if (map_simple_select_at(dump, 1, param + 2, section + 1, &sparse_rank->upper_zero) != 0) return -1;
+	sparse_rank->n = header->param[param + 5];
+	elias_fano * const ones = &sparse_rank->ones;
+	ones->length = header->param[param];
+	ones->l = header->param[param + 1];
+	ones->lower_bits_length = header->section[section].length / sizeof *ones->lower_bits;
+	ones->lower_bits = (const uint64_t *)(base + header->section[section].offset);
+	ones->upper.length = sparse_rank->upper_zero.length;
+	ones->upper.num_ones = sparse_rank->upper_zero.length - sparse_rank->upper_zero.num_ones;
+	ones->upper.num_words = sparse_rank->upper_zero.num_words;
+	ones->upper.bits = sparse_rank->upper_zero.bits;
+	return 0;
+}
+
+int sparse_rank_validate(const sparse_rank *sparse_rank) {
+	const elias_fano * const ones = &sparse_rank->ones;
+	if (ones->length >= UINT64_MAX / 64 || sparse_rank->upper_zero.num_ones > sparse_rank->upper_zero.length) return -1;
+	// The sentinel, too, has lower bits (and the lower bits are never empty)
+	const uint64_t lower_bits_length = ((ones->length + 1) * ones->l + 63) / 64;
+	if (ones->lower_bits_length < (lower_bits_length > 0 ? lower_bits_length : 1)) return -1;
+	if (ones->upper.num_ones != ones->length + 1) return -1;
+	// Ranks select the zero following the upper bits of n
+	if (sparse_rank->upper_zero.num_ones <= sparse_rank->n >> ones->l) return -1;
+	return simple_select_validate(&sparse_rank->upper_zero);
+}
+
+sparse_rank *load_sparse_rank(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	sparse_rank *sparse_rank = malloc(sizeof *sparse_rank);
+	if (sparse_rank == NULL || map_sparse_rank(map, length, sparse_rank) != 0) {
+		free(sparse_rank);
+		munmap(map, length);
+		return NULL;
+	}
+	sparse_rank->map = map;
+	sparse_rank->map_length = length;
+	return sparse_rank;
+}
+
+static int validate(const void *sparse_rank) {
+	return sparse_rank_validate(sparse_rank);
+}
+
+sparse_rank *load_sparse_rank_validated(int h) {
+	sparse_rank *sparse_rank = load_sparse_rank(h);
+	if (sparse_rank == NULL) return NULL;
+	if (sparse_rank_validate(sparse_rank) == 0) return sparse_rank;
+	munmap(sparse_rank->map, sparse_rank->map_length);
+	free(sparse_rank);
+	return NULL;
+}
+
+sparse_rank *load_sparse_rank_verify(int h, dump_verifier *verifier) {
+	sparse_rank *sparse_rank = load_sparse_rank(h);
+	if (sparse_rank == NULL) return NULL;
+	const dump_header * const header = sparse_rank->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)sparse_rank->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, sparse_rank) == 0) return sparse_rank;
+	munmap(sparse_rank->map, sparse_rank->map_length);
+	free(sparse_rank);
+	return NULL;
+}
+
+uint64_t sparse_rank_rank(const sparse_rank *sparse_rank, const uint64_t pos) {
+	const elias_fano * const ones = &sparse_rank->ones;
+	const uint64_t * const upper = ones->upper.bits;
+	const int l = ones->l;
+	const uint64_t zeros = pos >> l;
+	const uint64_t pos_lower_bits = pos & (UINT64_C(1) << l) - 1;
+	// The ones before the zero of rank zeros are the elements whose upper bits are at most those of pos
+	uint64_t position = simple_select_select(&sparse_rank->upper_zero, zeros);
+	uint64_t rank = position - zeros;
+
+	// We step back over the elements with the same upper bits as pos that are not smaller
+	while (position-- != 0 && (upper[position / 64] & UINT64_C(1) << position % 64) != 0 && elias_fano_lower_bits(ones->lower_bits, l, rank - 1) >= pos_lower_bits) rank--;
+	return rank;
+}
+
+void sparse_rank_rank_sorted(const sparse_rank *sparse_rank, const uint64_t *pos, uint64_t *rank, const uint64_t n) {
+	const elias_fano * const ones = &sparse_rank->ones;
+	// The selection structure on the ones has no inventories, so we start from the first word
+	elias_fano_iterator iterator = { .elias_fano = ones, .upper_zero = &sparse_rank->upper_zero, .index = 0, .curr = 0, .window = ones->upper.bits[0] };
+	uint64_t next = 0; // The first element not smaller than the last position (UINT64_MAX if there is none)
+	for (uint64_t i = 0; i < n; i++) {
+		// The iterator does not move past a successor, so we can skip only if it is too small
+		if (i == 0 || pos[i] > next) next = elias_fano_iterator_skip_to(&iterator, pos[i]);
+		rank[i] = iterator.index;
+	}
+}
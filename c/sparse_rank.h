@@ -0,0 +1,61 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SPARSE_RANK_H_INCLUDED
+#define SPARSE_RANK_H_INCLUDED
+
+#include <inttypes.h>
+#include "elias_fano.h"
+
+/* A view of a sparse rank dump (see SparseRank.dump() in Java): the positions of the ones of a
+   bit vector, stored as an Elias-Fano list with a selection structure on the zeroes of the
+   upper bits. */
+typedef struct {
+	uint64_t n; // The number of bits of the underlying bit vector
+	/* The list of the positions of the ones, whose upper bits are shared with upper_zero: its
+	   selection structure on the upper bits has no inventories, so it can be used only by
+	   iterators, which scan the upper bits or select zeroes. */
+	elias_fano ones;
+	simple_select upper_zero; // Selects the zeroes of the upper bits
+	void *map; // The mapping, if loaded by load_sparse_rank()
+	uint64_t map_length;
+} sparse_rank;
+
+/* Maps a dump in memory (no copy), with no validation (see sparse_rank_validate());
+   returns NULL if the dump is not a sparse rank dump. */
+sparse_rank *load_sparse_rank(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_sparse_rank(const void *dump, uint64_t length, sparse_rank *sparse_rank);
+/* Fills a view of a structure embedded in a dump already checked by dump_map_header(), whose
+   parameters and sections start at the given indices; returns zero on success. */
+int map_sparse_rank_at(const void *dump, int param, int section, sparse_rank *sparse_rank);
+/* Checks the selection structure on zeroes and the size of the lower bits; returns zero if valid. */
+int sparse_rank_validate(const sparse_rank *sparse_rank);
+/* Maps a dump and validates it (see sparse_rank_validate()); returns NULL if the dump is not valid. */
+sparse_rank *load_sparse_rank_validated(int h);
+/* Maps a dump and starts verifying it in the background (see dump.h). */
+sparse_rank *load_sparse_rank_verify(int h, dump_verifier *verifier);
+/* Returns the number of ones before position pos, which must not be larger than n. */
+uint64_t sparse_rank_rank(const sparse_rank *sparse_rank, uint64_t pos);
+/* Stores in rank the ranks of the n given nondecreasing positions, moving forward with an
+   iterator from the previous rank: zeroes are counted word by word on short skips, and
+   selected only on long ones. */
+void sparse_rank_rank_sorted(const sparse_rank *sparse_rank, const uint64_t *pos, uint64_t *rank, uint64_t n);
+
+#endif /* SPARSE_RANK_H_INCLUDED */
@@ -0,0 +1,84 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "sparse_select.h"
+
+int map_sparse_select(const void *dump, const uint64_t length, sparse_select *sparse_select) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_SPARSE_SELECT || header->num_sections != 5) return -1;
+	memset(sparse_select, 0, sizeof *sparse_select);
+	sparse_select->n = header->param[5];
+	return map_elias_fano_at(dump, 0, 0, &sparse_select->ones);
+}
+
+int sparse_select_validate(const sparse_select *sparse_select) {
+	return elias_fano_validate(&sparse_select->ones);
+}
+
+sparse_select *load_sparse_select(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	sparse_select *sparse_select = malloc(sizeof *sparse_select);
+	if (sparse_select == NULL || map_sparse_select(map, length, sparse_select) != 0) {
+		free(sparse_select);
+		munmap(map, length);
+		return NULL;
+	}
+	sparse_select->map = map;
+	sparse_select->map_length = length;
+	return sparse_select;
+}
+
+static int validate(const void *sparse_select) {
+	return sparse_select_validate(sparse_select);
+}
+
+sparse_select *load_sparse_select_validated(int h) {
+	sparse_select *sparse_select = load_sparse_select(h);
+	if (sparse_select == NULL) return NULL;
+	if (sparse_select_validate(sparse_select) == 0) return sparse_select;
+	munmap(sparse_select->map, sparse_select->map_length);
+	free(sparse_select);
+	return NULL;
+}
+
+sparse_select *load_sparse_select_verify(int h, dump_verifier *verifier) {
+	sparse_select *sparse_select = load_sparse_select(h);
+	if (sparse_select == NULL) return NULL;
+	const dump_header * const header = sparse_select->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)sparse_select->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, sparse_select) == 0) return sparse_select;
+	munmap(sparse_select->map, sparse_select->map_length);
+	free(sparse_select);
+	return NULL;
+}
+
+uint64_t sparse_select_select(const sparse_select *sparse_select, const uint64_t rank) {
+	return elias_fano_get(&sparse_select->ones, rank);
+}
+
+void sparse_select_select_batch(const sparse_select *sparse_select, const uint64_t *rank, uint64_t *pos, const uint64_t n) {
+	elias_fano_get_batch(&sparse_select->ones, rank, pos, n);
+}
@@ -0,0 +1,51 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SPARSE_SELECT_H_INCLUDED
+#define SPARSE_SELECT_H_INCLUDED
+
+#include <inttypes.h>
+#include "elias_fano.h"
+
+/* A view of a sparse select dump (see SparseSelect.dump() in Java): the positions of the ones of
+   a bit vector, stored as an Elias-Fano list. */
+typedef struct {
+	uint64_t n; // The number of bits of the underlying bit vector
+	elias_fano ones; // The list of the positions of the ones
+	void *map; // The mapping, if loaded by load_sparse_select()
+	uint64_t map_length;
+} sparse_select;
+
+/* Maps a dump in memory (no copy), with no validation (see sparse_select_validate());
+   returns NULL if the dump is not a sparse select dump. */
+sparse_select *load_sparse_select(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_sparse_select(const void *dump, uint64_t length, sparse_select *sparse_select);
+/* Checks the list of the positions of the ones; returns zero if valid. */
+int sparse_select_validate(const sparse_select *sparse_select);
+/* Maps a dump and validates it (see sparse_select_validate()); returns NULL if the dump is not valid. */
+sparse_select *load_sparse_select_validated(int h);
+/* Maps a dump and starts verifying it in the background (see dump.h). */
+sparse_select *load_sparse_select_verify(int h, dump_verifier *verifier);
+/* Returns the position of the one of given rank, which must be smaller than the number of ones. */
+uint64_t sparse_select_select(const sparse_select *sparse_select, uint64_t rank);
+/* Stores in pos the positions of the ones of the n given ranks, prefetching groups of ranks. */
+void sparse_select_select_batch(const sparse_select *sparse_select, const uint64_t *rank, uint64_t *pos, uint64_t n);
+
+#endif /* SPARSE_SELECT_H_INCLUDED */
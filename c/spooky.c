@@ -91,6 +91,14 @@ void spooky_short_rehash(const uint64_t *signature, const uint64_t seed, uint64_
 	spooky_short_mix(tuple);
 }
 
+void spooky_short_rehash_triple(const uint64_t *signature, const uint64_t seed, uint64_t * const tuple) {
+	tuple[0] = seed;
+	tuple[1] = SC_CONST + signature[0];
+	tuple[2] = SC_CONST + signature[1];
+	tuple[3] = SC_CONST + signature[2];
+	spooky_short_mix(tuple);
+}
+
 void spooky_short(const void *restrict message, size_t length, uint64_t seed, uint64_t *tuple) {
 	union {
 		const uint8_t *p8;
@@ -173,3 +181,96 @@ void spooky_short(const void *restrict message, size_t length, uint64_t seed, ui
 
 	memcpy(tuple, h, sizeof h);
 }
+
+/* Hashes the last 0..255 bits of a bit vector (starting at bits) and its length. */
+static inline void spooky_short_bits_end(uint64_t *h, const uint64_t *bits, uint64_t remaining, const uint64_t length, uint64_t *tuple) {
+	//Handle the case of 128+ remaining bits.
+	if (remaining >= 128) {
+		h[2] += bits[0];
+		h[3] += bits[1];
+		spooky_short_mix(h);
+		bits += 2;
+		remaining -= 128;
+	}
+
+	// Handle the last 0..127 bits, and the length
+	if (remaining > 64) {
+		h[2] += bits[0];
+		h[3] += bits[1] & UINT64_C(-1) >> 128 - remaining;
+	}
+	else if (remaining > 0) h[2] += bits[0] & UINT64_C(-1) >> 64 - remaining;
+	else {
+		h[2] += SC_CONST;
+		h[3] += SC_CONST;
+	}
+
+	h[0] += length;
+
+	spooky_short_end(h);
+
+	memcpy(tuple, h, 4 * sizeof *h);
+}
+
+void spooky_short_bits(const uint64_t *bits, const uint64_t length, const uint64_t seed, uint64_t *tuple) {
+	uint64_t h[4];
+	h[0] = seed;
+	h[1] = seed;
+	h[2] = SC_CONST;
+	h[3] = SC_CONST;
+
+	uint64_t remaining = length;
+
+	// handle all complete sets of 256 bits
+	for (; remaining >= 256; bits += 4, remaining -= 256) {
+		h[2] += bits[0];
+		h[3] += bits[1];
+		spooky_short_mix(h);
+		h[0] += bits[2];
+		h[1] += bits[3];
+	}
+
+	spooky_short_bits_end(h, bits, remaining, length, tuple);
+}
+
+void spooky_short_bits_preprocess(const uint64_t *bits, const uint64_t length, const uint64_t seed, uint64_t *state) {
+	uint64_t h[4];
+	h[0] = seed;
+	h[1] = seed;
+	h[2] = SC_CONST;
+	h[3] = SC_CONST;
+
+	// The state after the first mix of each set of 256 bits, if at least 128 bits are left
+	for (uint64_t remaining = length; remaining >= 128; bits += 4, remaining -= 256, state += 4) {
+		h[2] += bits[0];
+		h[3] += bits[1];
+		spooky_short_mix(h);
+		memcpy(state, h, sizeof h);
+		if (remaining < 384) break;
+		h[0] += bits[2];
+		h[1] += bits[3];
+	}
+}
+
+void spooky_short_bits_prefix(const uint64_t *bits, const uint64_t length, const uint64_t seed, const uint64_t *state, uint64_t *tuple) {
+	uint64_t h[4];
+	uint64_t pos;
+	if (length >= 128) {
+		const uint64_t p = (length - 128) / 256;
+		memcpy(h, state + 4 * p, sizeof h);
+		pos = p * 256 + 128;
+		if (length - pos >= 128) {
+			h[0] += bits[pos / 64];
+			h[1] += bits[pos / 64 + 1];
+			pos += 128;
+		}
+	}
+	else {
+		h[0] = seed;
+		h[1] = seed;
+		h[2] = SC_CONST;
+		h[3] = SC_CONST;
+		pos = 0;
+	}
+
+	spooky_short_bits_end(h, bits + pos / 64, length - pos, length, tuple);
+}
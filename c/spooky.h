@@ -53,5 +53,13 @@
 
 void spooky_short(const void *restrict message, size_t length, uint64_t seed, uint64_t *tuple);
 void spooky_short_rehash(const uint64_t *signature, const uint64_t seed, uint64_t * const tuple);
+// As spooky_short_rehash(), but mixing the first three words of the signature (as Hashes.spooky4(long[], long, long[]) in Java)
+void spooky_short_rehash_triple(const uint64_t *signature, const uint64_t seed, uint64_t * const tuple);
+// As spooky_short(), but on the first length bits of a bit vector stored as in a LongArrayBitVector (as Hashes.spooky4(BitVector, long, long[]) in Java)
+void spooky_short_bits(const uint64_t *bits, uint64_t length, uint64_t seed, uint64_t *tuple);
+// Stores in state, which must contain 4 * ((length + 128) / 256) words, the state of spooky_short_bits() after each set of 256 bits (as Hashes.preprocessSpooky4() in Java)
+void spooky_short_bits_preprocess(const uint64_t *bits, uint64_t length, uint64_t seed, uint64_t *state);
+// As spooky_short_bits(), but in constant time on a prefix of a preprocessed bit vector with the same seed (as Hashes.spooky4(BitVector, long, long, long[], long[]) in Java)
+void spooky_short_bits_prefix(const uint64_t *bits, uint64_t length, uint64_t seed, const uint64_t *state, uint64_t *tuple);
 
 #endif /* SPOOKY_H_INCLUDED */
@@ -0,0 +1,155 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * Benchmarks a balanced-parentheses dump: matches, enclosing parentheses and tree navigation,
+ * checking the results against those computed with a stack.
+ *
+ * test_balanced_parentheses DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "balanced_parentheses.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample, uint64_t n) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / n);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	balanced_parentheses *bp = load_balanced_parentheses(h);
+	close(h);
+	assert(bp != NULL);
+	const uint64_t length = bp->length;
+	assert(length != 0);
+
+	// Matches, enclosing parentheses and subtree sizes computed with a stack
+	uint64_t *match = malloc(length * sizeof *match), *enclose = malloc(length * sizeof *enclose), *stack = malloc(length * sizeof *stack), depth = 0;
+	uint64_t *open_pos = malloc(length / 2 * sizeof *open_pos), *close_pos = malloc(length / 2 * sizeof *close_pos), num_open = 0, num_close = 0;
+	for (uint64_t i = 0; i < length; i++) {
+		if (bp->bits[i / 64] >> i % 64 & 1) {
+			enclose[i] = depth == 0 ? UINT64_MAX : stack[depth - 1];
+			stack[depth++] = i;
+			open_pos[num_open++] = i;
+		} else {
+			match[i] = stack[--depth];
+			match[match[i]] = i;
+			close_pos[num_close++] = i;
+		}
+	}
+
+	for (uint64_t i = 0; i < num_open; i++) {
+		const uint64_t p = open_pos[i];
+		assert(balanced_parentheses_find_close(bp, p) == match[p]);
+		assert(balanced_parentheses_find_open(bp, match[p]) == p);
+		assert(balanced_parentheses_enclose(bp, p) == enclose[p]);
+		assert(balanced_parentheses_subtree_size(bp, p) == (match[p] - p + 1) / 2);
+		assert(balanced_parentheses_first_child(bp, p) == (match[p] == p + 1 ? UINT64_MAX : p + 1));
+		assert(balanced_parentheses_next_sibling(bp, p) == (match[p] + 1 < length && bp->bits[(match[p] + 1) / 64] >> (match[p] + 1) % 64 & 1 ? match[p] + 1 : UINT64_MAX));
+	}
+
+	uint64_t *open_query = malloc(NQUERIES * sizeof *open_query), *close_query = malloc(NQUERIES * sizeof *close_query);
+	for (int i = 0; i < NQUERIES; i++) {
+		open_query[i] = open_pos[next() % num_open];
+		close_query[i] = close_pos[next() % num_close];
+	}
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += balanced_parentheses_find_close(bp, open_query[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("find_close", sample, NQUERIES);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += balanced_parentheses_find_open(bp, close_query[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("find_open", sample, NQUERIES);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += balanced_parentheses_enclose(bp, open_query[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("enclose", sample, NQUERIES);
+
+	// A depth-first visit of the forest using first_child(), next_sibling() and parent()
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		uint64_t node = 0, visited = 0;
+		for (;;) {
+			visited++;
+			uint64_t next = balanced_parentheses_first_child(bp, node);
+			while (next == UINT64_MAX && node != UINT64_MAX) {
+				next = balanced_parentheses_next_sibling(bp, node);
+				if (next == UINT64_MAX) node = balanced_parentheses_parent(bp, node);
+			}
+			if (next == UINT64_MAX) break;
+			node = next;
+		}
+		sample[k] = elapsed + get_system_time();
+		assert(visited == num_open);
+	}
+	report("visit", sample, num_open);
+
+	const volatile int unused = u;
+}
@@ -0,0 +1,169 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmarks an Elias-Fano list dump: random gets and pairs of consecutive
+ * elements, one at a time and in batches, ranges of consecutive elements, and
+ * sequential decoding in blocks.
+ *
+ * test_elias_fano DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "elias_fano.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+#define RANGE 64
+#define BLOCK 256
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / NQUERIES);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	elias_fano *elias_fano = load_elias_fano_validated(h);
+	close(h);
+	assert(elias_fano != NULL);
+	assert(elias_fano->length >= RANGE);
+
+	uint64_t *index = malloc(NQUERIES * sizeof *index), *result = malloc(NQUERIES * sizeof *result);
+	for (int i = 0; i < NQUERIES; i++) index[i] = next() % elias_fano->length;
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += elias_fano_get(elias_fano, index[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		elias_fano_get_batch(elias_fano, index, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get (batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) assert(result[i] == elias_fano_get(elias_fano, index[i]));
+
+	// Pairs of consecutive elements, as in the lookup of an interval in a prefix-sum list
+	uint64_t *end = malloc(NQUERIES * sizeof *end), t;
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) {
+			elias_fano_get_pair(elias_fano, index[i], &t, &end[i]);
+			u += end[i] - t;
+		}
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get pair", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		elias_fano_get_pair_batch(elias_fano, index, result, end, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get pair (batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) assert(result[i] == elias_fano_get(elias_fano, index[i]) && end[i] == elias_fano_get(elias_fano, index[i] + 1));
+
+	// Ranges of RANGE elements starting at random indices
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i += RANGE) {
+			const uint64_t from = index[i] < elias_fano->length - RANGE ? index[i] : 0;
+			elias_fano_get_range(elias_fano, from, from + RANGE, result + i);
+		}
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get (range)", sample);
+	for (int i = 0; i < NQUERIES / RANGE * RANGE; i++) {
+		const uint64_t from = index[i / RANGE * RANGE] < elias_fano->length - RANGE ? index[i / RANGE * RANGE] : 0;
+		assert(result[i] == elias_fano_get(elias_fano, from + i % RANGE));
+	}
+
+	// Sequential decoding of NQUERIES elements, starting over at the end of the list
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		elias_fano_iterator iterator;
+		elias_fano_iterator_init(elias_fano, 0, &iterator);
+		for (int i = 0; i < NQUERIES; i += BLOCK) {
+			if (elias_fano_iterator_next(&iterator, result, BLOCK) != BLOCK) elias_fano_iterator_init(elias_fano, 0, &iterator);
+			u += result[BLOCK - 1];
+		}
+		sample[k] = elapsed + get_system_time();
+	}
+	report("iterator (blocks)", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0, from = 0; i < NQUERIES; i += BLOCK, from += BLOCK) {
+			if (from + BLOCK > elias_fano->length) from = 0;
+			elias_fano_get_range(elias_fano, from, from + BLOCK, result);
+			u += result[BLOCK - 1];
+		}
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get (consecutive ranges)", sample);
+
+	elias_fano_iterator iterator;
+	elias_fano_iterator_init(elias_fano, 0, &iterator);
+	for (uint64_t i = 0, c; (c = elias_fano_iterator_next(&iterator, result, BLOCK)) != 0; i += c)
+		for (uint64_t j = 0; j < c; j++) assert(result[j] == elias_fano_get(elias_fano, i + j));
+
+	const volatile int unused = u;
+}
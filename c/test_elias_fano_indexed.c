@@ -0,0 +1,134 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * Benchmarks an indexed Elias-Fano list dump: random successors, predecessors
+ * and membership queries, and successors of a sorted stream of lower bounds.
+ *
+ * test_elias_fano_indexed DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "elias_fano_indexed.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / NQUERIES);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	elias_fano_indexed *elias_fano_indexed = load_elias_fano_indexed_validated(h);
+	close(h);
+	assert(elias_fano_indexed != NULL);
+	assert(elias_fano_indexed->elias_fano.length != 0);
+
+	const uint64_t max = elias_fano_indexed->last_element + 1;
+	uint64_t *bound = malloc(NQUERIES * sizeof *bound), *index = malloc(NQUERIES * sizeof *index), *result = malloc(NQUERIES * sizeof *result);
+	for (int i = 0; i < NQUERIES; i++) bound[i] = next() % max;
+
+	uint64_t sample[SAMPLES], u = 0, t;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += elias_fano_indexed_successor(elias_fano_indexed, bound[i], &t);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("successor", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += elias_fano_indexed_predecessor(elias_fano_indexed, bound[i], &t);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("predecessor", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += elias_fano_indexed_contains(elias_fano_indexed, bound[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("contains", sample);
+
+	// Sorted streams whose average gap is the universe divided by NQUERIES times 1, 16 and 256
+	for (int gap = 1; gap <= 256; gap *= 16) {
+		for (int i = 0; i < NQUERIES; i++) bound[i] = next() % (max / gap + 1);
+		qsort(bound, NQUERIES, sizeof *bound, cmp_uint64_t);
+
+		for (int k = SAMPLES; k-- != 0; ) {
+			int64_t elapsed = - get_system_time();
+			for (int i = 0; i < NQUERIES; i++) u += elias_fano_indexed_successor(elias_fano_indexed, bound[i], &t);
+			sample[k] = elapsed + get_system_time();
+		}
+		printf("1/%d of the universe, ", gap);
+		report("successor (sorted)", sample);
+
+		for (int k = SAMPLES; k-- != 0; ) {
+			int64_t elapsed = - get_system_time();
+			elias_fano_indexed_successor_sorted(elias_fano_indexed, bound, index, result, NQUERIES);
+			sample[k] = elapsed + get_system_time();
+		}
+		printf("1/%d of the universe, ", gap);
+		report("successor (sorted stream)", sample);
+		for (int i = 0; i < NQUERIES; i++) {
+			assert(result[i] == elias_fano_indexed_successor(elias_fano_indexed, bound[i], &t));
+			assert(index[i] == t);
+		}
+	}
+
+	const volatile int unused = u;
+}
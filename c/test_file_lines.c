@@ -0,0 +1,130 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Checks and benchmarks a file-lines dump (see FileLinesBigList.dump() in Java) against a
+ * sequential scan of the text file it describes, and then measures random lookups, one at a time
+ * and in batches.
+ *
+ * test_file_lines DUMP TEXT
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "file_lines.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / NQUERIES);
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 3);
+	const int h = open(argv[1], O_RDONLY), t = open(argv[2], O_RDONLY);
+	assert(h >= 0 && t >= 0);
+	file_lines *file_lines = load_file_lines_validated(h, t);
+	close(h);
+	close(t);
+	assert(file_lines != NULL);
+	printf("%" PRIu64 " lines, %" PRIu64 " bytes\n", file_lines->size, file_lines->text_length);
+	if (file_lines->size == 0) return 0;
+
+	// A sequential scan recognizing the same terminators as the Java list
+	const char * const text = file_lines->text;
+	const uint64_t n = file_lines->text_length;
+	const int terminators = file_lines->terminators;
+	uint64_t line = 0, start = 0, len;
+	for (uint64_t p = 0; p <= n; p++) {
+		int t = 0;
+		if (p == n) t = start < n;
+		else if ((terminators & FILE_LINES_CR_LF) && text[p] == '\r' && p + 1 < n && text[p + 1] == '\n') t = 2;
+		else if ((terminators & FILE_LINES_LF) && text[p] == '\n') t = 1;
+		else if ((terminators & FILE_LINES_CR) && text[p] == '\r') t = 1;
+		if (t == 0) continue;
+		const char * const l = file_lines_get(file_lines, line++, &len);
+		assert(l == text + start && len == p - start);
+		p += t - 1;
+		start = p + 1;
+	}
+	assert(line == file_lines->size);
+
+	uint64_t *index = malloc(NQUERIES * sizeof *index), *result_len = malloc(NQUERIES * sizeof *result_len);
+	const char **result = malloc(NQUERIES * sizeof *result);
+	for (int i = 0; i < NQUERIES; i++) index[i] = next() % file_lines->size;
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += *file_lines_get(file_lines, index[i], &len) + len;
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		file_lines_get_batch(file_lines, index, result, result_len, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get (batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) {
+		const char * const l = file_lines_get(file_lines, index[i], &len);
+		assert(result[i] == l && result_len[i] == len);
+	}
+
+	const volatile int unused = u;
+}
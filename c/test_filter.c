@@ -0,0 +1,162 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Checks and benchmarks a filter (an approximate dictionary) built on a newline-separated list
+ * of strings using TransformationStrategies.rawByteArray(): all keys must be found, and keys not
+ * in the set (the keys followed by a byte not appearing in text) must be found about as rarely
+ * as the fingerprint width predicts, both for single and for batched lookups. The generic code
+ * and, if the width is 8 or 16, the direct access code are checked against each other, and
+ * positive and negative lookups are measured separately.
+ *
+ * test_filter DUMP KEYS
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "filter3.h"
+#include "filter4.h"
+
+#define SAMPLES 11
+
+typedef struct {
+	const char *name;
+	int (*contains)(const filter *filter, const char *key, uint64_t len);
+	void (*contains_batch)(const filter *filter, char * const *key, const int *len, int *result, uint64_t n);
+} kernel;
+
+static const kernel kernel3[] = {
+	{ "filter3", filter3_contains_byte_array, filter3_contains_byte_array_batch },
+	{ "filter3_8", filter3_8_contains_byte_array, filter3_8_contains_byte_array_batch },
+	{ "filter3_16", filter3_16_contains_byte_array, filter3_16_contains_byte_array_batch }
+};
+
+static const kernel kernel4[] = {
+	{ "filter4", filter4_contains_byte_array, filter4_contains_byte_array_batch },
+	{ "filter4_8", filter4_8_contains_byte_array, filter4_8_contains_byte_array_batch },
+	{ "filter4_16", filter4_16_contains_byte_array, filter4_16_contains_byte_array_batch }
+};
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static void bench(const kernel *kernel, const filter *filter, char **key, int *key_len, int *result, const uint64_t n, const char *name) {
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0; i < n; i++) u += kernel->contains(filter, key[i], key_len[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s %s: median %.3f ns/key\n", kernel->name, name, sample[SAMPLES / 2] * 1000. / n);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		kernel->contains_batch(filter, key, key_len, result, n);
+		sample[k] = elapsed + get_system_time();
+		u += result[0];
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s %s (batch): median %.3f ns/key\n", kernel->name, name, sample[SAMPLES / 2] * 1000. / n);
+
+	const volatile int unused = u;
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 3);
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	filter *filter = load_filter_validated(h);
+	close(h);
+	assert(filter != NULL);
+	const uint64_t n = filter->size;
+	printf("%" PRIu64 " keys, arity %d, %d-bit fingerprints\n", n, filter->arity, filter->fingerprint_width);
+	if (n == 0) return 0;
+
+	h = open(argv[2], O_RDONLY);
+	assert(h >= 0);
+	const off_t len = lseek(h, 0, SEEK_END);
+	lseek(h, 0, SEEK_SET);
+	char *data = malloc(len + 1);
+	read(h, data, len);
+	close(h);
+	data[len] = 0xA;
+
+	char **key = malloc(n * sizeof *key), **alien = malloc(n * sizeof *alien);
+	int *key_len = malloc(n * sizeof *key_len), *alien_len = malloc(n * sizeof *alien_len);
+	char *p = data, * const end = data + len;
+	for (uint64_t i = 0; i < n; i++) {
+		assert(p < end);
+		key[i] = p;
+		while(*p != 0xA) p++;
+		key_len[i] = p++ - key[i];
+		alien[i] = malloc(key_len[i] + 1);
+		memcpy(alien[i], key[i], key_len[i]);
+		alien[i][key_len[i]] = 1;
+		alien_len[i] = key_len[i] + 1;
+	}
+
+	// The generic kernel, followed by the direct access kernel for the width, if any
+	const kernel *kernel[2] = { filter->arity == 3 ? &kernel3[0] : &kernel4[0] };
+	const int num_kernels = filter->fingerprint_width == 8 || filter->fingerprint_width == 16 ? 2 : 1;
+	if (num_kernels == 2) kernel[1] = kernel[0] + (filter->fingerprint_width == 8 ? 1 : 2);
+
+	int *result = malloc(n * sizeof *result), *alien_result = malloc(n * sizeof *alien_result);
+	uint64_t false_positives = 0;
+	for (int k = 0; k < num_kernels; k++) {
+		kernel[k]->contains_batch(filter, key, key_len, result, n);
+		for (uint64_t i = 0; i < n; i++) assert(kernel[k]->contains(filter, key[i], key_len[i]) == 1 && result[i] == 1);
+
+		kernel[k]->contains_batch(filter, alien, alien_len, result, n);
+		for (uint64_t i = 0; i < n; i++) {
+			const int v = kernel[k]->contains(filter, alien[i], alien_len[i]);
+			assert(result[i] == v);
+			// All kernels must agree
+			if (k == 0) {
+				alien_result[i] = v;
+				false_positives += v;
+			}
+			else assert(alien_result[i] == v);
+		}
+	}
+
+	const double expected = n / (double)(UINT64_C(1) << (filter->fingerprint_width < 63 ? filter->fingerprint_width : 63));
+	printf("false positives: %" PRIu64 " (expected %.3f)\n", false_positives, expected);
+	assert(false_positives <= 2 * expected + 10);
+
+	for (int k = 0; k < num_kernels; k++) {
+		bench(kernel[k], filter, key, key_len, result, n, "positive");
+		bench(kernel[k], filter, alien, alien_len, result, n, "negative");
+	}
+}
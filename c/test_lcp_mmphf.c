@@ -0,0 +1,143 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Checks and benchmarks an LCP monotone minimal perfect hash function built on a
+ * newline-separated, sorted list of strings using TransformationStrategies.prefixFreeByteArray():
+ * every key must be mapped to its rank. Lookups are measured on the keys in random order, one at a
+ * time and in batches, and in sorted order in batches, where consecutive keys share the
+ * evaluation of their prefix.
+ *
+ * test_lcp_mmphf DUMP KEYS
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "lcp_mmphf.h"
+
+#define SAMPLES 11
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample, const uint64_t n) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/key\n", name, sample[SAMPLES / 2] * 1000. / n);
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 3);
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	lcp_mmphf *lcp_mmphf = load_lcp_mmphf_validated(h);
+	close(h);
+	assert(lcp_mmphf != NULL);
+
+	h = open(argv[2], O_RDONLY);
+	assert(h >= 0);
+	const off_t len = lseek(h, 0, SEEK_END);
+	lseek(h, 0, SEEK_SET);
+	char *data = malloc(len + 1);
+	read(h, data, len);
+	close(h);
+	data[len] = 0xA;
+
+	const uint64_t n = lcp_mmphf->size;
+	char **key = malloc(n * sizeof *key), **shuffled = malloc(n * sizeof *shuffled);
+	int *key_len = malloc(n * sizeof *key_len), *shuffled_len = malloc(n * sizeof *shuffled_len);
+	uint64_t *rank = malloc(n * sizeof *rank);
+	int64_t *result = malloc(n * sizeof *result);
+	char *p = data, * const end = data + len;
+	for (uint64_t i = 0; i < n; i++) {
+		assert(p < end);
+		key[i] = p;
+		while(*p != 0xA) p++;
+		key_len[i] = p++ - key[i];
+		rank[i] = i;
+	}
+
+	for (uint64_t i = n; i-- > 1; ) {
+		const uint64_t j = next() % (i + 1), t = rank[i];
+		rank[i] = rank[j];
+		rank[j] = t;
+	}
+	for (uint64_t i = 0; i < n; i++) {
+		shuffled[i] = key[rank[i]];
+		shuffled_len[i] = key_len[rank[i]];
+		assert(lcp_mmphf_get_byte_array(lcp_mmphf, shuffled[i], shuffled_len[i]) == rank[i]);
+	}
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0; i < n; i++) u += lcp_mmphf_get_byte_array(lcp_mmphf, shuffled[i], shuffled_len[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get", sample, n);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		lcp_mmphf_get_byte_array_batch(lcp_mmphf, shuffled, shuffled_len, result, n);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get (batch)", sample, n);
+	for (uint64_t i = 0; i < n; i++) assert(result[i] == rank[i]);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		lcp_mmphf_get_byte_array_batch(lcp_mmphf, key, key_len, result, n);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get (sorted batch)", sample, n);
+	for (uint64_t i = 0; i < n; i++) assert(result[i] == i);
+
+	const volatile int unused = u;
+}
@@ -0,0 +1,119 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Builds a function on N pseudorandom 64-bit keys with the given number of threads, checks that
+ * it is a bijection and that adding the keys by batches gives the same function, dumps it, and
+ * checks that the validated reloaded function agrees.
+ *
+ * test_mph_builder N THREADS DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "mph_builder.h"
+
+#define BATCH (1 << 20)
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 4);
+	const uint64_t n = strtoull(argv[1], NULL, 0);
+	const int threads = atoi(argv[2]);
+
+	// A xoroshiro128+ sequence has no repetitions within its period
+	uint64_t *key = malloc(n * sizeof *key);
+	for (uint64_t i = 0; i < n; i++) key[i] = next();
+
+	mph_builder * const builder = mph_builder_new(NULL, 0);
+	assert(builder != NULL);
+	int64_t elapsed = - get_system_time();
+	int result = 0;
+	for (uint64_t i = 0; i < n && result == 0; i++) result = mph_builder_add_uint64_t(builder, key[i]);
+	assert(result == 0);
+	mph built, other;
+	result = mph_builder_build(builder, threads, &built);
+	assert(result == 0);
+	elapsed += get_system_time();
+	printf("Built in %.3f s (%.3f ns/key), %" PRIu64 " unsolvable, %" PRIu64 " unorientable, %.3f bits/key\n", elapsed / 1E6, elapsed * 1000. / n, builder->unsolvable, builder->unorientable, (built.edge_offset_and_seed_length + built.array_length) * 64. / n);
+	result = mph_validate(&built);
+	assert(result == 0);
+
+	uint64_t *seen = calloc((n + 63) / 64, sizeof *seen);
+	for (uint64_t i = 0; i < n; i++) {
+		const int64_t v = mph_get_uint64_t(&built, key[i]);
+		assert(v >= 0 && (uint64_t)v < n);
+		assert(!(seen[v / 64] & UINT64_C(1) << v % 64));
+		seen[v / 64] |= UINT64_C(1) << v % 64;
+	}
+
+	// Rebuilding the same keys, added in parallel by batches, after a reset gives the same function
+	result = mph_builder_reset(builder, 0);
+	assert(result == 0);
+	for (uint64_t i = 0; i < n && result == 0; i += BATCH) result = mph_builder_add_uint64_t_batch(builder, key + i, n - i < BATCH ? n - i : BATCH, threads);
+	assert(result == 0 && builder->size == n);
+	result = mph_builder_build(builder, threads == 1 ? 2 : 1, &other);
+	assert(result == 0);
+	assert(other.array_length == built.array_length && memcmp(other.array, built.array, built.array_length * sizeof *built.array) == 0);
+	assert(memcmp(other.edge_offset_and_seed, built.edge_offset_and_seed, built.edge_offset_and_seed_length * sizeof *built.edge_offset_and_seed) == 0);
+	mph_builder_free(builder);
+
+	result = mph_dump(&built, DUMP_RAW_LONG, argv[3]);
+	assert(result == 0);
+	const int h = open(argv[3], O_RDONLY);
+	assert(h >= 0);
+	mph *loaded = load_mph_validated(h);
+	close(h);
+	assert(loaded != NULL && loaded->size == n);
+	for (uint64_t i = 0; i < n; i++) {
+		const int64_t v = mph_get_uint64_t(loaded, key[i]);
+		assert(v == mph_get_uint64_t(&built, key[i]));
+	}
+	printf("OK\n");
+}
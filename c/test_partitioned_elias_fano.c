@@ -0,0 +1,128 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmarks a partitioned Elias-Fano list dump: random accesses, random
+ * successors and bulk decoding of consecutive ranges.
+ *
+ * test_partitioned_elias_fano DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "partitioned_elias_fano.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+#define RANGE 1024
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample, uint64_t n) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/element\n", name, sample[SAMPLES / 2] * 1000. / n);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	partitioned_elias_fano *partitioned_elias_fano = load_partitioned_elias_fano_validated(h);
+	close(h);
+	assert(partitioned_elias_fano != NULL);
+	const uint64_t n = partitioned_elias_fano->length;
+	assert(n != 0);
+
+	const uint64_t max = partitioned_elias_fano_get(partitioned_elias_fano, n - 1) + 1;
+	uint64_t *position = malloc(NQUERIES * sizeof *position), *bound = malloc(NQUERIES * sizeof *bound), *dest = malloc(RANGE * sizeof *dest);
+	for (int i = 0; i < NQUERIES; i++) {
+		position[i] = next() % n;
+		bound[i] = next() % max;
+	}
+
+	uint64_t sample[SAMPLES], u = 0, t;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += partitioned_elias_fano_get(partitioned_elias_fano, position[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get", sample, NQUERIES);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += partitioned_elias_fano_successor(partitioned_elias_fano, bound[i], &t);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("successor", sample, NQUERIES);
+
+	// Ranges of RANGE elements starting at random positions
+	const uint64_t ranges = NQUERIES / RANGE;
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0; i < ranges; i++) {
+			const uint64_t from = position[i] > n - RANGE ? 0 : position[i];
+			const uint64_t to = from + RANGE < n ? from + RANGE : n;
+			partitioned_elias_fano_get_range(partitioned_elias_fano, from, to, dest);
+			u += dest[(to - from) / 2];
+		}
+		sample[k] = elapsed + get_system_time();
+	}
+	report("get_range", sample, ranges * RANGE);
+
+	for (uint64_t i = 0; i < ranges; i++) {
+		const uint64_t from = position[i] > n - RANGE ? 0 : position[i];
+		const uint64_t to = from + RANGE < n ? from + RANGE : n;
+		partitioned_elias_fano_get_range(partitioned_elias_fano, from, to, dest);
+		for (uint64_t j = from; j < to; j++) assert(dest[j - from] == partitioned_elias_fano_get(partitioned_elias_fano, j));
+	}
+
+	const volatile int unused = u;
+}
@@ -0,0 +1,151 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmarks the population-count kernels against the scalar one, checking that they agree.
+ *
+ * test_popcount [WORDS]
+ *
+ * The default size (2^14 words) fits in the L2 cache; use larger sizes to measure memory-bound behavior.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/time.h>
+#include "popcount.h"
+
+#define SAMPLES 11
+#define NRANGES 1000000
+// Words processed by each sample of the bulk kernels
+#define WORK (UINT64_C(1) << 26)
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static double median(uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	return sample[SAMPLES / 2];
+}
+
+int main(int argc, char* argv[]) {
+	const uint64_t n = argc > 1 ? strtoull(argv[1], NULL, 0) : 1 << 14;
+	uint64_t *words = malloc(n * sizeof *words), *count = malloc(((n + 7) / 8 * 2 + 1) * sizeof *count), *expected = malloc(((n + 7) / 8 * 2 + 1) * sizeof *expected);
+	uint64_t *from = malloc(NRANGES * sizeof *from), *to = malloc(NRANGES * sizeof *to);
+	for (uint64_t i = 0; i < n; i++) words[i] = next() & next(); // Density 1/4
+	for (int i = 0; i < NRANGES; i++) {
+		from[i] = next() % (n * 64);
+		// Ranges of up to 64 Ki bits
+		const uint64_t l = next() % (UINT64_C(1) << 16);
+		to[i] = from[i] + (l < n * 64 - from[i] ? l : n * 64 - from[i]);
+	}
+
+	popcount_use(POPCOUNT_SCALAR);
+	const uint64_t ones = popcount_words(words, n), pairs = popcount_nonzero_pairs(words, n);
+	assert(popcount_rank9_counts(words, n, expected) == ones);
+
+	uint64_t sample[SAMPLES], u = 0;
+	const uint64_t reps = WORK / n > 0 ? WORK / n : 1;
+
+	for (int kernel = POPCOUNT_SCALAR; kernel <= POPCOUNT_AVX512; kernel++) {
+		if (popcount_use(kernel) != 0) {
+			printf("%s: not supported\n", popcount_kernel_name(kernel));
+			continue;
+		}
+
+		// Tails of every length
+		for (uint64_t l = 0; l < 64 && l <= n; l++) {
+			popcount_use(POPCOUNT_SCALAR);
+			const uint64_t c = popcount_words(words + n - l, l), p = popcount_nonzero_pairs(words + n - l, l);
+			popcount_use(kernel);
+			assert(popcount_words(words + n - l, l) == c);
+			assert(popcount_nonzero_pairs(words + n - l, l) == p);
+		}
+
+		for (int k = SAMPLES; k-- != 0; ) {
+			int64_t elapsed = - get_system_time();
+			for (uint64_t r = reps; r-- != 0;) u += popcount_words(words, n);
+			sample[k] = elapsed + get_system_time();
+		}
+		assert(popcount_words(words, n) == ones);
+		printf("%s: words %.3f GB/s", popcount_kernel_name(kernel), reps * n * 8 / (median(sample) * 1000));
+
+		for (int k = SAMPLES; k-- != 0; ) {
+			int64_t elapsed = - get_system_time();
+			for (uint64_t r = reps; r-- != 0;) u += popcount_nonzero_pairs(words, n);
+			sample[k] = elapsed + get_system_time();
+		}
+		assert(popcount_nonzero_pairs(words, n) == pairs);
+		printf(", nonzero pairs %.3f GB/s", reps * n * 8 / (median(sample) * 1000));
+
+		for (int k = SAMPLES; k-- != 0; ) {
+			int64_t elapsed = - get_system_time();
+			for (uint64_t r = reps; r-- != 0;) u += popcount_rank9_counts(words, n, count);
+			sample[k] = elapsed + get_system_time();
+		}
+		assert(memcmp(count, expected, ((n + 7) / 8 * 2 + 1) * sizeof *count) == 0);
+		printf(", rank9 counts %.3f GB/s", reps * n * 8 / (median(sample) * 1000));
+
+		uint64_t bits = 0;
+		for (int i = 0; i < NRANGES; i++) bits += to[i] - from[i];
+		for (int k = SAMPLES; k-- != 0; ) {
+			int64_t elapsed = - get_system_time();
+			for (int i = 0; i < NRANGES; i++) u += popcount_range(words, from[i], to[i]);
+			sample[k] = elapsed + get_system_time();
+		}
+		printf(", ranges %.3f GB/s\n", bits / 8 / (median(sample) * 1000));
+	}
+
+	// Ranges against the naive count
+	for (int i = 0; i < 1000; i++) {
+		uint64_t c = 0;
+		for (uint64_t p = from[i]; p < to[i]; p++) c += words[p / 64] >> p % 64 & 1;
+		assert(popcount_range(words, from[i], to[i]) == c);
+	}
+
+	const volatile int unused = u;
+}
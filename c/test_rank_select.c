@@ -0,0 +1,123 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmarks rank and select on a Select9 dump, one at a time and in batches.
+ *
+ * test_rank_select DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "select9.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / NQUERIES);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	select9 *select9 = load_select9(h);
+	close(h);
+	assert(select9 != NULL);
+	const rank9 * const rank9 = &select9->rank9;
+	assert(rank9->num_ones != 0);
+
+	uint64_t *pos = malloc(NQUERIES * sizeof *pos), *rank = malloc(NQUERIES * sizeof *rank), *result = malloc(NQUERIES * sizeof *result);
+	for (int i = 0; i < NQUERIES; i++) {
+		pos[i] = next() % rank9->length;
+		rank[i] = next() % rank9->num_ones;
+	}
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += rank9_rank(rank9, pos[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("rank", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		rank9_rank_batch(rank9, pos, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("rank (batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) assert(result[i] == rank9_rank(rank9, pos[i]));
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += select9_select(select9, rank[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		select9_select_batch(select9, rank, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select (batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) {
+		assert(result[i] == select9_select(select9, rank[i]));
+		assert(rank9_rank(rank9, result[i]) == rank[i]);
+	}
+
+	const volatile int unused = u;
+}
@@ -0,0 +1,132 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Checks and benchmarks a signed minimal perfect hash function built on a newline-separated
+ * list of strings using TransformationStrategies.rawByteArray(): keys must be mapped to distinct
+ * values, and keys not in the set (the keys followed by a byte not appearing in text) must be
+ * rejected about as often as the signature width predicts, both for single and for batched
+ * lookups. Positive and negative lookups are measured separately.
+ *
+ * test_signed_mph DUMP KEYS
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "signed_mph.h"
+
+#define SAMPLES 11
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static void bench(const signed_mph *signed_mph, char **key, int *key_len, int64_t *result, const uint64_t n, const char *name) {
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0; i < n; i++) u += signed_mph_get_byte_array(signed_mph, key[i], key_len[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/key\n", name, sample[SAMPLES / 2] * 1000. / n);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		signed_mph_get_byte_array_batch(signed_mph, key, key_len, result, n);
+		sample[k] = elapsed + get_system_time();
+		u += result[0];
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s (batch): median %.3f ns/key\n", name, sample[SAMPLES / 2] * 1000. / n);
+
+	const volatile int unused = u;
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 3);
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	signed_mph *signed_mph = load_signed_mph_validated(h);
+	close(h);
+	assert(signed_mph != NULL);
+	const uint64_t n = signed_mph->size;
+	printf("%" PRIu64 " keys, %d-bit signatures\n", n, signed_mph->signature_width);
+	if (n == 0) return 0;
+
+	h = open(argv[2], O_RDONLY);
+	assert(h >= 0);
+	const off_t len = lseek(h, 0, SEEK_END);
+	lseek(h, 0, SEEK_SET);
+	char *data = malloc(len + 1);
+	read(h, data, len);
+	close(h);
+	data[len] = 0xA;
+
+	char **key = malloc(n * sizeof *key), **alien = malloc(n * sizeof *alien);
+	int *key_len = malloc(n * sizeof *key_len), *alien_len = malloc(n * sizeof *alien_len);
+	char *p = data, * const end = data + len;
+	for (uint64_t i = 0; i < n; i++) {
+		assert(p < end);
+		key[i] = p;
+		while(*p != 0xA) p++;
+		key_len[i] = p++ - key[i];
+		alien[i] = malloc(key_len[i] + 1);
+		memcpy(alien[i], key[i], key_len[i]);
+		alien[i][key_len[i]] = 1;
+		alien_len[i] = key_len[i] + 1;
+	}
+
+	int64_t *result = malloc(n * sizeof *result);
+	char *seen = calloc(n, 1);
+	signed_mph_get_byte_array_batch(signed_mph, key, key_len, result, n);
+	for (uint64_t i = 0; i < n; i++) {
+		const int64_t v = signed_mph_get_byte_array(signed_mph, key[i], key_len[i]);
+		assert(v >= 0 && v < (int64_t)n && !seen[v] && result[i] == v);
+		seen[v] = 1;
+	}
+
+	uint64_t false_positives = 0;
+	signed_mph_get_byte_array_batch(signed_mph, alien, alien_len, result, n);
+	for (uint64_t i = 0; i < n; i++) {
+		const int64_t v = signed_mph_get_byte_array(signed_mph, alien[i], alien_len[i]);
+		assert(result[i] == v && v < (int64_t)n);
+		if (v != -1) false_positives++;
+	}
+	const double expected = n / (double)(UINT64_C(1) << (signed_mph->signature_width < 63 ? signed_mph->signature_width : 63));
+	printf("false positives: %" PRIu64 " (expected %.3f)\n", false_positives, expected);
+	assert(false_positives <= 2 * expected + 10);
+
+	bench(signed_mph, key, key_len, result, n, "positive");
+	bench(signed_mph, alien, alien_len, result, n, "negative");
+}
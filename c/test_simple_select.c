@@ -0,0 +1,153 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Benchmarks select on a SimpleSelect or SimpleSelectZero dump: random ranks,
+ * sorted ranks (dense and sparse), and consecutive ranks (as Elias-Fano lists do).
+ *
+ * test_simple_select DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "simple_select.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+#define SPARSE 64
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / NQUERIES);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	simple_select *simple_select = load_simple_select_validated(h);
+	close(h);
+	assert(simple_select != NULL);
+	assert(simple_select->num_ones != 0);
+
+	uint64_t *rank = malloc(NQUERIES * sizeof *rank), *sorted = malloc(NQUERIES * sizeof *sorted), *result = malloc(NQUERIES * sizeof *result), *sparse = malloc(NQUERIES / SPARSE * sizeof *sparse);
+	for (int i = 0; i < NQUERIES; i++) sorted[i] = rank[i] = next() % simple_select->num_ones;
+	qsort(sorted, NQUERIES, sizeof *sorted, cmp_uint64_t);
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += simple_select_select(simple_select, rank[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		simple_select_select_batch(simple_select, rank, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select (batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) assert(result[i] == simple_select_select(simple_select, rank[i]));
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += simple_select_select(simple_select, sorted[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select (sorted)", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		simple_select_select_sorted(simple_select, sorted, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select (sorted, batch)", sample);
+	for (int i = 0; i < NQUERIES; i++) assert(result[i] == simple_select_select(simple_select, sorted[i]));
+
+	// One sorted rank out of SPARSE
+	for (int i = 0; i < NQUERIES / SPARSE; i++) sparse[i] = sorted[i * SPARSE];
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES / SPARSE; i++) u += simple_select_select(simple_select, sparse[i]);
+		sample[k] = (elapsed + get_system_time()) * SPARSE;
+	}
+	report("select (sparse sorted)", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		simple_select_select_sorted(simple_select, sparse, result, NQUERIES / SPARSE);
+		sample[k] = (elapsed + get_system_time()) * SPARSE;
+	}
+	report("select (sparse sorted, batch)", sample);
+	for (int i = 0; i < NQUERIES / SPARSE; i++) assert(result[i] == simple_select_select(simple_select, sparse[i]));
+
+	// Consecutive ranks, in runs of 64 starting from random ranks
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i += 64) {
+			const uint64_t r = rank[i] < simple_select->num_ones - 64 ? rank[i] : 0;
+			simple_select_select_bulk(simple_select, r, result + i, NQUERIES - i < 64 ? NQUERIES - i : 64);
+		}
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select (bulk)", sample);
+	if (simple_select->num_ones > 64)
+		for (int i = 0; i < NQUERIES; i++) {
+			const uint64_t r = rank[i / 64 * 64] < simple_select->num_ones - 64 ? rank[i / 64 * 64] : 0;
+			assert(result[i] == simple_select_select(simple_select, r + i % 64));
+		}
+
+	const volatile int unused = u;
+}
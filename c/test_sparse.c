@@ -0,0 +1,127 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+/*
+ * Benchmarks sparse rank and select dumps of the same bit vector: random ranks, one at a time and
+ * on sorted positions, and random selections, one at a time and in batches.
+ *
+ * test_sparse RANK_DUMP SELECT_DUMP
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "sparse_rank.h"
+#include "sparse_select.h"
+
+#define SAMPLES 11
+#define NQUERIES 10000000
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static void report(const char *name, uint64_t *sample) {
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("%s: median %.3f ns/query\n", name, sample[SAMPLES / 2] * 1000. / NQUERIES);
+}
+
+int main(int argc, char* argv[]) {
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	sparse_rank *sparse_rank = load_sparse_rank_validated(h);
+	close(h);
+	assert(sparse_rank != NULL);
+	h = open(argv[2], O_RDONLY);
+	assert(h >= 0);
+	sparse_select *sparse_select = load_sparse_select_validated(h);
+	close(h);
+	assert(sparse_select != NULL);
+	assert(sparse_select->ones.length == sparse_rank->ones.length && sparse_select->ones.length != 0);
+
+	uint64_t *pos = malloc(NQUERIES * sizeof *pos), *rank = malloc(NQUERIES * sizeof *rank), *result = malloc(NQUERIES * sizeof *result);
+	for (int i = 0; i < NQUERIES; i++) pos[i] = next() % (sparse_rank->n + 1);
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += sparse_rank_rank(sparse_rank, pos[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("rank", sample);
+
+	qsort(pos, NQUERIES, sizeof *pos, cmp_uint64_t);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		sparse_rank_rank_sorted(sparse_rank, pos, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("rank (sorted)", sample);
+	for (int i = 0; i < NQUERIES; i++) assert(result[i] == sparse_rank_rank(sparse_rank, pos[i]));
+
+	for (int i = 0; i < NQUERIES; i++) rank[i] = next() % sparse_select->ones.length;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (int i = 0; i < NQUERIES; i++) u += sparse_select_select(sparse_select, rank[i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select", sample);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		sparse_select_select_batch(sparse_select, rank, result, NQUERIES);
+		sample[k] = elapsed + get_system_time();
+	}
+	report("select (batch)", sample);
+	// The positions of the ones are distinct, so rank inverts select
+	for (int i = 0; i < NQUERIES; i++) assert(sparse_rank_rank(sparse_rank, result[i]) == rank[i] && result[i] == sparse_select_select(sparse_select, rank[i]));
+
+	const volatile int unused = u;
+}
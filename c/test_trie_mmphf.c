@@ -0,0 +1,161 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Checks and benchmarks a trie-based monotone minimal perfect hash function (a hollow trie, a
+ * two-step LCP function, or a function based on a hollow-trie or z-fast-trie distributor), whose
+ * kind is read from the container header, built on a newline-separated, sorted list of strings
+ * using TransformationStrategies.prefixFreeByteArray(): every key must be mapped to its rank
+ * (functions based on a hollow-trie distributor with a single key return -1). Lookups are
+ * measured on the keys in random order.
+ *
+ * test_trie_mmphf DUMP KEYS
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "hollow_trie.h"
+#include "hollow_trie_distributor.h"
+#include "two_steps_lcp_mmphf.h"
+#include "zfast_trie_distributor.h"
+
+#define SAMPLES 11
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static int kind;
+static const void *mmphf;
+
+static int64_t get(const char *key, const uint64_t len) {
+	switch(kind) {
+	case DUMP_HOLLOW_TRIE:
+		return hollow_trie_get_byte_array(mmphf, key, len);
+	case DUMP_HOLLOW_TRIE_DISTRIBUTOR_MMPHF:
+		return hollow_trie_distributor_mmphf_get_byte_array(mmphf, key, len);
+	case DUMP_TWO_STEPS_LCP_MMPHF:
+		return two_steps_lcp_mmphf_get_byte_array(mmphf, key, len);
+	default:
+		return zfast_trie_distributor_mmphf_get_byte_array(mmphf, key, len);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 3);
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	dump_header header;
+	assert(dump_read_header(h, &header) == 1);
+	lseek(h, 0, SEEK_SET);
+	kind = header.kind;
+	uint64_t n = 0;
+	switch(kind) {
+	case DUMP_HOLLOW_TRIE:
+		mmphf = load_hollow_trie_validated(h);
+		if (mmphf != NULL) n = ((const hollow_trie *)mmphf)->size;
+		break;
+	case DUMP_HOLLOW_TRIE_DISTRIBUTOR_MMPHF:
+		mmphf = load_hollow_trie_distributor_mmphf_validated(h);
+		if (mmphf != NULL) n = ((const hollow_trie_distributor_mmphf *)mmphf)->size;
+		break;
+	case DUMP_TWO_STEPS_LCP_MMPHF:
+		mmphf = load_two_steps_lcp_mmphf_validated(h);
+		if (mmphf != NULL) n = ((const two_steps_lcp_mmphf *)mmphf)->size;
+		break;
+	case DUMP_ZFAST_TRIE_DISTRIBUTOR_MMPHF:
+		mmphf = load_zfast_trie_distributor_mmphf_validated(h);
+		if (mmphf != NULL) n = ((const zfast_trie_distributor_mmphf *)mmphf)->size;
+		break;
+	}
+	close(h);
+	assert(mmphf != NULL);
+	printf("%s: %" PRIu64 " keys\n", dump_kind_name(&header), n);
+
+	h = open(argv[2], O_RDONLY);
+	assert(h >= 0);
+	const off_t len = lseek(h, 0, SEEK_END);
+	lseek(h, 0, SEEK_SET);
+	char *data = malloc(len + 1);
+	read(h, data, len);
+	close(h);
+	data[len] = 0xA;
+
+	char **key = malloc(n * sizeof *key);
+	int *key_len = malloc(n * sizeof *key_len);
+	uint64_t *rank = malloc(n * sizeof *rank);
+	char *p = data, * const end = data + len;
+	for (uint64_t i = 0; i < n; i++) {
+		assert(p < end);
+		key[i] = p;
+		while(*p != 0xA) p++;
+		key_len[i] = p++ - key[i];
+		rank[i] = i;
+	}
+
+	for (uint64_t i = n; i-- > 1; ) {
+		const uint64_t j = next() % (i + 1), t = rank[i];
+		rank[i] = rank[j];
+		rank[j] = t;
+	}
+	const int single = n == 1 && kind == DUMP_HOLLOW_TRIE_DISTRIBUTOR_MMPHF;
+	for (uint64_t i = 0; i < n; i++) assert(get(key[rank[i]], key_len[rank[i]]) == (single ? -1 : (int64_t)rank[i]));
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0; i < n; i++) u += get(key[rank[i]], key_len[rank[i]]);
+		sample[k] = elapsed + get_system_time();
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("get: median %.3f ns/key\n", sample[SAMPLES / 2] * 1000. / n);
+
+	const volatile int unused = u;
+}
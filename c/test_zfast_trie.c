@@ -0,0 +1,209 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Checks and benchmarks a frozen z-fast trie built on a newline-separated, sorted list of strings
+ * using TransformationStrategies.prefixFreeByteArray(): successors, predecessors and prefix ranges
+ * of the keys, of strings obtained by modifying the keys, and of their prefixes must match those
+ * computed by binary search on the list, both for single and for batched queries. Queries are
+ * measured on the keys in random order.
+ *
+ * test_zfast_trie DUMP KEYS
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "zfast_trie.h"
+
+#define SAMPLES 11
+
+static uint64_t get_system_time(void) {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static int cmp_uint64_t(const void *a, const void *b) {
+	return *(uint64_t *)a < *(uint64_t *)b ? -1 : *(uint64_t *)a > *(uint64_t *)b ? 1 : 0;
+}
+
+static inline uint64_t rotl(const uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t s[2] = { 0x5603141978c51071, 0x3bbddc01ebdf4b72 };
+
+uint64_t next(void) {
+	const uint64_t s0 = s[0];
+	uint64_t s1 = s[1];
+	const uint64_t result = s0 + s1;
+
+	s1 ^= s0;
+	s[0] = rotl(s0, 24) ^ s1 ^ (s1 << 16); // a, b
+	s[1] = rotl(s1, 37); // c
+
+	return result;
+}
+
+static char **key;
+static int *key_len;
+static uint64_t n;
+
+static int compare(const char *a, const int a_len, const char *b, const int b_len) {
+	const int t = memcmp(a, b, a_len < b_len ? a_len : b_len);
+	return t != 0 ? t : a_len - b_len;
+}
+
+/* Returns the rank of the first key greater than (or equal to, if weak is true) a string. */
+static int64_t search(const char *q, const int q_len, const int weak) {
+	uint64_t l = 0, r = n;
+	while (l < r) {
+		const uint64_t m = (l + r) / 2;
+		const int t = compare(key[m], key_len[m], q, q_len);
+		if (t < 0 || t == 0 && !weak) l = m + 1;
+		else r = m;
+	}
+	return l;
+}
+
+/* Returns the end of the range of keys starting with a prefix, given its start. */
+static int64_t prefix_end(const char *q, const int q_len, uint64_t l) {
+	uint64_t r = n;
+	while (l < r) {
+		const uint64_t m = (l + r) / 2;
+		if (key_len[m] >= q_len && memcmp(key[m], q, q_len) == 0) l = m + 1;
+		else r = m;
+	}
+	return l;
+}
+
+int main(int argc, char* argv[]) {
+	assert(argc == 3);
+	int h = open(argv[1], O_RDONLY);
+	assert(h >= 0);
+	zfast_trie *zfast_trie = load_zfast_trie_validated(h);
+	close(h);
+	assert(zfast_trie != NULL);
+	n = zfast_trie->size;
+	printf("%" PRIu64 " keys, %" PRIu64 " internal nodes\n", n, zfast_trie->num_nodes);
+
+	h = open(argv[2], O_RDONLY);
+	assert(h >= 0);
+	const off_t len = lseek(h, 0, SEEK_END);
+	lseek(h, 0, SEEK_SET);
+	char *data = malloc(len + 1);
+	read(h, data, len);
+	close(h);
+	data[len] = 0xA;
+
+	key = malloc(n * sizeof *key);
+	key_len = malloc(n * sizeof *key_len);
+	uint64_t *rank = malloc(n * sizeof *rank);
+	char *p = data, * const end = data + len;
+	for (uint64_t i = 0; i < n; i++) {
+		assert(p < end);
+		key[i] = p;
+		while(*p != 0xA) p++;
+		key_len[i] = p++ - key[i];
+		rank[i] = i;
+	}
+
+	for (uint64_t i = n; i-- > 1; ) {
+		const uint64_t j = next() % (i + 1), t = rank[i];
+		rank[i] = rank[j];
+		rank[j] = t;
+	}
+
+	// Queries: the keys, the keys with a modified last byte, half keys, and keys with an additional byte
+	const uint64_t m = 4 * n + 1;
+	char **query = malloc(m * sizeof *query);
+	int *query_len = malloc(m * sizeof *query_len);
+	for (uint64_t i = 0; i < n; i++) {
+		const int l = key_len[rank[i]];
+		for (int k = 0; k < 4; k++) query[4 * i + k] = malloc(l + 1);
+		memcpy(query[4 * i], key[rank[i]], query_len[4 * i] = l);
+		memcpy(query[4 * i + 1], key[rank[i]], query_len[4 * i + 1] = l);
+		query[4 * i + 1][l - 1] += next() % 2 ? 1 : -1;
+		memcpy(query[4 * i + 2], key[rank[i]], query_len[4 * i + 2] = l / 2);
+		memcpy(query[4 * i + 3], key[rank[i]], l);
+		query[4 * i + 3][l] = 1 + next() % 255;
+		query_len[4 * i + 3] = l + 1;
+	}
+	query[4 * n] = "";
+	query_len[4 * n] = 0;
+
+	int64_t *successor = malloc(m * sizeof *successor), *strict_successor = malloc(m * sizeof *strict_successor);
+	uint64_t *start = malloc(m * sizeof *start), *end_ = malloc(m * sizeof *end_);
+	zfast_trie_successor_byte_array_batch(zfast_trie, query, query_len, successor, m);
+	zfast_trie_strict_successor_byte_array_batch(zfast_trie, query, query_len, strict_successor, m);
+	zfast_trie_prefix_range_byte_array_batch(zfast_trie, query, query_len, start, end_, m);
+
+	for (uint64_t i = 0; i < m; i++) {
+		const int64_t succ = search(query[i], query_len[i], 1), strict_succ = search(query[i], query_len[i], 0);
+		if (i < 4 * n && i % 4 == 0) assert(succ == (int64_t)rank[i / 4] && strict_succ == succ + 1);
+		assert(zfast_trie_successor_byte_array(zfast_trie, query[i], query_len[i]) == succ);
+		assert(zfast_trie_strict_successor_byte_array(zfast_trie, query[i], query_len[i]) == strict_succ);
+		assert(zfast_trie_predecessor_byte_array(zfast_trie, query[i], query_len[i]) == succ - 1);
+		assert(zfast_trie_weak_predecessor_byte_array(zfast_trie, query[i], query_len[i]) == strict_succ - 1);
+		assert(successor[i] == succ && strict_successor[i] == strict_succ);
+
+		uint64_t s, e;
+		zfast_trie_prefix_range_byte_array(zfast_trie, query[i], query_len[i], &s, &e);
+		assert(s == (uint64_t)succ && e == (uint64_t)prefix_end(query[i], query_len[i], succ));
+		assert(start[i] == s && end_[i] == e);
+	}
+	if (n == 0) return 0;
+
+	uint64_t sample[SAMPLES], u = 0;
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		for (uint64_t i = 0; i < n; i++) u += zfast_trie_successor_byte_array(zfast_trie, query[4 * i], query_len[4 * i]);
+		sample[k] = elapsed + get_system_time();
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("successor: median %.3f ns/key\n", sample[SAMPLES / 2] * 1000. / n);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		zfast_trie_successor_byte_array_batch(zfast_trie, query, query_len, successor, n);
+		sample[k] = elapsed + get_system_time();
+		u += successor[0];
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("successor (batch): median %.3f ns/key\n", sample[SAMPLES / 2] * 1000. / n);
+
+	for (int k = SAMPLES; k-- != 0; ) {
+		int64_t elapsed = - get_system_time();
+		zfast_trie_prefix_range_byte_array_batch(zfast_trie, query, query_len, start, end_, n);
+		sample[k] = elapsed + get_system_time();
+		u += start[0];
+	}
+	qsort(sample, SAMPLES, sizeof *sample, cmp_uint64_t);
+	printf("prefix range (batch): median %.3f ns/key\n", sample[SAMPLES / 2] * 1000. / n);
+
+	const volatile int unused = u;
+}
@@ -0,0 +1,123 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "two_sizes.h"
+
+// Indices whose memory accesses are issued together by the batched method
+#define BATCH 16
+
+/* Returns the element of given index of an array of elements of width bits; the next word
+   is read only if the element crosses a word boundary. */
+static inline uint64_t get_element(const uint64_t * const array, const int width, const uint64_t index) {
+	if (width == 0) return 0;
+	const uint64_t position = index * width;
+	const uint64_t start_word = position / 64;
+	const int start_bit = position % 64;
+	uint64_t result = array[start_word] >> start_bit;
+	if (start_bit + width > 64) result |= array[start_word + 1] << 64 - start_bit;
+	return result & UINT64_MAX >> 64 - width;
+}
+
+int map_two_sizes(const void *dump, const uint64_t length, two_sizes *two_sizes) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL) return -1;
+	if (header->kind != DUMP_TWO_SIZES || header->param[1] > 64 || header->param[2] > 64) return -1;
+	// The marker is present if and only if there are large elements
+	if (header->num_sections != (header->param[2] != 0 ? 4 : 2)) return -1;
+	const char * const base = dump;
+	memset(two_sizes, 0, sizeof *two_sizes);
+	two_sizes->length = header->param[0];
+	two_sizes->small_width = header->param[1];
+	two_sizes->large_width = header->param[2];
+	two_sizes->small_length = header->section[0].length / sizeof *two_sizes->small;
+	two_sizes->small = (const uint64_t *)(base + header->section[0].offset);
+	two_sizes->large_length = header->section[1].length / sizeof *two_sizes->large;
+	two_sizes->large = (const uint64_t *)(base + header->section[1].offset);
+	return two_sizes->large_width != 0 ? map_rank9_at(dump, 3, 2, &two_sizes->marker) : 0;
+}
+
+int two_sizes_validate(const two_sizes *two_sizes) {
+	const uint64_t length = two_sizes->length;
+	if (length >= UINT64_MAX / 64) return -1;
+	uint64_t num_large = 0;
+	if (two_sizes->large_width != 0) {
+		if (rank9_validate(&two_sizes->marker) != 0 || two_sizes->marker.length != length) return -1;
+		num_large = two_sizes->marker.num_ones;
+	}
+	if (two_sizes->small_length < ((length - num_large) * two_sizes->small_width + 63) / 64) return -1;
+	if (two_sizes->large_length < (num_large * two_sizes->large_width + 63) / 64) return -1;
+	return 0;
+}
+
+two_sizes *load_two_sizes(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	two_sizes *two_sizes = malloc(sizeof *two_sizes);
+	if (two_sizes == NULL || map_two_sizes(map, length, two_sizes) != 0 || two_sizes_validate(two_sizes) != 0) {
+		free(two_sizes);
+		munmap(map, length);
+		return NULL;
+	}
+	two_sizes->map = map;
+	two_sizes->map_length = length;
+	return two_sizes;
+}
+
+uint64_t two_sizes_get(const two_sizes *two_sizes, const uint64_t index) {
+	if (two_sizes->large_width == 0) return get_element(two_sizes->small, two_sizes->small_width, index);
+	const uint64_t rank = rank9_rank(&two_sizes->marker, index);
+	if (two_sizes->marker.bits[index / 64] & UINT64_C(1) << index % 64) return get_element(two_sizes->large, two_sizes->large_width, rank);
+	return get_element(two_sizes->small, two_sizes->small_width, index - rank);
+}
+
+void two_sizes_get_batch(const two_sizes *two_sizes, const uint64_t *index, uint64_t *dest, const uint64_t n) {
+	const uint64_t * const small = two_sizes->small, * const large = two_sizes->large;
+	const int small_width = two_sizes->small_width, large_width = two_sizes->large_width;
+
+	if (large_width == 0) {
+		for (uint64_t i = 0; i < n; i += BATCH) {
+			const int b = n - i < BATCH ? n - i : BATCH;
+			if (small_width != 0) for (int j = 0; j < b; j++) __builtin_prefetch(&small[index[i + j] * small_width / 64]);
+			for (int j = 0; j < b; j++) dest[i + j] = get_element(small, small_width, index[i + j]);
+		}
+		return;
+	}
+
+	const uint64_t * const marker = two_sizes->marker.bits;
+	uint64_t rank[BATCH];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		// The ranks prefetch the counts and the words of the marker
+		rank9_rank_batch(&two_sizes->marker, index + i, rank, b);
+		for (int j = 0; j < b; j++) {
+			const uint64_t k = index[i + j];
+			if (marker[k / 64] & UINT64_C(1) << k % 64) __builtin_prefetch(&large[rank[j] * large_width / 64]);
+			else if (small_width != 0) __builtin_prefetch(&small[(k - rank[j]) * small_width / 64]);
+		}
+		for (int j = 0; j < b; j++) {
+			const uint64_t k = index[i + j];
+			dest[i + j] = marker[k / 64] & UINT64_C(1) << k % 64 ? get_element(large, large_width, rank[j]) : get_element(small, small_width, k - rank[j]);
+		}
+	}
+}
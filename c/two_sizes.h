@@ -0,0 +1,55 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TWO_SIZES_H_INCLUDED
+#define TWO_SIZES_H_INCLUDED
+
+#include <inttypes.h>
+#include "rank9.h"
+
+/* A view of a two-sizes list dump (see TwoSizesLongBigList.dump() in Java). Small and large elements
+   are stored in two packed arrays; if there are large elements, a Rank9 on a marker recording
+   which elements are large maps an index to a position in the appropriate array. */
+typedef struct {
+	uint64_t length;
+	int small_width;
+	int large_width; // Zero if there are no large elements (and thus no marker)
+	uint64_t small_length;
+	const uint64_t *small;
+	uint64_t large_length;
+	const uint64_t *large;
+	rank9 marker; // Not mapped if there are no large elements
+	void *map; // The mapping, if loaded by load_two_sizes()
+	uint64_t map_length;
+} two_sizes;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a valid two-sizes list dump. */
+two_sizes *load_two_sizes(int h);
+/* Fills a view of a dump mapped in memory; returns zero on success. */
+int map_two_sizes(const void *dump, uint64_t length, two_sizes *two_sizes);
+/* Checks the marker and the size of the arrays; returns zero if valid. */
+int two_sizes_validate(const two_sizes *two_sizes);
+/* Returns the element of given index, which must be smaller than the length. */
+uint64_t two_sizes_get(const two_sizes *two_sizes, uint64_t index);
+/* Stores in dest the elements of the n given indices; for each group of indices, the memory of
+   the marker is prefetched, and then that of the small or large elements. */
+void two_sizes_get_batch(const two_sizes *two_sizes, const uint64_t *index, uint64_t *dest, uint64_t n);
+
+#endif /* TWO_SIZES_H_INCLUDED */
@@ -0,0 +1,133 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "lcp_mmphf.h"
+#include "two_steps_lcp_mmphf.h"
+
+#define BUFFER_WORDS 32 // Byte arrays shorter than this many words are converted on the stack
+
+static inline int64_t get_signature(const sf *sf, const uint64_t signature[4]) {
+	return sf->width == 0 ? 0 : sf3_get_signature(sf, signature);
+}
+
+static inline uint64_t get_bits(const uint64_t * const bits, const uint64_t pos, const int width) {
+	const uint64_t word = pos / 64;
+	const int bit = pos % 64;
+	uint64_t result = bits[word] >> bit;
+	if (bit + width > 64) result |= bits[word + 1] << 64 - bit;
+	return width == 64 ? result : result & (UINT64_C(1) << width) - 1;
+}
+
+int map_two_steps_lcp_mmphf(const void *dump, const uint64_t length, two_steps_lcp_mmphf *two_steps_lcp_mmphf) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_TWO_STEPS_LCP_MMPHF) return -1;
+	memset(two_steps_lcp_mmphf, 0, sizeof *two_steps_lcp_mmphf);
+	two_steps_lcp_mmphf->size = header->param[0];
+	if (two_steps_lcp_mmphf->size == 0) return header->num_sections == 0 ? 0 : -1;
+	if (header->num_sections != 6 || header->param[1] > 32 || header->param[3] > 64 || header->param[4] > 64) return -1;
+	two_steps_lcp_mmphf->log2_bucket_size = header->param[1];
+	two_steps_lcp_mmphf->global_seed = header->param[2];
+	two_steps_lcp_mmphf->signature_width = header->param[3];
+	two_steps_lcp_mmphf->signature_mask = two_steps_lcp_mmphf->signature_width == 0 ? 0 : UINT64_MAX >> 64 - two_steps_lcp_mmphf->signature_width;
+	if (map_sf_at(dump, two_steps_lcp_mmphf->log2_bucket_size, 5, 0, &two_steps_lcp_mmphf->offsets) != 0 || map_sf_at(dump, header->param[4], 8, 2, &two_steps_lcp_mmphf->lcp_to_bucket) != 0) return -1;
+	// The two-step function is a complete container, aligned as any section
+	if (map_two_steps_sf3((const char *)dump + header->section[4].offset, header->section[4].length, &two_steps_lcp_mmphf->lcp_lengths) != 0) return -1;
+	two_steps_lcp_mmphf->signatures_length = header->section[5].length / sizeof *two_steps_lcp_mmphf->signatures;
+	two_steps_lcp_mmphf->signatures = (const uint64_t *)((const char *)dump + header->section[5].offset);
+	return 0;
+}
+
+two_steps_lcp_mmphf *load_two_steps_lcp_mmphf(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	two_steps_lcp_mmphf *two_steps_lcp_mmphf = malloc(sizeof *two_steps_lcp_mmphf);
+	if (two_steps_lcp_mmphf == NULL || map_two_steps_lcp_mmphf(map, length, two_steps_lcp_mmphf) != 0) {
+		free(two_steps_lcp_mmphf);
+		munmap(map, length);
+		return NULL;
+	}
+	two_steps_lcp_mmphf->map = map;
+	two_steps_lcp_mmphf->map_length = length;
+	return two_steps_lcp_mmphf;
+}
+
+int two_steps_lcp_mmphf_validate(const two_steps_lcp_mmphf *two_steps_lcp_mmphf) {
+	if (two_steps_lcp_mmphf->size == 0) return 0;
+	// Functions of width zero are never probed
+	const sf * const offsets = &two_steps_lcp_mmphf->offsets, * const lcp_to_bucket = &two_steps_lcp_mmphf->lcp_to_bucket;
+	if (offsets->width != 0 && (sf_validate(offsets) != 0 || offsets->global_seed != two_steps_lcp_mmphf->global_seed)) return -1;
+	if (lcp_to_bucket->width != 0 && sf_validate(lcp_to_bucket) != 0) return -1;
+	if (two_steps_sf3_validate(&two_steps_lcp_mmphf->lcp_lengths) != 0) return -1;
+	if (two_steps_lcp_mmphf->signature_width != 0 && (two_steps_lcp_mmphf->size >= UINT64_MAX / 64 || two_steps_lcp_mmphf->signatures_length * 64 < two_steps_lcp_mmphf->size * two_steps_lcp_mmphf->signature_width)) return -1;
+	return 0;
+}
+
+static int validate(const void *two_steps_lcp_mmphf) {
+	return two_steps_lcp_mmphf_validate(two_steps_lcp_mmphf);
+}
+
+two_steps_lcp_mmphf *load_two_steps_lcp_mmphf_validated(int h) {
+	two_steps_lcp_mmphf *two_steps_lcp_mmphf = load_two_steps_lcp_mmphf(h);
+	if (two_steps_lcp_mmphf == NULL) return NULL;
+	if (two_steps_lcp_mmphf_validate(two_steps_lcp_mmphf) == 0) return two_steps_lcp_mmphf;
+	munmap(two_steps_lcp_mmphf->map, two_steps_lcp_mmphf->map_length);
+	free(two_steps_lcp_mmphf);
+	return NULL;
+}
+
+two_steps_lcp_mmphf *load_two_steps_lcp_mmphf_verify(int h, dump_verifier *verifier) {
+	two_steps_lcp_mmphf *two_steps_lcp_mmphf = load_two_steps_lcp_mmphf(h);
+	if (two_steps_lcp_mmphf == NULL) return NULL;
+	const dump_header * const header = two_steps_lcp_mmphf->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)two_steps_lcp_mmphf->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, two_steps_lcp_mmphf) == 0) return two_steps_lcp_mmphf;
+	munmap(two_steps_lcp_mmphf->map, two_steps_lcp_mmphf->map_length);
+	free(two_steps_lcp_mmphf);
+	return NULL;
+}
+
+int64_t two_steps_lcp_mmphf_get_bits(const two_steps_lcp_mmphf *two_steps_lcp_mmphf, const uint64_t *bits, const uint64_t length) {
+	if (two_steps_lcp_mmphf->size == 0) return -1;
+	uint64_t signature[4], prefix_signature[4];
+	spooky_short_bits(bits, length, two_steps_lcp_mmphf->global_seed, signature);
+	// -1 becomes larger than any length
+	const uint64_t prefix = two_steps_sf3_get_signature(&two_steps_lcp_mmphf->lcp_lengths, signature);
+	if (prefix > length) return -1;
+	spooky_short_bits(bits, prefix, two_steps_lcp_mmphf->lcp_to_bucket.global_seed, prefix_signature);
+	const uint64_t result = (get_signature(&two_steps_lcp_mmphf->lcp_to_bucket, prefix_signature) << two_steps_lcp_mmphf->log2_bucket_size) + get_signature(&two_steps_lcp_mmphf->offsets, signature);
+	// Out-of-set keys can generate bizarre 3-hyperedges
+	if (result >= two_steps_lcp_mmphf->size) return -1;
+	if (two_steps_lcp_mmphf->signature_mask != 0 && ((get_bits(two_steps_lcp_mmphf->signatures, result * two_steps_lcp_mmphf->signature_width, two_steps_lcp_mmphf->signature_width) ^ signature[0]) & two_steps_lcp_mmphf->signature_mask) != 0) return -1;
+	return result;
+}
+
+int64_t two_steps_lcp_mmphf_get_byte_array(const two_steps_lcp_mmphf *two_steps_lcp_mmphf, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = two_steps_lcp_mmphf_get_bits(two_steps_lcp_mmphf, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
@@ -0,0 +1,70 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TWO_STEPS_LCP_MMPHF_H_INCLUDED
+#define TWO_STEPS_LCP_MMPHF_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "two_steps_sf3.h"
+
+/* A view of a two-step LCP-based monotone minimal perfect hash function dump (see
+   TwoStepsLcpMonotoneMinimalPerfectHashFunction.dump() in Java). Keys are bit vectors stored as
+   in a LongArrayBitVector; a two-step function (see two_steps_sf3.h), embedded in the dump,
+   maps a key to the length of the longest common prefix of its bucket, a function maps the prefix
+   of the key of that length to the bucket, and a third function maps the key to its offset in the
+   bucket. The lookup code uses the generic code of sf3.c, so it must not be compiled with SF_8. */
+typedef struct {
+	uint64_t size;
+	int log2_bucket_size;
+	uint64_t global_seed;
+	int signature_width;
+	uint64_t signature_mask;
+	sf offsets; // A function of width zero always returns zero
+	sf lcp_to_bucket; // Ditto
+	two_steps_sf3 lcp_lengths;
+	uint64_t signatures_length;
+	const uint64_t *signatures;
+	void *map; // The mapping, if loaded by load_two_steps_lcp_mmphf()
+	uint64_t map_length;
+} two_steps_lcp_mmphf;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a two-step LCP monotone minimal
+   perfect hash function dump. */
+two_steps_lcp_mmphf *load_two_steps_lcp_mmphf(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_two_steps_lcp_mmphf(const void *dump, uint64_t length, two_steps_lcp_mmphf *two_steps_lcp_mmphf);
+/* Maps a function and validates it (see two_steps_lcp_mmphf_validate()); returns NULL if the dump is not valid. */
+two_steps_lcp_mmphf *load_two_steps_lcp_mmphf_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h); the embedded two-step
+   function is verified as a whole section. */
+two_steps_lcp_mmphf *load_two_steps_lcp_mmphf_verify(int h, dump_verifier *verifier);
+/* Checks the three functions (see sf_validate() and two_steps_sf3_validate()), that the seeds agree
+   and that the signatures cover all keys; returns zero if valid. */
+int two_steps_lcp_mmphf_validate(const two_steps_lcp_mmphf *two_steps_lcp_mmphf);
+/* Returns the rank of a key of given length in bits, or -1 if the key can be recognized as not
+   belonging to the key set. */
+int64_t two_steps_lcp_mmphf_get_bits(const two_steps_lcp_mmphf *two_steps_lcp_mmphf, const uint64_t *bits, uint64_t length);
+/* As two_steps_lcp_mmphf_get_bits(), for a function built using
+   TransformationStrategies.prefixFreeByteArray() (see lcp_mmphf_byte_array_to_bits()). */
+int64_t two_steps_lcp_mmphf_get_byte_array(const two_steps_lcp_mmphf *two_steps_lcp_mmphf, const char *key, uint64_t len);
+
+#endif /* TWO_STEPS_LCP_MMPHF_H_INCLUDED */
@@ -0,0 +1,195 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "two_steps_sf3.h"
+
+#define OFFSET_MASK (UINT64_C(-1) >> 8)
+#define BATCH 16
+
+int map_two_steps_sf3(const void *dump, const uint64_t length, two_steps_sf3 *two_steps_sf3) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_TWO_STEPS_SF || header->arity != 3) return -1;
+	const uint64_t first_width = header->param[1];
+	memset(two_steps_sf3, 0, sizeof *two_steps_sf3);
+	two_steps_sf3->size = header->param[0];
+	if (two_steps_sf3->size == 0) return header->num_sections == 0 ? 0 : -1;
+	if (first_width == 0) {
+		if (header->num_sections != 2) return -1;
+		if (map_sf_at(dump, header->width, 2, 0, &two_steps_sf3->second) != 0) return -1;
+	}
+	else {
+		// The escape value must fit the remap table of the Java class
+		if (header->num_sections != 5 || first_width > 31) return -1;
+		if (map_sf_at(dump, first_width, 2, 0, &two_steps_sf3->first) != 0 || map_sf_at(dump, header->width, 5, 3, &two_steps_sf3->second) != 0) return -1;
+		two_steps_sf3->escape = (UINT64_C(1) << first_width) - 1;
+		two_steps_sf3->remap_length = header->section[2].length / sizeof *two_steps_sf3->remap;
+		two_steps_sf3->remap = (const uint64_t *)((const char *)dump + header->section[2].offset);
+	}
+	two_steps_sf3->global_seed = two_steps_sf3->second.global_seed;
+	return 0;
+}
+
+two_steps_sf3 *load_two_steps_sf3(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	two_steps_sf3 *two_steps_sf3 = malloc(sizeof *two_steps_sf3);
+	if (two_steps_sf3 == NULL || map_two_steps_sf3(map, length, two_steps_sf3) != 0) {
+		free(two_steps_sf3);
+		munmap(map, length);
+		return NULL;
+	}
+	two_steps_sf3->map = map;
+	two_steps_sf3->map_length = length;
+	return two_steps_sf3;
+}
+
+int two_steps_sf3_validate(const two_steps_sf3 *two_steps_sf3) {
+	if (two_steps_sf3->size == 0) return 0;
+	// An empty second function is never queried
+	if (two_steps_sf3->second.size != 0 && sf_validate(&two_steps_sf3->second) != 0) return -1;
+	if (two_steps_sf3->first.width == 0) return 0;
+	if (sf_validate(&two_steps_sf3->first) != 0 || two_steps_sf3->first.global_seed != two_steps_sf3->second.global_seed) return -1;
+	return two_steps_sf3->remap_length < two_steps_sf3->escape ? -1 : 0;
+}
+
+static int validate(const void *two_steps_sf3) {
+	return two_steps_sf3_validate(two_steps_sf3);
+}
+
+two_steps_sf3 *load_two_steps_sf3_validated(int h) {
+	two_steps_sf3 *two_steps_sf3 = load_two_steps_sf3(h);
+	if (two_steps_sf3 == NULL) return NULL;
+	if (two_steps_sf3_validate(two_steps_sf3) == 0) return two_steps_sf3;
+	munmap(two_steps_sf3->map, two_steps_sf3->map_length);
+	free(two_steps_sf3);
+	return NULL;
+}
+
+two_steps_sf3 *load_two_steps_sf3_verify(int h, dump_verifier *verifier) {
+	two_steps_sf3 *two_steps_sf3 = load_two_steps_sf3(h);
+	if (two_steps_sf3 == NULL) return NULL;
+	const dump_header * const header = two_steps_sf3->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)two_steps_sf3->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, two_steps_sf3) == 0) return two_steps_sf3;
+	munmap(two_steps_sf3->map, two_steps_sf3->map_length);
+	free(two_steps_sf3);
+	return NULL;
+}
+
+int64_t two_steps_sf3_get_signature(const two_steps_sf3 *two_steps_sf3, const uint64_t signature[4]) {
+	if (two_steps_sf3->size == 0) return -1;
+	if (two_steps_sf3->first.width != 0) {
+		const uint64_t value = sf3_get_signature(&two_steps_sf3->first, signature);
+		// The first function is built so that it resolves most keys
+		if (__builtin_expect(value != two_steps_sf3->escape, 1)) return two_steps_sf3->remap[value];
+	}
+	if (two_steps_sf3->second.size == 0) return -1;
+	return sf3_get_signature(&two_steps_sf3->second, signature);
+}
+
+int64_t two_steps_sf3_get_byte_array(const two_steps_sf3 *two_steps_sf3, char *key, const uint64_t len) {
+	uint64_t signature[4];
+	spooky_short(key, len, two_steps_sf3->global_seed, signature);
+	return two_steps_sf3_get_signature(two_steps_sf3, signature);
+}
+
+int64_t two_steps_sf3_get_uint64_t(const two_steps_sf3 *two_steps_sf3, const uint64_t key) {
+	uint64_t signature[4];
+	spooky_short(&key, 8, two_steps_sf3->global_seed, signature);
+	return two_steps_sf3_get_signature(two_steps_sf3, signature);
+}
+
+static void inline signature_to_equation(const uint64_t *signature, const uint64_t seed, int num_variables, unsigned int *e) {
+	uint64_t hash[4];
+	spooky_short_rehash(signature, seed, hash);
+	const int shift = __builtin_clzll(num_variables | 1); // Empty buckets yield zero
+	const uint64_t mask = (UINT64_C(1) << shift) - 1;
+	e[0] = ((hash[0] & mask) * num_variables) >> shift;
+	e[1] = ((hash[1] & mask) * num_variables) >> shift;
+	e[2] = ((hash[2] & mask) * num_variables) >> shift;
+}
+
+static uint64_t inline get_value(const uint64_t * const array, uint64_t pos, const int width) {
+	pos *= width;
+	const int l = 64 - width;
+	const uint64_t start_word = pos / 64;
+	const int start_bit = pos % 64;
+	if (start_bit <= l) return array[start_word] << l - start_bit >> l;
+	return array[start_word] >> start_bit | array[start_word + 1] << 64 + l - start_bit >> l;
+}
+
+/* Evaluates a function on the b signatures with given indices, prefetching the offsets and
+   seeds of their buckets before computing the equations, and their data before extracting it. */
+static void sf3_get_signature_batch(const sf *sf, const uint64_t (*signature)[4], const int *index, const int b, uint64_t *value) {
+	uint64_t bucket[BATCH], pos[BATCH][3];
+	for (int j = 0; j < b; j++) {
+		bucket[j] = ((__uint128_t)(signature[index[j]][0] >> 1) * (__uint128_t)sf->multiplier) >> 64;
+		__builtin_prefetch(&sf->offset_and_seed[bucket[j]]);
+	}
+	for (int j = 0; j < b; j++) {
+		const uint64_t offset_seed = sf->offset_and_seed[bucket[j]];
+		const uint64_t bucket_offset = offset_seed & OFFSET_MASK;
+		const int num_variables = (sf->offset_and_seed[bucket[j] + 1] & OFFSET_MASK) - bucket_offset;
+		unsigned int e[3];
+		signature_to_equation(signature[index[j]], offset_seed & ~OFFSET_MASK, num_variables, e);
+		for (int k = 0; k < 3; k++) {
+			pos[j][k] = e[k] + bucket_offset;
+			__builtin_prefetch(&sf->array[pos[j][k] * sf->width / 64]);
+		}
+	}
+	for (int j = 0; j < b; j++) value[j] = get_value(sf->array, pos[j][0], sf->width) ^ get_value(sf->array, pos[j][1], sf->width) ^ get_value(sf->array, pos[j][2], sf->width);
+}
+
+void two_steps_sf3_get_signature_batch(const two_steps_sf3 *two_steps_sf3, const uint64_t (*signature)[4], int64_t *result, const uint64_t n) {
+	int index[BATCH], escaped[BATCH];
+	uint64_t value[BATCH];
+	for (int j = 0; j < BATCH; j++) index[j] = j;
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		int e = 0;
+		if (two_steps_sf3->size == 0) {
+			for (int j = 0; j < b; j++) result[i + j] = -1;
+			continue;
+		}
+		if (two_steps_sf3->first.width != 0) {
+			sf3_get_signature_batch(&two_steps_sf3->first, signature + i, index, b, value);
+			for (int j = 0; j < b; j++) {
+				if (value[j] != two_steps_sf3->escape) result[i + j] = two_steps_sf3->remap[value[j]];
+				else escaped[e++] = j;
+			}
+		}
+		else for (int j = 0; j < b; j++) escaped[e++] = j;
+
+		// Only the escaped signatures touch the memory of the second function
+		if (e == 0) continue;
+		if (two_steps_sf3->second.size == 0) {
+			for (int k = 0; k < e; k++) result[i + escaped[k]] = -1;
+			continue;
+		}
+		sf3_get_signature_batch(&two_steps_sf3->second, signature + i, escaped, e, value);
+		for (int k = 0; k < e; k++) result[i + escaped[k]] = value[k];
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TWO_STEPS_SF3_H_INCLUDED
+#define TWO_STEPS_SF3_H_INCLUDED
+
+#include <inttypes.h>
+#include "sf3.h"
+
+/* A view of a two-step function dump (see TwoStepsGOV3Function.dump() in Java). The first
+   function maps the keys with frequent values to their rank by frequency, which is remapped to
+   the value, and all other keys to the escape value, in which case the second function is
+   queried. The lookup code uses the generic code of sf3.c, so it must not be compiled with SF_8. */
+typedef struct {
+	uint64_t size;
+	uint64_t global_seed;
+	uint64_t escape; // The value of the first function redirecting to the second one
+	sf first; // The first function, whose width is zero if there is no first function
+	uint64_t remap_length;
+	const uint64_t *remap; // The values of the first function, by rank
+	sf second; // The second function, whose size is zero if all values are frequent
+	void *map; // The mapping, if loaded by load_two_steps_sf3()
+	uint64_t map_length;
+} two_steps_sf3;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a two-step function dump. */
+two_steps_sf3 *load_two_steps_sf3(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_two_steps_sf3(const void *dump, uint64_t length, two_steps_sf3 *two_steps_sf3);
+/* Maps a function and validates it (see two_steps_sf3_validate()); returns NULL if the dump is not valid. */
+two_steps_sf3 *load_two_steps_sf3_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h). */
+two_steps_sf3 *load_two_steps_sf3_verify(int h, dump_verifier *verifier);
+/* Checks both functions (see sf_validate()), that they use the same seed and that the remap
+   table covers all values of the first function but the escape; returns zero if valid. */
+int two_steps_sf3_validate(const two_steps_sf3 *two_steps_sf3);
+int64_t two_steps_sf3_get_byte_array(const two_steps_sf3 *two_steps_sf3, char *key, uint64_t len);
+int64_t two_steps_sf3_get_uint64_t(const two_steps_sf3 *two_steps_sf3, uint64_t key);
+int64_t two_steps_sf3_get_signature(const two_steps_sf3 *two_steps_sf3, const uint64_t signature[4]);
+/* Stores in result the values of n signatures: the first function is evaluated on a group of
+   signatures, prefetching its buckets and then its data, and the second function only on the
+   escaped signatures of the group, in the same way. */
+void two_steps_sf3_get_signature_batch(const two_steps_sf3 *two_steps_sf3, const uint64_t (*signature)[4], int64_t *result, uint64_t n);
+
+#endif /* TWO_STEPS_SF3_H_INCLUDED */
@@ -0,0 +1,462 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "spooky.h"
+#include "lcp_mmphf.h"
+#include "zfast_trie.h"
+
+#define BUFFER_WORDS 32 // Keys shorter than this many words use buffers on the stack
+#define BATCH 16
+
+/* The results of locate(): the comparison between a bit vector and the extent of its exit node. */
+#define PROPER_PREFIX -2
+#define SMALLER -1
+#define EQUAL 0
+#define GREATER 1
+
+static inline int get_bit(const uint64_t * const bits, const uint64_t pos) {
+	return bits[pos / 64] >> pos % 64 & 1;
+}
+
+static inline uint64_t get_bits(const uint64_t * const bits, const uint64_t pos, const int width) {
+	const uint64_t word = pos / 64;
+	const int bit = pos % 64;
+	uint64_t result = bits[word] >> bit;
+	if (bit + width > 64) result |= bits[word + 1] << 64 - bit;
+	return width == 64 ? result : result & (UINT64_C(1) << width) - 1;
+}
+
+static inline int64_t check_mask(const uint64_t length) {
+	return length == 0 ? -1 : (int64_t)(UINT64_MAX << 64 - __builtin_clzll(length));
+}
+
+static inline int64_t mph_bucket(const mph *mph, const uint64_t signature[4]) {
+	return ((__uint128_t)(signature[0] >> 1) * (__uint128_t)mph->multiplier) >> 64;
+}
+
+int map_zfast_trie(const void *dump, const uint64_t length, zfast_trie *zfast_trie) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_ZFAST_TRIE) return -1;
+	memset(zfast_trie, 0, sizeof *zfast_trie);
+	zfast_trie->size = header->param[0];
+	if (zfast_trie->size == 0) return header->num_sections == 0 ? 0 : -1;
+	// Leaves and children are packed in 32 bits
+	if (zfast_trie->size > UINT32_MAX / 2) return -1;
+	zfast_trie->num_nodes = zfast_trie->size - 1;
+	zfast_trie->root = header->param[1];
+	if (header->num_sections != (zfast_trie->num_nodes == 0 ? 8 : 9)) return -1;
+	if (header->section[0].length != zfast_trie->num_nodes * sizeof *zfast_trie->nodes || header->section[1].length != zfast_trie->num_nodes * sizeof *zfast_trie->links) return -1;
+	const char * const base = dump;
+	zfast_trie->nodes = (const zfast_trie_node *)(base + header->section[0].offset);
+	zfast_trie->links = (const zfast_trie_link *)(base + header->section[1].offset);
+	zfast_trie->keys_length = header->section[2].length / sizeof *zfast_trie->keys;
+	zfast_trie->keys = (const uint64_t *)(base + header->section[2].offset);
+	if (map_elias_fano_at(dump, 2, 3, &zfast_trie->offsets) != 0) return -1;
+	if (zfast_trie->num_nodes == 0) return 0;
+	// The map is a complete container, aligned as any section
+	return map_mph(base + header->section[8].offset, header->section[8].length, &zfast_trie->handle2node);
+}
+
+zfast_trie *load_zfast_trie(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	zfast_trie *zfast_trie = malloc(sizeof *zfast_trie);
+	if (zfast_trie == NULL || map_zfast_trie(map, length, zfast_trie) != 0) {
+		free(zfast_trie);
+		munmap(map, length);
+		return NULL;
+	}
+	zfast_trie->map = map;
+	zfast_trie->map_length = length;
+	return zfast_trie;
+}
+
+int zfast_trie_validate(const zfast_trie *zfast_trie) {
+	if (zfast_trie->size == 0) return 0;
+	const elias_fano * const offsets = &zfast_trie->offsets;
+	if (elias_fano_validate(offsets) != 0 || offsets->length != zfast_trie->size + 1) return -1;
+	if (zfast_trie->keys_length > UINT64_MAX / 64 || elias_fano_get(offsets, zfast_trie->size) > zfast_trie->keys_length * 64) return -1;
+	const uint64_t num_ids = zfast_trie->num_nodes + zfast_trie->size;
+	if (zfast_trie->root >= num_ids) return -1;
+	if (zfast_trie->num_nodes == 0) return 0;
+	if (mph_validate(&zfast_trie->handle2node) != 0 || zfast_trie->handle2node.size != zfast_trie->num_nodes) return -1;
+	for (uint64_t p = 0; p < zfast_trie->num_nodes; p++) {
+		const zfast_trie_link * const link = &zfast_trie->links[p];
+		const uint64_t first = link->leaves & UINT32_MAX, last = link->leaves >> 32;
+		if (first > last || last >= zfast_trie->size) return -1;
+		if ((link->children & UINT32_MAX) >= num_ids || link->children >> 32 >= num_ids) return -1;
+		// The extent is a prefix of the first key, and the handle a prefix of the extent
+		uint64_t start, end;
+		elias_fano_get_pair(offsets, first, &start, &end);
+		if (zfast_trie->nodes[p].extent_length > end - start || link->handle_length > zfast_trie->nodes[p].extent_length) return -1;
+	}
+	return 0;
+}
+
+static int validate(const void *zfast_trie) {
+	return zfast_trie_validate(zfast_trie);
+}
+
+zfast_trie *load_zfast_trie_validated(int h) {
+	zfast_trie *zfast_trie = load_zfast_trie(h);
+	if (zfast_trie == NULL) return NULL;
+	if (zfast_trie_validate(zfast_trie) == 0) return zfast_trie;
+	munmap(zfast_trie->map, zfast_trie->map_length);
+	free(zfast_trie);
+	return NULL;
+}
+
+zfast_trie *load_zfast_trie_verify(int h, dump_verifier *verifier) {
+	zfast_trie *zfast_trie = load_zfast_trie(h);
+	if (zfast_trie == NULL) return NULL;
+	const dump_header * const header = zfast_trie->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)zfast_trie->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, zfast_trie) == 0) return zfast_trie;
+	munmap(zfast_trie->map, zfast_trie->map_length);
+	free(zfast_trie);
+	return NULL;
+}
+
+/* Returns the length of the longest common prefix of the first length bits of bits and of the
+   bits of the keys in [from..to). */
+static uint64_t lcp(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length, const uint64_t from, const uint64_t to) {
+	const uint64_t n = length < to - from ? length : to - from;
+	for (uint64_t i = 0; i < n; i += 64) {
+		const int width = n - i < 64 ? n - i : 64;
+		const uint64_t x = get_bits(bits, i, width) ^ get_bits(zfast_trie->keys, from + i, width);
+		if (x != 0) return i + __builtin_ctzll(x);
+	}
+	return n;
+}
+
+/* Stores in from the bit offset of the first key below a node, and returns the length of the
+   extent of the node. */
+static inline uint64_t extent(const zfast_trie *zfast_trie, const uint64_t id, uint64_t *from) {
+	uint64_t to;
+	if (id < zfast_trie->num_nodes) {
+		*from = elias_fano_get(&zfast_trie->offsets, zfast_trie->links[id].leaves & UINT32_MAX);
+		return zfast_trie->nodes[id].extent_length;
+	}
+	elias_fano_get_pair(&zfast_trie->offsets, id - zfast_trie->num_nodes, from, &to);
+	return to - *from;
+}
+
+/* Returns whether the node returned by the map for the signature of a prefix of length f can
+   have a handle equal to the prefix. Out-of-set prefixes can generate bizarre 3-hyperedges; since
+   a handle is never longer than the extent, the last check guarantees that fat binary searches
+   make progress even on a false positive. */
+static inline int matches(const zfast_trie *zfast_trie, const uint64_t p, const uint64_t signature[4], const uint64_t f) {
+	return p < zfast_trie->num_nodes && zfast_trie->nodes[p].signature == signature[2] && zfast_trie->nodes[p].extent_length >= f;
+}
+
+/* Returns the internal node that might have as handle a prefix of length f, given its signature, or -1. */
+static inline int64_t probe(const zfast_trie *zfast_trie, const uint64_t signature[4], const uint64_t f) {
+	const uint64_t p = mph_get_signature(&zfast_trie->handle2node, signature);
+	return matches(zfast_trie, p, signature, f) ? (int64_t)p : -1;
+}
+
+/* Returns the deepest internal node whose handle appears to be a prefix of a bit vector, and
+   whose extent is not longer than the bit vector, by a fat binary search on the lengths of its
+   prefixes (as ZFastTrie.fatBinarySearch() in Java), or -1. */
+static int64_t fat_binary_search(const zfast_trie *zfast_trie, const uint64_t *bits, const int64_t length, const uint64_t *state) {
+	uint64_t signature[4];
+	int64_t a = -1, b = length, mask = check_mask(length), top = -1;
+	while (a < b) {
+		const int64_t f = b & mask;
+		if ((a & mask) != f) {
+			spooky_short_bits_prefix(bits, f, zfast_trie->handle2node.global_seed, state, signature);
+			const int64_t p = probe(zfast_trie, signature, f);
+			if (p >= 0) {
+				a = zfast_trie->nodes[p].extent_length;
+				top = p;
+			} else b = f - 1;
+		}
+		mask >>= 1;
+	}
+	return top;
+}
+
+/* As fat_binary_search(), but checking explicitly the handles, and excluding nodes whose extent
+   is not a proper prefix of the bit vector (as ZFastTrie.fatBinarySearchExact() in Java). */
+static int64_t fat_binary_search_exact(const zfast_trie *zfast_trie, const uint64_t *bits, const int64_t length, const uint64_t *state) {
+	uint64_t signature[4], from;
+	int64_t a = -1, b = length, mask = check_mask(length), top = -1;
+	while (a < b) {
+		const int64_t f = b & mask;
+		if ((a & mask) != f) {
+			spooky_short_bits_prefix(bits, f, zfast_trie->handle2node.global_seed, state, signature);
+			const int64_t p = probe(zfast_trie, signature, f);
+			const uint64_t extent_length = p >= 0 ? extent(zfast_trie, p, &from) : 0;
+			if (p >= 0 && zfast_trie->links[p].handle_length == (uint64_t)f && extent_length < (uint64_t)length && lcp(zfast_trie, bits, length, from, from + extent_length) == extent_length) {
+				a = extent_length;
+				top = p;
+			} else b = f - 1;
+		}
+		mask >>= 1;
+	}
+	return top;
+}
+
+/* Returns the exit node of a bit vector, given the result of a fat binary search, and compares
+   the bit vector with its extent (see the constants above). */
+static int exit_node(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length, const uint64_t *state, int64_t parex, uint64_t *exit) {
+	uint64_t id = zfast_trie->root, from, extent_length = 0, l = 0;
+	if (parex >= 0) {
+		extent_length = extent(zfast_trie, parex, &from);
+		l = lcp(zfast_trie, bits, length, from, from + extent_length);
+		// A false positive; we search again, checking the handles
+		if (l < zfast_trie->links[parex].handle_length && (parex = fat_binary_search_exact(zfast_trie, bits, length, state)) >= 0) {
+			extent_length = extent(zfast_trie, parex, &from);
+			l = lcp(zfast_trie, bits, length, from, from + extent_length);
+		}
+		if (parex >= 0) {
+			id = parex;
+			// The extent is a proper prefix of the bit vector: we exit from a child
+			if (l == extent_length && length != extent_length) {
+				const uint64_t children = zfast_trie->links[parex].children;
+				id = get_bit(bits, extent_length) ? children >> 32 : children & UINT32_MAX;
+			}
+		}
+	}
+	if (id != (uint64_t)parex) {
+		extent_length = extent(zfast_trie, id, &from);
+		l = lcp(zfast_trie, bits, length, from, from + extent_length);
+	}
+	*exit = id;
+	if (l == length) return l == extent_length ? EQUAL : PROPER_PREFIX;
+	if (l == extent_length) return GREATER;
+	return get_bit(bits, l) ? GREATER : SMALLER;
+}
+
+/* Stores in first and last the leaves below a node. */
+static inline void leaves(const zfast_trie *zfast_trie, const uint64_t id, uint64_t *first, uint64_t *last) {
+	if (id < zfast_trie->num_nodes) {
+		*first = zfast_trie->links[id].leaves & UINT32_MAX;
+		*last = zfast_trie->links[id].leaves >> 32;
+	} else *first = *last = id - zfast_trie->num_nodes;
+}
+
+/* Locates a bit vector: stores in first and last the leaves below its exit node, and returns
+   the comparison between the bit vector and the extent of the exit node. In an empty trie, the
+   bit vector is greater than the (empty) interval of leaves [0..-1]. */
+static int locate(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length, uint64_t *first, uint64_t *last) {
+	if (zfast_trie->size == 0) {
+		*first = 0;
+		*last = UINT64_MAX;
+		return GREATER;
+	}
+	uint64_t buffer[BUFFER_WORDS], *state = NULL, exit;
+	int64_t parex = -1;
+	if (zfast_trie->num_nodes != 0) {
+		const uint64_t state_words = 4 * ((length + 128) / 256);
+		state = state_words <= BUFFER_WORDS ? buffer : malloc(state_words * sizeof *state);
+		spooky_short_bits_preprocess(bits, length, zfast_trie->handle2node.global_seed, state);
+		parex = fat_binary_search(zfast_trie, bits, length, state);
+	}
+	const int cmp = exit_node(zfast_trie, bits, length, state, parex, &exit);
+	if (state != buffer) free(state);
+	leaves(zfast_trie, exit, first, last);
+	return cmp;
+}
+
+static inline int64_t successor(const int cmp, const uint64_t first, const uint64_t last) {
+	return cmp <= EQUAL ? first : last + 1;
+}
+
+static inline int64_t strict_successor(const int cmp, const uint64_t first, const uint64_t last) {
+	return cmp < EQUAL ? first : last + 1;
+}
+
+static inline void prefix_range(const int cmp, const uint64_t first, const uint64_t last, uint64_t *start, uint64_t *end) {
+	if (cmp == EQUAL || cmp == PROPER_PREFIX) {
+		*start = first;
+		*end = last + 1;
+	} else *start = *end = cmp == SMALLER ? first : last + 1;
+}
+
+int64_t zfast_trie_successor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length) {
+	uint64_t first, last;
+	const int cmp = locate(zfast_trie, bits, length, &first, &last);
+	return successor(cmp, first, last);
+}
+
+int64_t zfast_trie_strict_successor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length) {
+	uint64_t first, last;
+	const int cmp = locate(zfast_trie, bits, length, &first, &last);
+	return strict_successor(cmp, first, last);
+}
+
+int64_t zfast_trie_predecessor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length) {
+	return zfast_trie_successor_bits(zfast_trie, bits, length) - 1;
+}
+
+int64_t zfast_trie_weak_predecessor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length) {
+	return zfast_trie_strict_successor_bits(zfast_trie, bits, length) - 1;
+}
+
+void zfast_trie_prefix_range_bits(const zfast_trie *zfast_trie, const uint64_t *bits, const uint64_t length, uint64_t *start, uint64_t *end) {
+	uint64_t first, last;
+	const int cmp = locate(zfast_trie, bits, length, &first, &last);
+	prefix_range(cmp, first, last, start, end);
+}
+
+int64_t zfast_trie_successor_byte_array(const zfast_trie *zfast_trie, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = zfast_trie_successor_bits(zfast_trie, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
+
+int64_t zfast_trie_strict_successor_byte_array(const zfast_trie *zfast_trie, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = zfast_trie_strict_successor_bits(zfast_trie, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
+
+int64_t zfast_trie_predecessor_byte_array(const zfast_trie *zfast_trie, const char *key, const uint64_t len) {
+	return zfast_trie_successor_byte_array(zfast_trie, key, len) - 1;
+}
+
+int64_t zfast_trie_weak_predecessor_byte_array(const zfast_trie *zfast_trie, const char *key, const uint64_t len) {
+	return zfast_trie_strict_successor_byte_array(zfast_trie, key, len) - 1;
+}
+
+void zfast_trie_prefix_range_byte_array(const zfast_trie *zfast_trie, const char *prefix, const uint64_t len, uint64_t *start, uint64_t *end) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	// We drop the terminator
+	zfast_trie_prefix_range_bits(zfast_trie, bits, lcp_mmphf_byte_array_to_bits(prefix, len, bits) - 8, start, end);
+	if (bits != buffer) free(bits);
+}
+
+/* Locates a group of at most BATCH bit vectors, storing the results of locate() in cmp, first and
+   last. The fat binary searches advance in lockstep: at each step, we compute the signatures of
+   the prefixes to probe and prefetch their buckets, then we evaluate the map and prefetch the
+   nodes, and finally we check the nodes. */
+static void locate_batch(const zfast_trie *zfast_trie, const uint64_t * const *bits, const uint64_t *length, int *cmp, uint64_t *first, uint64_t *last, const int b) {
+	uint64_t buffer[BATCH][BUFFER_WORDS], signature[BATCH][4], exit;
+	uint64_t *state[BATCH];
+	int64_t a[BATCH], r[BATCH], mask[BATCH], top[BATCH], f[BATCH], p[BATCH];
+	const mph * const handle2node = &zfast_trie->handle2node;
+
+	for (int j = 0; j < b; j++) {
+		const uint64_t state_words = 4 * ((length[j] + 128) / 256);
+		state[j] = state_words <= BUFFER_WORDS ? buffer[j] : malloc(state_words * sizeof *state[j]);
+		spooky_short_bits_preprocess(bits[j], length[j], handle2node->global_seed, state[j]);
+		a[j] = top[j] = -1;
+		r[j] = length[j];
+		mask[j] = check_mask(length[j]);
+	}
+
+	for (;;) {
+		int active = 0;
+		for (int j = 0; j < b; j++) {
+			// We skip the lengths that need not be probed
+			while (a[j] < r[j] && (a[j] & mask[j]) == (r[j] & mask[j])) mask[j] >>= 1;
+			if (a[j] >= r[j]) {
+				f[j] = -1;
+				continue;
+			}
+			active++;
+			f[j] = r[j] & mask[j];
+			spooky_short_bits_prefix(bits[j], f[j], handle2node->global_seed, state[j], signature[j]);
+			__builtin_prefetch(&handle2node->edge_offset_and_seed[mph_bucket(handle2node, signature[j])]);
+		}
+		if (active == 0) break;
+		for (int j = 0; j < b; j++) {
+			if (f[j] < 0) continue;
+			p[j] = mph_get_signature(handle2node, signature[j]);
+			if ((uint64_t)p[j] < zfast_trie->num_nodes) __builtin_prefetch(&zfast_trie->nodes[p[j]]);
+		}
+		for (int j = 0; j < b; j++) {
+			if (f[j] < 0) continue;
+			if (matches(zfast_trie, p[j], signature[j], f[j])) {
+				a[j] = zfast_trie->nodes[p[j]].extent_length;
+				top[j] = p[j];
+			} else r[j] = f[j] - 1;
+			mask[j] >>= 1;
+		}
+	}
+
+	for (int j = 0; j < b; j++) {
+		cmp[j] = exit_node(zfast_trie, bits[j], length[j], state[j], top[j], &exit);
+		leaves(zfast_trie, exit, &first[j], &last[j]);
+		if (state[j] != buffer[j]) free(state[j]);
+	}
+}
+
+/* Converts a group of byte arrays to bit vectors, dropping the terminator unless terminated is true,
+   and locates them. */
+static void locate_byte_array_batch(const zfast_trie *zfast_trie, char * const *key, const int *len, const int terminated, int *cmp, uint64_t *first, uint64_t *last, const int b) {
+	uint64_t buffer[BATCH][BUFFER_WORDS], length[BATCH];
+	const uint64_t *bits[BATCH];
+	if (zfast_trie->size == 0 || zfast_trie->num_nodes == 0) {
+		for (int j = 0; j < b; j++) {
+			uint64_t * const p = len[j] / 8 < BUFFER_WORDS ? buffer[0] : malloc((len[j] / 8 + 1) * sizeof *p);
+			cmp[j] = locate(zfast_trie, p, lcp_mmphf_byte_array_to_bits(key[j], len[j], p) - (terminated ? 0 : 8), &first[j], &last[j]);
+			if (p != buffer[0]) free(p);
+		}
+		return;
+	}
+	for (int j = 0; j < b; j++) {
+		uint64_t * const p = len[j] / 8 < BUFFER_WORDS ? buffer[j] : malloc((len[j] / 8 + 1) * sizeof *p);
+		length[j] = lcp_mmphf_byte_array_to_bits(key[j], len[j], p) - (terminated ? 0 : 8);
+		bits[j] = p;
+	}
+	locate_batch(zfast_trie, bits, length, cmp, first, last, b);
+	for (int j = 0; j < b; j++) if (bits[j] != buffer[j]) free((void *)bits[j]);
+}
+
+void zfast_trie_successor_byte_array_batch(const zfast_trie *zfast_trie, char * const *key, const int *len, int64_t *result, const uint64_t n) {
+	uint64_t first[BATCH], last[BATCH];
+	int cmp[BATCH];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		locate_byte_array_batch(zfast_trie, key + i, len + i, 1, cmp, first, last, b);
+		for (int j = 0; j < b; j++) result[i + j] = successor(cmp[j], first[j], last[j]);
+	}
+}
+
+void zfast_trie_strict_successor_byte_array_batch(const zfast_trie *zfast_trie, char * const *key, const int *len, int64_t *result, const uint64_t n) {
+	uint64_t first[BATCH], last[BATCH];
+	int cmp[BATCH];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		locate_byte_array_batch(zfast_trie, key + i, len + i, 1, cmp, first, last, b);
+		for (int j = 0; j < b; j++) result[i + j] = strict_successor(cmp[j], first[j], last[j]);
+	}
+}
+
+void zfast_trie_prefix_range_byte_array_batch(const zfast_trie *zfast_trie, char * const *prefix, const int *len, uint64_t *start, uint64_t *end, const uint64_t n) {
+	uint64_t first[BATCH], last[BATCH];
+	int cmp[BATCH];
+	for (uint64_t i = 0; i < n; i += BATCH) {
+		const int b = n - i < BATCH ? n - i : BATCH;
+		locate_byte_array_batch(zfast_trie, prefix + i, len + i, 0, cmp, first, last, b);
+		for (int j = 0; j < b; j++) prefix_range(cmp[j], first[j], last[j], start + i + j, end + i + j);
+	}
+}
@@ -0,0 +1,117 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ZFAST_TRIE_H_INCLUDED
+#define ZFAST_TRIE_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "mph.h"
+#include "elias_fano.h"
+
+/* The data of an internal node probed by the fat binary search. */
+typedef struct {
+	uint64_t signature; // The third word of the hash of the handle, computed with the seed of the map
+	uint64_t extent_length;
+} zfast_trie_node;
+
+/* The data of an internal node used once a search is over. Identifiers smaller than the number
+   of internal nodes denote internal nodes; larger ones denote leaves, following the internal nodes
+   in key order. */
+typedef struct {
+	uint64_t handle_length;
+	uint64_t leaves; // The first (lower 32 bits) and last (upper 32 bits) leaf of the subtrie
+	uint64_t children; // The left (lower 32 bits) and right (upper 32 bits) child
+} zfast_trie_link;
+
+/* A view of a frozen z-fast trie dump (see ZFastTrie.dump() in Java). Keys are bit vectors stored
+   as in a LongArrayBitVector, and queries return ranks in key order. Internal nodes are numbered by
+   a minimal perfect hash function on their handles, which replaces the map from handles to nodes:
+   the exit node of a key is found by a fat binary search on the lengths of its prefixes, whose
+   hashes are computed in constant time (see spooky_short_bits_prefix()), and checked against the
+   signature of the handle of the node returned by the function. As in Java, if the search fails,
+   which can happen only with a false positive, it is repeated checking the handles explicitly. */
+typedef struct {
+	uint64_t size;
+	uint64_t num_nodes; // The number of internal nodes
+	uint64_t root;
+	const zfast_trie_node *nodes;
+	const zfast_trie_link *links;
+	uint64_t keys_length;
+	const uint64_t *keys; // The keys, concatenated
+	elias_fano offsets; // The bit offset of each key, and the end of the keys
+	mph handle2node; // Maps the handle of each internal node to its identifier
+	void *map; // The mapping, if loaded by load_zfast_trie()
+	uint64_t map_length;
+} zfast_trie;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a z-fast trie dump. */
+zfast_trie *load_zfast_trie(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_zfast_trie(const void *dump, uint64_t length, zfast_trie *zfast_trie);
+/* Maps a trie and validates it (see zfast_trie_validate()); returns NULL if the dump is not valid. */
+zfast_trie *load_zfast_trie_validated(int h);
+/* Maps a trie and starts verifying it in the background (see dump.h); the embedded map is
+   verified as a whole section. */
+zfast_trie *load_zfast_trie_verify(int h, dump_verifier *verifier);
+/* Checks the map (see mph_validate()) and the offsets (see elias_fano_validate()), and that
+   the handles, extents, leaves and children of the nodes lie within the keys and the nodes;
+   returns zero if valid. */
+int zfast_trie_validate(const zfast_trie *zfast_trie);
+
+/* Returns the rank of the first key greater than or equal to a bit vector of given length, or the
+   number of keys if there is no such key. */
+int64_t zfast_trie_successor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, uint64_t length);
+/* Returns the rank of the first key greater than a bit vector of given length, or the number of
+   keys if there is no such key. */
+int64_t zfast_trie_strict_successor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, uint64_t length);
+/* Returns the rank of the last key smaller than a bit vector of given length, or -1 if there is
+   no such key. */
+int64_t zfast_trie_predecessor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, uint64_t length);
+/* Returns the rank of the last key smaller than or equal to a bit vector of given length, or -1 if
+   there is no such key. */
+int64_t zfast_trie_weak_predecessor_bits(const zfast_trie *zfast_trie, const uint64_t *bits, uint64_t length);
+/* Stores in start and end the interval of ranks of the keys having a bit vector of given length as
+   a prefix; if there are none, the interval is empty and starts at the successor. */
+void zfast_trie_prefix_range_bits(const zfast_trie *zfast_trie, const uint64_t *bits, uint64_t length, uint64_t *start, uint64_t *end);
+
+/* As the functions above, for a trie built using TransformationStrategies.prefixFreeByteArray()
+   (see lcp_mmphf_byte_array_to_bits()); the order of the keys is the lexicographical order of
+   byte arrays. */
+int64_t zfast_trie_successor_byte_array(const zfast_trie *zfast_trie, const char *key, uint64_t len);
+int64_t zfast_trie_strict_successor_byte_array(const zfast_trie *zfast_trie, const char *key, uint64_t len);
+int64_t zfast_trie_predecessor_byte_array(const zfast_trie *zfast_trie, const char *key, uint64_t len);
+int64_t zfast_trie_weak_predecessor_byte_array(const zfast_trie *zfast_trie, const char *key, uint64_t len);
+/* The prefix is not terminated: the range contains the keys starting with the given bytes. */
+void zfast_trie_prefix_range_byte_array(const zfast_trie *zfast_trie, const char *prefix, uint64_t len, uint64_t *start, uint64_t *end);
+
+/* Store in result the successors (or strict successors) of the n given byte arrays. Keys are
+   searched in groups, advancing the fat binary searches of a group in lockstep: the buckets of
+   the map, and then the nodes, of all the probes of a step are prefetched before being read.
+   The predecessor of a key is its successor minus one, and the weak predecessor is its strict
+   successor minus one. */
+void zfast_trie_successor_byte_array_batch(const zfast_trie *zfast_trie, char * const *key, const int *len, int64_t *result, uint64_t n);
+void zfast_trie_strict_successor_byte_array_batch(const zfast_trie *zfast_trie, char * const *key, const int *len, int64_t *result, uint64_t n);
+/* Stores in start and end the intervals of ranks of the keys having the n given byte arrays as
+   prefixes, searching the prefixes as zfast_trie_successor_byte_array_batch() does. */
+void zfast_trie_prefix_range_byte_array_batch(const zfast_trie *zfast_trie, char * const *prefix, const int *len, uint64_t *start, uint64_t *end, uint64_t n);
+
+#endif /* ZFAST_TRIE_H_INCLUDED */
@@ -0,0 +1,349 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+#include "spooky.h"
+#include "lcp_mmphf.h"
+#include "zfast_trie_distributor.h"
+
+#define LEFT 0
+#define BUFFER_WORDS 32 // Keys shorter than this many words use buffers on the stack
+
+static inline int get_bit(const uint64_t * const bits, const uint64_t pos) {
+	return bits[pos / 64] >> pos % 64 & 1;
+}
+
+static inline uint64_t get_bits(const uint64_t * const bits, const uint64_t pos, const int width) {
+	const uint64_t word = pos / 64;
+	const int bit = pos % 64;
+	uint64_t result = bits[word] >> bit;
+	if (bit + width > 64) result |= bits[word + 1] << 64 - bit;
+	return width == 64 ? result : result & (UINT64_C(1) << width) - 1;
+}
+
+static inline int64_t get_signature(const sf *sf, const uint64_t signature[4]) {
+	return sf->width == 0 ? 0 : sf3_get_signature(sf, signature);
+}
+
+/* Returns the position of the last one (or zero, if complement is -1) before length, or -1. */
+static inline int64_t last(const uint64_t * const bits, const uint64_t length, const uint64_t complement) {
+	if (length == 0) return -1;
+	uint64_t word = (length - 1) / 64;
+	uint64_t w = (bits[word] ^ complement) & UINT64_MAX >> 63 - (length - 1) % 64;
+	for (;;) {
+		if (w != 0) return word * 64 + 63 - __builtin_clzll(w);
+		if (word-- == 0) return -1;
+		w = bits[word] ^ complement;
+	}
+}
+
+/* Moves the 32 bits of x to the odd positions of a word. */
+static inline uint64_t spread(uint64_t x) {
+#ifdef __BMI2__
+	return _pdep_u64(x, UINT64_C(0xAAAAAAAAAAAAAAAA));
+#else
+	x = (x | x << 16) & UINT64_C(0x0000FFFF0000FFFF);
+	x = (x | x << 8) & UINT64_C(0x00FF00FF00FF00FF);
+	x = (x | x << 4) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+	x = (x | x << 2) & UINT64_C(0x3333333333333333);
+	return ((x | x << 1) & UINT64_C(0x5555555555555555)) << 1;
+#endif
+}
+
+/* Stores in dest, which must contain (length + one) / 32 + 1 words, the image under
+   TransformationStrategies.prefixFree() of the first length bits of bits followed, if one is true,
+   by a one, and returns its length. */
+static uint64_t prefix_free(const uint64_t * const bits, const uint64_t length, const int one, uint64_t * const dest) {
+	const uint64_t n = length + one;
+	for (uint64_t k = 0; k <= n / 32; k++) {
+		const uint64_t start = k * 32;
+		uint64_t x = start < length ? bits[k / 2] >> k % 2 * 32 & UINT32_MAX : 0;
+		if (length - start < 32) x &= (UINT64_C(1) << length - start) - 1;
+		if (one && length - start < 32) x |= UINT64_C(1) << length - start;
+		// Each bit is preceded by a one; bits past the end, including the terminator, are zero
+		const uint64_t valid = n - start < 32 ? n - start : 32;
+		dest[k] = (spread(x) | UINT64_C(0x5555555555555555)) & (valid == 32 ? UINT64_MAX : (UINT64_C(1) << 2 * valid) - 1);
+	}
+	return 2 * n + 1;
+}
+
+int map_zfast_trie_distributor(const void *dump, const uint64_t length, zfast_trie_distributor *zfast_trie_distributor) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_ZFAST_TRIE_DISTRIBUTOR) return -1;
+	memset(zfast_trie_distributor, 0, sizeof *zfast_trie_distributor);
+	zfast_trie_distributor->size = header->param[0];
+	zfast_trie_distributor->num_delimiters = header->param[1];
+	if (header->num_sections == 0) {
+		zfast_trie_distributor->no_delimiters = 1;
+		return 0;
+	}
+	if (header->param[2] > 63 || header->param[3] > 64 - header->param[2]) return -1;
+	zfast_trie_distributor->log_w = header->param[2];
+	zfast_trie_distributor->log_w_mask = (UINT64_C(1) << zfast_trie_distributor->log_w) - 1;
+	zfast_trie_distributor->signature_size = header->param[3];
+	zfast_trie_distributor->signature_mask = zfast_trie_distributor->signature_size == 0 ? 0 : UINT64_MAX >> 64 - zfast_trie_distributor->signature_size;
+	if (map_sf_at(dump, 1, 4, 0, &zfast_trie_distributor->behaviour) != 0) return -1;
+	zfast_trie_distributor->global_seed = zfast_trie_distributor->behaviour.global_seed;
+	if (header->num_sections == 2) {
+		zfast_trie_distributor->empty_trie = 1;
+		return 0;
+	}
+	if (header->num_sections != 10) return -1;
+	if (map_sf_at(dump, zfast_trie_distributor->log_w + zfast_trie_distributor->signature_size, 7, 2, &zfast_trie_distributor->signatures) != 0 || map_sf_at(dump, zfast_trie_distributor->log_w, 10, 4, &zfast_trie_distributor->corrections) != 0) return -1;
+	if (map_rank9_at(dump, 13, 6, &zfast_trie_distributor->leaves) != 0) return -1;
+	zfast_trie_distributor->num_mistakes = header->section[8].length / sizeof *zfast_trie_distributor->mistakes;
+	zfast_trie_distributor->mistakes = (const int32_t *)((const char *)dump + header->section[8].offset);
+	// The ranker is a complete container, aligned as any section
+	return map_two_steps_lcp_mmphf((const char *)dump + header->section[9].offset, header->section[9].length, &zfast_trie_distributor->ranker);
+}
+
+zfast_trie_distributor *load_zfast_trie_distributor(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	zfast_trie_distributor *zfast_trie_distributor = malloc(sizeof *zfast_trie_distributor);
+	if (zfast_trie_distributor == NULL || map_zfast_trie_distributor(map, length, zfast_trie_distributor) != 0) {
+		free(zfast_trie_distributor);
+		munmap(map, length);
+		return NULL;
+	}
+	zfast_trie_distributor->map = map;
+	zfast_trie_distributor->map_length = length;
+	return zfast_trie_distributor;
+}
+
+int zfast_trie_distributor_validate(const zfast_trie_distributor *zfast_trie_distributor) {
+	if (zfast_trie_distributor->no_delimiters) return 0;
+	if (sf_validate(&zfast_trie_distributor->behaviour) != 0) return -1;
+	if (zfast_trie_distributor->empty_trie) return 0;
+	// The correction function is queried only on mistakes
+	if (sf_validate(&zfast_trie_distributor->signatures) != 0 || zfast_trie_distributor->num_mistakes != 0 && sf_validate(&zfast_trie_distributor->corrections) != 0) return -1;
+	for (uint64_t i = 1; i < zfast_trie_distributor->num_mistakes; i++) if (zfast_trie_distributor->mistakes[i - 1] > zfast_trie_distributor->mistakes[i]) return -1;
+	const rank9 * const leaves = &zfast_trie_distributor->leaves;
+	if (rank9_validate(leaves) != 0 || two_steps_lcp_mmphf_validate(&zfast_trie_distributor->ranker) != 0) return -1;
+	// Ranks are always smaller than the size of the ranker, and never negative
+	return leaves->length == 0 || zfast_trie_distributor->ranker.size > leaves->length ? -1 : 0;
+}
+
+static int validate_distributor(const void *zfast_trie_distributor) {
+	return zfast_trie_distributor_validate(zfast_trie_distributor);
+}
+
+zfast_trie_distributor *load_zfast_trie_distributor_validated(int h) {
+	zfast_trie_distributor *zfast_trie_distributor = load_zfast_trie_distributor(h);
+	if (zfast_trie_distributor == NULL) return NULL;
+	if (zfast_trie_distributor_validate(zfast_trie_distributor) == 0) return zfast_trie_distributor;
+	munmap(zfast_trie_distributor->map, zfast_trie_distributor->map_length);
+	free(zfast_trie_distributor);
+	return NULL;
+}
+
+zfast_trie_distributor *load_zfast_trie_distributor_verify(int h, dump_verifier *verifier) {
+	zfast_trie_distributor *zfast_trie_distributor = load_zfast_trie_distributor(h);
+	if (zfast_trie_distributor == NULL) return NULL;
+	const dump_header * const header = zfast_trie_distributor->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)zfast_trie_distributor->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate_distributor, zfast_trie_distributor) == 0) return zfast_trie_distributor;
+	munmap(zfast_trie_distributor->map, zfast_trie_distributor->map_length);
+	free(zfast_trie_distributor);
+	return NULL;
+}
+
+static inline int is_mistake(const zfast_trie_distributor *zfast_trie_distributor, const int32_t signature) {
+	const int32_t * const mistakes = zfast_trie_distributor->mistakes;
+	uint64_t l = 0, r = zfast_trie_distributor->num_mistakes;
+	while (l < r) {
+		const uint64_t m = (l + r) / 2;
+		if (mistakes[m] < signature) l = m + 1;
+		else r = m;
+	}
+	return l < zfast_trie_distributor->num_mistakes && mistakes[l] == signature;
+}
+
+/* Returns the length of the string of the exit node of a key by a fat binary search on the
+   lengths of its prefixes, unless the key is a mistake. */
+static uint64_t node_string_length(const zfast_trie_distributor *zfast_trie_distributor, const uint64_t *bits, const uint64_t length, const uint64_t signature[4], const uint64_t *state) {
+	uint64_t prefix_signature[4];
+	if (is_mistake(zfast_trie_distributor, (int32_t)signature[0])) {
+		spooky_short_bits(bits, length, zfast_trie_distributor->corrections.global_seed, prefix_signature);
+		return get_signature(&zfast_trie_distributor->corrections, prefix_signature);
+	}
+
+	uint64_t r = length, l = 0;
+	int i = length == 0 ? -1 : 63 - __builtin_clzll(length);
+	uint64_t mask = i < 0 ? 0 : UINT64_C(1) << i;
+	for (; r - l > 1 && i >= 0; i--, mask >>= 1) {
+		if ((l & mask) == (r - 1 & mask)) continue;
+		const uint64_t f = r - 1 & UINT64_MAX << i;
+		spooky_short_bits_prefix(bits, f, zfast_trie_distributor->global_seed, state, prefix_signature);
+		const int64_t data = get_signature(&zfast_trie_distributor->signatures, prefix_signature);
+		const uint64_t g = data & zfast_trie_distributor->log_w_mask;
+		if (data == -1 || g > length) {
+			r = f;
+			continue;
+		}
+		spooky_short_bits_prefix(bits, g, zfast_trie_distributor->global_seed, state, prefix_signature);
+		if ((uint64_t)data >> zfast_trie_distributor->log_w == (prefix_signature[0] & zfast_trie_distributor->signature_mask) && g >= f) l = g;
+		else r = f;
+	}
+	return l;
+}
+
+int64_t zfast_trie_distributor_get(const zfast_trie_distributor *zfast_trie_distributor, const uint64_t *bits, const uint64_t length, const uint64_t signature[4], const uint64_t *state) {
+	if (zfast_trie_distributor->no_delimiters) return 0;
+	const int64_t b = get_signature(&zfast_trie_distributor->behaviour, signature);
+	if (zfast_trie_distributor->empty_trie) return b;
+	const uint64_t l = node_string_length(zfast_trie_distributor, bits, length, signature, state);
+	if (l >= length) return -1;
+
+	// The string to rank is a prefix of the key, possibly followed by a one
+	uint64_t prefix = l;
+	int one = 1;
+	if (b == LEFT) {
+		if (!get_bit(bits, l)) {
+			prefix = last(bits, l, 0) + 1;
+			one = 0;
+		}
+	} else if (get_bit(bits, l)) {
+		const int64_t last_zero = last(bits, l, UINT64_MAX);
+		// We are exiting at the right of 1^k
+		if (last_zero == -1) return zfast_trie_distributor->num_delimiters;
+		prefix = last_zero;
+	}
+
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const key = (prefix + one) / 32 < BUFFER_WORDS ? buffer : malloc(((prefix + one) / 32 + 1) * sizeof *key);
+	const int64_t pos = two_steps_lcp_mmphf_get_bits(&zfast_trie_distributor->ranker, key, prefix_free(bits, prefix, one, key));
+	if (key != buffer) free(key);
+	return rank9_rank(&zfast_trie_distributor->leaves, pos < 0 ? 0 : pos);
+}
+
+int64_t zfast_trie_distributor_get_bits(const zfast_trie_distributor *zfast_trie_distributor, const uint64_t *bits, const uint64_t length) {
+	uint64_t buffer[BUFFER_WORDS], signature[4];
+	const uint64_t state_words = 4 * ((length + 128) / 256);
+	uint64_t * const state = state_words <= BUFFER_WORDS ? buffer : malloc(state_words * sizeof *state);
+	spooky_short_bits_preprocess(bits, length, zfast_trie_distributor->global_seed, state);
+	spooky_short_bits_prefix(bits, length, zfast_trie_distributor->global_seed, state, signature);
+	const int64_t result = zfast_trie_distributor_get(zfast_trie_distributor, bits, length, signature, state);
+	if (state != buffer) free(state);
+	return result;
+}
+
+int map_zfast_trie_distributor_mmphf(const void *dump, const uint64_t length, zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf) {
+	const dump_header * const header = dump_map_header(dump, length);
+	if (header == NULL || header->kind != DUMP_ZFAST_TRIE_DISTRIBUTOR_MMPHF) return -1;
+	memset(zfast_trie_distributor_mmphf, 0, sizeof *zfast_trie_distributor_mmphf);
+	zfast_trie_distributor_mmphf->size = header->param[0];
+	if (zfast_trie_distributor_mmphf->size == 0) return header->num_sections == 0 ? 0 : -1;
+	if (header->num_sections != 4 || header->param[1] > 32 || header->param[3] > 64) return -1;
+	zfast_trie_distributor_mmphf->log2_bucket_size = header->param[1];
+	zfast_trie_distributor_mmphf->global_seed = header->param[2];
+	zfast_trie_distributor_mmphf->signature_width = header->param[3];
+	zfast_trie_distributor_mmphf->signature_mask = zfast_trie_distributor_mmphf->signature_width == 0 ? 0 : UINT64_MAX >> 64 - zfast_trie_distributor_mmphf->signature_width;
+	if (map_sf_at(dump, zfast_trie_distributor_mmphf->log2_bucket_size, 4, 0, &zfast_trie_distributor_mmphf->offset) != 0) return -1;
+	// The distributor is a complete container, aligned as any section
+	if (map_zfast_trie_distributor((const char *)dump + header->section[2].offset, header->section[2].length, &zfast_trie_distributor_mmphf->distributor) != 0) return -1;
+	zfast_trie_distributor_mmphf->signatures_length = header->section[3].length / sizeof *zfast_trie_distributor_mmphf->signatures;
+	zfast_trie_distributor_mmphf->signatures = (const uint64_t *)((const char *)dump + header->section[3].offset);
+	return 0;
+}
+
+zfast_trie_distributor_mmphf *load_zfast_trie_distributor_mmphf(int h) {
+	uint64_t length;
+	void * const map = dump_map(h, &length);
+	if (map == NULL) return NULL;
+	zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf = malloc(sizeof *zfast_trie_distributor_mmphf);
+	if (zfast_trie_distributor_mmphf == NULL || map_zfast_trie_distributor_mmphf(map, length, zfast_trie_distributor_mmphf) != 0) {
+		free(zfast_trie_distributor_mmphf);
+		munmap(map, length);
+		return NULL;
+	}
+	zfast_trie_distributor_mmphf->map = map;
+	zfast_trie_distributor_mmphf->map_length = length;
+	return zfast_trie_distributor_mmphf;
+}
+
+int zfast_trie_distributor_mmphf_validate(const zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf) {
+	if (zfast_trie_distributor_mmphf->size == 0) return 0;
+	// Functions of width zero are never probed
+	const sf * const offset = &zfast_trie_distributor_mmphf->offset;
+	if (offset->width != 0 && (sf_validate(offset) != 0 || offset->global_seed != zfast_trie_distributor_mmphf->global_seed)) return -1;
+	const zfast_trie_distributor * const distributor = &zfast_trie_distributor_mmphf->distributor;
+	if (zfast_trie_distributor_validate(distributor) != 0 || !distributor->no_delimiters && distributor->global_seed != zfast_trie_distributor_mmphf->global_seed) return -1;
+	if (zfast_trie_distributor_mmphf->signature_width != 0 && (zfast_trie_distributor_mmphf->size >= UINT64_MAX / 64 || zfast_trie_distributor_mmphf->signatures_length * 64 < zfast_trie_distributor_mmphf->size * zfast_trie_distributor_mmphf->signature_width)) return -1;
+	return 0;
+}
+
+static int validate(const void *zfast_trie_distributor_mmphf) {
+	return zfast_trie_distributor_mmphf_validate(zfast_trie_distributor_mmphf);
+}
+
+zfast_trie_distributor_mmphf *load_zfast_trie_distributor_mmphf_validated(int h) {
+	zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf = load_zfast_trie_distributor_mmphf(h);
+	if (zfast_trie_distributor_mmphf == NULL) return NULL;
+	if (zfast_trie_distributor_mmphf_validate(zfast_trie_distributor_mmphf) == 0) return zfast_trie_distributor_mmphf;
+	munmap(zfast_trie_distributor_mmphf->map, zfast_trie_distributor_mmphf->map_length);
+	free(zfast_trie_distributor_mmphf);
+	return NULL;
+}
+
+zfast_trie_distributor_mmphf *load_zfast_trie_distributor_mmphf_verify(int h, dump_verifier *verifier) {
+	zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf = load_zfast_trie_distributor_mmphf(h);
+	if (zfast_trie_distributor_mmphf == NULL) return NULL;
+	const dump_header * const header = zfast_trie_distributor_mmphf->map;
+	const void *section[DUMP_MAX_SECTIONS];
+	for (uint32_t i = 0; i < header->num_sections; i++) section[i] = (const char *)zfast_trie_distributor_mmphf->map + header->section[i].offset;
+	if (dump_verify_start(verifier, header, section, validate, zfast_trie_distributor_mmphf) == 0) return zfast_trie_distributor_mmphf;
+	munmap(zfast_trie_distributor_mmphf->map, zfast_trie_distributor_mmphf->map_length);
+	free(zfast_trie_distributor_mmphf);
+	return NULL;
+}
+
+int64_t zfast_trie_distributor_mmphf_get_bits(const zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf, const uint64_t *bits, const uint64_t length) {
+	if (zfast_trie_distributor_mmphf->size == 0) return -1;
+	uint64_t buffer[BUFFER_WORDS], signature[4];
+	const uint64_t state_words = 4 * ((length + 128) / 256);
+	uint64_t * const state = state_words <= BUFFER_WORDS ? buffer : malloc(state_words * sizeof *state);
+	spooky_short_bits_preprocess(bits, length, zfast_trie_distributor_mmphf->global_seed, state);
+	spooky_short_bits_prefix(bits, length, zfast_trie_distributor_mmphf->global_seed, state, signature);
+	const int64_t bucket = zfast_trie_distributor_get(&zfast_trie_distributor_mmphf->distributor, bits, length, signature, state);
+	if (state != buffer) free(state);
+	if (bucket < 0) return -1;
+
+	const uint64_t result = ((uint64_t)bucket << zfast_trie_distributor_mmphf->log2_bucket_size) + get_signature(&zfast_trie_distributor_mmphf->offset, signature);
+	// Out-of-set keys can generate bizarre 3-hyperedges
+	if (result >= zfast_trie_distributor_mmphf->size) return -1;
+	if (zfast_trie_distributor_mmphf->signature_mask != 0 && ((get_bits(zfast_trie_distributor_mmphf->signatures, result * zfast_trie_distributor_mmphf->signature_width, zfast_trie_distributor_mmphf->signature_width) ^ signature[0]) & zfast_trie_distributor_mmphf->signature_mask) != 0) return -1;
+	return result;
+}
+
+int64_t zfast_trie_distributor_mmphf_get_byte_array(const zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf, const char *key, const uint64_t len) {
+	uint64_t buffer[BUFFER_WORDS];
+	uint64_t * const bits = len / 8 < BUFFER_WORDS ? buffer : malloc((len / 8 + 1) * sizeof *bits);
+	const int64_t result = zfast_trie_distributor_mmphf_get_bits(zfast_trie_distributor_mmphf, bits, lcp_mmphf_byte_array_to_bits(key, len, bits));
+	if (bits != buffer) free(bits);
+	return result;
+}
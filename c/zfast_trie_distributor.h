@@ -0,0 +1,125 @@
+/*
+ * Sux: Succinct data structures
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ *  This library is free software; you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License as published by the Free
+ *  Software Foundation; either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  This library is distributed in the hope that it will be useful, but
+ *  WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ *  or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+ *  for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with this program; if not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ZFAST_TRIE_DISTRIBUTOR_H_INCLUDED
+#define ZFAST_TRIE_DISTRIBUTOR_H_INCLUDED
+
+#include <inttypes.h>
+#include "dump.h"
+#include "sf3.h"
+#include "rank9.h"
+#include "two_steps_lcp_mmphf.h"
+
+/* A view of a z-fast-trie distributor dump (see ZFastTrieDistributor.dump() in Java), which maps a
+   key to its bucket. The behaviour function tells whether a key exits the trie on the bucket
+   delimiters to the left or to the right; the exit node is found by a fat binary search on the
+   prefixes of the key, whose hashes are computed in constant time (see
+   spooky_short_bits_prefix()), using a function mapping the handle of each node to the length and
+   to a signature of its string, whereas the keys on which the search fails (recognized by the
+   32-bit signatures of the mistakes) are mapped to the length by the correction function. A
+   string derived from the exit node is then ranked among the leaves of the trie by an embedded
+   two-step LCP monotone minimal perfect hash function, built using TransformationStrategies.prefixFree()
+   (which maps each bit b to the bits one and b, and appends a zero), and the rank is mapped to a
+   bucket by a Rank9 on the leaves that are delimiters. The lookup code uses the generic code of
+   sf3.c, so it must not be compiled with SF_8. */
+typedef struct {
+	uint64_t size;
+	uint64_t num_delimiters;
+	uint64_t global_seed; // The seed of the behaviour function
+	int no_delimiters; // If true, every key is in the first bucket
+	int empty_trie; // If true, the bucket is given by the behaviour function
+	int log_w; // The number of bits used to store the length of a node string
+	uint64_t log_w_mask;
+	int signature_size; // The number of bits of the signature of a node string
+	uint64_t signature_mask;
+	sf behaviour;
+	sf signatures; // Handles to lengths (lower log_w bits) and signatures of node strings
+	sf corrections;
+	rank9 leaves;
+	uint64_t num_mistakes;
+	const int32_t *mistakes; // Sorted
+	two_steps_lcp_mmphf ranker;
+	void *map; // The mapping, if loaded by load_zfast_trie_distributor()
+	uint64_t map_length;
+} zfast_trie_distributor;
+
+/* A view of a z-fast-trie distributor-based monotone minimal perfect hash function dump (see
+   ZFastTrieDistributorMonotoneMinimalPerfectHashFunction.dump() in Java): the distributor,
+   embedded in a section, maps a key to its bucket, and a function maps the key to its offset in
+   the bucket (the lower log2_bucket_size bits of the rank). */
+typedef struct {
+	uint64_t size;
+	int log2_bucket_size;
+	uint64_t global_seed;
+	int signature_width;
+	uint64_t signature_mask;
+	sf offset; // A function of width zero always returns zero
+	zfast_trie_distributor distributor;
+	uint64_t signatures_length;
+	const uint64_t *signatures;
+	void *map; // The mapping, if loaded by load_zfast_trie_distributor_mmphf()
+	uint64_t map_length;
+} zfast_trie_distributor_mmphf;
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a z-fast-trie distributor dump. */
+zfast_trie_distributor *load_zfast_trie_distributor(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_zfast_trie_distributor(const void *dump, uint64_t length, zfast_trie_distributor *zfast_trie_distributor);
+/* Maps a distributor and validates it (see zfast_trie_distributor_validate()); returns NULL if the dump is not valid. */
+zfast_trie_distributor *load_zfast_trie_distributor_validated(int h);
+/* Maps a distributor and starts verifying it in the background (see dump.h); the embedded ranker
+   is verified as a whole section. */
+zfast_trie_distributor *load_zfast_trie_distributor_verify(int h, dump_verifier *verifier);
+/* Checks the functions (see sf_validate()), the Rank9 on the leaves (see rank9_validate()) and the
+   ranker (see two_steps_lcp_mmphf_validate()), that the widths of the functions agree with the
+   number of bits of lengths and signatures, that the mistakes are sorted and that the ranker maps
+   to leaves; returns zero if valid. */
+int zfast_trie_distributor_validate(const zfast_trie_distributor *zfast_trie_distributor);
+/* Returns the bucket of a key of given length in bits, or -1 if the key can be recognized as not
+   belonging to the key set (an arbitrary bucket otherwise), given its signature and its state
+   (see spooky_short_bits_preprocess()), both computed using the seed of the distributor. */
+int64_t zfast_trie_distributor_get(const zfast_trie_distributor *zfast_trie_distributor, const uint64_t *bits, uint64_t length, const uint64_t signature[4], const uint64_t *state);
+/* As zfast_trie_distributor_get(), but hashes the key. */
+int64_t zfast_trie_distributor_get_bits(const zfast_trie_distributor *zfast_trie_distributor, const uint64_t *bits, uint64_t length);
+
+/* Maps a dump in memory (no copy); returns NULL if the dump is not a z-fast-trie distributor-based
+   monotone minimal perfect hash function dump. */
+zfast_trie_distributor_mmphf *load_zfast_trie_distributor_mmphf(int h);
+/* Fills a view of a container mapped in memory (e.g., a member of a catalog, see catalog.h);
+   returns zero on success. */
+int map_zfast_trie_distributor_mmphf(const void *dump, uint64_t length, zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf);
+/* Maps a function and validates it (see zfast_trie_distributor_mmphf_validate()); returns NULL if the dump is not valid. */
+zfast_trie_distributor_mmphf *load_zfast_trie_distributor_mmphf_validated(int h);
+/* Maps a function and starts verifying it in the background (see dump.h); the embedded
+   distributor is verified as a whole section. */
+zfast_trie_distributor_mmphf *load_zfast_trie_distributor_mmphf_verify(int h, dump_verifier *verifier);
+/* Checks the offset function (see sf_validate()) and the distributor (see
+   zfast_trie_distributor_validate()), that the seeds agree and that the signatures cover all keys;
+   returns zero if valid. */
+int zfast_trie_distributor_mmphf_validate(const zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf);
+/* Returns the rank of a key of given length in bits, or -1 if the key can be recognized as not
+   belonging to the key set. */
+int64_t zfast_trie_distributor_mmphf_get_bits(const zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf, const uint64_t *bits, uint64_t length);
+/* As zfast_trie_distributor_mmphf_get_bits(), for a function built using
+   TransformationStrategies.prefixFreeByteArray() (see lcp_mmphf_byte_array_to_bits()). */
+int64_t zfast_trie_distributor_mmphf_get_byte_array(const zfast_trie_distributor_mmphf *zfast_trie_distributor_mmphf, const char *key, uint64_t len);
+
+#endif /* ZFAST_TRIE_DISTRIBUTOR_H_INCLUDED */
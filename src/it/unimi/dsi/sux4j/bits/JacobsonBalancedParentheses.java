@@ -33,6 +33,7 @@ import it.unimi.dsi.bits.BitVector;
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongArrayList;
 import it.unimi.dsi.lang.MutableString;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.mph.HollowTrieMonotoneMinimalPerfectHashFunction;
 import it.unimi.dsi.sux4j.util.EliasFanoLongBigList;
 
@@ -662,6 +663,23 @@ public class JacobsonBalancedParentheses implements BalancedParentheses {
 			(closingPioneers != null ? closingPioneers.numBits() + closingPioneersRank.numBits() + closingPioneerMatches.numBits() : 0);
 	}
 
+	/**
+	 * Dumps the parentheses in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The only parameter is the length of the bit vector, and the only section contains its bits: the
+	 * C implementation builds at load time a range min-max directory in place of the pioneers, and
+	 * provides also {@link #findOpen(long)}, {@link #enclose(long)} and tree navigation.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.BALANCED_PARENTHESES, 0, 0)) {
+			dump.param(bitVector.length());
+			dump.section(bitVector);
+		}
+	}
+
 	private void readObject(final ObjectInputStream s) throws IOException, ClassNotFoundException {
 		s.defaultReadObject();
 		bits = bitVector.bits();
@@ -29,6 +29,7 @@ import java.io.ObjectInputStream;
 import it.unimi.dsi.bits.BitVector;
 import it.unimi.dsi.bits.Fast;
 import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A <code>rank9</code> implementation.
  *
@@ -147,6 +148,30 @@ public class Rank9 extends AbstractRank implements Rank {
 		return lastOne;
 	}
 
+	/**
+	 * Dumps this structure in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.RANK9, 0, 0)) {
+			dump(dump);
+		}
+	}
+
+	/**
+	 * Appends the parameters and the sections of this structure to a dump, so that it can be
+	 * embedded in the dump of a structure using it.
+	 *
+	 * @param dump a dump.
+	 * @see #dump(String)
+	 */
+	public void dump(final NativeDump dump) throws IOException {
+		dump.param(bitVector.length(), numOnes, lastOne);
+		dump.section(bitVector);
+		dump.section(count);
+	}
+
 	private void readObject(final ObjectInputStream s) throws IOException, ClassNotFoundException {
 		s.defaultReadObject();
 		bits = bitVector.bits();
@@ -31,6 +31,7 @@ import it.unimi.dsi.bits.Fast;
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.bits.LongBigArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongBigList;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A <code>select9</code> implementation.
  *
@@ -283,6 +284,20 @@ public class Select9 implements Select {
 		return rank9.numBits() + bits(inventory.length) + bits(subinventory.length);
 	}
 
+	/**
+	 * Dumps this structure, together with the underlying {@link Rank9}, in the {@linkplain NativeDump
+	 * native format} used by the C implementation.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.SELECT9, 0, 0)) {
+			rank9.dump(dump);
+			dump.section(inventory);
+			dump.section(subinventory);
+		}
+	}
+
 	private void readObject(final ObjectInputStream s) throws IOException, ClassNotFoundException {
 		s.defaultReadObject();
 		bits = rank9.bitVector.bits();
@@ -31,6 +31,7 @@ import it.unimi.dsi.bits.Fast;
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongArrays;
 import it.unimi.dsi.fastutil.longs.LongBigList;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.util.EliasFanoMonotoneLongBigList;
 
 /** A simple select implementation based on a two-level inventory, a spill list and broadword bit search.
@@ -338,6 +339,38 @@ public class SimpleSelect implements Select {
 		return select(rank, dest, 0, dest.length);
 	}
 
+	/**
+	 * Dumps this structure, together with the underlying bit vector, in the {@linkplain NativeDump
+	 * native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the length of the bit vector, the number of ones and the logarithm of the
+	 * number of ones per inventory entry (the other sizes are derived from it); the sections are
+	 * the bits, the inventory, the subinventory and the exact spill.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.SIMPLE_SELECT, 0, 0)) {
+			dump(dump);
+		}
+	}
+
+	/**
+	 * Appends the parameters and the sections of this structure to a dump, so that it can be
+	 * embedded in the dump of a structure using it.
+	 *
+	 * @param dump a dump.
+	 * @see #dump(String)
+	 */
+	public void dump(final NativeDump dump) throws IOException {
+		dump.param(bitVector.length(), numOnes, log2OnesPerInventory);
+		dump.section(bitVector);
+		dump.section(inventory);
+		dump.section(subinventory);
+		dump.section(exactSpill);
+	}
+
 	private void readObject(final ObjectInputStream s) throws IOException, ClassNotFoundException {
 		s.defaultReadObject();
 		subinventory16 = LongArrayBitVector.wrap(subinventory).asLongBigList(Short.SIZE);
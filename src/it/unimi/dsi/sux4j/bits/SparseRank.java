@@ -31,6 +31,7 @@ import it.unimi.dsi.bits.Fast;
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongBigList;
 import it.unimi.dsi.fastutil.longs.LongIterator;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.util.EliasFanoMonotoneLongBigList;
 
 /** A rank implementation for sparse bit arrays based on the {@linkplain EliasFanoMonotoneLongBigList Elias&ndash;Fano representation of monotone functions}.
@@ -215,6 +216,39 @@ public class SparseRank extends AbstractRank {
 		return result;
 	}
 
+	/**
+	 * Dumps this structure in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The layout is that of a {@linkplain SparseSelect#dump(String) dump of a sparse select}, but
+	 * the upper bits are followed by the inventories of a {@link SimpleSelectZero}: the parameters
+	 * are the number of ones and of lower bits, followed by those of the
+	 * {@linkplain SimpleSelectZero#dump(NativeDump) selection structure} on the upper bits, and the
+	 * number of bits of the underlying bit vector; the first section contains the lower bits, and
+	 * the following ones are those of the selection structure.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.SPARSE_RANK, 0, 0)) {
+			dump(dump);
+		}
+	}
+
+	/**
+	 * Appends the parameters and the sections of this structure to a dump, so that it can be
+	 * embedded in the dump of a structure using it.
+	 *
+	 * @param dump a dump.
+	 * @see #dump(String)
+	 */
+	public void dump(final NativeDump dump) throws IOException {
+		dump.param(m, l);
+		dump.section(lowerBits);
+		selectZeroUpper.dump(dump);
+		dump.param(n);
+	}
+
 	private void readObject(final ObjectInputStream s) throws IOException, ClassNotFoundException {
 		s.defaultReadObject();
 		// A fix that avoids bumping the serial id from 2L
@@ -22,11 +22,14 @@ package it.unimi.dsi.sux4j.bits;
 import static it.unimi.dsi.bits.LongArrayBitVector.bit;
 import static it.unimi.dsi.bits.LongArrayBitVector.word;
 
+import java.io.IOException;
+
 import it.unimi.dsi.bits.BitVector;
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongBigList;
 import it.unimi.dsi.fastutil.longs.LongIterator;
 import it.unimi.dsi.fastutil.longs.LongList;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.util.EliasFanoMonotoneLongBigList;
 
 /** A select implementation for sparse bit arrays based on the {@linkplain EliasFanoMonotoneLongBigList Elias&ndash;Fano representation of monotone functions}.
@@ -168,6 +171,24 @@ public class SparseSelect extends EliasFanoMonotoneLongBigList implements Select
 		return result;
 	}
 
+	/**
+	 * Dumps this structure in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters and the sections are those of the {@linkplain EliasFanoMonotoneLongBigList#dump(String)
+	 * dump of the underlying list} of the positions of the ones, followed by the number of bits of the
+	 * underlying bit vector.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	@Override
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.SPARSE_SELECT, 0, 0)) {
+			dump(dump);
+			dump.param(n);
+		}
+	}
+
 	@Override
 	public int hashCode() {
 		return System.identityHashCode(this);
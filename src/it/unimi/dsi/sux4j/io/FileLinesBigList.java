@@ -20,6 +20,7 @@
 package it.unimi.dsi.sux4j.io;
 
 import java.io.Closeable;
+import java.io.File;
 import java.io.FileInputStream;
 import java.io.FileNotFoundException;
 import java.io.IOException;
@@ -210,6 +211,27 @@ public class FileLinesBigList extends AbstractObjectBigList<MutableString> imple
 		}
 	}
 
+	/**
+	 * Dumps the starts of the lines of this list in the {@linkplain NativeDump native format} used by
+	 * the C implementation, which maps the file itself and returns lines without copying.
+	 *
+	 * <p>
+	 * The parameters and the sections are those of the {@linkplain EliasFanoMonotoneLongBigList#dump(String)
+	 * dump of the list} of the starts of the lines, whose sentinel is the length of the file, followed
+	 * by the length of the file and by the line terminators, as a mask in which {@link LineTerminator#CR},
+	 * {@link LineTerminator#LF} and {@link LineTerminator#CR_LF} are represented by 1, 2 and 4.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.FILE_LINES, 0, 0)) {
+			borders.dump(dump);
+			int mask = 0;
+			for (final LineTerminator terminator : terminators) mask |= terminator == LineTerminator.CR ? 1 : terminator == LineTerminator.LF ? 2 : 4;
+			dump.param(new File(filename).length(), mask);
+		}
+	}
+
 	/** An iterator over the lines of a {@link FileLinesBigList}. Instances of this
 	 * class open an {@link java.io.InputStream}, and thus should be {@linkplain Closeable#close() closed} after
 	 * usage. A &ldquo;safety-net&rdquo; finaliser tries to take care of the cases in which
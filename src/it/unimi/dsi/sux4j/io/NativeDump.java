@@ -0,0 +1,485 @@
+/*
+ * Sux4J: Succinct data structures for Java
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the GNU Lesser General Public License v2.1 or later,
+ * which is available at
+ * http://www.gnu.org/licenses/old-licenses/lgpl-2.1-standalone.html,
+ * or the Apache Software License 2.0, which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later OR Apache-2.0
+ */
+
+package it.unimi.dsi.sux4j.io;
+
+import java.io.Closeable;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.FileChannel;
+
+import it.unimi.dsi.bits.BitVector;
+import it.unimi.dsi.bits.TransformationStrategies;
+import it.unimi.dsi.bits.TransformationStrategy;
+import it.unimi.dsi.fastutil.longs.LongIterable;
+
+/**
+ * A writer for the self-describing binary container used by the C implementations of Sux4J data
+ * structures (see the <code>c</code> directory of the distribution).
+ *
+ * <p>
+ * A dump starts with a header of {@link #ALIGNMENT} bytes containing a {@linkplain #MAGIC magic
+ * number}, the {@linkplain #VERSION format version}, the kind of structure, its arity and width,
+ * the transformation strategy and the hash function used for the keys, up to {@link #MAX_PARAMS}
+ * scalar parameters and a table of up to {@link #MAX_SECTIONS} sections. Each section is described
+ * by its offset, its length in bytes and a checksum. Sections start at offsets that are multiples
+ * of {@link #ALIGNMENT}, so that a dump can be mapped into memory and used directly. All data is
+ * written in native byte order.
+ *
+ * <p>
+ * Checksums are computed using the {@linkplain #FAST_CHECKSUM fast checksum}, which processes
+ * the section as a sequence of 64-bit words (the last one padded with zeroes) in four independent
+ * lanes, so that it can be verified at memory speed.
+ *
+ * <p>
+ * The header layout is the following (all offsets in bytes):
+ *
+ * <pre>
+ *   0 magic (64 bits)
+ *   8 version (32 bits), kind (32 bits)
+ *  16 arity (32 bits), width (32 bits)
+ *  24 strategy (32 bits), hash (32 bits)
+ *  32 checksum algorithm (32 bits), number of sections (32 bits)
+ *  40 parameters (16 &times; 64 bits)
+ * 168 sections (16 &times; (offset, length, checksum), 64 bits each)
+ * </pre>
+ *
+ * <p>
+ * Typical usage:
+ *
+ * <pre>
+ * try (final NativeDump dump = new NativeDump(file, NativeDump.MPH, 3, 2, NativeDump.strategy(transform))) {
+ * 	dump.param(n, multiplier, globalSeed);
+ * 	dump.section(edgeOffsetAndSeed);
+ * 	dump.section(array);
+ * }
+ * </pre>
+ *
+ * @author Sebastiano Vigna
+ * @since 5.2.4
+ */
+
+public class NativeDump implements Closeable {
+	/** A structure that can be dumped to a file, and thus {@linkplain NativeDump#embed(Dumpable) embedded} in a dump. */
+	@FunctionalInterface
+	public interface Dumpable {
+		/**
+		 * Dumps the structure.
+		 *
+		 * @param file the name of the dump file.
+		 */
+		void dump(String file) throws IOException;
+	}
+
+	/** The magic number: the string <code>SUX4JDMP</code> read as a little-endian long. */
+	public static final long MAGIC = 0x504D444A34585553L;
+	/** The current version of the format. */
+	public static final int VERSION = 1;
+	/** The alignment of the header and of the sections. */
+	public static final int ALIGNMENT = 4096;
+	/** The maximum number of parameters. */
+	public static final int MAX_PARAMS = 16;
+	/** The maximum number of sections. */
+	public static final int MAX_SECTIONS = 16;
+
+	/** The offset in the header of the format version (the magic number is at offset zero). */
+	public static final int VERSION_OFFSET = 8;
+	/** The offset in the header of the kind of structure. */
+	public static final int KIND_OFFSET = 12;
+	/** The offset in the header of the arity. */
+	public static final int ARITY_OFFSET = 16;
+	/** The offset in the header of the width. */
+	public static final int WIDTH_OFFSET = 20;
+	/** The offset in the header of the transformation strategy. */
+	public static final int STRATEGY_OFFSET = 24;
+	/** The offset in the header of the hash function. */
+	public static final int HASH_OFFSET = 28;
+	/** The offset in the header of the checksum algorithm. */
+	public static final int CHECKSUM_OFFSET = 32;
+	/** The offset in the header of the number of sections. */
+	public static final int NUM_SECTIONS_OFFSET = 36;
+	/** The offset in the header of the parameters, 64 bits each. */
+	public static final int PARAMS_OFFSET = 40;
+	/** The offset in the header of the section table. */
+	public static final int SECTIONS_OFFSET = PARAMS_OFFSET + MAX_PARAMS * Long.BYTES;
+	/** The size of an entry of the section table (offset, length and checksum, 64 bits each). */
+	public static final int SECTION_ENTRY_SIZE = 3 * Long.BYTES;
+
+	/** A {@link it.unimi.dsi.sux4j.mph.GOVMinimalPerfectHashFunction}. */
+	public static final int MPH = 1;
+	/** A {@link it.unimi.dsi.sux4j.mph.GOV3Function} or a {@link it.unimi.dsi.sux4j.mph.GOV4Function}. */
+	public static final int SF = 2;
+	/** A {@link it.unimi.dsi.sux4j.mph.GV3CompressedFunction} or a {@link it.unimi.dsi.sux4j.mph.GV4CompressedFunction}. */
+	public static final int CSF = 3;
+	/** A {@link it.unimi.dsi.sux4j.bits.Rank9}. */
+	public static final int RANK9 = 4;
+	/** A {@link it.unimi.dsi.sux4j.bits.Select9} (the sections of the underlying {@link it.unimi.dsi.sux4j.bits.Rank9} come first). */
+	public static final int SELECT9 = 5;
+	/** A {@link it.unimi.dsi.sux4j.bits.SimpleSelect}. */
+	public static final int SIMPLE_SELECT = 6;
+	/** A {@link it.unimi.dsi.sux4j.bits.SimpleSelectZero}. */
+	public static final int SIMPLE_SELECT_ZERO = 7;
+	/** An {@link it.unimi.dsi.sux4j.util.EliasFanoMonotoneLongBigList} (the sections of the {@link it.unimi.dsi.sux4j.bits.SimpleSelect} on the upper bits follow the lower bits). */
+	public static final int ELIAS_FANO = 8;
+	/** An {@link it.unimi.dsi.sux4j.util.EliasFanoIndexedMonotoneLongBigList} (the inventories of the {@link it.unimi.dsi.sux4j.bits.SimpleSelectZero} on the upper bits follow the sections of an {@link #ELIAS_FANO} dump). */
+	public static final int ELIAS_FANO_INDEXED = 9;
+	/** A {@link it.unimi.dsi.sux4j.util.PartitionedEliasFanoMonotoneLongBigList}. */
+	public static final int PARTITIONED_ELIAS_FANO = 10;
+	/** A {@link it.unimi.dsi.sux4j.util.TwoSizesLongBigList} (the sections of the {@link it.unimi.dsi.sux4j.bits.Rank9} on the marker follow those of the small and large elements, if there are large elements). */
+	public static final int TWO_SIZES = 11;
+	/** A {@link it.unimi.dsi.sux4j.bits.SparseRank} (laid out as a {@link #SPARSE_SELECT} dump, but with a {@link it.unimi.dsi.sux4j.bits.SimpleSelectZero} on the upper bits). */
+	public static final int SPARSE_RANK = 12;
+	/** A {@link it.unimi.dsi.sux4j.bits.SparseSelect} (an {@link #ELIAS_FANO} dump followed by the length of the underlying bit vector). */
+	public static final int SPARSE_SELECT = 13;
+	/** A {@link it.unimi.dsi.sux4j.bits.JacobsonBalancedParentheses} (just the parentheses: the C implementation builds its own directory). */
+	public static final int BALANCED_PARENTHESES = 14;
+	/** A {@link it.unimi.dsi.sux4j.mph.CHDMinimalPerfectHashFunction} (the sections of the displacement coefficients and of the {@link it.unimi.dsi.sux4j.bits.SparseRank} on the holes follow the chunk descriptors). */
+	public static final int CHD = 15;
+	/** A {@link it.unimi.dsi.sux4j.mph.TwoStepsGOV3Function} (the sections of the first {@link #SF} function, if any, and the remap table precede those of the second function). */
+	public static final int TWO_STEPS_SF = 16;
+	/** A {@link it.unimi.dsi.sux4j.mph.LcpMonotoneMinimalPerfectHashFunction} (the sections of the two {@link #SF} functions precede the signatures). */
+	public static final int LCP_MMPHF = 17;
+	/** A {@link it.unimi.dsi.sux4j.mph.HollowTrieMonotoneMinimalPerfectHashFunction} (the sections of the {@link it.unimi.dsi.sux4j.util.EliasFanoLongBigList} of skips precede the trie). */
+	public static final int HOLLOW_TRIE = 18;
+	/** A {@link it.unimi.dsi.sux4j.mph.HollowTrieDistributor} (a {@link #HOLLOW_TRIE} dump followed by the two {@link #SF} functions of the distributor). */
+	public static final int HOLLOW_TRIE_DISTRIBUTOR = 19;
+	/** A {@link it.unimi.dsi.sux4j.mph.HollowTrieDistributorMonotoneMinimalPerfectHashFunction} (the sections of the {@link #SF} offset function precede an {@linkplain #embed(Dumpable) embedded} {@link #HOLLOW_TRIE_DISTRIBUTOR} dump). */
+	public static final int HOLLOW_TRIE_DISTRIBUTOR_MMPHF = 20;
+	/** A {@link it.unimi.dsi.sux4j.mph.TwoStepsLcpMonotoneMinimalPerfectHashFunction} (the sections of the two {@link #SF} functions precede an {@linkplain #embed(Dumpable) embedded} {@link #TWO_STEPS_SF} dump and the signatures). */
+	public static final int TWO_STEPS_LCP_MMPHF = 21;
+	/** A {@link it.unimi.dsi.sux4j.mph.ZFastTrieDistributor} (the sections of three {@link #SF} functions and of a {@link #RANK9} precede the mistake signatures and an {@linkplain #embed(Dumpable) embedded} {@link #TWO_STEPS_LCP_MMPHF} dump). */
+	public static final int ZFAST_TRIE_DISTRIBUTOR = 22;
+	/** A {@link it.unimi.dsi.sux4j.mph.ZFastTrieDistributorMonotoneMinimalPerfectHashFunction} (the sections of the {@link #SF} offset function precede an {@linkplain #embed(Dumpable) embedded} {@link #ZFAST_TRIE_DISTRIBUTOR} dump and the signatures). */
+	public static final int ZFAST_TRIE_DISTRIBUTOR_MMPHF = 23;
+	/** A frozen {@link it.unimi.dsi.sux4j.util.ZFastTrie} (the sections of the nodes, of the keys and of the {@link #ELIAS_FANO} list of their offsets precede an {@linkplain #embed(Dumpable) embedded} {@link #MPH} dump mapping handles to nodes). */
+	public static final int ZFAST_TRIE = 24;
+	/** A signed {@link it.unimi.dsi.sux4j.mph.GOVMinimalPerfectHashFunction} (an {@link #MPH} dump followed by the signature width and by the signatures). */
+	public static final int SIGNED_MPH = 25;
+	/** A {@link it.unimi.dsi.sux4j.mph.GOV3Function} or a {@link it.unimi.dsi.sux4j.mph.GOV4Function} built as an {@linkplain it.unimi.dsi.sux4j.mph.GOV3Function.Builder#dictionary(int) approximate dictionary} (laid out as an {@link #SF} dump whose width is the fingerprint width). */
+	public static final int FILTER = 26;
+	/** A {@link it.unimi.dsi.sux4j.io.FileLinesBigList} (an {@link #ELIAS_FANO} dump of the starts of the lines followed by the length of the file and by its line terminators). */
+	public static final int FILE_LINES = 27;
+
+	/** An unknown transformation strategy. */
+	public static final int UNKNOWN_STRATEGY = 0;
+	/** The {@linkplain TransformationStrategies#rawByteArray() raw byte-array transformation strategy}. */
+	public static final int RAW_BYTE_ARRAY = 1;
+	/** The {@linkplain TransformationStrategies#rawFixedLong() raw long transformation strategy}. */
+	public static final int RAW_LONG = 2;
+	/** The {@linkplain TransformationStrategies#prefixFreeByteArray() prefix-free byte-array transformation strategy}. */
+	public static final int PREFIX_FREE_BYTE_ARRAY = 3;
+	/** The {@linkplain TransformationStrategies#prefixFree() prefix-free bit-vector transformation strategy}. */
+	public static final int PREFIX_FREE = 4;
+
+	/** No hash function. */
+	public static final int NO_HASH = 0;
+	/** SpookyHash V2 (short version), as implemented by {@link it.unimi.dsi.sux4j.mph.Hashes#spooky4(it.unimi.dsi.bits.BitVector, long, long[])}. */
+	public static final int SPOOKY_V2 = 1;
+
+	/** No checksum. */
+	public static final int NO_CHECKSUM = 0;
+	/**
+	 * A fast 64-bit checksum: word <var>i</var> of a section is accumulated in lane <var>i</var> mod 4
+	 * using an xxHash64 round; lanes are then merged and the result is finalized with the section length
+	 * using MurmurHash3's finalizer.
+	 */
+	public static final int FAST_CHECKSUM = 1;
+
+	private static final long PRIME64_1 = 0x9E3779B185EBCA87L;
+	private static final long PRIME64_2 = 0xC2B2AE3D27D4EB4FL;
+
+	/** The stream underlying {@link #channel}. */
+	private final FileOutputStream fos;
+	/** The channel used to write the dump. */
+	private final FileChannel channel;
+	/** A buffer for the section being written. */
+	private final ByteBuffer buffer;
+	/** The kind of structure. */
+	private final int kind;
+	/** The arity of the structure, or zero. */
+	private final int arity;
+	/** The width of the structure, or zero. */
+	private final int width;
+	/** The transformation strategy of the structure. */
+	private final int strategy;
+	/** The hash function of the structure. */
+	private final int hash;
+	/** The parameters. */
+	private final long[] param = new long[MAX_PARAMS];
+	/** The number of parameters. */
+	private int numParams;
+	/** The offsets of the sections. */
+	private final long[] offset = new long[MAX_SECTIONS];
+	/** The lengths of the sections in bytes. */
+	private final long[] length = new long[MAX_SECTIONS];
+	/** The checksums of the sections. */
+	private final long[] checksum = new long[MAX_SECTIONS];
+	/** The number of sections. */
+	private int numSections;
+	/** The lanes of the checksum of the section being written. */
+	private final long[] lane = new long[4];
+	/** The number of words accumulated in {@link #lane}. */
+	private long words;
+	/** The position of the next byte to be written. */
+	private long position;
+
+	/**
+	 * Creates a new dump for a structure that does not hash keys.
+	 *
+	 * @param file the name of the dump file.
+	 * @param kind the kind of structure.
+	 * @param arity the arity of the structure, or zero.
+	 * @param width the width of the structure, or zero.
+	 */
+	public NativeDump(final String file, final int kind, final int arity, final int width) throws IOException {
+		this(file, kind, arity, width, UNKNOWN_STRATEGY, NO_HASH);
+	}
+
+	/**
+	 * Creates a new dump for a structure hashing keys with {@linkplain #SPOOKY_V2 SpookyHash}.
+	 *
+	 * @param file the name of the dump file.
+	 * @param kind the kind of structure.
+	 * @param arity the arity of the structure (e.g., 3 or 4 for functions), or zero.
+	 * @param width the width of the structure (e.g., the output width of a function), or zero.
+	 * @param strategy the transformation strategy, as returned by {@link #strategy(TransformationStrategy)}.
+	 */
+	public NativeDump(final String file, final int kind, final int arity, final int width, final int strategy) throws IOException {
+		this(file, kind, arity, width, strategy, SPOOKY_V2);
+	}
+
+	/**
+	 * Creates a new dump.
+	 *
+	 * @param file the name of the dump file.
+	 * @param kind the kind of structure.
+	 * @param arity the arity of the structure (e.g., 3 or 4 for functions), or zero.
+	 * @param width the width of the structure (e.g., the output width of a function), or zero.
+	 * @param strategy the transformation strategy, as returned by {@link #strategy(TransformationStrategy)}.
+	 * @param hash the hash function used on the keys.
+	 */
+	public NativeDump(final String file, final int kind, final int arity, final int width, final int strategy, final int hash) throws IOException {
+		this.kind = kind;
+		this.arity = arity;
+		this.width = width;
+		this.strategy = strategy;
+		this.hash = hash;
+		fos = new FileOutputStream(file);
+		channel = fos.getChannel();
+		buffer = ByteBuffer.allocateDirect(1024 * 1024).order(ByteOrder.nativeOrder());
+		position = ALIGNMENT;
+	}
+
+	/**
+	 * Returns the identifier of a transformation strategy.
+	 *
+	 * @param transform a transformation strategy.
+	 * @return {@link #RAW_BYTE_ARRAY}, {@link #RAW_LONG}, {@link #PREFIX_FREE_BYTE_ARRAY}, {@link #PREFIX_FREE} or {@link #UNKNOWN_STRATEGY}.
+	 */
+	public static int strategy(final TransformationStrategy<?> transform) {
+		if (transform == TransformationStrategies.rawByteArray()) return RAW_BYTE_ARRAY;
+		if (transform == TransformationStrategies.rawFixedLong()) return RAW_LONG;
+		if (transform == TransformationStrategies.prefixFreeByteArray()) return PREFIX_FREE_BYTE_ARRAY;
+		if (transform == TransformationStrategies.prefixFree()) return PREFIX_FREE;
+		return UNKNOWN_STRATEGY;
+	}
+
+	/**
+	 * Appends parameters to the header.
+	 *
+	 * @param value the parameters to append.
+	 */
+	public void param(final long... value) {
+		if (numParams + value.length > MAX_PARAMS) throw new IllegalStateException("Too many parameters");
+		for (final long v : value) param[numParams++] = v;
+	}
+
+	private void beginSection() throws IOException {
+		if (numSections == MAX_SECTIONS) throw new IllegalStateException("Too many sections");
+		position = position + ALIGNMENT - 1 & -ALIGNMENT;
+		offset[numSections] = position;
+		buffer.clear();
+		lane[0] = PRIME64_1 + PRIME64_2;
+		lane[1] = PRIME64_2;
+		lane[2] = 0;
+		lane[3] = -PRIME64_1;
+		words = 0;
+	}
+
+	private void accumulate(final long word) {
+		final int l = (int)(words++ & 3);
+		lane[l] = Long.rotateLeft(lane[l] + word * PRIME64_2, 31) * PRIME64_1;
+	}
+
+	private void flush() throws IOException {
+		buffer.flip();
+		final int limit = buffer.limit();
+		int i;
+		for (i = 0; i + Long.BYTES <= limit; i += Long.BYTES) accumulate(buffer.getLong(i));
+		if (i < limit) { // Partial word, only at the end of a section
+			final ByteBuffer last = ByteBuffer.allocate(Long.BYTES).order(buffer.order());
+			while (i < limit) last.put(buffer.get(i++));
+			accumulate(last.getLong(0));
+		}
+		while (buffer.hasRemaining()) position += channel.write(buffer, position);
+		buffer.clear();
+	}
+
+	private void endSection() throws IOException {
+		flush();
+		length[numSections] = position - offset[numSections];
+		checksum[numSections] = checksum(lane, length[numSections]);
+		numSections++;
+	}
+
+	private void putLong(final long l) throws IOException {
+		if (buffer.remaining() < Long.BYTES) flush();
+		buffer.putLong(l);
+	}
+
+	/**
+	 * Appends a section containing an array of longs.
+	 *
+	 * @param a an array.
+	 */
+	public void section(final long[] a) throws IOException {
+		beginSection();
+		for (final long l : a) putLong(l);
+		endSection();
+	}
+
+	/**
+	 * Appends a section containing a sequence of longs.
+	 *
+	 * @param a an iterable on longs.
+	 */
+	public void section(final LongIterable a) throws IOException {
+		beginSection();
+		for (final long l : a) putLong(l);
+		endSection();
+	}
+
+	/**
+	 * Appends a section containing the bits of a bit vector, padded with zeroes to a multiple of
+	 * {@link Long#SIZE}.
+	 *
+	 * @param v a bit vector.
+	 */
+	public void section(final BitVector v) throws IOException {
+		beginSection();
+		final long length = v.length();
+		for (long i = 0; i < length; i += Long.SIZE) putLong(v.getLong(i, Math.min(i + Long.SIZE, length)));
+		endSection();
+	}
+
+	/**
+	 * Appends a section containing an array of integers.
+	 *
+	 * @param a an array.
+	 */
+	public void section(final int[] a) throws IOException {
+		beginSection();
+		for (final int i : a) {
+			if (buffer.remaining() < Integer.BYTES) flush();
+			buffer.putInt(i);
+		}
+		endSection();
+	}
+
+	/**
+	 * Appends a section containing an array of bytes.
+	 *
+	 * @param a an array.
+	 */
+	public void section(final byte[] a) throws IOException {
+		beginSection();
+		for (final byte b : a) {
+			if (!buffer.hasRemaining()) flush();
+			buffer.put(b);
+		}
+		endSection();
+	}
+
+	/**
+	 * Appends a section containing the complete dump of a structure, so that a structure can embed
+	 * structures whose parameters and sections would not fit in its header.
+	 *
+	 * <p>
+	 * The dump is written to a temporary file and then copied. Since sections start at offsets that
+	 * are multiples of {@link #ALIGNMENT}, the C implementation can map the embedded dump in place.
+	 *
+	 * @param structure a structure.
+	 */
+	public void embed(final Dumpable structure) throws IOException {
+		final File file = File.createTempFile(NativeDump.class.getSimpleName(), ".dump");
+		try {
+			structure.dump(file.toString());
+			beginSection();
+			try (final FileInputStream fis = new FileInputStream(file); final FileChannel in = fis.getChannel()) {
+				while (in.read(buffer) != -1) if (!buffer.hasRemaining()) flush();
+			}
+			endSection();
+		} finally {
+			file.delete();
+		}
+	}
+
+	private static long checksum(final long[] lane, final long length) {
+		long h = Long.rotateLeft(lane[0], 1) + Long.rotateLeft(lane[1], 7) + Long.rotateLeft(lane[2], 12) + Long.rotateLeft(lane[3], 18);
+		h ^= length;
+		h ^= h >>> 33;
+		h *= 0xFF51AFD7ED558CCDL;
+		h ^= h >>> 33;
+		h *= 0xC4CEB9FE1A85EC53L;
+		h ^= h >>> 33;
+		return h;
+	}
+
+	/** Writes the header and closes the dump. */
+	@Override
+	public void close() throws IOException {
+		buffer.clear();
+		buffer.putLong(MAGIC);
+		buffer.putInt(VERSION);
+		buffer.putInt(kind);
+		buffer.putInt(arity);
+		buffer.putInt(width);
+		buffer.putInt(strategy);
+		buffer.putInt(hash);
+		buffer.putInt(FAST_CHECKSUM);
+		buffer.putInt(numSections);
+		assert buffer.position() == PARAMS_OFFSET;
+		for (final long p : param) buffer.putLong(p);
+		assert buffer.position() == SECTIONS_OFFSET;
+		for (int i = 0; i < MAX_SECTIONS; i++) {
+			buffer.putLong(offset[i]);
+			buffer.putLong(length[i]);
+			buffer.putLong(checksum[i]);
+		}
+		while (buffer.position() < ALIGNMENT) buffer.put((byte)0);
+		buffer.flip();
+		long p = 0;
+		while (buffer.hasRemaining()) p += channel.write(buffer, p);
+		fos.close();
+	}
+}
@@ -73,6 +73,7 @@ import it.unimi.dsi.io.OfflineIterable.Serializer;
 import it.unimi.dsi.lang.MutableString;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.bits.SparseRank;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.util.EliasFanoLongBigList;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandomGenerator;
 
@@ -636,6 +637,34 @@ public class CHDMinimalPerfectHashFunction<T> extends AbstractHashFunction<T> im
 		s.defaultReadObject();
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys, the shift for chunks, the global seed and the signature
+	 * width (zero for no signatures), followed by those of the
+	 * {@linkplain EliasFanoLongBigList#dump(NativeDump) displacement coefficients} and of the
+	 * {@linkplain SparseRank#dump(NativeDump) sparse rank} on the holes; the first section contains
+	 * the chunk descriptors (offset, cumulative number of buckets and seed of each chunk, plus the
+	 * offset and number of buckets of a final sentinel chunk), followed by the sections of the
+	 * coefficients and of the sparse rank, and by the signatures (empty if there are none), packed in
+	 * a bit vector.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		final int signatureWidth = Long.bitCount(signatureMask);
+		final LongArrayBitVector signatureBits = LongArrayBitVector.getInstance();
+		if (signatureWidth != 0) signatureBits.asLongBigList(signatureWidth).addAll(signatures);
+		try (final NativeDump dump = new NativeDump(file, NativeDump.CHD, 0, 0, NativeDump.strategy(transform))) {
+			dump.param(n, chunkShift, globalSeed, signatureWidth);
+			dump.section(offsetNumBucketsSeed);
+			coefficients.dump(dump);
+			rank.dump(dump);
+			dump.section(signatureBits);
+		}
+	}
+
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
 		final SimpleJSAP jsap = new SimpleJSAP(CHDMinimalPerfectHashFunction.class.getName(), "Builds a CHD minimal perfect hash function reading a newline-separated list of strings.",
 				new Parameter[] {
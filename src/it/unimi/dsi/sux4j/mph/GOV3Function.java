@@ -22,13 +22,9 @@ package it.unimi.dsi.sux4j.mph;
 import static it.unimi.dsi.bits.LongArrayBitVector.bits;
 
 import java.io.File;
-import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.Serializable;
-import java.nio.ByteBuffer;
-import java.nio.ByteOrder;
-import java.nio.channels.FileChannel;
 import java.nio.charset.Charset;
 import java.util.Arrays;
 import java.util.Iterator;
@@ -82,6 +78,7 @@ import it.unimi.dsi.sux4j.bits.Rank16;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
 import it.unimi.dsi.sux4j.io.BucketedHashStore.Bucket;
 import it.unimi.dsi.sux4j.io.BucketedHashStore.DuplicateException;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.mph.solve.Linear3SystemSolver;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandomGenerator;
 import it.unimi.dsi.util.concurrent.ReorderingBlockingQueue;
@@ -798,47 +795,41 @@ public class GOV3Function<T> extends AbstractObject2LongFunction<T> implements S
 		return true;
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * An {@linkplain Builder#dictionary(int) approximate dictionary} is dumped as a
+	 * {@link NativeDump#FILTER}, whose width is the fingerprint width, and it can be probed by the
+	 * C <code>filter3_contains_*()</code> functions.
+	 *
+	 * @param file the name of the dump file.
+	 */
 	public void dump(final String file) throws IOException {
-		final ByteBuffer buffer = ByteBuffer.allocateDirect(1024 * 1024).order(ByteOrder.nativeOrder());
-		final FileOutputStream fos = new FileOutputStream(file);
-		final FileChannel channel = fos.getChannel();
-
-		buffer.clear();
-		buffer.putLong(size64());
-		buffer.putLong(width);
-		buffer.putLong(multiplier);
-		buffer.putLong(globalSeed);
-		buffer.putLong(offsetAndSeed.length);
-
-		for (final long l : offsetAndSeed) {
-			if (!buffer.hasRemaining()) {
-				buffer.flip();
-				channel.write(buffer);
-				buffer.clear();
-			}
-			buffer.putLong(l);
+		try (final NativeDump dump = new NativeDump(file, signatureMask != 0 && signatures == null ? NativeDump.FILTER : NativeDump.SF, 3, width, NativeDump.strategy(transform))) {
+			dump(dump);
 		}
+	}
 
-		buffer.flip();
-		channel.write(buffer);
-		buffer.clear();
-
+	/**
+	 * Appends the parameters and the sections of this function to a dump, so that it can be
+	 * embedded in the dump of a structure using it.
+	 *
+	 * <p>
+	 * The parameters are the number of keys, the multiplier and the global seed; the sections
+	 * contain the offsets and seeds of the buckets and the data, packed in {@link #width} bits. The
+	 * width must be recorded by the structure using this function.
+	 *
+	 * @param dump a dump.
+	 * @see #dump(String)
+	 */
+	public void dump(final NativeDump dump) throws IOException {
+		dump.param(size64(), multiplier, globalSeed);
+		dump.section(offsetAndSeed);
 		final LongBigArrayBitVector v = LongBigArrayBitVector.getInstance().ensureCapacity(data.size64() * width + Long.SIZE - 1 & -Long.SIZE);
 		for (final long d : data) v.append(d, width);
 		v.length(data.size64() * width + Long.SIZE - 1 & -Long.SIZE);
-		final LongBigList list = v.asLongBigList(Long.SIZE);
-		buffer.putLong(list.size64());
-		for (final long l : list) {
-			if (!buffer.hasRemaining()) {
-				buffer.flip();
-				channel.write(buffer);
-				buffer.clear();
-			}
-			buffer.putLong(l);
-		}
-		buffer.flip();
-		channel.write(buffer);
-		fos.close();
+		dump.section(v.asLongBigList(Long.SIZE));
 	}
 
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
@@ -20,14 +20,10 @@
 package it.unimi.dsi.sux4j.mph;
 
 import java.io.File;
-import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.ObjectInputStream;
 import java.io.Serializable;
-import java.nio.ByteBuffer;
-import java.nio.ByteOrder;
-import java.nio.channels.FileChannel;
 import java.nio.charset.Charset;
 import java.util.Arrays;
 import java.util.Iterator;
@@ -68,6 +64,7 @@ import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
 import it.unimi.dsi.sux4j.io.BucketedHashStore.Bucket;
 import it.unimi.dsi.sux4j.io.BucketedHashStore.DuplicateException;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.mph.solve.Linear3SystemSolver;
 import it.unimi.dsi.sux4j.mph.solve.Orient3Hypergraph;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandomGenerator;
@@ -579,33 +576,28 @@ public class GOVMinimalPerfectHashFunction<T> extends AbstractHashFunction<T> im
 		array = bitVector.bits();
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * A signed function is dumped as a {@link NativeDump#SIGNED_MPH}: the signature width follows
+	 * the parameters, and the signatures, indexed by the value of the function, follow the sections.
+	 *
+	 * @param file the name of the dump file.
+	 */
 	public void dump(final String file) throws IOException {
-		final ByteBuffer buffer = ByteBuffer.allocateDirect(edgeOffsetAndSeed.length * 8 + 32).order(ByteOrder.nativeOrder());
-		final FileOutputStream fos = new FileOutputStream(file);
-		final FileChannel channel = fos.getChannel();
-
-		buffer.clear();
-		buffer.putLong(size64());
-		buffer.putLong(multiplier);
-		buffer.putLong(globalSeed);
-		buffer.putLong(edgeOffsetAndSeed.length);
-		for(final long l : edgeOffsetAndSeed) buffer.putLong(l);
-		buffer.flip();
-		channel.write(buffer);
-		buffer.clear();
-
-		buffer.putLong(array.length);
-		for(final long l: array) {
-			if (!buffer.hasRemaining()) {
-				buffer.flip();
-				channel.write(buffer);
-				buffer.clear();
+		final int signatureWidth = Long.bitCount(signatureMask);
+		try (final NativeDump dump = new NativeDump(file, signatureWidth == 0 ? NativeDump.MPH : NativeDump.SIGNED_MPH, 3, 2, NativeDump.strategy(transform))) {
+			dump.param(size64(), multiplier, globalSeed);
+			if (signatureWidth != 0) dump.param(signatureWidth);
+			dump.section(edgeOffsetAndSeed);
+			dump.section(array);
+			if (signatureWidth != 0) {
+				final LongArrayBitVector signatureBits = LongArrayBitVector.getInstance();
+				signatureBits.asLongBigList(signatureWidth).addAll(signatures);
+				dump.section(signatureBits);
 			}
-			buffer.putLong(l);
 		}
-		buffer.flip();
-		channel.write(buffer);
-		fos.close();
 	}
 
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
@@ -20,16 +20,11 @@
 package it.unimi.dsi.sux4j.mph;
 
 import static it.unimi.dsi.bits.LongArrayBitVector.bits;
-import static it.unimi.dsi.bits.LongArrayBitVector.words;
 
 import java.io.File;
-import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.Serializable;
-import java.nio.ByteBuffer;
-import java.nio.ByteOrder;
-import java.nio.channels.FileChannel;
 import java.nio.charset.Charset;
 import java.util.Arrays;
 import java.util.Iterator;
@@ -81,6 +76,7 @@ import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
 import it.unimi.dsi.sux4j.io.BucketedHashStore.Bucket;
 import it.unimi.dsi.sux4j.io.BucketedHashStore.DuplicateException;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.mph.codec.Codec;
 import it.unimi.dsi.sux4j.mph.codec.Codec.Decoder;
 import it.unimi.dsi.sux4j.mph.codec.Codec.Huffman;
@@ -639,54 +635,18 @@ public class GV4CompressedFunction<T> extends AbstractObject2LongFunction<T> imp
 		return true;
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * @param file the name of the dump file.
+	 */
 	public void dump(final String file) throws IOException {
-		final ByteBuffer buffer = ByteBuffer.allocateDirect(1024 * 1024).order(ByteOrder.nativeOrder());
-		final FileOutputStream fos = new FileOutputStream(file);
-		final FileChannel channel = fos.getChannel();
-
-		buffer.clear();
-		buffer.putLong(size64());
-		buffer.putLong(multiplier);
-		buffer.putLong(globalMaxCodewordLength);
-		buffer.putLong(globalSeed);
-		buffer.putLong(offsetAndSeed.length);
-
-		for (final long l : offsetAndSeed) {
-			if (!buffer.hasRemaining()) {
-				buffer.flip();
-				channel.write(buffer);
-				buffer.clear();
-			}
-			buffer.putLong(l);
+		try (final NativeDump dump = new NativeDump(file, NativeDump.CSF, 4, globalMaxCodewordLength, NativeDump.strategy(transform))) {
+			dump.param(size64(), multiplier, globalSeed, globalMaxCodewordLength);
+			dump.section(offsetAndSeed);
+			dump.section(data);
+			((Codec.Huffman.Coder.Decoder)decoder).dump(dump);
 		}
-
-		buffer.flip();
-		channel.write(buffer);
-		buffer.clear();
-
-		final LongBigList list = data.asLongBigList(Long.SIZE);
-		buffer.putLong(words(data.length()));
-
-		for (final long l : list) {
-			buffer.putLong(l);
-			if (!buffer.hasRemaining()) {
-				buffer.flip();
-				channel.write(buffer);
-				buffer.clear();
-			}
-		}
-
-		if (!LongArrayBitVector.round(data.length())) buffer.putLong(data.getLong(data.length() & -Long.SIZE, data.length()));
-
-		buffer.flip();
-		channel.write(buffer);
-		buffer.clear();
-
-		((Codec.Huffman.Coder.Decoder)decoder).dump(buffer);
-		buffer.flip();
-		channel.write(buffer);
-
-		fos.close();
 	}
 
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
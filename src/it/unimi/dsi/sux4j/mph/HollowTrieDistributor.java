@@ -46,6 +46,7 @@ import it.unimi.dsi.io.InputBitStream;
 import it.unimi.dsi.io.OutputBitStream;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.bits.BalancedParentheses;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.util.EliasFanoLongBigList;
 
 /** A distributor based on a hollow trie.
@@ -586,4 +587,28 @@ public class HollowTrieDistributor<T> extends AbstractObject2LongFunction<T> imp
 	public double bitsPerSkip() {
 		return (double)skips.numBits() / skips.size64();
 	}
+
+	/**
+	 * Dumps this distributor in the {@linkplain NativeDump native format} used by the C
+	 * implementation.
+	 *
+	 * <p>
+	 * The layout extends that of a {@linkplain HollowTrieMonotoneMinimalPerfectHashFunction#dump(String)
+	 * hollow trie}, whose number of keys is replaced by the number of keys of this distributor, with
+	 * the {@linkplain GOV3Function#dump(NativeDump) parameters and sections} of the function mapping
+	 * pairs node/path to exit behaviours and of the false-follow detector, both of width one. A
+	 * distributor whose trie has less than two leaves has no further parameters and no sections.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.HOLLOW_TRIE_DISTRIBUTOR, 0, 0, NativeDump.strategy(transformationStrategy))) {
+			dump.param(size);
+			if (trie == null || trie.length() == 0) return;
+			skips.dump(dump);
+			dump.section(trie);
+			externalBehaviour.dump(dump);
+			falseFollowsDetector.dump(dump);
+		}
+	}
 }
@@ -51,6 +51,7 @@ import it.unimi.dsi.fastutil.longs.AbstractLongBigList;
 import it.unimi.dsi.fastutil.objects.ObjectArrayList;
 import it.unimi.dsi.io.FileLinesByteArrayIterable;
 import it.unimi.dsi.io.FileLinesMutableStringIterable;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A monotone minimal perfect hash implementation based on fixed-size bucketing that uses
  * a {@linkplain HollowTrieDistributor hollow trie} as a distributor.
@@ -166,6 +167,33 @@ public class HollowTrieDistributorMonotoneMinimalPerfectHashFunction<T> extends
 		return distributor.numBits() + offset.numBits() + transform.numBits();
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys and the base-2 logarithm of the bucket size, followed
+	 * by the {@linkplain GOV3Function#dump(NativeDump) parameters} of the function mapping keys to
+	 * their offset in their bucket; the sections are those of the same function, followed by the
+	 * {@linkplain HollowTrieDistributor#dump(String) dump of the distributor}, which is
+	 * {@linkplain NativeDump#embed(NativeDump.Dumpable) embedded}. A function with at most one key
+	 * has no further parameters and no sections.
+	 *
+	 * <p>
+	 * The C implementation can evaluate this function on byte arrays only if it was built using
+	 * {@link TransformationStrategies#prefixFreeByteArray()}.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.HOLLOW_TRIE_DISTRIBUTOR_MMPHF, 3, 0, NativeDump.strategy(transform))) {
+			dump.param(size);
+			if (size <= 1) return;
+			dump.param(log2BucketSize);
+			offset.dump(dump);
+			dump.embed(distributor::dump);
+		}
+	}
+
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
 
 		final SimpleJSAP jsap = new SimpleJSAP(HollowTrieDistributorMonotoneMinimalPerfectHashFunction.class.getName(), "Builds a monotone minimal perfect hash using a hollow trie as a distributor reading a newline-separated list of strings.",
@@ -57,6 +57,7 @@ import it.unimi.dsi.io.FileLinesByteArrayIterable;
 import it.unimi.dsi.io.FileLinesMutableStringIterable;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.bits.JacobsonBalancedParentheses;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.util.EliasFanoLongBigList;
 
 /** A hollow trie, that is, a compacted trie recording just the length of the paths associated to the
@@ -359,6 +360,31 @@ public class HollowTrieMonotoneMinimalPerfectHashFunction<T> extends AbstractHas
 		return balParen.numBits() + trie.length() + this.skips.numBits() + transform.numBits();
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The first parameter is the number of keys, followed by the
+	 * {@linkplain EliasFanoLongBigList#dump(NativeDump) parameters} of the list of skips; the
+	 * sections are those of the list of skips, followed by the trie. A function with at most one
+	 * key has no further parameters and no sections. The C implementation builds its own
+	 * balanced-parentheses directory on the trie.
+	 *
+	 * <p>
+	 * The C implementation can evaluate this function on byte arrays only if it was built using
+	 * {@link TransformationStrategies#prefixFreeByteArray()}.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.HOLLOW_TRIE, 0, 0, NativeDump.strategy(transform))) {
+			dump.param(size);
+			if (size <= 1) return;
+			skips.dump(dump);
+			dump.section(trie);
+		}
+	}
+
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
 
 		final SimpleJSAP jsap = new SimpleJSAP(HollowTrieMonotoneMinimalPerfectHashFunction.class.getName(), "Builds a monotone minimal perfect hash function based on a hollow trie reading a newline-separated list of strings.",
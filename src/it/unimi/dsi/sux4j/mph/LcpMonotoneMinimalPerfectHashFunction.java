@@ -66,6 +66,7 @@ import it.unimi.dsi.io.FileLinesMutableStringIterable;
 import it.unimi.dsi.io.OfflineIterable;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A monotone minimal perfect hash implementation based on fixed-size bucketing that uses
  * longest common prefixes as distributors.
@@ -372,6 +373,38 @@ public class LcpMonotoneMinimalPerfectHashFunction<T> extends AbstractHashFuncti
 		return offsetLcpLength.numBits() + lcp2Bucket.numBits() + transform.numBits();
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys, the base-2 logarithm of the bucket size, the seed, the
+	 * signature width (zero for no signatures) and the output widths of the two functions, followed
+	 * by the {@linkplain GOV3Function#dump(NativeDump) parameters} of the function mapping keys to
+	 * offsets and longest-common-prefix lengths and of the function mapping longest common prefixes
+	 * to buckets; the sections are those of the two functions, followed by the signatures (empty if
+	 * there are none), packed in a bit vector. An empty function has no further parameters and no
+	 * sections.
+	 *
+	 * <p>
+	 * Keys are hashed as bit vectors: the C implementation can evaluate this function on byte arrays
+	 * only if it was built using {@link TransformationStrategies#prefixFreeByteArray()}.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		final int signatureWidth = Long.bitCount(signatureMask);
+		try (final NativeDump dump = new NativeDump(file, NativeDump.LCP_MMPHF, 3, 0, NativeDump.strategy(transform))) {
+			dump.param(n, log2BucketSize, seed, signatureWidth);
+			if (n == 0) return;
+			dump.param(offsetLcpLength.width, lcp2Bucket.width);
+			offsetLcpLength.dump(dump);
+			lcp2Bucket.dump(dump);
+			final LongArrayBitVector signatureBits = LongArrayBitVector.getInstance();
+			if (signatureWidth != 0) signatureBits.asLongBigList(signatureWidth).addAll(signatures);
+			dump.section(signatureBits);
+		}
+	}
+
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
 
 		final SimpleJSAP jsap = new SimpleJSAP(LcpMonotoneMinimalPerfectHashFunction.class.getName(), "Builds an LCP-based monotone minimal perfect hash function reading a newline-separated list of strings.", new Parameter[] {
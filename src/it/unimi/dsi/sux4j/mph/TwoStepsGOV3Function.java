@@ -58,6 +58,7 @@ import it.unimi.dsi.io.FileLinesByteArrayIterable;
 import it.unimi.dsi.io.FileLinesMutableStringIterable;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandomGenerator;
 
 
@@ -367,6 +368,31 @@ public class TwoStepsGOV3Function<T> extends AbstractHashFunction<T> implements
 		return (firstFunction != null ? firstFunction.numBits() : 0) + secondFunction.numBits() + transform.numBits() + remap.length * (long)Long.SIZE;
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys and the output width of the first function (zero if
+	 * there is no first function), followed by the {@linkplain GOV3Function#dump(NativeDump)
+	 * parameters} of the first function, if any, and of the second function; the sections are those
+	 * of the first function, if any, followed by the remap table, and those of the second function.
+	 * The escape value is the largest value of the first function. An empty function has no
+	 * sections.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.TWO_STEPS_SF, 3, width, NativeDump.strategy(transform))) {
+			dump.param(n, firstFunction == null ? 0 : firstFunction.width);
+			if (n == 0) return;
+			if (firstFunction != null) {
+				firstFunction.dump(dump);
+				dump.section(remap);
+			}
+			secondFunction.dump(dump);
+		}
+	}
+
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
 
 		final SimpleJSAP jsap = new SimpleJSAP(TwoStepsGOV3Function.class.getName(), "Builds a two-steps GOV3 function mapping a newline-separated list of strings to their ordinal position, or to specific values.",
@@ -62,6 +62,7 @@ import it.unimi.dsi.io.FileLinesMutableStringIterable;
 import it.unimi.dsi.io.OfflineIterable;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandomGenerator;
 
 /** A monotone minimal perfect hash implementation based on fixed-size bucketing that uses
@@ -405,6 +406,42 @@ public class TwoStepsLcpMonotoneMinimalPerfectHashFunction<T> extends AbstractHa
 		return result < 0 || result >= n ? defRetValue : result;
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys, the base-2 logarithm of the bucket size, the seed, the
+	 * signature width (zero for no signatures) and the output width of the function mapping longest
+	 * common prefixes to buckets, followed by the {@linkplain GOV3Function#dump(NativeDump)
+	 * parameters} of the function mapping keys to offsets and of the function mapping longest
+	 * common prefixes to buckets; the sections are those of the two functions, followed by the
+	 * {@linkplain TwoStepsGOV3Function#dump(String) dump of the function mapping keys to
+	 * longest-common-prefix lengths}, which is {@linkplain NativeDump#embed(NativeDump.Dumpable)
+	 * embedded}, and by the signatures (empty if there are none), packed in a bit vector. An empty
+	 * function has no further parameters and no sections.
+	 *
+	 * <p>
+	 * Keys are hashed as bit vectors: the C implementation can evaluate this function on byte arrays
+	 * only if it was built using {@link TransformationStrategies#prefixFreeByteArray()}, and on bit
+	 * vectors if it was built using {@link TransformationStrategies#prefixFree()}.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		final int signatureWidth = Long.bitCount(signatureMask);
+		try (final NativeDump dump = new NativeDump(file, NativeDump.TWO_STEPS_LCP_MMPHF, 3, 0, NativeDump.strategy(transform))) {
+			dump.param(n, log2BucketSize, seed, signatureWidth);
+			if (n == 0) return;
+			dump.param(lcp2Bucket.width);
+			offsets.dump(dump);
+			lcp2Bucket.dump(dump);
+			dump.embed(lcpLengths::dump);
+			final LongArrayBitVector signatureBits = LongArrayBitVector.getInstance();
+			if (signatureWidth != 0) signatureBits.asLongBigList(signatureWidth).addAll(signatures);
+			dump.section(signatureBits);
+		}
+	}
+
 	public long getLongByBitVectorAndSignature(final BitVector bitVector, final long[] signature) {
 		if (n == 0) return defRetValue;
 		final long prefix = lcpLengths.getLongBySignature(signature);
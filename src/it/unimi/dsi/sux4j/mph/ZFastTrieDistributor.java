@@ -49,6 +49,7 @@ import it.unimi.dsi.lang.MutableString;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.bits.Rank9;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A distributor based on a z-fast trie. */
 
@@ -736,6 +737,41 @@ public class ZFastTrieDistributor<T> extends AbstractObject2LongFunction<T> impl
 		return behaviour.numBits() + signatures.numBits() + ranker.numBits() + leaves.bitVector().length() + transformationStrategy.numBits() + numBitsForMistakes();
 	}
 
+	/**
+	 * Dumps this distributor in the {@linkplain NativeDump native format} used by the C
+	 * implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys, the number of delimiters, the number of bits used to
+	 * store the length of a node string and the number of bits of the signature of a node string,
+	 * followed by the {@linkplain GOV3Function#dump(NativeDump) parameters} of the behaviour
+	 * function, of the function mapping node handles to signatures and lengths of node strings, of
+	 * the correction function, and the {@linkplain Rank9#dump(NativeDump) parameters} of the ranking
+	 * structure on the leaves. The sections are those of the same structures, followed by the
+	 * sorted signatures of the mistakes, and by the {@linkplain TwoStepsLcpMonotoneMinimalPerfectHashFunction#dump(String)
+	 * dump of the leaf ranker}, which is {@linkplain NativeDump#embed(NativeDump.Dumpable) embedded}.
+	 * A distributor without delimiters has no sections, and a distributor whose trie is empty has
+	 * just the sections of the behaviour function. The seed of the distributor is the seed of the
+	 * behaviour function.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.ZFAST_TRIE_DISTRIBUTOR, 3, 0, NativeDump.strategy(transformationStrategy))) {
+			dump.param(size, numDelimiters, logW, Long.bitCount(signatureMask));
+			if (noDelimiters) return;
+			behaviour.dump(dump);
+			if (emptyTrie) return;
+			signatures.dump(dump);
+			corrections.dump(dump);
+			leaves.dump(dump);
+			final int[] mistakes = mistakeSignatures.toIntArray();
+			Arrays.sort(mistakes);
+			dump.section(mistakes);
+			dump.embed(ranker::dump);
+		}
+	}
+
 	@Override
 	public boolean containsKey(final Object o) {
 		return true;
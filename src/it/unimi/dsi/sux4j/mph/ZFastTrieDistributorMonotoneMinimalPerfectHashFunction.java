@@ -48,6 +48,7 @@ import com.martiansoftware.jsap.stringparsers.ForNameStringParser;
 import it.unimi.dsi.bits.BitVector;
 import it.unimi.dsi.bits.Fast;
 import it.unimi.dsi.bits.HuTuckerTransformationStrategy;
+import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.bits.TransformationStrategy;
 import it.unimi.dsi.fastutil.io.BinIO;
@@ -58,6 +59,7 @@ import it.unimi.dsi.io.FileLinesByteArrayIterable;
 import it.unimi.dsi.io.FileLinesMutableStringIterable;
 import it.unimi.dsi.logging.ProgressLogger;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandomGenerator;
 
 /** A monotone minimal perfect hash implementation based on fixed-size bucketing that uses
@@ -272,6 +274,38 @@ public class ZFastTrieDistributorMonotoneMinimalPerfectHashFunction<T> extends A
 		return distributor.numBits() + offset.numBits() + transform.numBits();
 	}
 
+	/**
+	 * Dumps this function in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the number of keys, the base-2 logarithm of the bucket size, the seed and
+	 * the signature width (zero for no signatures), followed by the
+	 * {@linkplain GOV3Function#dump(NativeDump) parameters} of the function mapping keys to their
+	 * offset in their bucket; the sections are those of the same function, followed by the
+	 * {@linkplain ZFastTrieDistributor#dump(String) dump of the distributor}, which is
+	 * {@linkplain NativeDump#embed(NativeDump.Dumpable) embedded}, and by the signatures (empty if
+	 * there are none), packed in a bit vector. An empty function has no further parameters and no
+	 * sections.
+	 *
+	 * <p>
+	 * The C implementation can evaluate this function on byte arrays only if it was built using
+	 * {@link TransformationStrategies#prefixFreeByteArray()}.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		final int signatureWidth = Long.bitCount(signatureMask);
+		try (final NativeDump dump = new NativeDump(file, NativeDump.ZFAST_TRIE_DISTRIBUTOR_MMPHF, 3, 0, NativeDump.strategy(transform))) {
+			dump.param(size, log2BucketSize, seed, signatureWidth);
+			if (size == 0) return;
+			offset.dump(dump);
+			dump.embed(distributor::dump);
+			final LongArrayBitVector signatureBits = LongArrayBitVector.getInstance();
+			if (signatureWidth != 0) signatureBits.asLongBigList(signatureWidth).addAll(signatures);
+			dump.section(signatureBits);
+		}
+	}
+
 	public static void main(final String[] arg) throws NoSuchMethodException, IOException, JSAPException {
 
 		final SimpleJSAP jsap = new SimpleJSAP(ZFastTrieDistributorMonotoneMinimalPerfectHashFunction.class.getName(), "Builds a monotone minimal perfect hash using a probabilistic z-fast trie as a distributor reading a newline-separated list of strings.", new Parameter[] {
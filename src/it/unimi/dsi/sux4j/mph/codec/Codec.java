@@ -19,8 +19,8 @@
 
 package it.unimi.dsi.sux4j.mph.codec;
 
+import java.io.IOException;
 import java.io.Serializable;
-import java.nio.ByteBuffer;
 import java.util.Arrays;
 
 import com.google.common.primitives.Longs;
@@ -31,6 +31,7 @@ import it.unimi.dsi.fastutil.longs.Long2IntMaps;
 import it.unimi.dsi.fastutil.longs.Long2IntOpenHashMap;
 import it.unimi.dsi.fastutil.longs.Long2LongMap;
 import it.unimi.dsi.fastutil.longs.LongArrays;
+import it.unimi.dsi.sux4j.io.NativeDump;
 import it.unimi.dsi.sux4j.mph.GV3CompressedFunction;
 
 /** A class representing a specific instantaneous code for {@linkplain GV3CompressedFunction compressed functions}.
@@ -466,15 +467,17 @@ public interface Codec {
 					return Integer.SIZE * shift.length + Integer.SIZE * howManyUpToBlock.length + Long.SIZE * lastCodeWordPlusOne.length + Long.SIZE * symbol.length;
 				}
 
-				public void dump(final ByteBuffer buffer) {
-					buffer.putLong(escapedSymbolLength);
-					buffer.putLong(escapeLength);
-					buffer.putLong(lastCodeWordPlusOne.length);
-					buffer.putLong(symbol.length);
-					for(final long l : lastCodeWordPlusOne) buffer.putLong(l);
-					for(final int i : howManyUpToBlock) buffer.putInt(i);
-					for(final byte i : shift) buffer.put(i);
-					for(final long l : symbol) buffer.putLong(l);
+				/**
+				 * Appends the parameters and the tables of this decoder to a native dump.
+				 *
+				 * @param dump a native dump.
+				 */
+				public void dump(final NativeDump dump) throws IOException {
+					dump.param(escapedSymbolLength, escapeLength);
+					dump.section(lastCodeWordPlusOne);
+					dump.section(howManyUpToBlock);
+					dump.section(shift);
+					dump.section(symbol);
 				}
 
 			}
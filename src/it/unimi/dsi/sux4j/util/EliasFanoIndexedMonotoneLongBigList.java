@@ -23,6 +23,7 @@ import static it.unimi.dsi.bits.LongArrayBitVector.bit;
 import static it.unimi.dsi.bits.LongArrayBitVector.bits;
 import static it.unimi.dsi.bits.LongArrayBitVector.word;
 
+import java.io.IOException;
 import java.io.Serializable;
 
 import it.unimi.dsi.fastutil.bytes.ByteIterable;
@@ -33,7 +34,9 @@ import it.unimi.dsi.fastutil.longs.LongIterable;
 import it.unimi.dsi.fastutil.longs.LongIterator;
 import it.unimi.dsi.fastutil.shorts.ShortIterable;
 import it.unimi.dsi.fastutil.shorts.ShortIterator;
+import it.unimi.dsi.sux4j.bits.SimpleSelect;
 import it.unimi.dsi.sux4j.bits.SimpleSelectZero;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /**
  * An extension of {@link EliasFanoMonotoneLongBigList} providing indexing (i.e., content-based
@@ -904,6 +907,33 @@ public class EliasFanoIndexedMonotoneLongBigList extends EliasFanoMonotoneLongBi
 		return currentIndex;
 	}
 
+	/**
+	 * Dumps this list in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The dump extends {@linkplain EliasFanoMonotoneLongBigList#dump(String) that of the superclass}:
+	 * the parameters of the {@linkplain SimpleSelect#dump(NativeDump) selection structure} on the
+	 * upper bits are followed by those of the {@linkplain SimpleSelectZero#dump(NativeDump, boolean)
+	 * selection structure on zeroes}, and then by the first and the last element; the sections of
+	 * the selection structure on zeroes, but for the upper bits, which are not repeated, follow
+	 * those of the superclass.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	@Override
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.ELIAS_FANO_INDEXED, 0, 0)) {
+			dump(dump);
+		}
+	}
+
+	@Override
+	public void dump(final NativeDump dump) throws IOException {
+		super.dump(dump);
+		selectUpperZero.dump(dump, false);
+		dump.param(firstElement, lastElement);
+	}
+
 	/**
 	 * An list iterator over the values of this {@link EliasFanoIndexedMonotoneLongBigList}
 	 *
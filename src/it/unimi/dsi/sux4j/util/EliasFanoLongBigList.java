@@ -41,6 +41,7 @@ import it.unimi.dsi.fastutil.longs.LongIterator;
 import it.unimi.dsi.fastutil.longs.LongIterators;
 import it.unimi.dsi.fastutil.shorts.ShortIterable;
 import it.unimi.dsi.fastutil.shorts.ShortIterator;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A compressed big list of longs; each element occupies a number of bits bounded by one plus its bit length plus the logarithm of the average bit length of an element.
  *
@@ -283,4 +284,22 @@ public class EliasFanoLongBigList extends AbstractLongBigList implements Seriali
 	public long numBits() {
 		return borders.numBits() + bits.length();
 	}
+
+	/**
+	 * Appends the parameters and the sections of this list to a {@linkplain NativeDump native dump},
+	 * so that it can be embedded in the dump of a structure using it.
+	 *
+	 * <p>
+	 * The only parameter is the offset that must be subtracted from an element after restoring its
+	 * most significant bit, followed by those of the {@linkplain EliasFanoMonotoneLongBigList#dump(NativeDump)
+	 * list of borders}; the first section contains the concatenated bits of the elements, and the
+	 * following ones are those of the list of borders.
+	 *
+	 * @param dump a dump.
+	 */
+	public void dump(final NativeDump dump) throws IOException {
+		dump.param(offset);
+		dump.section(bits);
+		borders.dump(dump);
+	}
 }
@@ -45,6 +45,7 @@ import it.unimi.dsi.fastutil.longs.LongIterators;
 import it.unimi.dsi.fastutil.shorts.ShortIterable;
 import it.unimi.dsi.fastutil.shorts.ShortIterator;
 import it.unimi.dsi.sux4j.bits.SimpleSelect;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /**
  * An implementation of Elias&ndash;Fano's representation of monotone sequences; an element occupies
@@ -596,6 +597,36 @@ public class EliasFanoMonotoneLongBigList extends AbstractLongBigList implements
 		return length;
 	}
 
+	/**
+	 * Dumps this list in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the length of the list and the number of lower bits, followed by those of
+	 * the {@linkplain SimpleSelect#dump(NativeDump) selection structure} on the upper bits; the
+	 * first section contains the lower bits, and the following ones are those of the selection
+	 * structure.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.ELIAS_FANO, 0, 0)) {
+			dump(dump);
+		}
+	}
+
+	/**
+	 * Appends the parameters and the sections of this list to a dump, so that it can be embedded
+	 * in the dump of a structure using it.
+	 *
+	 * @param dump a dump.
+	 * @see #dump(String)
+	 */
+	public void dump(final NativeDump dump) throws IOException {
+		dump.param(length, l);
+		dump.section(lowerBits);
+		selectUpper.dump(dump);
+	}
+
 	private void readObject(final ObjectInputStream s) throws IOException, ClassNotFoundException {
 		s.defaultReadObject();
 		upperBits = selectUpper.bitVector().bits();
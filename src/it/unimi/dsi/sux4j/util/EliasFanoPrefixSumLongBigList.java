@@ -50,6 +50,12 @@ import it.unimi.dsi.fastutil.shorts.ShortIterable;
  * delegates to {@link #getDelta(long)}. The iterator has the same properties of the iterator
  * returned by {@link EliasFanoMonotoneLongBigList#listIterator(long) EliasFanoMonotoneLongBiglist}.
  *
+ * <p>
+ * The {@linkplain #dump(String) native dump} is that of the underlying list of prefix sums, whose
+ * length is one plus the length of this list; the C function {@code elias_fano_get_pair()}
+ * returns the prefix sums of index <var>i</var> and <var>i</var>&nbsp;+&nbsp;1, that is, the
+ * interval associated with the value of index <var>i</var>, with a single selection.
+ *
  * @see EliasFanoMonotoneLongBigList
  */
 public class EliasFanoPrefixSumLongBigList extends EliasFanoMonotoneLongBigList {
@@ -0,0 +1,272 @@
+/*
+ * Sux4J: Succinct data structures for Java
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the GNU Lesser General Public License v2.1 or later,
+ * which is available at
+ * http://www.gnu.org/licenses/old-licenses/lgpl-2.1-standalone.html,
+ * or the Apache Software License 2.0, which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later OR Apache-2.0
+ */
+
+package it.unimi.dsi.sux4j.util;
+
+import static it.unimi.dsi.bits.LongArrayBitVector.bits;
+import static it.unimi.dsi.bits.LongArrayBitVector.word;
+
+import java.io.IOException;
+import java.io.Serializable;
+
+import it.unimi.dsi.bits.Fast;
+import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.fastutil.ints.IntIterable;
+import it.unimi.dsi.fastutil.longs.AbstractLongBigList;
+import it.unimi.dsi.fastutil.longs.LongArrayList;
+import it.unimi.dsi.fastutil.longs.LongIterable;
+import it.unimi.dsi.fastutil.longs.LongIterator;
+import it.unimi.dsi.fastutil.longs.LongIterators;
+import it.unimi.dsi.sux4j.io.NativeDump;
+
+/**
+ * A partitioned Elias&ndash;Fano representation of monotone sequences, which adapts to clustered
+ * sequences.
+ *
+ * <p>
+ * Instances of this class represent a nondecreasing sequence of natural numbers, like an
+ * {@link EliasFanoMonotoneLongBigList}, but the sequence is divided into chunks of a fixed number
+ * of elements (128 by default), each of which is encoded with the cheapest of three methods,
+ * relative to its first element:
+ * <ul>
+ * <li>implicitly, if the chunk contains all integers between its first and its last element, which
+ * requires no space;
+ * <li>as a bitmap, if the elements of the chunk are distinct and the bitmap is not larger than the
+ * Elias&ndash;Fano representation;
+ * <li>using the Elias&ndash;Fano representation otherwise.
+ * </ul>
+ * The first and the last element of each chunk are stored in an
+ * {@link EliasFanoIndexedMonotoneLongBigList}, which makes it possible to find quickly the chunk
+ * containing the successor of a value. Dense runs of a clustered sequence occupy thus about one
+ * bit per element, or none at all, rather than two plus the logarithm of the average gap of the
+ * whole sequence.
+ *
+ * <p>
+ * The representation is described by Giuseppe Ottaviano and Rossano Venturini in
+ * &ldquo;Partitioned Elias&ndash;Fano indexes&rdquo;, <i>Proc. SIGIR 2014</i>, pages 273&minus;282,
+ * ACM, 2014; this implementation uses chunks of fixed size rather than optimal partitions.
+ *
+ * <p>
+ * This class is thread safe.
+ *
+ * @author Sebastiano Vigna
+ * @since 5.2.4
+ */
+
+public class PartitionedEliasFanoMonotoneLongBigList extends AbstractLongBigList implements Serializable {
+	private static final long serialVersionUID = 0L;
+	/** The default base-2 logarithm of the number of elements in a chunk. */
+	public static final int DEFAULT_LOG2_PARTITION_SIZE = 7;
+	/** A chunk containing all integers between its first and last element. */
+	protected static final int IMPLICIT = 0;
+	/** A chunk encoded as a bitmap. */
+	protected static final int BITMAP = 1;
+	/** A chunk encoded using the Elias&ndash;Fano representation. */
+	protected static final int ELIAS_FANO = 2;
+
+	/** The length of the sequence. */
+	protected final long length;
+	/** The base-2 logarithm of the number of elements in a chunk. */
+	protected final int log2PartitionSize;
+	/** The first and last element of each chunk, interleaved. */
+	protected final EliasFanoIndexedMonotoneLongBigList endpoints;
+	/** The width of a descriptor. */
+	protected final int descriptorWidth;
+	/**
+	 * For each chunk, a descriptor of {@link #descriptorWidth} bits containing the position of its
+	 * encoding in {@link #bits} shifted left by two, plus its type.
+	 */
+	protected final LongArrayBitVector descriptors;
+	/** The encodings of the chunks, concatenated. */
+	protected final LongArrayBitVector bits;
+
+	/**
+	 * Creates a partitioned Elias&ndash;Fano representation of the values returned by the given
+	 * {@linkplain Iterable iterable object}.
+	 *
+	 * @param list an iterable object returning nondecreasing natural numbers.
+	 */
+	public PartitionedEliasFanoMonotoneLongBigList(final IntIterable list) {
+		this((LongIterable)() -> LongIterators.wrap(list.iterator()));
+	}
+
+	/**
+	 * Creates a partitioned Elias&ndash;Fano representation of the values returned by the given
+	 * {@linkplain Iterable iterable object}.
+	 *
+	 * @param list an iterable object returning nondecreasing natural numbers.
+	 */
+	public PartitionedEliasFanoMonotoneLongBigList(final LongIterable list) {
+		this(list.iterator(), DEFAULT_LOG2_PARTITION_SIZE);
+	}
+
+	/**
+	 * Creates a partitioned Elias&ndash;Fano representation of the values returned by the given
+	 * iterator.
+	 *
+	 * @param iterator an iterator returning nondecreasing natural numbers.
+	 * @param log2PartitionSize the base-2 logarithm of the number of elements in a chunk.
+	 */
+	public PartitionedEliasFanoMonotoneLongBigList(final LongIterator iterator, final int log2PartitionSize) {
+		if (log2PartitionSize < 0 || log2PartitionSize > 16) throw new IllegalArgumentException("Illegal partition size: 2^" + log2PartitionSize);
+		this.log2PartitionSize = log2PartitionSize;
+		final long[] chunk = new long[1 << log2PartitionSize];
+		final LongArrayList endpoints = new LongArrayList();
+		final LongArrayList descriptors = new LongArrayList();
+		bits = LongArrayBitVector.getInstance();
+		long length = 0, last = 0;
+		int m = 0;
+
+		for (;;) {
+			final boolean hasNext = iterator.hasNext();
+			if (hasNext) {
+				final long v = iterator.nextLong();
+				if (v < 0) throw new IllegalArgumentException("Negative value: " + v);
+				if (v < last) throw new IllegalArgumentException("Values are not nondecreasing: " + v + " < " + last);
+				chunk[m++] = last = v;
+				length++;
+			}
+			if (m == chunk.length || !hasNext && m != 0) {
+				endpoints.add(chunk[0]);
+				endpoints.add(chunk[m - 1]);
+				descriptors.add(bits.length() << 2 | encode(chunk, m, bits));
+				m = 0;
+			}
+			if (!hasNext) break;
+		}
+
+		this.length = length;
+		this.endpoints = new EliasFanoIndexedMonotoneLongBigList(endpoints);
+		descriptorWidth = Fast.length(bits.length()) + 2;
+		this.descriptors = LongArrayBitVector.getInstance(descriptors.size() * (long)descriptorWidth);
+		this.descriptors.asLongBigList(descriptorWidth).addAll(descriptors);
+		bits.trim();
+	}
+
+	/**
+	 * Returns the number of lower bits used by the Elias&ndash;Fano representation of a chunk.
+	 *
+	 * @param m the number of elements of the chunk.
+	 * @param u the size of the universe of the chunk (its last element minus its first element plus
+	 *            one).
+	 * @return the number of lower bits.
+	 */
+	protected static int lowerBits(final long m, final long u) {
+		return Math.max(0, Fast.mostSignificantBit(u / m));
+	}
+
+	/**
+	 * Appends the cheapest encoding of a chunk to a bit vector.
+	 *
+	 * @param chunk an array containing the chunk.
+	 * @param m the number of elements of the chunk.
+	 * @param bits the bit vector to which the encoding will be appended.
+	 * @return the type of the encoding.
+	 */
+	private static int encode(final long[] chunk, final int m, final LongArrayBitVector bits) {
+		final long first = chunk[0], u = chunk[m - 1] - first + 1;
+		boolean distinct = true;
+		for (int i = 1; i < m; i++) if (chunk[i] == chunk[i - 1]) distinct = false;
+		if (distinct && u == m) return IMPLICIT;
+
+		final int l = lowerBits(m, u);
+		final long upperBitsLength = m + (u - 1 >>> l);
+		if (distinct && u <= m * (long)l + upperBitsLength) {
+			final long start = bits.length();
+			bits.length(start + u);
+			for (int i = 0; i < m; i++) bits.set(start + chunk[i] - first);
+			return BITMAP;
+		}
+
+		if (l != 0) for (int i = 0; i < m; i++) bits.append(chunk[i] - first & (1L << l) - 1, l);
+		final long start = bits.length();
+		bits.length(start + upperBitsLength);
+		for (int i = 0; i < m; i++) bits.set(start + (chunk[i] - first >>> l) + i);
+		return ELIAS_FANO;
+	}
+
+	/**
+	 * Returns the position of the one of given rank in a bit array, starting from a given
+	 * position.
+	 *
+	 * @param bits a bit array.
+	 * @param from the starting position.
+	 * @param rank the rank of the one to find.
+	 * @return the position of the one of rank {@code rank} relative to {@code from}.
+	 */
+	private static long select(final long[] bits, final long from, long rank) {
+		int word = word(from);
+		long window = bits[word] & -1L << from;
+		for (int bitCount; rank >= (bitCount = Long.bitCount(window)); rank -= bitCount) window = bits[++word];
+		return bits(word) + Fast.select(window, (int)rank) - from;
+	}
+
+	@Override
+	public long getLong(final long index) {
+		assert index >= 0;
+		assert index < length;
+
+		final long chunk = index >>> log2PartitionSize;
+		final long rank = index & (1L << log2PartitionSize) - 1;
+		final long first = endpoints.getLong(2 * chunk);
+		final long descriptor = descriptors.getLong(chunk * descriptorWidth, (chunk + 1) * descriptorWidth);
+		final long offset = descriptor >>> 2;
+
+		switch ((int)(descriptor & 3)) {
+		case IMPLICIT:
+			return first + rank;
+		case BITMAP:
+			return first + select(bits.bits(), offset, rank);
+		default:
+			final long m = Math.min(1L << log2PartitionSize, length - (chunk << log2PartitionSize));
+			final int l = lowerBits(m, endpoints.getLong(2 * chunk + 1) - first + 1);
+			final long upper = select(bits.bits(), offset + m * l, rank) - rank;
+			return first + (l == 0 ? upper : upper << l | bits.getLong(offset + rank * l, offset + (rank + 1) * l));
+		}
+	}
+
+	@Override
+	public long size64() {
+		return length;
+	}
+
+	public long numBits() {
+		return endpoints.numBits() + descriptors.length() + bits.length();
+	}
+
+	/**
+	 * Dumps this list in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the length of the list, the base-2 logarithm of the number of elements in
+	 * a chunk, and the width of the descriptors, followed by those of the
+	 * {@linkplain EliasFanoIndexedMonotoneLongBigList#dump(NativeDump) list of endpoints}; the
+	 * sections are those of the list of endpoints, the descriptors and the encodings of the chunks.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.PARTITIONED_ELIAS_FANO, 0, 0)) {
+			dump.param(length, log2PartitionSize, descriptorWidth);
+			endpoints.dump(dump);
+			dump.section(descriptors);
+			dump.section(bits);
+		}
+	}
+}
@@ -19,6 +19,7 @@
 
 package it.unimi.dsi.sux4j.util;
 
+import java.io.IOException;
 import java.io.Serializable;
 import java.util.Arrays;
 
@@ -34,6 +35,7 @@ import it.unimi.dsi.fastutil.longs.LongIterator;
 import it.unimi.dsi.fastutil.longs.LongIterators;
 import it.unimi.dsi.fastutil.shorts.ShortIterable;
 import it.unimi.dsi.sux4j.bits.Rank9;
+import it.unimi.dsi.sux4j.io.NativeDump;
 
 /** A compressed big list of longs; small elements and large elements are stored separately, using two different, optimally chosen bit sizes.
  *
@@ -189,4 +191,52 @@ public class TwoSizesLongBigList extends AbstractLongBigList implements Serializ
 	public long numBits() {
 		return numBits;
 	}
+
+	/**
+	 * Returns the minimum number of bits necessary to represent the elements of a list.
+	 *
+	 * @param list a list.
+	 * @return the minimum number of bits necessary to represent the elements of {@code list}.
+	 */
+	private static int width(final LongBigList list) {
+		long max = 0;
+		for (final LongIterator i = list.iterator(); i.hasNext();) max = Math.max(max, i.nextLong());
+		return Fast.mostSignificantBit(max) + 1;
+	}
+
+	/**
+	 * Returns a bit vector containing the elements of a list packed using a given number of bits.
+	 *
+	 * @param list a list.
+	 * @param width the number of bits used for each element.
+	 * @return a bit vector containing the elements of {@code list}, packed.
+	 */
+	private static LongArrayBitVector pack(final LongBigList list, final int width) {
+		final LongArrayBitVector v = LongArrayBitVector.getInstance(list.size64() * width);
+		if (width != 0) for (final LongIterator i = list.iterator(); i.hasNext();) v.append(i.nextLong(), width);
+		return v;
+	}
+
+	/**
+	 * Dumps this list in the {@linkplain NativeDump native format} used by the C implementation.
+	 *
+	 * <p>
+	 * The parameters are the length of the list and the widths of the small and large elements
+	 * (the latter is zero if there are no large elements), followed, if there are large elements,
+	 * by those of the {@linkplain Rank9#dump(NativeDump) ranking structure} on the marker; the
+	 * sections contain the small elements, the large elements and, if there are large elements,
+	 * those of the ranking structure. Elements are packed using the minimum number of bits for the
+	 * largest one.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.TWO_SIZES, 0, 0)) {
+			final int smallWidth = width(small), largeWidth = large == null ? 0 : width(large);
+			dump.param(length, smallWidth, largeWidth);
+			dump.section(pack(small, smallWidth));
+			dump.section(large == null ? LongArrayBitVector.getInstance() : pack(large, largeWidth));
+			if (rank != null) rank.dump(dump);
+		}
+	}
 }
@@ -55,6 +55,7 @@ import it.unimi.dsi.fastutil.ints.IntArrayList;
 import it.unimi.dsi.fastutil.ints.IntIterator;
 import it.unimi.dsi.fastutil.ints.IntOpenHashSet;
 import it.unimi.dsi.fastutil.io.BinIO;
+import it.unimi.dsi.fastutil.longs.LongArrayList;
 import it.unimi.dsi.fastutil.longs.LongOpenHashSet;
 import it.unimi.dsi.fastutil.objects.AbstractObjectSet;
 import it.unimi.dsi.fastutil.objects.AbstractObjectSortedSet;
@@ -64,10 +65,14 @@ import it.unimi.dsi.fastutil.objects.ObjectIterator;
 import it.unimi.dsi.fastutil.objects.ObjectOpenHashSet;
 import it.unimi.dsi.fastutil.objects.ObjectSet;
 import it.unimi.dsi.fastutil.objects.ObjectSortedSet;
+import it.unimi.dsi.fastutil.objects.Reference2IntOpenHashMap;
 import it.unimi.dsi.io.FastBufferedReader;
 import it.unimi.dsi.io.LineIterator;
 import it.unimi.dsi.lang.MutableString;
 import it.unimi.dsi.logging.ProgressLogger;
+import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.mph.GOVMinimalPerfectHashFunction;
 import it.unimi.dsi.sux4j.mph.Hashes;
 
 /** A z-fast trie, that is, a predecessor/successor data structure using low linear (in the number of keys) additional space and
@@ -1928,6 +1933,111 @@ public class ZFastTrie<T> extends AbstractObjectSortedSet<T> implements Serializ
 		throw new UnsupportedOperationException();
 	}
 
+	/**
+	 * Dumps a frozen copy of this trie in the {@linkplain NativeDump native format} used by the C
+	 * implementation, which answers successor, predecessor and prefix-range queries by key rank.
+	 *
+	 * <p>
+	 * Nodes are stored in flat arrays: internal nodes are numbered by a
+	 * {@link GOVMinimalPerfectHashFunction} on their handles, which replaces the map from handles to
+	 * nodes, and are followed by the leaves in key order. The parameters are the number of keys and
+	 * the root, followed by the {@linkplain EliasFanoMonotoneLongBigList#dump(NativeDump) parameters}
+	 * of the list of the bit offsets of the keys. The sections are:
+	 * <ul>
+	 * <li>for each internal node, the third word of the {@linkplain Hashes#spooky4(BitVector, long, long[])
+	 * hash} of its handle with the seed of the minimal perfect hash function, and the length of its
+	 * extent;
+	 * <li>for each internal node, the length of its handle, its first and last leaf and its left and
+	 * right child, packed in the lower and upper 32 bits of a word;
+	 * <li>the keys, concatenated;
+	 * <li>the sections of the list of the offsets of the keys;
+	 * <li>if there are internal nodes, the {@linkplain GOVMinimalPerfectHashFunction#dump(String) dump}
+	 * of the minimal perfect hash function, which is {@linkplain NativeDump#embed(NativeDump.Dumpable)
+	 * embedded}.
+	 * </ul>
+	 * An empty trie has no further parameters and no sections.
+	 *
+	 * @param file the name of the dump file.
+	 */
+	public void dump(final String file) throws IOException {
+		try (final NativeDump dump = new NativeDump(file, NativeDump.ZFAST_TRIE, 0, 0, NativeDump.strategy(transform))) {
+			dump.param(size);
+			if (size == 0) return;
+			final int numNodes = size - 1;
+
+			final Reference2IntOpenHashMap<Leaf<T>> leafIndex = new Reference2IntOpenHashMap<>(size);
+			final LongArrayBitVector keys = LongArrayBitVector.getInstance();
+			final long[] offset = new long[size + 1];
+			int k = 0;
+			for (Leaf<T> leaf = head.next; leaf != tail; leaf = leaf.next) {
+				leafIndex.put(leaf, k);
+				final BitVector key = leaf.key(transform);
+				final long length = key.length();
+				for (long from = 0; from < length; from += Long.SIZE) {
+					final long to = Math.min(from + Long.SIZE, length);
+					keys.append(key.getLong(from, to), (int)(to - from));
+				}
+				offset[++k] = keys.length();
+			}
+
+			final ObjectArrayList<InternalNode<T>> internalNodes = new ObjectArrayList<>(numNodes);
+			final ObjectArrayList<Node<T>> stack = new ObjectArrayList<>();
+			stack.push(root);
+			while (!stack.isEmpty()) {
+				final Node<T> node = stack.pop();
+				if (node.isLeaf()) continue;
+				final InternalNode<T> internalNode = (InternalNode<T>)node;
+				internalNodes.add(internalNode);
+				stack.push(internalNode.right);
+				stack.push(internalNode.left);
+			}
+
+			final long[] nodes = new long[2 * numNodes];
+			final long[] links = new long[3 * numNodes];
+			final Reference2IntOpenHashMap<InternalNode<T>> nodeIndex = new Reference2IntOpenHashMap<>(numNodes);
+			GOVMinimalPerfectHashFunction<BitVector> handle2Node = null;
+
+			if (numNodes != 0) {
+				final ObjectArrayList<LongArrayBitVector> handles = new ObjectArrayList<>(numNodes);
+				for (final InternalNode<T> node : internalNodes) handles.add(LongArrayBitVector.copy(node.handle(transform)));
+				final BucketedHashStore<BitVector> bucketedHashStore = new BucketedHashStore<>(TransformationStrategies.identity());
+				bucketedHashStore.addAll(handles.iterator());
+				bucketedHashStore.checkAndRetry(handles);
+				handle2Node = new GOVMinimalPerfectHashFunction.Builder<BitVector>().keys(handles).transform(TransformationStrategies.identity()).store(bucketedHashStore).build();
+				final long seed = bucketedHashStore.seed();
+				bucketedHashStore.close();
+
+				final long[] hash = new long[3];
+				for (int i = 0; i < numNodes; i++) {
+					final int p = (int)handle2Node.getLong(handles.get(i));
+					nodeIndex.put(internalNodes.get(i), p);
+					Hashes.spooky4(handles.get(i), seed, hash);
+					nodes[2 * p] = hash[2];
+					nodes[2 * p + 1] = internalNodes.get(i).extentLength;
+				}
+
+				for (final InternalNode<T> node : internalNodes) {
+					final int p = nodeIndex.getInt(node);
+					links[3 * p] = node.handleLength();
+					links[3 * p + 1] = leafIndex.getInt(node.leftLeaf()) | (long)leafIndex.getInt(node.rightLeaf()) << 32;
+					links[3 * p + 2] = nodeId(node.left, numNodes, nodeIndex, leafIndex) | nodeId(node.right, numNodes, nodeIndex, leafIndex) << 32;
+				}
+			}
+
+			dump.param(nodeId(root, numNodes, nodeIndex, leafIndex));
+			dump.section(nodes);
+			dump.section(links);
+			dump.section(keys);
+			new EliasFanoMonotoneLongBigList(LongArrayList.wrap(offset)).dump(dump);
+			if (handle2Node != null) dump.embed(handle2Node::dump);
+		}
+	}
+
+	/** Returns the identifier of a node in a {@linkplain #dump(String) dump}: internal nodes come first, followed by leaves. */
+	private static <U> long nodeId(final Node<U> node, final int numNodes, final Reference2IntOpenHashMap<InternalNode<U>> nodeIndex, final Reference2IntOpenHashMap<Leaf<U>> leafIndex) {
+		return node.isInternal() ? nodeIndex.getInt(node) : numNodes + leafIndex.getInt(node);
+	}
+
 	private void writeObject(final ObjectOutputStream s) throws IOException {
 		s.defaultWriteObject();
 		if (size > 0) writeNode(root, transform, s);
@@ -22,9 +22,15 @@ package it.unimi.dsi.sux4j.bits;
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertTrue;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
 import org.junit.Test;
 
 import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 
 public class JacobsonBalancedParenthesesTest extends BalancedParenthesesTestCase {
 
@@ -243,4 +249,34 @@ public class JacobsonBalancedParenthesesTest extends BalancedParenthesesTestCase
 		// assertEquals(3, bp.enclose(5));
 
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(JacobsonBalancedParenthesesTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final LongArrayBitVector v = LongArrayBitVector.getInstance();
+		// A complete binary tree of depth 10
+		recComplete(v, 10);
+		final JacobsonBalancedParentheses bp = new JacobsonBalancedParentheses(v);
+		bp.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.BALANCED_PARENTHESES, header.kind);
+		assertEquals(1, header.numSections);
+		assertEquals(v.length(), header.param[0]);
+		assertEquals((v.length() + Long.SIZE - 1) / Long.SIZE * Long.BYTES, header.length[0]);
+		final int bits = header.offset[0];
+		for (int i = 0; i < (v.length() + Long.SIZE - 1) / Long.SIZE; i++) assertEquals(v.bits()[i], buffer.getLong(bits + i * Long.BYTES));
+	}
+
+	private static void recComplete(final LongArrayBitVector v, final int depth) {
+		v.add(true);
+		if (depth != 0) {
+			recComplete(v, depth - 1);
+			recComplete(v, depth - 1);
+		}
+		v.add(false);
+	}
 }
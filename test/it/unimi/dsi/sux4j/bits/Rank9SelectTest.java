@@ -21,11 +21,16 @@ package it.unimi.dsi.sux4j.bits;
 
 import static org.junit.Assert.assertEquals;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Random;
 
 import org.junit.Test;
 
 import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class Rank9SelectTest extends RankSelectTestCase {
@@ -266,4 +271,34 @@ public class Rank9SelectTest extends RankSelectTestCase {
 		final Rank9 rank9 = new Rank9(new long[2], 127);
 		assertEquals(0, rank9.rankStrict(127));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(Rank9SelectTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final Random r = new XoRoShiRo128PlusRandom(0);
+		final LongArrayBitVector v = LongArrayBitVector.getInstance();
+		for (int i = 0; i < 10000; i++) v.add(r.nextInt(10) == 0);
+		final Rank9 rank9 = new Rank9(v);
+		final Select9 select9 = new Select9(rank9);
+		select9.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.SELECT9, header.kind);
+		assertEquals(4, header.numSections);
+		assertEquals(v.length(), header.param[0]);
+		assertEquals(rank9.count(), header.param[1]);
+		assertEquals(rank9.lastOne(), header.param[2]);
+
+		final int bits = header.offset[0], count = header.offset[1];
+		final int words = LongArrayBitVector.words(v.length());
+		assertEquals(words * (long)Long.BYTES, header.length[0]);
+		for (int i = 0; i < words; i++) assertEquals(v.bits()[i], buffer.getLong(bits + i * Long.BYTES));
+		assertEquals(rank9.count.length * (long)Long.BYTES, header.length[1]);
+		for (int i = 0; i < rank9.count.length; i++) assertEquals(rank9.count[i], buffer.getLong(count + i * Long.BYTES));
+		assertEquals((rank9.count() + 511) / 512 + 1, header.length[2] / Long.BYTES);
+		assertEquals((words + 3) / 4, header.length[3] / Long.BYTES);
+	}
 }
@@ -21,11 +21,16 @@ package it.unimi.dsi.sux4j.bits;
 
 import static org.junit.Assert.assertEquals;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Random;
 
 import org.junit.Test;
 
 import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class SimpleSelectZeroTest extends RankSelectTestCase {
@@ -212,4 +217,32 @@ public class SimpleSelectZeroTest extends RankSelectTestCase {
 				assertEquals(i, r.selectZero(i));
 		}
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(SimpleSelectZeroTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final Random r = new XoRoShiRo128PlusRandom(0);
+		final LongArrayBitVector v = LongArrayBitVector.getInstance();
+		// A sparse prefix followed by a dense suffix, so that some inventory entries spill
+		for (int i = 0; i < 1000000; i++) v.add(i < 500000 ? r.nextInt(100000) != 0 : r.nextInt(10) != 0);
+		final SimpleSelectZero select = new SimpleSelectZero(v);
+		select.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.SIMPLE_SELECT_ZERO, header.kind);
+		assertEquals(4, header.numSections);
+		assertEquals(v.length(), header.param[0]);
+		final long count = v.length() - v.count();
+		assertEquals(count, header.param[1]);
+		final int log2OnesPerInventory = (int)header.param[2];
+
+		final int bits = header.offset[0], inventory = header.offset[1];
+		final int words = LongArrayBitVector.words(v.length());
+		assertEquals(words * (long)Long.BYTES, header.length[0]);
+		for (int i = 0; i < words; i++) assertEquals(v.bits()[i], buffer.getLong(bits + i * Long.BYTES));
+		for (long i = 0; i < count; i += 1 << log2OnesPerInventory) assertEquals(select.selectZero(i), buffer.getLong(inventory + (int)(i >>> log2OnesPerInventory) * Long.BYTES) & ~(1L << 63));
+	}
 }
@@ -21,12 +21,17 @@ package it.unimi.dsi.sux4j.bits;
 
 import static org.junit.Assert.assertEquals;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Random;
 
 import org.junit.Test;
 
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongArrayList;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class SparseRankTest extends RankSelectTestCase {
@@ -243,4 +248,32 @@ public class SparseRankTest extends RankSelectTestCase {
 		final SparseSelect select = new SparseSelect(bv);
         assertEquals(Integer.MAX_VALUE + 1L, select.select(0));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(SparseRankTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final XoRoShiRo128PlusRandom random = new XoRoShiRo128PlusRandom(0);
+		final LongArrayBitVector v = LongArrayBitVector.getInstance().length(1000000);
+		for (int i = 0; i < 1000; i++) v.set(random.nextInt(1000000));
+		final SparseRank rank = new SparseRank(v);
+		rank.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.SPARSE_RANK, header.kind);
+		assertEquals(5, header.numSections);
+		assertEquals(v.count(), header.param[0]);
+		assertEquals(rank.l, header.param[1]);
+		assertEquals(rank.upperBits.length(), header.param[2]);
+		// The parameter of a selection structure on zeroes is the number of zeroes
+		assertEquals(rank.upperBits.length() - v.count() - 1, header.param[3]);
+		assertEquals(v.length(), header.param[5]);
+
+		final int lower = header.offset[0];
+		for (int i = 0; i < rank.lowerBits.length; i++) assertEquals(rank.lowerBits[i], buffer.getLong(lower + i * Long.BYTES));
+		final int upper = header.offset[1];
+		for (int i = 0; i < rank.upperBits.length() / Long.SIZE; i++) assertEquals(rank.upperBits.getLong(i * (long)Long.SIZE, (i + 1) * (long)Long.SIZE), buffer.getLong(upper + i * Long.BYTES));
+	}
 }
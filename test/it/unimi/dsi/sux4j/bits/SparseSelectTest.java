@@ -21,11 +21,18 @@ package it.unimi.dsi.sux4j.bits;
 
 import static org.junit.Assert.assertEquals;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Random;
 
 import org.junit.Test;
 
+import it.unimi.dsi.bits.Fast;
 import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
+import it.unimi.dsi.sux4j.util.EliasFanoMonotoneLongBigList;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class SparseSelectTest extends RankSelectTestCase {
@@ -218,4 +225,36 @@ public class SparseSelectTest extends RankSelectTestCase {
 				assertEquals(i, r.select(i));
 		}
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(SparseSelectTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final XoRoShiRo128PlusRandom random = new XoRoShiRo128PlusRandom(0);
+		final LongArrayBitVector v = LongArrayBitVector.getInstance().length(1000000);
+		for (int i = 0; i < 1000; i++) v.set(random.nextInt(1000000));
+		final SparseSelect select = new SparseSelect(v);
+		select.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.SPARSE_SELECT, header.kind);
+		assertEquals(5, header.numSections);
+		assertEquals(v.count(), header.param[0]);
+		// The upper bits contain a sentinel
+		assertEquals(v.count() + 1, header.param[3]);
+		assertEquals(v.length(), header.param[5]);
+
+		assertEquals(Math.max(0, Fast.mostSignificantBit(v.length() / v.count())), header.param[1]);
+		// The parameters and sections are those of the underlying list
+		final File g = File.createTempFile(SparseSelectTest.class.getSimpleName(), "dump");
+		g.deleteOnExit();
+		new EliasFanoMonotoneLongBigList(v.count(), v.length(), v.asLongSet().iterator()).dump(g.toString());
+		final ByteBuffer list = NativeDumpTest.read(g);
+		final NativeDumpTest.Header listHeader = NativeDumpTest.header(list);
+		for (int i = 0; i < 5; i++) assertEquals(listHeader.param[i], header.param[i]);
+		assertEquals(list.limit(), buffer.limit());
+		for (int i = NativeDump.ALIGNMENT; i < list.limit(); i += Long.BYTES) assertEquals(list.getLong(i), buffer.getLong(i));
+	}
 }
@@ -0,0 +1,67 @@
+/*
+ * Sux4J: Succinct data structures for Java
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the GNU Lesser General Public License v2.1 or later,
+ * which is available at
+ * http://www.gnu.org/licenses/old-licenses/lgpl-2.1-standalone.html,
+ * or the Apache Software License 2.0, which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later OR Apache-2.0
+ */
+
+package it.unimi.dsi.sux4j.io;
+
+import static org.junit.Assert.assertEquals;
+
+import java.io.File;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.util.EnumSet;
+
+import org.junit.Test;
+
+import it.unimi.dsi.fastutil.io.FastBufferedInputStream;
+import it.unimi.dsi.fastutil.io.FastBufferedInputStream.LineTerminator;
+
+public class FileLinesBigListTest {
+
+	@Test
+	public void testDump() throws IOException {
+		final File t = File.createTempFile(FileLinesBigListTest.class.getSimpleName(), "tmp");
+		t.deleteOnExit();
+		final FileWriter fw = new FileWriter(t);
+		fw.write("\naa\r\naaaa\n\raa".toCharArray());
+		fw.close();
+
+		final File f = File.createTempFile(FileLinesBigListTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		FileLinesBigList fll = new FileLinesBigList(t.toString(), "ASCII");
+		assertEquals(5, fll.size64());
+		fll.dump(f.toString());
+
+		NativeDumpTest.Header header = NativeDumpTest.header(NativeDumpTest.read(f));
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.FILE_LINES, header.kind);
+		assertEquals(5, header.numSections);
+		assertEquals(5, header.param[0]);
+		// The upper bits contain a sentinel
+		assertEquals(6, header.param[3]);
+		assertEquals(t.length(), header.param[5]);
+		assertEquals(7, header.param[6]);
+
+		fll = new FileLinesBigList(t.toString(), "ASCII", FastBufferedInputStream.DEFAULT_BUFFER_SIZE, EnumSet.of(LineTerminator.LF));
+		assertEquals(4, fll.size64());
+		fll.dump(f.toString());
+		header = NativeDumpTest.header(NativeDumpTest.read(f));
+		assertEquals(4, header.param[0]);
+		assertEquals(2, header.param[6]);
+	}
+}
@@ -0,0 +1,149 @@
+/*
+ * Sux4J: Succinct data structures for Java
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the GNU Lesser General Public License v2.1 or later,
+ * which is available at
+ * http://www.gnu.org/licenses/old-licenses/lgpl-2.1-standalone.html,
+ * or the Apache Software License 2.0, which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later OR Apache-2.0
+ */
+
+package it.unimi.dsi.sux4j.io;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotEquals;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.file.Files;
+
+import org.junit.Test;
+
+import it.unimi.dsi.bits.LongArrayBitVector;
+import it.unimi.dsi.bits.TransformationStrategies;
+
+public class NativeDumpTest {
+
+	/** A dump header parsed by {@link NativeDumpTest#header(ByteBuffer, int)}. */
+	public static final class Header {
+		public long magic;
+		public int version, kind, arity, width, strategy, hash, checksum, numSections;
+		public final long[] param = new long[NativeDump.MAX_PARAMS];
+		/** The offsets of the sections within the buffer (i.e., including the base of the header). */
+		public final int[] offset = new int[NativeDump.MAX_SECTIONS];
+		public final long[] length = new long[NativeDump.MAX_SECTIONS];
+		public final long[] sectionChecksum = new long[NativeDump.MAX_SECTIONS];
+	}
+
+	/** Reads a dump in native byte order. */
+	public static ByteBuffer read(final File file) throws IOException {
+		return ByteBuffer.wrap(Files.readAllBytes(file.toPath())).order(ByteOrder.nativeOrder());
+	}
+
+	/** Parses the header of a dump starting at the beginning of a buffer. */
+	public static Header header(final ByteBuffer buffer) {
+		return header(buffer, 0);
+	}
+
+	/** Parses the header of a dump starting at a given position of a buffer (e.g., an embedded dump). */
+	public static Header header(final ByteBuffer buffer, final int base) {
+		final Header header = new Header();
+		header.magic = buffer.getLong(base);
+		header.version = buffer.getInt(base + NativeDump.VERSION_OFFSET);
+		header.kind = buffer.getInt(base + NativeDump.KIND_OFFSET);
+		header.arity = buffer.getInt(base + NativeDump.ARITY_OFFSET);
+		header.width = buffer.getInt(base + NativeDump.WIDTH_OFFSET);
+		header.strategy = buffer.getInt(base + NativeDump.STRATEGY_OFFSET);
+		header.hash = buffer.getInt(base + NativeDump.HASH_OFFSET);
+		header.checksum = buffer.getInt(base + NativeDump.CHECKSUM_OFFSET);
+		header.numSections = buffer.getInt(base + NativeDump.NUM_SECTIONS_OFFSET);
+		for (int i = 0; i < NativeDump.MAX_PARAMS; i++) header.param[i] = buffer.getLong(base + NativeDump.PARAMS_OFFSET + i * Long.BYTES);
+		for (int i = 0; i < NativeDump.MAX_SECTIONS; i++) {
+			final int entry = base + NativeDump.SECTIONS_OFFSET + i * NativeDump.SECTION_ENTRY_SIZE;
+			header.offset[i] = base + (int)buffer.getLong(entry);
+			header.length[i] = buffer.getLong(entry + Long.BYTES);
+			header.sectionChecksum[i] = buffer.getLong(entry + 2 * Long.BYTES);
+		}
+		return header;
+	}
+
+	@Test
+	public void testHeaderAndSections() throws IOException {
+		final File f = File.createTempFile(NativeDumpTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+
+		final long[] a = { 1, 2, 3 };
+		final int[] b = { 4, 5 };
+		final byte[] c = { 6, 7, 8 };
+		final LongArrayBitVector v = LongArrayBitVector.getInstance();
+		for (int i = 0; i < 100; i++) v.add(i % 3 == 0);
+
+		try (final NativeDump dump = new NativeDump(f.toString(), NativeDump.SF, 3, 8, NativeDump.strategy(TransformationStrategies.rawByteArray()))) {
+			dump.param(42, 43);
+			dump.section(a);
+			dump.section(b);
+			dump.section(c);
+			dump.section(v);
+		}
+
+		final ByteBuffer buffer = read(f);
+		final Header header = header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.VERSION, header.version);
+		assertEquals(NativeDump.SF, header.kind);
+		assertEquals(3, header.arity);
+		assertEquals(8, header.width);
+		assertEquals(NativeDump.RAW_BYTE_ARRAY, header.strategy);
+		assertEquals(NativeDump.SPOOKY_V2, header.hash);
+		assertEquals(NativeDump.FAST_CHECKSUM, header.checksum);
+		assertEquals(4, header.numSections);
+		assertEquals(42, header.param[0]);
+		assertEquals(43, header.param[1]);
+		assertEquals(0, header.param[2]);
+
+		final long[] length = { 3 * Long.BYTES, 2 * Integer.BYTES, 3, 2 * Long.BYTES };
+		for (int i = 0; i < 4; i++) {
+			assertEquals(0, header.offset[i] % NativeDump.ALIGNMENT);
+			assertEquals(length[i], header.length[i]);
+		}
+
+		assertEquals(3, buffer.getLong(header.offset[0] + 16));
+		assertEquals(5, buffer.getInt(header.offset[1] + 4));
+		assertEquals(8, buffer.get(header.offset[2] + 2));
+		assertEquals(v.getLong(64, 100), buffer.getLong(header.offset[3] + 8));
+	}
+
+	@Test
+	public void testChecksum() throws IOException {
+		final File f = File.createTempFile(NativeDumpTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+
+		final long[] a = new long[1000];
+		for (int i = 0; i < a.length; i++) a[i] = i * 0x9E3779B97F4A7C15L;
+		final ByteBuffer bytes = ByteBuffer.allocate(a.length * Long.BYTES).order(ByteOrder.nativeOrder());
+		for (final long l : a) bytes.putLong(l);
+		final long[] b = a.clone();
+		b[500] ^= 1;
+
+		try (final NativeDump dump = new NativeDump(f.toString(), NativeDump.SF, 3, 8)) {
+			dump.section(a);
+			dump.section(bytes.array());
+			dump.section(b);
+		}
+
+		final Header header = header(read(f));
+		assertEquals(header.sectionChecksum[0], header.sectionChecksum[1]);
+		assertNotEquals(header.sectionChecksum[0], header.sectionChecksum[2]);
+	}
+}
@@ -23,6 +23,7 @@ import static org.junit.Assert.assertEquals;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Arrays;
 import java.util.Collections;
 import java.util.List;
@@ -31,6 +32,8 @@ import org.junit.Test;
 
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.sux4j.mph.CHDMinimalPerfectHashFunction.Builder;
 
 @SuppressWarnings("deprecation")
@@ -90,4 +93,31 @@ public class CHDMinimalPerfectHashFunctionTest {
 		final CHDMinimalPerfectHashFunction<String> mph = new CHDMinimalPerfectHashFunction.Builder<String>().keys(emptyList).transform(TransformationStrategies.utf16()).build();
 		assertEquals(-1, mph.getLong("a"));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final String[] s = new String[1000];
+		for (int i = s.length; i-- != 0;) s[i] = Integer.toString(i);
+		final CHDMinimalPerfectHashFunction<CharSequence> mph = new Builder<CharSequence>().keys(Arrays.asList(s)).transform(TransformationStrategies.utf16()).signed(32).build();
+		final File f = File.createTempFile(getClass().getSimpleName(), "dump");
+		f.deleteOnExit();
+		mph.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.CHD, header.kind);
+		assertEquals(13, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertEquals(32, header.param[3]);
+
+		// A single chunk, followed by the sentinel chunk
+		assertEquals(5 * Long.BYTES, header.length[0]);
+		final int descriptors = header.offset[0];
+		assertEquals(0, buffer.getLong(descriptors));
+		assertEquals(0, buffer.getLong(descriptors + Long.BYTES));
+		// The bit vector of the sparse rank covers all positions of the chunks
+		assertEquals(buffer.getLong(descriptors + 3 * Long.BYTES), header.param[15]);
+		assertEquals((s.length * 32 + Long.SIZE - 1) / Long.SIZE * Long.BYTES, header.length[12]);
+	}
 }
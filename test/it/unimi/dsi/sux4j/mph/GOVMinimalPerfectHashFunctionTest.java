@@ -24,6 +24,7 @@ import static org.junit.Assert.assertEquals;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Arrays;
 
 import org.junit.Test;
@@ -32,6 +33,8 @@ import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
 import it.unimi.dsi.fastutil.objects.ObjectLists;
 import it.unimi.dsi.sux4j.io.BucketedHashStore;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.sux4j.mph.GOVMinimalPerfectHashFunction.Builder;
 
 public class GOVMinimalPerfectHashFunctionTest {
@@ -92,6 +95,34 @@ public class GOVMinimalPerfectHashFunctionTest {
 		}
 	}
 
+	@Test
+	public void testDump() throws IOException {
+		final String[] s = new String[1000];
+		for (int i = s.length; i-- != 0;) s[i] = Integer.toString(i);
+		for (final int signatureWidth : new int[] { 0, 32 }) {
+			final GOVMinimalPerfectHashFunction<CharSequence> mph = new Builder<CharSequence>().keys(Arrays.asList(s)).transform(TransformationStrategies.utf16()).signed(signatureWidth).build();
+			final File f = File.createTempFile(getClass().getSimpleName(), "dump");
+			f.deleteOnExit();
+			mph.dump(f.toString());
+
+			final ByteBuffer buffer = NativeDumpTest.read(f);
+			final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+			assertEquals(NativeDump.MAGIC, header.magic);
+			assertEquals(signatureWidth == 0 ? NativeDump.MPH : NativeDump.SIGNED_MPH, header.kind);
+			assertEquals(signatureWidth == 0 ? 2 : 3, header.numSections);
+			assertEquals(s.length, header.param[0]);
+			if (signatureWidth == 0) continue;
+			assertEquals(signatureWidth, header.param[3]);
+
+			// The signatures are indexed by the value of the function
+			final int signatures = header.offset[2];
+			for (final String key : s) {
+				final long v = mph.getLong(key);
+				assertEquals(mph.signatures.getLong(v), buffer.getInt(signatures + (int)v * Integer.BYTES) & 0xFFFFFFFFL);
+			}
+		}
+	}
+
 	@Test
 	public void testCountNonZeroPairs() {
 		assertEquals(0, countNonzeroPairs(0));
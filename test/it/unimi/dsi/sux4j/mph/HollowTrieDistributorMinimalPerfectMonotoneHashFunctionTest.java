@@ -23,6 +23,8 @@ import static org.junit.Assert.assertEquals;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 import java.util.Random;
 
@@ -31,6 +33,8 @@ import org.junit.Test;
 import it.unimi.dsi.bits.HuTuckerTransformationStrategy;
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class HollowTrieDistributorMinimalPerfectMonotoneHashFunctionTest {
@@ -127,4 +131,30 @@ public class HollowTrieDistributorMinimalPerfectMonotoneHashFunctionTest {
 					assertEquals(i, mph.getLong(s[i]));
 			}
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final byte[][] s = new byte[10000][];
+		for (int i = s.length; i-- != 0;) s[i] = binary(i).getBytes(StandardCharsets.US_ASCII);
+		final HollowTrieDistributorMonotoneMinimalPerfectHashFunction<byte[]> mph = new HollowTrieDistributorMonotoneMinimalPerfectHashFunction<>(Arrays.asList(s), TransformationStrategies.prefixFreeByteArray());
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		mph.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.HOLLOW_TRIE_DISTRIBUTOR_MMPHF, header.kind);
+		assertEquals(NativeDump.PREFIX_FREE_BYTE_ARRAY, header.strategy);
+		assertEquals(3, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		// The distributor is a complete dump embedded in the last section
+		final int distributor = header.offset[2];
+		assertEquals(0, distributor % NativeDump.ALIGNMENT);
+		final NativeDumpTest.Header distributorHeader = NativeDumpTest.header(buffer, distributor);
+		assertEquals(NativeDump.MAGIC, distributorHeader.magic);
+		assertEquals(NativeDump.HOLLOW_TRIE_DISTRIBUTOR, distributorHeader.kind);
+		assertEquals(11, distributorHeader.numSections);
+		assertEquals(s.length, distributorHeader.param[0]);
+	}
 }
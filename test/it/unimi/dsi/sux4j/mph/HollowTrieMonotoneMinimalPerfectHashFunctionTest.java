@@ -23,7 +23,11 @@ import static org.junit.Assert.assertEquals;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
 import java.util.Arrays;
+import java.util.List;
 import java.util.Random;
 
 import org.junit.Test;
@@ -33,6 +37,8 @@ import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
 import it.unimi.dsi.fastutil.objects.ObjectArrayList;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class HollowTrieMonotoneMinimalPerfectHashFunctionTest {
@@ -135,4 +141,31 @@ public class HollowTrieMonotoneMinimalPerfectHashFunctionTest {
 		assertEquals(n, hollowTrie.size64());
 
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final List<byte[]> s = new ArrayList<>();
+		for (int i = 0; i < 10000; i++) s.add(String.format("%08x", i * 31L).getBytes(StandardCharsets.US_ASCII));
+		final HollowTrieMonotoneMinimalPerfectHashFunction<byte[]> mph = new HollowTrieMonotoneMinimalPerfectHashFunction<>(s, TransformationStrategies.prefixFreeByteArray());
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		mph.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.HOLLOW_TRIE, header.kind);
+		assertEquals(NativeDump.PREFIX_FREE_BYTE_ARRAY, header.strategy);
+		assertEquals(7, header.numSections);
+		assertEquals(s.size(), header.param[0]);
+		assertEquals((mph.trie.length() + Long.SIZE - 1) / Long.SIZE * Long.BYTES, header.length[6]);
+		final int trie = header.offset[6];
+		for (int i = 0; i < 10; i++) assertEquals(mph.trie.getLong(i * Long.SIZE, (i + 1) * Long.SIZE), buffer.getLong(trie + i * Long.BYTES));
+
+		final HollowTrieMonotoneMinimalPerfectHashFunction<byte[]> singleton = new HollowTrieMonotoneMinimalPerfectHashFunction<>(s.subList(0, 1), TransformationStrategies.prefixFreeByteArray());
+		singleton.dump(file.toString());
+		final NativeDumpTest.Header singletonHeader = NativeDumpTest.header(NativeDumpTest.read(file));
+		assertEquals(1, singletonHeader.param[0]);
+		assertEquals(0, singletonHeader.numSections);
+	}
 }
@@ -23,6 +23,8 @@ import static org.junit.Assert.assertEquals;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 
 import org.junit.Test;
@@ -30,6 +32,8 @@ import org.junit.Test;
 import it.unimi.dsi.bits.HuTuckerTransformationStrategy;
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 
 public class LcpMonotoneMinimalPerfectHashFunctionTest {
 
@@ -88,4 +92,32 @@ public class LcpMonotoneMinimalPerfectHashFunctionTest {
 		final LcpMonotoneMinimalPerfectHashFunction<String> mph = new LcpMonotoneMinimalPerfectHashFunction.Builder<String>().keys(Arrays.asList(new String[] {})).transform(TransformationStrategies.prefixFreeUtf16()).build();
 		assertEquals(-1, mph.getLong(""));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final byte[][] s = new byte[10000][];
+		for (int i = s.length; i-- != 0;) s[i] = binary(i).getBytes(StandardCharsets.US_ASCII);
+		final LcpMonotoneMinimalPerfectHashFunction<byte[]> mph = new LcpMonotoneMinimalPerfectHashFunction.Builder<byte[]>().keys(Arrays.asList(s)).transform(TransformationStrategies.prefixFreeByteArray()).signed(32).build();
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		mph.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.LCP_MMPHF, header.kind);
+		assertEquals(NativeDump.PREFIX_FREE_BYTE_ARRAY, header.strategy);
+		assertEquals(5, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertEquals(mph.log2BucketSize, header.param[1]);
+		assertEquals(mph.seed, header.param[2]);
+		assertEquals(32, header.param[3]);
+		assertEquals(mph.offsetLcpLength.width, header.param[4]);
+		assertEquals(mph.lcp2Bucket.width, header.param[5]);
+		assertEquals(s.length, header.param[6]);
+		assertEquals(mph.lcp2Bucket.size64(), header.param[9]);
+		assertEquals(s.length * 32L / Byte.SIZE, header.length[4]);
+		final int signatures = header.offset[4];
+		for (int i = 0; i < 10; i++) assertEquals(mph.signatures.getLong(i), buffer.getInt(signatures + i * Integer.BYTES) & 0xFFFFFFFFL);
+	}
 }
@@ -21,7 +21,9 @@ package it.unimi.dsi.sux4j.mph;
 
 import static org.junit.Assert.assertEquals;
 
+import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.Arrays;
 
 import org.junit.Test;
@@ -30,6 +32,8 @@ import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.longs.LongArrayList;
 import it.unimi.dsi.fastutil.longs.LongBigList;
 import it.unimi.dsi.fastutil.longs.LongBigLists;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 
 public class TwoStepsGOV3FunctionTest {
 
@@ -71,4 +75,33 @@ public class TwoStepsGOV3FunctionTest {
 		assertEquals(l.getLong(6), mph.getLong("g"));
 		assertEquals(l.getLong(7), mph.getLong("h"));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final String[] s = new String[1000];
+		final long[] v = new long[s.length];
+		for (int i = s.length; i-- != 0;) {
+			s[i] = Integer.toString(i);
+			v[i] = i % 10 == 0 ? i : i % 3;
+		}
+		final TwoStepsGOV3Function<CharSequence> f = new TwoStepsGOV3Function.Builder<CharSequence>().keys(Arrays.asList(s)).transform(TransformationStrategies.utf16()).values(LongBigLists.asBigList(new LongArrayList(v))).build();
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		f.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.TWO_STEPS_SF, header.kind);
+		assertEquals(f.width, header.width);
+		assertEquals(s.length, header.param[0]);
+		// Frequent values make a first function worthwhile
+		assertEquals(f.firstFunction.width, header.param[1]);
+		assertEquals(5, header.numSections);
+		assertEquals(s.length, header.param[2]);
+		assertEquals(f.secondFunction.size64(), header.param[5]);
+		assertEquals(f.remap.length * Long.BYTES, header.length[2]);
+		final int remap = header.offset[2];
+		for (int i = 0; i < f.remap.length; i++) assertEquals(f.remap[i], buffer.getLong(remap + i * Long.BYTES));
+	}
 }
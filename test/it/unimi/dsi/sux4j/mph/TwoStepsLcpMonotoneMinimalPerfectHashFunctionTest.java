@@ -23,6 +23,8 @@ import static org.junit.Assert.assertEquals;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 
 import org.junit.Test;
@@ -30,6 +32,8 @@ import org.junit.Test;
 import it.unimi.dsi.bits.HuTuckerTransformationStrategy;
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 
 public class TwoStepsLcpMonotoneMinimalPerfectHashFunctionTest {
 
@@ -86,4 +90,32 @@ public class TwoStepsLcpMonotoneMinimalPerfectHashFunctionTest {
 		final TwoStepsLcpMonotoneMinimalPerfectHashFunction<String> mph = new TwoStepsLcpMonotoneMinimalPerfectHashFunction.Builder<String>().keys(Arrays.asList(new String[] {})).transform(TransformationStrategies.prefixFreeUtf16()).build();
 		assertEquals(-1, mph.getLong(""));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final byte[][] s = new byte[10000][];
+		for (int i = s.length; i-- != 0;) s[i] = binary(i).getBytes(StandardCharsets.US_ASCII);
+		final TwoStepsLcpMonotoneMinimalPerfectHashFunction<byte[]> mph = new TwoStepsLcpMonotoneMinimalPerfectHashFunction.Builder<byte[]>().keys(Arrays.asList(s)).transform(TransformationStrategies.prefixFreeByteArray()).signed(32).build();
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		mph.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.TWO_STEPS_LCP_MMPHF, header.kind);
+		assertEquals(NativeDump.PREFIX_FREE_BYTE_ARRAY, header.strategy);
+		assertEquals(6, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertEquals(mph.log2BucketSize, header.param[1]);
+		assertEquals(mph.seed, header.param[2]);
+		assertEquals(32, header.param[3]);
+		final NativeDumpTest.Header lcpLengths = NativeDumpTest.header(buffer, header.offset[4]);
+		assertEquals(NativeDump.MAGIC, lcpLengths.magic);
+		assertEquals(NativeDump.TWO_STEPS_SF, lcpLengths.kind);
+		assertEquals(s.length, lcpLengths.param[0]);
+		assertEquals(s.length * 32L / Byte.SIZE, header.length[5]);
+		final int signatures = header.offset[5];
+		for (int i = 0; i < 10; i++) assertEquals(mph.signatures.getLong(i), buffer.getInt(signatures + i * Integer.BYTES) & 0xFFFFFFFFL);
+	}
 }
@@ -24,6 +24,8 @@ import static org.junit.Assert.assertTrue;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 
 import org.junit.Test;
@@ -31,6 +33,8 @@ import org.junit.Test;
 import it.unimi.dsi.bits.HuTuckerTransformationStrategy;
 import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 
 public class ZFastTrieDistributorMonotoneMinimalPerfectHashFunctionTest {
 
@@ -147,4 +151,33 @@ public class ZFastTrieDistributorMonotoneMinimalPerfectHashFunctionTest {
 			}
 		}
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final byte[][] s = new byte[10000][];
+		for (int i = s.length; i-- != 0;) s[i] = binary(i).getBytes(StandardCharsets.US_ASCII);
+		final ZFastTrieDistributorMonotoneMinimalPerfectHashFunction<byte[]> mph = new ZFastTrieDistributorMonotoneMinimalPerfectHashFunction<>(Arrays.asList(s), TransformationStrategies.prefixFreeByteArray(), -1, 32, null);
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		mph.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.ZFAST_TRIE_DISTRIBUTOR_MMPHF, header.kind);
+		assertEquals(NativeDump.PREFIX_FREE_BYTE_ARRAY, header.strategy);
+		assertEquals(4, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertEquals(32, header.param[3]);
+		// The distributor embeds in turn the ranker of its leaves
+		final NativeDumpTest.Header distributor = NativeDumpTest.header(buffer, header.offset[2]);
+		assertEquals(NativeDump.MAGIC, distributor.magic);
+		assertEquals(NativeDump.ZFAST_TRIE_DISTRIBUTOR, distributor.kind);
+		assertEquals(10, distributor.numSections);
+		final NativeDumpTest.Header ranker = NativeDumpTest.header(buffer, distributor.offset[9]);
+		assertEquals(NativeDump.MAGIC, ranker.magic);
+		assertEquals(NativeDump.TWO_STEPS_LCP_MMPHF, ranker.kind);
+		final int signatures = header.offset[3];
+		for (int i = 0; i < 10; i++) assertEquals(mph.signatures.getLong(i), buffer.getInt(signatures + i * Integer.BYTES) & 0xFFFFFFFFL);
+	}
 }
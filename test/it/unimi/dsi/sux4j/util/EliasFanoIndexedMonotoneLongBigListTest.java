@@ -23,6 +23,10 @@ import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertTrue;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
 import org.junit.Test;
 
 import it.unimi.dsi.Util;
@@ -30,6 +34,8 @@ import it.unimi.dsi.fastutil.longs.LongArrayList;
 import it.unimi.dsi.fastutil.longs.LongBigArrayBigList;
 import it.unimi.dsi.fastutil.longs.LongIterators;
 import it.unimi.dsi.fastutil.longs.LongOpenHashSet;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.sux4j.util.EliasFanoIndexedMonotoneLongBigList.EliasFanoIndexedMonotoneLongBigListIterator;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
@@ -337,4 +343,33 @@ public class EliasFanoIndexedMonotoneLongBigListTest {
 		assertEquals(3, l.index());
 		assertEquals(3, l.strictSuccessorIndexUnsafe(9));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(EliasFanoIndexedMonotoneLongBigListTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final XoRoShiRo128PlusRandom random = new XoRoShiRo128PlusRandom(0);
+		final long[] s = new long[100000];
+		s[0] = 5;
+		for (int i = 1; i < s.length; i++) s[i] = s[i - 1] + random.nextInt(1000);
+		final EliasFanoIndexedMonotoneLongBigList ef = new EliasFanoIndexedMonotoneLongBigList(LongArrayList.wrap(s));
+		ef.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.ELIAS_FANO_INDEXED, header.kind);
+		// The bit vector of the selection structure on zeroes is not repeated
+		assertEquals(8, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertEquals(ef.l, header.param[1]);
+		assertEquals(s.length + 1, header.param[3]);
+		assertEquals(header.param[2], header.param[5]);
+		assertEquals(header.param[2] - s.length - 1, header.param[6]);
+		assertEquals(s[0], header.param[8]);
+		assertEquals(s[s.length - 1], header.param[9]);
+
+		final int upper = header.offset[1];
+		for (int i = 0; i < (ef.selectUpper.bitVector().length() + 63) / 64; i++) assertEquals(ef.upperBits[i], buffer.getLong(upper + i * Long.BYTES));
+	}
 }
@@ -22,12 +22,18 @@ package it.unimi.dsi.sux4j.util;
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
 import org.junit.Test;
 
 import it.unimi.dsi.Util;
 import it.unimi.dsi.fastutil.longs.LongArrayList;
 import it.unimi.dsi.fastutil.longs.LongBigArrayBigList;
 import it.unimi.dsi.fastutil.longs.LongBigListIterator;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class EliasFanoMonotoneLongBigListTest {
@@ -156,4 +162,32 @@ public class EliasFanoMonotoneLongBigListTest {
 			}
 		}
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(EliasFanoMonotoneLongBigListTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final XoRoShiRo128PlusRandom random = new XoRoShiRo128PlusRandom(0);
+		final long[] s = new long[100000];
+		for (int i = 1; i < s.length; i++) s[i] = s[i - 1] + random.nextInt(1000);
+		final EliasFanoMonotoneLongBigList ef = new EliasFanoMonotoneLongBigList(LongArrayList.wrap(s));
+		ef.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.ELIAS_FANO, header.kind);
+		assertEquals(5, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertEquals(ef.l, header.param[1]);
+		assertEquals(ef.selectUpper.bitVector().length(), header.param[2]);
+		// The upper bits contain a sentinel
+		assertEquals(s.length + 1, header.param[3]);
+
+		final int lower = header.offset[0];
+		assertEquals(ef.lowerBits.length * (long)Long.BYTES, header.length[0]);
+		for (int i = 0; i < ef.lowerBits.length; i++) assertEquals(ef.lowerBits[i], buffer.getLong(lower + i * Long.BYTES));
+		final int upper = header.offset[1];
+		for (int i = 0; i < ef.upperBits.length && i < (ef.selectUpper.bitVector().length() + 63) / 64; i++) assertEquals(ef.upperBits[i], buffer.getLong(upper + i * Long.BYTES));
+	}
 }
@@ -22,11 +22,18 @@ package it.unimi.dsi.sux4j.util;
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
 import org.junit.Test;
 
 import it.unimi.dsi.Util;
+import it.unimi.dsi.fastutil.longs.LongArrayList;
 import it.unimi.dsi.fastutil.longs.LongBigArrayBigList;
 import it.unimi.dsi.fastutil.longs.LongBigListIterator;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
 
 public class EliasFanoPrefixSumLongBigListTest {
@@ -110,4 +117,24 @@ public class EliasFanoPrefixSumLongBigListTest {
 		}
 		assertEquals(l, new EliasFanoPrefixSumLongBigList(l));
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(EliasFanoPrefixSumLongBigListTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final XoRoShiRo128PlusRandom random = new XoRoShiRo128PlusRandom(0);
+		final long[] s = new long[100000];
+		for (int i = 0; i < s.length; i++) s[i] = random.nextInt(1000);
+		final EliasFanoPrefixSumLongBigList l = new EliasFanoPrefixSumLongBigList(LongArrayList.wrap(s));
+		l.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.ELIAS_FANO, header.kind);
+		// The dump contains the prefix sums, including the total
+		assertEquals(s.length + 1, header.param[0]);
+		assertEquals(l.l, header.param[1]);
+		final int lower = header.offset[0];
+		for (int i = 0; i < l.lowerBits.length; i++) assertEquals(l.lowerBits[i], buffer.getLong(lower + i * Long.BYTES));
+	}
 }
@@ -0,0 +1,132 @@
+/*
+ * Sux4J: Succinct data structures for Java
+ *
+ * Copyright (C) 2021 Sebastiano Vigna
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the GNU Lesser General Public License v2.1 or later,
+ * which is available at
+ * http://www.gnu.org/licenses/old-licenses/lgpl-2.1-standalone.html,
+ * or the Apache Software License 2.0, which is available at
+ * https://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later OR Apache-2.0
+ */
+
+package it.unimi.dsi.sux4j.util;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
+import org.junit.Test;
+
+import it.unimi.dsi.fastutil.longs.LongArrayList;
+import it.unimi.dsi.fastutil.longs.LongBigArrayBigList;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
+import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
+
+public class PartitionedEliasFanoMonotoneLongBigListTest {
+
+	/** Returns a clustered sequence: runs of consecutive values, dense and sparse stretches, and repeats. */
+	private static LongArrayList clustered(final int n, final long seed) {
+		final XoRoShiRo128PlusRandom random = new XoRoShiRo128PlusRandom(seed);
+		final LongArrayList l = new LongArrayList();
+		long x = random.nextInt(100);
+		while (l.size() < n) {
+			final int length = 1 + random.nextInt(500);
+			switch (random.nextInt(4)) {
+			case 0:
+				for (int i = 0; i < length; i++) l.add(x++);
+				break;
+			case 1:
+				for (int i = 0; i < length; i++) l.add(x += 1 + random.nextInt(3));
+				break;
+			case 2:
+				for (int i = 0; i < length; i++) l.add(x += random.nextInt(2));
+				break;
+			default:
+				for (int i = 0; i < length; i++) l.add(x += random.nextInt(1 << 20));
+			}
+		}
+		l.size(n);
+		return l;
+	}
+
+	@Test
+	public void testSmall() {
+		LongBigArrayBigList l;
+
+		l = new LongBigArrayBigList(new long[][] { {} });
+		assertEquals(l, new PartitionedEliasFanoMonotoneLongBigList(l));
+
+		l = new LongBigArrayBigList(new long[][] { { 0, 1, 2 } });
+		assertEquals(l, new PartitionedEliasFanoMonotoneLongBigList(l));
+
+		l = new LongBigArrayBigList(new long[][] { { 0, 10, 20 } });
+		assertEquals(l, new PartitionedEliasFanoMonotoneLongBigList(l));
+
+		l = new LongBigArrayBigList(new long[][] { { 0, 1, 1, 1, 5 } });
+		assertEquals(l, new PartitionedEliasFanoMonotoneLongBigList(l));
+
+		l = new LongBigArrayBigList(new long[][] { { Long.MAX_VALUE / 2, Long.MAX_VALUE - 1 } });
+		assertEquals(l, new PartitionedEliasFanoMonotoneLongBigList(l));
+	}
+
+	@Test
+	public void testClustered() {
+		for (final int n : new int[] { 1, 10, 127, 128, 129, 1000, 100000 }) {
+			final LongArrayList l = clustered(n, n);
+			for (int log2PartitionSize = 0; log2PartitionSize < 12; log2PartitionSize += 3) {
+				final PartitionedEliasFanoMonotoneLongBigList p = new PartitionedEliasFanoMonotoneLongBigList(l.iterator(), log2PartitionSize);
+				assertEquals(n, p.size64());
+				for (int i = 0; i < n; i++) assertEquals(l.getLong(i), p.getLong(i));
+			}
+		}
+	}
+
+	@Test
+	public void testSpace() {
+		final LongArrayList l = clustered(100000, 0);
+		assertTrue(new PartitionedEliasFanoMonotoneLongBigList(l).numBits() < new EliasFanoMonotoneLongBigList(l).numBits());
+	}
+
+	@Test(expected = IllegalArgumentException.class)
+	public void testNotMonotone() {
+		new PartitionedEliasFanoMonotoneLongBigList(LongArrayList.wrap(new long[] { 0, 2, 1 }));
+	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(PartitionedEliasFanoMonotoneLongBigListTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final LongArrayList l = clustered(100000, 1);
+		final PartitionedEliasFanoMonotoneLongBigList p = new PartitionedEliasFanoMonotoneLongBigList(l);
+		p.dump(f.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(f);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.PARTITIONED_ELIAS_FANO, header.kind);
+		assertEquals(10, header.numSections);
+		assertEquals(l.size(), header.param[0]);
+		assertEquals(p.log2PartitionSize, header.param[1]);
+		assertEquals(p.descriptorWidth, header.param[2]);
+		// The parameters of the endpoints follow
+		assertEquals(p.endpoints.size64(), header.param[3]);
+		assertEquals(l.getLong(0), header.param[11]);
+		assertEquals(l.getLong(l.size() - 1), header.param[12]);
+
+		final int descriptors = header.offset[8];
+		for (int i = 0; i < p.descriptors.length() / 64; i++) assertEquals(p.descriptors.getLong(i * 64L, (i + 1) * 64L), buffer.getLong(descriptors + i * Long.BYTES));
+		assertEquals((p.bits.length() + 63) / 64 * Long.BYTES, header.length[9]);
+	}
+}
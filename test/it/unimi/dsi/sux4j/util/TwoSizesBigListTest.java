@@ -21,10 +21,16 @@ package it.unimi.dsi.sux4j.util;
 
 import static org.junit.Assert.assertEquals;
 
+import java.io.File;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+
 import org.junit.Test;
 
 import it.unimi.dsi.bits.LongArrayBitVector;
 import it.unimi.dsi.fastutil.longs.LongBigList;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 
 public class TwoSizesBigListTest {
 	@Test
@@ -43,4 +49,39 @@ public class TwoSizesBigListTest {
 		ts = new TwoSizesLongBigList(l);
 		assertEquals(ts, l);
 	}
+
+	@Test
+	public void testDump() throws IOException {
+		final File f = File.createTempFile(TwoSizesBigListTest.class.getSimpleName(), "dump");
+		f.deleteOnExit();
+		final LongBigList l = LongArrayBitVector.getInstance().asLongBigList(20);
+		for (int i = 0; i < 10000; i++) l.add(i % 100 == 0 ? 1000000 + i : i % 7);
+		new TwoSizesLongBigList(l).dump(f.toString());
+
+		ByteBuffer buffer = NativeDumpTest.read(f);
+		NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.TWO_SIZES, header.kind);
+		assertEquals(4, header.numSections);
+		assertEquals(l.size64(), header.param[0]);
+		assertEquals(3, header.param[1]);
+		assertEquals(20, header.param[2]);
+		// The parameters of the Rank9 on the marker
+		assertEquals(l.size64(), header.param[3]);
+		assertEquals(100, header.param[4]);
+		// The first small elements are 1, 2, ..., 6, 0, 1
+		final int small = header.offset[0];
+		assertEquals(1 | 2 << 3 | 3 << 6, buffer.getLong(small) & 0x1FF);
+		final int large = header.offset[1];
+		assertEquals(1000000, buffer.getLong(large) & (1 << 20) - 1);
+
+		// No large elements
+		l.clear();
+		for (int i = 0; i < 1000; i++) l.add(i % 2);
+		new TwoSizesLongBigList(l).dump(f.toString());
+		buffer = NativeDumpTest.read(f);
+		header = NativeDumpTest.header(buffer);
+		assertEquals(2, header.numSections);
+		assertEquals(1, header.param[1]);
+		assertEquals(0, header.param[2]);
+	}
 }
@@ -26,6 +26,8 @@ import static org.junit.Assert.assertTrue;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import java.util.Arrays;
 import java.util.Collections;
 import java.util.TreeSet;
@@ -41,6 +43,8 @@ import it.unimi.dsi.bits.TransformationStrategies;
 import it.unimi.dsi.fastutil.io.BinIO;
 import it.unimi.dsi.fastutil.objects.ObjectArrayList;
 import it.unimi.dsi.fastutil.objects.ObjectBidirectionalIterator;
+import it.unimi.dsi.sux4j.io.NativeDump;
+import it.unimi.dsi.sux4j.io.NativeDumpTest;
 import it.unimi.dsi.sux4j.mph.Hashes;
 import it.unimi.dsi.sux4j.util.ZFastTrie.InternalNode;
 import it.unimi.dsi.util.XoRoShiRo128PlusRandom;
@@ -636,4 +640,40 @@ public class ZFastTrieTest {
 		}
 	}
 
+	@Test
+	public void testDump() throws IOException {
+		final byte[][] s = new byte[1000][];
+		for (int i = s.length; i-- != 0;) s[i] = binary(i).getBytes(StandardCharsets.US_ASCII);
+		final ZFastTrie<byte[]> zft = new ZFastTrie<>(Arrays.asList(s), TransformationStrategies.prefixFreeByteArray());
+		final File file = File.createTempFile(getClass().getSimpleName(), "dump");
+		file.deleteOnExit();
+		zft.dump(file.toString());
+
+		final ByteBuffer buffer = NativeDumpTest.read(file);
+		final NativeDumpTest.Header header = NativeDumpTest.header(buffer);
+		assertEquals(NativeDump.MAGIC, header.magic);
+		assertEquals(NativeDump.ZFAST_TRIE, header.kind);
+		assertEquals(NativeDump.PREFIX_FREE_BYTE_ARRAY, header.strategy);
+		assertEquals(9, header.numSections);
+		assertEquals(s.length, header.param[0]);
+		assertTrue(header.param[1] < 2 * s.length - 1);
+		// Nodes and links of the internal nodes
+		assertEquals(2 * Long.BYTES * (s.length - 1), header.length[0]);
+		assertEquals(3 * Long.BYTES * (s.length - 1), header.length[1]);
+		// Keys of 32 bytes plus terminator, and their offsets
+		assertTrue(header.length[2] >= s.length * 33);
+		assertEquals(s.length + 1, header.param[2]);
+		final NativeDumpTest.Header mphHeader = NativeDumpTest.header(buffer, header.offset[8]);
+		assertEquals(NativeDump.MAGIC, mphHeader.magic);
+		assertEquals(NativeDump.MPH, mphHeader.kind);
+		assertEquals(s.length - 1, mphHeader.param[0]);
+
+		final ZFastTrie<byte[]> single = new ZFastTrie<>(Arrays.asList(s[0]), TransformationStrategies.prefixFreeByteArray());
+		single.dump(file.toString());
+		final NativeDumpTest.Header singleHeader = NativeDumpTest.header(NativeDumpTest.read(file));
+		assertEquals(8, singleHeader.numSections);
+		// The root is the only leaf
+		assertEquals(0, singleHeader.param[1]);
+	}
+
 }